@@ -0,0 +1,1281 @@
+/*
+Author: Guo Jia
+Description: Implementation of ArchiveIndex.  Tar headers are read with
+             pread at computed offsets, so the data of a plain tar file is
+             never read while indexing; a tar.gz has to be inflated from
+             start to end once, but its data is discarded as it goes.  Zip
+             indexing reads only the end record and the central directory.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ArchiveIndex.h"
+#include "DirectoryListing.h"
+#include "InflateReader.h"
+#include "JobProgress.h"
+
+using namespace std;
+
+namespace
+{
+    // Extended-header records (GNU long names, pax) larger than this are
+    // skipped rather than read into memory.
+    const uint64_t MAX_EXTENDED_HEADER = 1024 * 1024;
+
+    // How often (in members) the indexing message is refreshed.
+    const size_t MESSAGE_INTERVAL = 1024;
+
+    const uint32_t ZIP_LOCAL_HEADER     = 0x04034b50;
+    const uint32_t ZIP_CENTRAL_HEADER   = 0x02014b50;
+    const uint32_t ZIP_END_RECORD       = 0x06054b50;
+    const uint32_t ZIP64_END_RECORD     = 0x06064b50;
+    const uint32_t ZIP64_END_LOCATOR    = 0x07064b50;
+    const size_t   ZIP_END_RECORD_SIZE  = 22;
+    const size_t   ZIP_MAX_COMMENT      = 0xFFFF;
+    const size_t   ZIP64_LOCATOR_SIZE   = 20;
+    const size_t   ZIP64_END_SIZE       = 56;
+    const size_t   ZIP_CENTRAL_SIZE     = 46;
+    const size_t   ZIP_LOCAL_SIZE       = 30;
+    const uint16_t ZIP_EXTRA_ZIP64      = 0x0001;
+    const uint16_t ZIP_EXTRA_TIMESTAMP  = 0x5455;
+    const uint16_t ZIP_METHOD_STORED    = 0;
+    const uint16_t ZIP_METHOD_DEFLATED  = 8;
+    const uint8_t  ZIP_HOST_UNIX        = 3;
+
+    uint16_t Little16(const unsigned char* p)
+    {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    uint32_t Little32(const unsigned char* p)
+    {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    uint64_t Little64(const unsigned char* p)
+    {
+        return static_cast<uint64_t>(Little32(p)) | (static_cast<uint64_t>(Little32(p + 4)) << 32);
+    }
+
+    // pread until 'length' bytes or the end of the file.
+    size_t ReadAt(int fd, void* buffer, size_t length, uint64_t offset)
+    {
+        size_t done = 0;
+        while (done < length)
+        {
+            ssize_t got = pread(fd, static_cast<char*>(buffer) + done, length - done,
+                                static_cast<off_t>(offset + done));
+            if (got < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (got <= 0)
+            {
+                break;
+            }
+            done += static_cast<size_t>(got);
+        }
+        return done;
+    }
+
+    bool WriteAll(int fd, const char* data, size_t length)
+    {
+        while (length > 0)
+        {
+            ssize_t written = write(fd, data, length);
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                return false;
+            }
+            data   += written;
+            length -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    // Opens the folder 'relative' below the folder 'base' one component at
+    // a time and refuses a symlink anywhere on the way, so nothing already
+    // in the destination can redirect a write outside it.  -1 on failure.
+    int OpenBeneath(int base, const string& relative)
+    {
+        int fd = fcntl(base, F_DUPFD_CLOEXEC, 0);
+        size_t start = 0;
+        while (fd >= 0 && start < relative.size())
+        {
+            size_t end = relative.find('/', start);
+            if (end == string::npos)
+            {
+                end = relative.size();
+            }
+            string part = relative.substr(start, end - start);
+            int next = openat(fd, part.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            close(fd);
+            fd = next;
+            start = end + 1;
+        }
+        return fd;
+    }
+
+    // True when a symlink created at 'relative' (whose first component is
+    // the extracted top folder) pointing at 'link' resolves inside that
+    // folder: the target is relative and never climbs above it.
+    bool LinkStaysInside(const string& relative, const string& link)
+    {
+        if (link.empty() || link[0] == '/')
+        {
+            return false;
+        }
+        size_t depth = static_cast<size_t>(count(relative.begin(), relative.end(), '/'));
+        depth = depth > 0 ? depth - 1 : 0;
+        size_t start = 0;
+        while (start <= link.size())
+        {
+            size_t end = link.find('/', start);
+            if (end == string::npos)
+            {
+                end = link.size();
+            }
+            string part = link.substr(start, end - start);
+            if (part == "..")
+            {
+                if (depth == 0)
+                {
+                    return false;
+                }
+                --depth;
+            }
+            else if (!part.empty() && part != ".")
+            {
+                ++depth;
+            }
+            start = end + 1;
+        }
+        return true;
+    }
+
+    // Tar numeric field: octal text, or base-256 when the top bit of the
+    // first byte is set (GNU, for sizes of 8 GiB and up).
+    uint64_t TarNumber(const char* field, size_t length)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(field);
+        uint64_t value = 0;
+        if (bytes[0] & 0x80)
+        {
+            value = bytes[0] & 0x7F;
+            for (size_t i = 1; i < length; ++i)
+            {
+                value = (value << 8) | bytes[i];
+            }
+            return value;
+        }
+        size_t i = 0;
+        while (i < length && field[i] == ' ')
+        {
+            ++i;
+        }
+        for (; i < length && field[i] >= '0' && field[i] <= '7'; ++i)
+        {
+            value = (value << 3) | static_cast<uint64_t>(field[i] - '0');
+        }
+        return value;
+    }
+
+    // NUL-terminated text field that may fill its whole width.
+    string TarText(const char* field, size_t length)
+    {
+        return string(field, strnlen(field, length));
+    }
+
+    // The header checksum counts its own field as spaces.  Some old tars
+    // summed signed chars, so both sums are accepted.
+    bool IsTarHeader(const char* block)
+    {
+        uint64_t stored      = TarNumber(block + 148, 8);
+        uint64_t unsignedSum = 0;
+        int64_t  signedSum   = 0;
+        for (size_t i = 0; i < 512; ++i)
+        {
+            char c = (i >= 148 && i < 156) ? ' ' : block[i];
+            unsignedSum += static_cast<unsigned char>(c);
+            signedSum   += static_cast<signed char>(c);
+        }
+        return block[148] != '\0' &&
+               (stored == unsignedSum || static_cast<int64_t>(stored) == signedSum);
+    }
+
+    bool IsZeroBlock(const char* block)
+    {
+        for (size_t i = 0; i < 512; ++i)
+        {
+            if (block[i] != '\0')
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // pax extended header: records of the form "<length> <key>=<value>\n".
+    void ParsePax(const string& data, string& path, string& link, uint64_t& size, bool& hasSize,
+                  int64_t& modified, bool& hasModified)
+    {
+        size_t pos = 0;
+        while (pos < data.size())
+        {
+            size_t space = data.find(' ', pos);
+            if (space == string::npos)
+            {
+                return;
+            }
+            size_t length = static_cast<size_t>(strtoull(data.c_str() + pos, nullptr, 10));
+            if (length == 0 || pos + length > data.size())
+            {
+                return;
+            }
+            size_t equals = data.find('=', space);
+            size_t end    = pos + length - 1;   // the '\n'
+            if (equals != string::npos && equals < end)
+            {
+                string key   = data.substr(space + 1, equals - space - 1);
+                string value = data.substr(equals + 1, end - equals - 1);
+                if (key == "path")
+                {
+                    path = value;
+                }
+                else if (key == "linkpath")
+                {
+                    link = value;
+                }
+                else if (key == "size")
+                {
+                    size    = strtoull(value.c_str(), nullptr, 10);
+                    hasSize = true;
+                }
+                else if (key == "mtime")
+                {
+                    modified    = strtoll(value.c_str(), nullptr, 10);
+                    hasModified = true;
+                }
+            }
+            pos += length;
+        }
+    }
+
+    // MS-DOS date and time as stored in zip headers, in local time.
+    int64_t DosTime(uint16_t date, uint16_t time)
+    {
+        struct tm parts;
+        memset(&parts, 0, sizeof(parts));
+        parts.tm_year  = ((date >> 9) & 0x7F) + 80;
+        parts.tm_mon   = ((date >> 5) & 0x0F) - 1;
+        parts.tm_mday  = date & 0x1F;
+        parts.tm_hour  = (time >> 11) & 0x1F;
+        parts.tm_min   = (time >> 5) & 0x3F;
+        parts.tm_sec   = (time & 0x1F) * 2;
+        parts.tm_isdst = -1;
+        return static_cast<int64_t>(mktime(&parts));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: ArchiveIndex
+Description: Creates an empty index.
+Parameters: None
+Return: None
+*/
+ArchiveIndex::ArchiveIndex()
+    : m_archive(),
+      m_archiveModified(0),
+      m_archiveSize(0),
+      m_format(FORMAT_NONE),
+      m_members(),
+      m_lookup(),
+      m_children()
+{
+}
+
+/*
+Function: ~ArchiveIndex
+Description: Destructor.  Nothing to release.
+Parameters: None
+Return: None
+*/
+ArchiveIndex::~ArchiveIndex()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Building
+// ---------------------------------------------------------------------------
+
+/*
+Function: DetectFormat
+Description: Zip files start with a local header (or, when empty, the end
+             record); tar files with a header whose checksum matches.
+             A gzip file is inflated just far enough to check for the
+             latter.
+Parameters: path - file to look at
+Return: Archive format, or FORMAT_NONE
+*/
+ArchiveIndex::Format ArchiveIndex::DetectFormat(const string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NOCTTY);
+    if (fd < 0)
+    {
+        return FORMAT_NONE;
+    }
+    char   block[TAR_BLOCK];
+    size_t length = ReadAt(fd, block, sizeof(block), 0);
+    close(fd);
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(block);
+    if (length >= 4 && (Little32(bytes) == ZIP_LOCAL_HEADER || Little32(bytes) == ZIP_END_RECORD))
+    {
+        return FORMAT_ZIP;
+    }
+    if (length == TAR_BLOCK && IsTarHeader(block))
+    {
+        return FORMAT_TAR;
+    }
+    if (length >= 2 && bytes[0] == 0x1F && bytes[1] == 0x8B)
+    {
+        InflateReader reader(path, 0, InflateReader::FRAMING_GZIP);
+        size_t inflated = 0;
+        while (inflated < TAR_BLOCK)
+        {
+            size_t got = reader.Read(block + inflated, TAR_BLOCK - inflated);
+            if (got == 0)
+            {
+                break;
+            }
+            inflated += got;
+        }
+        if (inflated == TAR_BLOCK && IsTarHeader(block))
+        {
+            return FORMAT_TAR_GZIP;
+        }
+    }
+    return FORMAT_NONE;
+}
+
+/*
+Function: Build
+Description: Replaces the index with the members of 'archive'.  The
+             archive's mtime and size are recorded so a cached index can be
+             checked against the file later.
+Parameters: archive  - archive file
+            progress - progress/cancel state of the job
+Return: true if the archive was indexed
+*/
+bool ArchiveIndex::Build(const string& archive, JobProgress& progress)
+{
+    m_archive = archive;
+    m_format  = FORMAT_NONE;
+    m_members.clear();
+    m_lookup.clear();
+    m_children.clear();
+
+    int fd = open(archive.c_str(), O_RDONLY | O_CLOEXEC | O_NOCTTY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        close(fd);
+        return false;
+    }
+    m_archiveModified = static_cast<int64_t>(info.st_mtime);
+    m_archiveSize     = static_cast<uint64_t>(info.st_size);
+    m_format          = DetectFormat(archive);
+
+    bool built = false;
+    if (m_format == FORMAT_ZIP)
+    {
+        built = BuildZip(fd, progress);
+    }
+    else if (m_format == FORMAT_TAR || m_format == FORMAT_TAR_GZIP)
+    {
+        built = BuildTar(fd, progress);
+    }
+    close(fd);
+
+    if (!built || progress.IsCancelled())
+    {
+        m_members.clear();
+        m_lookup.clear();
+        return false;
+    }
+    FinishMembers();
+    return true;
+}
+
+/*
+Function: BuildTar
+Description: Walks the headers in order.  GNU 'L'/'K' records and pax 'x'
+             records describe the header that follows them; the ustar
+             prefix field extends short names.  Device nodes and FIFOs are
+             left out.  A damaged or truncated archive ends the walk with
+             the members found so far; only a bad first header fails.
+Parameters: fd       - open archive
+            progress - advanced by archive bytes consumed
+Return: true if at least the first header was valid
+*/
+bool ArchiveIndex::BuildTar(int fd, JobProgress& progress)
+{
+    unique_ptr<InflateReader> inflater;
+    if (m_format == FORMAT_TAR_GZIP)
+    {
+        inflater.reset(new InflateReader(m_archive, 0, InflateReader::FRAMING_GZIP));
+    }
+    progress.SetTotal(m_archiveSize);
+
+    uint64_t position = 0;   // in the uncompressed tar stream
+    uint64_t reported = 0;
+    auto readBytes = [&](char* buffer, size_t length) -> bool
+    {
+        size_t got = 0;
+        if (inflater)
+        {
+            while (got < length)
+            {
+                size_t piece = inflater->Read(buffer + got, length - got);
+                if (piece == 0)
+                {
+                    break;
+                }
+                got += piece;
+            }
+        }
+        else
+        {
+            got = ReadAt(fd, buffer, length, position);
+        }
+        position += got;
+        return got == length;
+    };
+    auto skipBytes = [&](uint64_t length) -> bool
+    {
+        if (inflater)
+        {
+            bool skipped = inflater->Skip(length);
+            position = inflater->GetPosition();
+            return skipped;
+        }
+        position += length;   // plain tar: the next pread simply starts later
+        return position <= m_archiveSize;
+    };
+
+    string longName;
+    string longLink;
+    string paxPath;
+    string paxLink;
+    uint64_t paxSize     = 0;
+    int64_t  paxModified = 0;
+    bool     hasPaxSize     = false;
+    bool     hasPaxModified = false;
+
+    char   block[TAR_BLOCK];
+    size_t headers = 0;
+    while (!progress.IsCancelled())
+    {
+        uint64_t consumed = inflater ? inflater->GetCompressedPosition() : position;
+        if (consumed > reported)
+        {
+            progress.Advance(min(consumed, m_archiveSize) - min(reported, m_archiveSize));
+            reported = consumed;
+        }
+
+        if (!readBytes(block, TAR_BLOCK) || IsZeroBlock(block))
+        {
+            break;
+        }
+        if (!IsTarHeader(block))
+        {
+            return headers > 0;
+        }
+        ++headers;
+
+        char     type   = block[156];
+        uint64_t size   = hasPaxSize ? paxSize : TarNumber(block + 124, 12);
+        uint64_t padded = (size + TAR_BLOCK - 1) / TAR_BLOCK * TAR_BLOCK;
+
+        if (type == 'L' || type == 'K' || type == 'x' || type == 'g')
+        {
+            size = TarNumber(block + 124, 12);   // pax sizes describe the next header
+            padded = (size + TAR_BLOCK - 1) / TAR_BLOCK * TAR_BLOCK;
+            if (size > MAX_EXTENDED_HEADER)
+            {
+                if (!skipBytes(padded))
+                {
+                    break;
+                }
+                continue;
+            }
+            string data(static_cast<size_t>(padded), '\0');
+            if (!readBytes(&data[0], data.size()))
+            {
+                break;
+            }
+            data.resize(static_cast<size_t>(size));
+            if (type == 'L')
+            {
+                longName = string(data.c_str());
+            }
+            else if (type == 'K')
+            {
+                longLink = string(data.c_str());
+            }
+            else if (type == 'x')
+            {
+                ParsePax(data, paxPath, paxLink, paxSize, hasPaxSize, paxModified, hasPaxModified);
+            }
+            continue;
+        }
+
+        string name = TarText(block, 100);
+        if (memcmp(block + 257, "ustar\0", 6) == 0 && block[345] != '\0')
+        {
+            name = TarText(block + 345, 155) + "/" + name;
+        }
+        if (!longName.empty())
+        {
+            name = longName;
+        }
+        if (!paxPath.empty())
+        {
+            name = paxPath;
+        }
+        string link = !paxLink.empty() ? paxLink : !longLink.empty() ? longLink : TarText(block + 157, 100);
+
+        Member member;
+        member.mode           = static_cast<uint32_t>(TarNumber(block + 100, 8) & 07777);
+        member.size           = size;
+        member.modified       = hasPaxModified ? paxModified : static_cast<int64_t>(TarNumber(block + 136, 12));
+        member.offset         = position;
+        member.compressedSize = 0;
+        member.method         = 0;
+        member.encrypted      = false;
+        bool keep = true;
+        switch (type)
+        {
+        case '0':
+        case '\0':
+        case '7':
+            member.kind = (!name.empty() && name.back() == '/') ? KIND_DIRECTORY : KIND_FILE;
+            break;
+        case '5':
+            member.kind = KIND_DIRECTORY;
+            break;
+        case '2':
+            member.kind = KIND_SYMLINK;
+            member.link = link;
+            break;
+        case '1':
+            member.kind = KIND_HARDLINK;
+            member.link = CleanPath(link);
+            break;
+        default:
+            keep = false;   // devices, FIFOs, vendor extensions
+            break;
+        }
+        member.path = CleanPath(name);
+        if (keep && !member.path.empty())
+        {
+            if (member.kind == KIND_DIRECTORY)
+            {
+                member.size = 0;
+            }
+            AddMember(move(member));
+            if (m_members.size() % MESSAGE_INTERVAL == 0)
+            {
+                progress.SetMessage("Indexing: " + to_string(m_members.size()) + " members");
+            }
+        }
+
+        longName.clear();
+        longLink.clear();
+        paxPath.clear();
+        paxLink.clear();
+        hasPaxSize     = false;
+        hasPaxModified = false;
+        if (!skipBytes(padded))
+        {
+            break;
+        }
+    }
+    return headers > 0;
+}
+
+/*
+Function: BuildZip
+Description: Finds the end-of-central-directory record in the last 64 KiB
+             (it may be followed by a comment), follows the ZIP64 locator
+             when the classic fields overflow, then reads the central
+             directory in one piece and decodes its entries.  Sizes and the
+             local header offset come from the ZIP64 extra field when
+             needed, the mtime from the extended-timestamp field when
+             present.
+Parameters: fd       - open archive
+            progress - advanced by central directory bytes parsed
+Return: true if the central directory was read
+*/
+bool ArchiveIndex::BuildZip(int fd, JobProgress& progress)
+{
+    size_t tailLength = static_cast<size_t>(min<uint64_t>(m_archiveSize,
+                                                          ZIP_END_RECORD_SIZE + ZIP_MAX_COMMENT));
+    uint64_t tailStart = m_archiveSize - tailLength;
+    vector<unsigned char> tail(tailLength);
+    if (tailLength < ZIP_END_RECORD_SIZE || ReadAt(fd, tail.data(), tailLength, tailStart) != tailLength)
+    {
+        return false;
+    }
+
+    long end = -1;
+    for (size_t pos = tailLength - ZIP_END_RECORD_SIZE + 1; pos-- > 0;)
+    {
+        if (Little32(&tail[pos]) == ZIP_END_RECORD)
+        {
+            end = static_cast<long>(pos);
+            break;
+        }
+    }
+    if (end < 0)
+    {
+        return false;
+    }
+
+    const unsigned char* record = &tail[static_cast<size_t>(end)];
+    uint64_t entries   = Little16(record + 10);
+    uint64_t dirSize   = Little32(record + 12);
+    uint64_t dirOffset = Little32(record + 16);
+    if ((entries == 0xFFFF || dirSize == 0xFFFFFFFF || dirOffset == 0xFFFFFFFF) &&
+        static_cast<size_t>(end) >= ZIP64_LOCATOR_SIZE &&
+        Little32(record - ZIP64_LOCATOR_SIZE) == ZIP64_END_LOCATOR)
+    {
+        uint64_t zip64End = Little64(record - ZIP64_LOCATOR_SIZE + 8);
+        unsigned char zip64[ZIP64_END_SIZE];
+        if (ReadAt(fd, zip64, sizeof(zip64), zip64End) != sizeof(zip64) ||
+            Little32(zip64) != ZIP64_END_RECORD)
+        {
+            return false;
+        }
+        entries   = Little64(zip64 + 32);
+        dirSize   = Little64(zip64 + 40);
+        dirOffset = Little64(zip64 + 48);
+    }
+    if (dirOffset > m_archiveSize || dirSize > m_archiveSize - dirOffset)
+    {
+        return false;
+    }
+
+    vector<unsigned char> directory(static_cast<size_t>(dirSize));
+    progress.SetTotal(dirSize);
+    if (ReadAt(fd, directory.data(), directory.size(), dirOffset) != directory.size())
+    {
+        return false;
+    }
+
+    size_t pos = 0;
+    m_members.reserve(static_cast<size_t>(min<uint64_t>(entries, directory.size() / ZIP_CENTRAL_SIZE)));
+    while (pos + ZIP_CENTRAL_SIZE <= directory.size() && !progress.IsCancelled())
+    {
+        const unsigned char* header = &directory[pos];
+        if (Little32(header) != ZIP_CENTRAL_HEADER)
+        {
+            break;
+        }
+        uint8_t  host          = header[5];
+        uint16_t flags         = Little16(header + 8);
+        uint16_t method        = Little16(header + 10);
+        uint16_t time          = Little16(header + 12);
+        uint16_t date          = Little16(header + 14);
+        uint64_t compressed    = Little32(header + 20);
+        uint64_t size          = Little32(header + 24);
+        size_t   nameLength    = Little16(header + 28);
+        size_t   extraLength   = Little16(header + 30);
+        size_t   commentLength = Little16(header + 32);
+        uint32_t external      = Little32(header + 38);
+        uint64_t offset        = Little32(header + 42);
+        size_t   entryLength   = ZIP_CENTRAL_SIZE + nameLength + extraLength + commentLength;
+        if (pos + entryLength > directory.size())
+        {
+            break;
+        }
+
+        string name(reinterpret_cast<const char*>(header + ZIP_CENTRAL_SIZE), nameLength);
+        int64_t modified = DosTime(date, time);
+
+        const unsigned char* extra    = header + ZIP_CENTRAL_SIZE + nameLength;
+        const unsigned char* extraEnd = extra + extraLength;
+        while (extra + 4 <= extraEnd)
+        {
+            uint16_t id     = Little16(extra);
+            uint16_t length = Little16(extra + 2);
+            const unsigned char* field    = extra + 4;
+            const unsigned char* fieldEnd = min(field + length, extraEnd);
+            if (id == ZIP_EXTRA_ZIP64)
+            {
+                // Only the fields that overflowed are present, in this order.
+                if (size == 0xFFFFFFFF && field + 8 <= fieldEnd)
+                {
+                    size = Little64(field);
+                    field += 8;
+                }
+                if (compressed == 0xFFFFFFFF && field + 8 <= fieldEnd)
+                {
+                    compressed = Little64(field);
+                    field += 8;
+                }
+                if (offset == 0xFFFFFFFF && field + 8 <= fieldEnd)
+                {
+                    offset = Little64(field);
+                }
+            }
+            else if (id == ZIP_EXTRA_TIMESTAMP && length >= 5 && (field[0] & 1))
+            {
+                modified = static_cast<int32_t>(Little32(field + 1));
+            }
+            extra += 4 + length;
+        }
+
+        Member member;
+        uint32_t unixMode = (host == ZIP_HOST_UNIX) ? (external >> 16) : 0;
+        bool     folder   = (!name.empty() && name.back() == '/') || S_ISDIR(unixMode);
+        member.path           = CleanPath(name);
+        member.kind           = folder ? KIND_DIRECTORY : S_ISLNK(unixMode) ? KIND_SYMLINK : KIND_FILE;
+        member.mode           = (unixMode & 07777) != 0 ? (unixMode & 07777) : (folder ? 0755 : 0644);
+        member.size           = folder ? 0 : size;
+        member.modified       = modified;
+        member.offset         = offset;
+        member.compressedSize = compressed;
+        member.method         = method;
+        member.encrypted      = (flags & 1) != 0;
+        if (!member.path.empty())
+        {
+            AddMember(move(member));
+            if (m_members.size() % MESSAGE_INTERVAL == 0)
+            {
+                progress.SetMessage("Indexing: " + to_string(m_members.size()) + " members");
+            }
+        }
+        pos += entryLength;
+        progress.Advance(entryLength);
+    }
+    return true;
+}
+
+/*
+Function: AddMember
+Description: Appends the member, or overwrites an earlier one with the same
+             path – when a tar holds a path twice, extracting it leaves the
+             later copy.
+Parameters: member - the member
+Return: None
+*/
+void ArchiveIndex::AddMember(Member member)
+{
+    auto existing = m_lookup.find(member.path);
+    if (existing != m_lookup.end())
+    {
+        m_members[existing->second] = move(member);
+        return;
+    }
+    m_lookup.emplace(member.path, m_members.size());
+    m_members.push_back(move(member));
+}
+
+/*
+Function: FinishMembers
+Description: Archives need not contain entries for their folders ("a/b/c"
+             alone is fine), so every missing ancestor is added with the
+             archive's mtime.  Then hard links take the size of their
+             target, and each member is filed under its parent folder.
+Parameters: None
+Return: None
+*/
+void ArchiveIndex::FinishMembers()
+{
+    size_t explicitCount = m_members.size();
+    for (size_t i = 0; i < explicitCount; ++i)
+    {
+        string path = m_members[i].path;
+        for (size_t slash = path.rfind('/'); slash != string::npos && slash > 0;
+             slash = path.rfind('/', slash - 1))
+        {
+            string parent = path.substr(0, slash);
+            if (m_lookup.count(parent) != 0)
+            {
+                break;
+            }
+            Member folder;
+            folder.path           = parent;
+            folder.kind           = KIND_DIRECTORY;
+            folder.mode           = 0755;
+            folder.size           = 0;
+            folder.modified       = m_archiveModified;
+            folder.offset         = 0;
+            folder.compressedSize = 0;
+            folder.method         = 0;
+            folder.encrypted      = false;
+            AddMember(move(folder));
+        }
+    }
+
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        Member& member = m_members[i];
+        if (member.kind == KIND_HARDLINK)
+        {
+            member.size = DataOf(member).size;
+        }
+        size_t slash = member.path.rfind('/');
+        m_children[slash == string::npos ? string() : member.path.substr(0, slash)].push_back(i);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Browsing
+// ---------------------------------------------------------------------------
+
+/*
+Function: Find
+Description: Hash lookup by path.
+Parameters: path - member path
+Return: Member index, or -1
+*/
+long ArchiveIndex::Find(const string& path) const
+{
+    auto found = m_lookup.find(path);
+    return found == m_lookup.end() ? -1 : static_cast<long>(found->second);
+}
+
+/*
+Function: List
+Description: Turns the children of a folder into listing entries.  The
+             member index stands in for the inode, so each entry has a
+             stable identity within this version of the archive.
+Parameters: path    - folder inside the archive, "" for the top level
+            listing - receives the entries
+Return: true if the folder exists
+*/
+bool ArchiveIndex::List(const string& path, DirectoryListing& listing) const
+{
+    if (!path.empty())
+    {
+        long folder = Find(path);
+        if (folder < 0 || m_members[static_cast<size_t>(folder)].kind != KIND_DIRECTORY)
+        {
+            return false;
+        }
+    }
+
+    vector<DirectoryListing::Entry> entries;
+    auto children = m_children.find(path);
+    if (children != m_children.end())
+    {
+        entries.reserve(children->second.size());
+        for (size_t index : children->second)
+        {
+            const Member& member = m_members[index];
+            size_t slash = member.path.rfind('/');
+            DirectoryListing::Entry entry;
+            entry.name        = (slash == string::npos) ? member.path : member.path.substr(slash + 1);
+            entry.isDirectory = (member.kind == KIND_DIRECTORY);
+            entry.size        = member.size;
+            entry.modified    = member.modified;
+            entry.device      = 0;
+            entry.inode       = static_cast<uint64_t>(index) + 1;
+            entries.push_back(move(entry));
+        }
+    }
+    listing.SetEntries(path.empty() ? m_archive : m_archive + "/" + path, move(entries));
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Extraction
+// ---------------------------------------------------------------------------
+
+/*
+Function: Extract
+Description: Folders are created first, parents before children.  Files
+             are then written in the order their data appears in the
+             archive, so a tar.gz is inflated at most once from front to
+             back and member data in between is only skipped.  Only the
+             selected members are read.  Everything is created relative to
+             a descriptor for the folder holding the destination, walking
+             down without following symlinks, and symlinks are made last
+             so none of them can redirect a later write; a symlink whose
+             target is absolute or climbs out of the destination is left
+             out.
+Parameters: path        - member to copy out, "" for everything
+            destination - file or folder to create for it
+            progress    - advanced by bytes written
+Return: true if everything was written
+*/
+bool ArchiveIndex::Extract(const string& path, const string& destination, JobProgress& progress) const
+{
+    long root = path.empty() ? -1 : Find(path);
+    if (!path.empty() && root < 0)
+    {
+        return false;
+    }
+
+    vector<const Member*> folders;
+    vector<const Member*> files;
+    vector<const Member*> links;
+    uint64_t total = 0;
+    if (root >= 0 && m_members[static_cast<size_t>(root)].kind != KIND_DIRECTORY)
+    {
+        const Member& member = m_members[static_cast<size_t>(root)];
+        (member.kind == KIND_SYMLINK ? links : files).push_back(&member);
+    }
+    else
+    {
+        string prefix = path.empty() ? string() : path + "/";
+        for (const Member& member : m_members)
+        {
+            if (member.path != path && member.path.compare(0, prefix.size(), prefix) != 0)
+            {
+                continue;
+            }
+            if (member.kind == KIND_DIRECTORY)
+            {
+                folders.push_back(&member);
+            }
+            else
+            {
+                (member.kind == KIND_SYMLINK ? links : files).push_back(&member);
+            }
+        }
+    }
+    for (const Member* member : files)
+    {
+        total += member->size;
+    }
+    progress.SetTotal(total);
+
+    string full = destination;
+    while (full.size() > 1 && full.back() == '/')
+    {
+        full.pop_back();
+    }
+    size_t slash = full.rfind('/');
+    string holder = slash == string::npos ? string(".") : (slash == 0 ? string("/") : full.substr(0, slash));
+    string top = slash == string::npos ? full : full.substr(slash + 1);
+    int base = open(holder.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (base < 0)
+    {
+        return false;
+    }
+    if (root < 0 && mkdirat(base, top.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        close(base);
+        return false;   // the whole archive: its top level has no member
+    }
+
+    // Where a member ends up, relative to 'base': the part of its path
+    // below 'path', under the destination's own name.
+    auto target = [&](const Member& member) -> string
+    {
+        if (member.path == path)
+        {
+            return top;
+        }
+        return top + "/" + member.path.substr(path.empty() ? 0 : path.size() + 1);
+    };
+
+    // Opens the folder a member goes into; 'name' receives its own name.
+    auto parentOf = [&](const Member& member, string& name) -> int
+    {
+        string relative = target(member);
+        size_t cut = relative.rfind('/');
+        name = relative.substr(cut == string::npos ? 0 : cut + 1);
+        return OpenBeneath(base, cut == string::npos ? string() : relative.substr(0, cut));
+    };
+
+    sort(folders.begin(), folders.end(),
+         [](const Member* a, const Member* b) { return a->path < b->path; });
+    for (const Member* member : folders)
+    {
+        string name;
+        int parent = parentOf(*member, name);
+        bool made = parent >= 0 &&
+                    (mkdirat(parent, name.c_str(), (member->mode & 0777) | 0700) == 0 || errno == EEXIST);
+        if (parent >= 0)
+        {
+            close(parent);
+        }
+        if (!made)
+        {
+            close(base);
+            return false;
+        }
+    }
+
+    sort(files.begin(), files.end(), [this](const Member* a, const Member* b)
+    {
+        return DataOf(*a).offset < DataOf(*b).offset;
+    });
+
+    int fd = open(m_archive.c_str(), O_RDONLY | O_CLOEXEC | O_NOCTTY);
+    if (fd < 0)
+    {
+        close(base);
+        return false;
+    }
+    unique_ptr<InflateReader> stream;
+    bool ok = true;
+    for (const Member* member : files)
+    {
+        if (progress.IsCancelled())
+        {
+            ok = false;
+            break;
+        }
+        progress.SetMessage("Extracting " + member->path);
+
+        string name;
+        int parent = parentOf(*member, name);
+        int out = parent < 0 ? -1 :
+                  openat(parent, name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_NOFOLLOW,
+                         static_cast<mode_t>(member->mode & 0777));
+        if (parent >= 0)
+        {
+            close(parent);
+        }
+        if (out < 0)
+        {
+            ok = false;
+            break;
+        }
+        ok = ReadMember(fd, stream, DataOf(*member), [&](const char* data, size_t length)
+        {
+            if (progress.IsCancelled() || !WriteAll(out, data, length))
+            {
+                return false;
+            }
+            progress.Advance(length);
+            return true;
+        });
+        struct timespec times[2];
+        times[0].tv_sec  = 0;
+        times[0].tv_nsec = UTIME_OMIT;
+        times[1].tv_sec  = static_cast<time_t>(member->modified);
+        times[1].tv_nsec = 0;
+        futimens(out, times);
+        ok = (close(out) == 0) && ok;
+        if (!ok)
+        {
+            break;
+        }
+    }
+
+    for (const Member* member : links)
+    {
+        if (!ok || progress.IsCancelled())
+        {
+            break;
+        }
+        string link = member->link;
+        if (m_format == FORMAT_ZIP)
+        {
+            // zip keeps a symlink's target as its data
+            ok = ReadMember(fd, stream, *member, [&link](const char* data, size_t length)
+            {
+                link.append(data, length);
+                return true;
+            });
+        }
+        if (!ok || !LinkStaysInside(target(*member), link))
+        {
+            continue;
+        }
+        string name;
+        int parent = parentOf(*member, name);
+        if (parent < 0)
+        {
+            ok = false;
+            break;
+        }
+        unlinkat(parent, name.c_str(), 0);
+        ok = symlinkat(link.c_str(), parent, name.c_str()) == 0;
+        close(parent);
+    }
+    close(fd);
+    close(base);
+    return ok && !progress.IsCancelled();
+}
+
+/*
+Function: ReadMember
+Description: Plain tar members are read with pread at their offset.  For a
+             tar.gz the shared stream is advanced to the member (reopened
+             if it is already past it); zip members go to ReadZipMember().
+Parameters: fd     - open archive
+            stream - decompression state kept between tar.gz members
+            member - member whose data is wanted (not a hard link)
+            sink   - receives the data
+Return: true if all of the member's data was delivered
+*/
+bool ArchiveIndex::ReadMember(int fd, unique_ptr<InflateReader>& stream, const Member& member,
+                              const Sink& sink) const
+{
+    if (m_format == FORMAT_ZIP)
+    {
+        return ReadZipMember(fd, member, sink);
+    }
+
+    if (m_format == FORMAT_TAR_GZIP)
+    {
+        if (!stream || stream->GetPosition() > member.offset)
+        {
+            stream.reset(new InflateReader(m_archive, 0, InflateReader::FRAMING_GZIP));
+        }
+        if (!stream->Skip(member.offset - stream->GetPosition()))
+        {
+            return false;
+        }
+    }
+
+    vector<char> buffer(static_cast<size_t>(min<uint64_t>(member.size, COPY_BUFFER)));
+    uint64_t remaining = member.size;
+    uint64_t offset    = member.offset;
+    while (remaining > 0)
+    {
+        size_t want = static_cast<size_t>(min<uint64_t>(remaining, buffer.size()));
+        size_t got  = (m_format == FORMAT_TAR_GZIP) ? stream->Read(buffer.data(), want)
+                                                    : ReadAt(fd, buffer.data(), want, offset);
+        if (got == 0 || !sink(buffer.data(), got))
+        {
+            return false;
+        }
+        remaining -= got;
+        offset    += got;
+    }
+    return true;
+}
+
+/*
+Function: ReadZipMember
+Description: The local header repeats the name and has its own extra
+             field, so the data offset is only known after reading it.
+             Stored data is copied with pread; deflated data is inflated
+             from there.  Other methods and encrypted members are refused.
+Parameters: fd     - open archive
+            member - zip member
+            sink   - receives the data
+Return: true if all of the member's data was delivered
+*/
+bool ArchiveIndex::ReadZipMember(int fd, const Member& member, const Sink& sink) const
+{
+    unsigned char header[ZIP_LOCAL_SIZE];
+    if (member.encrypted ||
+        (member.method != ZIP_METHOD_STORED && member.method != ZIP_METHOD_DEFLATED) ||
+        ReadAt(fd, header, sizeof(header), member.offset) != sizeof(header) ||
+        Little32(header) != ZIP_LOCAL_HEADER)
+    {
+        return false;
+    }
+    uint64_t dataOffset = member.offset + ZIP_LOCAL_SIZE + Little16(header + 26) + Little16(header + 28);
+
+    unique_ptr<InflateReader> inflater;
+    if (member.method == ZIP_METHOD_DEFLATED)
+    {
+        inflater.reset(new InflateReader(m_archive, dataOffset, InflateReader::FRAMING_RAW));
+    }
+
+    vector<char> buffer(static_cast<size_t>(min<uint64_t>(member.size, COPY_BUFFER)));
+    uint64_t remaining = member.size;
+    uint64_t offset    = dataOffset;
+    while (remaining > 0)
+    {
+        size_t want = static_cast<size_t>(min<uint64_t>(remaining, buffer.size()));
+        size_t got  = inflater ? inflater->Read(buffer.data(), want)
+                               : ReadAt(fd, buffer.data(), want, offset);
+        if (got == 0 || !sink(buffer.data(), got))
+        {
+            return false;
+        }
+        remaining -= got;
+        offset    += got;
+    }
+    return true;
+}
+
+/*
+Function: DataOf
+Description: Follows a hard link to the member holding the data.  A link
+             whose target is missing, or is itself a link, yields the link
+             (with no data).
+Parameters: member - any member
+Return: The member to read data from
+*/
+const ArchiveIndex::Member& ArchiveIndex::DataOf(const Member& member) const
+{
+    if (member.kind != KIND_HARDLINK)
+    {
+        return member;
+    }
+    long target = Find(member.link);
+    if (target < 0 || m_members[static_cast<size_t>(target)].kind != KIND_FILE)
+    {
+        return member;
+    }
+    return m_members[static_cast<size_t>(target)];
+}
+
+/*
+Function: CleanPath
+Description: Drops empty and "." components and leading slashes.  A ".."
+             component rejects the name: extracting it would write outside
+             the destination.
+Parameters: path - name as stored in the archive
+Return: Cleaned path, or "" if unusable
+*/
+string ArchiveIndex::CleanPath(const string& path)
+{
+    string clean;
+    size_t start = 0;
+    while (start <= path.size())
+    {
+        size_t end = path.find('/', start);
+        if (end == string::npos)
+        {
+            end = path.size();
+        }
+        string part = path.substr(start, end - start);
+        if (part == "..")
+        {
+            return string();
+        }
+        if (!part.empty() && part != ".")
+        {
+            if (!clean.empty())
+            {
+                clean += '/';
+            }
+            clean += part;
+        }
+        start = end + 1;
+    }
+    return clean;
+}
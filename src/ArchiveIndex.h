@@ -0,0 +1,128 @@
+/*
+Author: Guo Jia
+Description: Declaration of ArchiveIndex – the member list of a tar, tar.gz
+             or zip archive, built without extracting anything: one pass
+             over the tar headers (seeking past the data of plain tar files)
+             or a parse of the zip central directory.  Lets the file panel
+             browse the archive as read-only folders and copy single members
+             out by seeking (tar, zip) or streaming (tar.gz) straight to
+             them.
+Date: 2026-10-18
+*/
+
+#ifndef ARCHIVEINDEX_H
+#define ARCHIVEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class DirectoryListing;
+class InflateReader;
+class JobProgress;
+
+class ArchiveIndex
+{
+public:
+    enum Format {
+        FORMAT_NONE,
+        FORMAT_TAR,
+        FORMAT_TAR_GZIP,
+        FORMAT_ZIP
+    };
+
+    enum Kind {
+        KIND_FILE,
+        KIND_DIRECTORY,
+        KIND_SYMLINK,
+        KIND_HARDLINK    // tar only: shares the data of the member 'link'
+    };
+
+    struct Member
+    {
+        std::string   path;             // '/'-separated, no leading or trailing '/'
+        Kind          kind;
+        std::uint32_t mode;             // permission bits
+        std::uint64_t size;             // uncompressed bytes
+        std::int64_t  modified;         // seconds since the epoch
+        std::uint64_t offset;           // tar: data offset in the uncompressed
+                                        // stream; zip: local header offset
+        std::uint64_t compressedSize;   // zip only
+        std::uint16_t method;           // zip only: 0 stored, 8 deflated
+        bool          encrypted;        // zip only
+        std::string   link;             // symlink / hard link target
+    };
+
+    ArchiveIndex();
+    virtual ~ArchiveIndex();
+
+    // Format of 'path' judged by its first bytes (a gzip file counts as
+    // tar.gz only if it decompresses to a tar header).
+    static Format DetectFormat(const std::string& path);
+
+    // Read the member list of 'archive'.  Progress is counted in bytes of
+    // the archive read so far.  Returns false if the archive cannot be read, is
+    // not a supported format, or the job was cancelled.
+    bool Build(const std::string& archive, JobProgress& progress);
+
+    const std::string& GetArchivePath() const { return m_archive; }
+    std::int64_t       GetArchiveModified() const { return m_archiveModified; }
+    std::uint64_t      GetArchiveSize() const { return m_archiveSize; }
+    Format             GetFormat() const { return m_format; }
+    std::size_t        GetMemberCount() const { return m_members.size(); }
+
+    // Index of the member at 'path' (no leading '/'), or -1.
+    long Find(const std::string& path) const;
+
+    // Fill 'listing' with the children of the folder 'path' ("" for the
+    // top level), under the virtual path "<archive>/<path>".  Returns
+    // false if there is no such folder.
+    bool List(const std::string& path, DirectoryListing& listing) const;
+
+    // Copy the member at 'path' (a file, or a folder with everything under
+    // it; "" for the whole archive) to 'destination'.  Existing files are
+    // overwritten.  Returns false on the first error, on an unsupported
+    // zip method or encryption, or if the job was cancelled.
+    bool Extract(const std::string& path, const std::string& destination, JobProgress& progress) const;
+
+private:
+    static constexpr std::size_t TAR_BLOCK   = 512;
+    static constexpr std::size_t COPY_BUFFER = 256 * 1024;
+
+    std::string                                               m_archive;
+    std::int64_t                                              m_archiveModified;
+    std::uint64_t                                             m_archiveSize;
+    Format                                                    m_format;
+    std::vector<Member>                                       m_members;
+    std::unordered_map<std::string, std::size_t>              m_lookup;     // path -> member
+    std::unordered_map<std::string, std::vector<std::size_t>> m_children;   // folder -> members
+
+    bool BuildTar(int fd, JobProgress& progress);
+    bool BuildZip(int fd, JobProgress& progress);
+
+    // Record a member (a later one with the same path replaces it), and
+    // after the last one add the folders only implied by member paths.
+    void AddMember(Member member);
+    void FinishMembers();
+
+    // Pass the data of 'member' to 'sink' piece by piece; the sink returns
+    // false to stop.  'stream' is the decompressed tar of a tar.gz, kept
+    // between calls and reopened only when a member lies behind it.
+    using Sink = std::function<bool(const char* data, std::size_t length)>;
+    bool ReadMember(int fd, std::unique_ptr<InflateReader>& stream, const Member& member,
+                    const Sink& sink) const;
+    bool ReadZipMember(int fd, const Member& member, const Sink& sink) const;
+
+    // The member whose data a hard link refers to, or the member itself.
+    const Member& DataOf(const Member& member) const;
+
+    // "a/./b/" -> "a/b"; empty if the name is unusable (absolute after
+    // cleaning, or climbs out with "..").
+    static std::string CleanPath(const std::string& path);
+};
+
+#endif // ARCHIVEINDEX_H
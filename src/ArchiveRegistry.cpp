@@ -0,0 +1,153 @@
+/*
+Author: Guo Jia
+Description: Implementation of ArchiveRegistry.  Only a handful of indexes
+             are kept – a large archive's index holds one entry per member –
+             so a plain list searched linearly is enough.
+Date: 2026-10-18
+*/
+
+#include <sys/stat.h>
+#include "ArchiveRegistry.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: ArchiveRegistry
+Description: Starts with no indexes.
+Parameters: None
+Return: None
+*/
+ArchiveRegistry::ArchiveRegistry()
+    : m_mutex(),
+      m_indexes()
+{
+}
+
+/*
+Function: ~ArchiveRegistry
+Description: Destructor.  Indexes still in use elsewhere stay alive
+             through their shared_ptrs.
+Parameters: None
+Return: None
+*/
+ArchiveRegistry::~ArchiveRegistry()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Access
+// ---------------------------------------------------------------------------
+
+/*
+Function: Get
+Description: Finds the archive's index and checks it against the file's
+             current mtime and size; a stale index is dropped.  A hit moves
+             to the front.
+Parameters: archive - archive file path
+Return: The index, or nullptr
+*/
+shared_ptr<const ArchiveIndex> ArchiveRegistry::Get(const string& archive)
+{
+    struct stat info;
+    bool exists = (stat(archive.c_str(), &info) == 0);
+
+    lock_guard<mutex> lock(m_mutex);
+    for (auto it = m_indexes.begin(); it != m_indexes.end(); ++it)
+    {
+        if ((*it)->GetArchivePath() != archive)
+        {
+            continue;
+        }
+        if (!exists ||
+            (*it)->GetArchiveModified() != static_cast<int64_t>(info.st_mtime) ||
+            (*it)->GetArchiveSize() != static_cast<uint64_t>(info.st_size))
+        {
+            m_indexes.erase(it);
+            return nullptr;
+        }
+        m_indexes.splice(m_indexes.begin(), m_indexes, it);
+        return m_indexes.front();
+    }
+    return nullptr;
+}
+
+/*
+Function: Put
+Description: Adds the index at the front, dropping an older index of the
+             same archive and the least recent one beyond MAX_ARCHIVES.
+Parameters: index - index to keep
+Return: None
+*/
+void ArchiveRegistry::Put(shared_ptr<const ArchiveIndex> index)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_indexes.remove_if([&index](const shared_ptr<const ArchiveIndex>& cached)
+    {
+        return cached->GetArchivePath() == index->GetArchivePath();
+    });
+    m_indexes.push_front(move(index));
+    if (m_indexes.size() > MAX_ARCHIVES)
+    {
+        m_indexes.pop_back();
+    }
+}
+
+/*
+Function: SplitPath
+Description: Looks for the longest prefix of 'path' that exists.  Real
+             folders are found at once; for a path inside an archive the
+             walk stops at the archive file, which must then be a format
+             ArchiveIndex reads.
+Parameters: path    - path to split
+            archive - receives the archive file
+            inner   - receives the path inside the archive
+Return: true if 'path' is the archive itself or lies inside it
+*/
+bool ArchiveRegistry::SplitPath(const string& path, string& archive, string& inner)
+{
+    string prefix = path;
+    while (prefix.size() > 1 && prefix.back() == '/')
+    {
+        prefix.pop_back();
+    }
+
+    struct stat info;
+    while (stat(prefix.c_str(), &info) != 0)
+    {
+        size_t slash = prefix.rfind('/');
+        if (slash == string::npos || slash == 0)
+        {
+            return false;
+        }
+        prefix.resize(slash);
+    }
+    if (!S_ISREG(info.st_mode) || ArchiveIndex::DetectFormat(prefix) == ArchiveIndex::FORMAT_NONE)
+    {
+        return false;
+    }
+
+    archive = prefix;
+    inner.clear();
+    for (size_t start = prefix.size(); start < path.size(); )
+    {
+        size_t end = path.find('/', start);
+        if (end == string::npos)
+        {
+            end = path.size();
+        }
+        if (end > start)
+        {
+            if (!inner.empty())
+            {
+                inner += '/';
+            }
+            inner += path.substr(start, end - start);
+        }
+        start = end + 1;
+    }
+    return true;
+}
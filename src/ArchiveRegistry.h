@@ -0,0 +1,46 @@
+/*
+Author: Guo Jia
+Description: Declaration of ArchiveRegistry – keeps the indexes of the
+             archives browsed recently, each valid for as long as the
+             archive file keeps the mtime and size it was indexed at, and
+             resolves the virtual paths ("/dir/a.tar.gz/inner/folder") the
+             file panel uses for folders inside archives.
+Date: 2026-10-18
+*/
+
+#ifndef ARCHIVEREGISTRY_H
+#define ARCHIVEREGISTRY_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "ArchiveIndex.h"
+
+class ArchiveRegistry
+{
+public:
+    ArchiveRegistry();
+    virtual ~ArchiveRegistry();
+
+    // Cached index of 'archive', or nullptr if there is none or the file
+    // has changed since it was built.
+    std::shared_ptr<const ArchiveIndex> Get(const std::string& archive);
+
+    // Store a freshly built index, replacing any older one of its archive.
+    void Put(std::shared_ptr<const ArchiveIndex> index);
+
+    // Split a path that runs into an archive into the archive file and the
+    // path inside it ("" for its top level).  Returns false for ordinary
+    // paths, including the ones that do not exist.
+    static bool SplitPath(const std::string& path, std::string& archive, std::string& inner);
+
+private:
+    static constexpr std::size_t MAX_ARCHIVES = 4;
+
+    std::mutex                                     m_mutex;
+    std::list<std::shared_ptr<const ArchiveIndex>> m_indexes;   // front = most recent
+};
+
+#endif // ARCHIVEREGISTRY_H
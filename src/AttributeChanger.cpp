@@ -0,0 +1,616 @@
+/*
+Author: Guo Jia
+Description: Implementation of AttributeChanger.  Every entry that needs a
+             change is opened with O_PATH | O_NOFOLLOW and checked to be the
+             entry the walk examined; the owner, mode and times are then
+             changed through that descriptor, never by name, so replacing
+             the entry with a symbolic link between the check and the
+             change cannot redirect it.  Entries already as asked cost no
+             system call.  Folders whose new mode would lock their owner out
+             are changed last, deepest first, so the walk can still list
+             them; their descriptors are kept open until then.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <grp.h>
+#include <mutex>
+#include <pwd.h>
+#include <string>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "AttributeChanger.h"
+#include "ParallelTreeWalker.h"
+#include "JobProgress.h"
+
+using namespace std;
+
+namespace
+{
+    // Failures after this many are counted but not described.
+    const size_t MAX_ERRORS = 20;
+
+    // Bits a class letter of a chmod clause stands for.
+    const mode_t USER_BITS  = S_ISUID | S_IRWXU;
+    const mode_t GROUP_BITS = S_ISGID | S_IRWXG;
+    const mode_t OTHER_BITS = S_ISVTX | S_IRWXO;
+
+    // Accepted forms of a time, tried in order.
+    const char* const TIME_FORMATS[] = { "%Y-%m-%d %H:%M:%S", "%Y-%m-%d %H:%M", "%Y-%m-%d" };
+
+    // Parse a whole string of decimal digits.
+    bool ParseNumber(const string& text, unsigned long& number)
+    {
+        if (text.empty() || text.find_first_not_of("0123456789") != string::npos)
+        {
+            return false;
+        }
+        errno  = 0;
+        number = strtoul(text.c_str(), nullptr, 10);
+        return errno == 0;
+    }
+
+    // Buffer size for the reentrant passwd/group lookups.
+    size_t LookupBufferSize(int name)
+    {
+        long size = sysconf(name);
+        return size > 0 ? static_cast<size_t>(size) : 16384;
+    }
+
+    bool LookUpUser(const string& text, uid_t& uid)
+    {
+        unsigned long number;
+        if (ParseNumber(text, number))
+        {
+            uid = static_cast<uid_t>(number);
+            return true;
+        }
+        struct passwd  entry;
+        struct passwd* found = nullptr;
+        string buffer(LookupBufferSize(_SC_GETPW_R_SIZE_MAX), '\0');
+        if (getpwnam_r(text.c_str(), &entry, &buffer[0], buffer.size(), &found) != 0 || found == nullptr)
+        {
+            return false;
+        }
+        uid = found->pw_uid;
+        return true;
+    }
+
+    bool LookUpGroup(const string& text, gid_t& gid)
+    {
+        unsigned long number;
+        if (ParseNumber(text, number))
+        {
+            gid = static_cast<gid_t>(number);
+            return true;
+        }
+        struct group  entry;
+        struct group* found = nullptr;
+        string buffer(LookupBufferSize(_SC_GETGR_R_SIZE_MAX), '\0');
+        if (getgrnam_r(text.c_str(), &entry, &buffer[0], buffer.size(), &found) != 0 || found == nullptr)
+        {
+            return false;
+        }
+        gid = found->gr_gid;
+        return true;
+    }
+
+    // A folder whose new mode is applied after the walk.
+    struct LockOut
+    {
+        string path;
+        int    fd;        // O_PATH descriptor opened during the walk
+        mode_t mode;
+        bool   counted;   // the entry had other changes
+    };
+
+    // Open 'name' in 'folder' without following a link and check it is
+    // still the entry 'info' describes.  Sets errno and returns -1 if it
+    // was removed or replaced since.
+    int OpenEntry(int folder, const char* name, const struct stat& info)
+    {
+        int fd = ::openat(folder, name, O_PATH | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return -1;
+        }
+        struct stat now;
+        if (::fstat(fd, &now) != 0 || now.st_dev != info.st_dev || now.st_ino != info.st_ino ||
+            (now.st_mode & S_IFMT) != (info.st_mode & S_IFMT))
+        {
+            ::close(fd);
+            errno = ESTALE;
+            return -1;
+        }
+        return fd;
+    }
+
+    // fchmod() refuses O_PATH descriptors; the /proc link of one names the
+    // open file itself, so following it cannot leave the entry.
+    int ChangeMode(int fd, mode_t mode)
+    {
+        string path = "/proc/self/fd/" + to_string(fd);
+        return ::fchmodat(AT_FDCWD, path.c_str(), mode, 0);
+    }
+
+    size_t Depth(const string& path)
+    {
+        return static_cast<size_t>(count(path.begin(), path.end(), '/'));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Changes / Result
+// ---------------------------------------------------------------------------
+
+/*
+Function: Changes::Changes
+Description: Default changes leave everything as it is.
+Parameters: None
+Return: None
+*/
+AttributeChanger::Changes::Changes()
+    : mode(),
+      owner(),
+      group(),
+      modified(),
+      accessed(false),
+      recursive(false),
+      include(),
+      exclude()
+{
+}
+
+/*
+Function: Result::Result
+Description: Zero counts.
+Parameters: None
+Return: None
+*/
+AttributeChanger::Result::Result()
+    : changed(0),
+      unchanged(0),
+      skipped(0),
+      failed(0),
+      errors()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: AttributeChanger
+Description: Starts with nothing to change.
+Parameters: None
+Return: None
+*/
+AttributeChanger::AttributeChanger()
+    : m_changes(),
+      m_setMode(false),
+      m_absoluteMode(false),
+      m_mode(0),
+      m_actions(),
+      m_uid(static_cast<uid_t>(-1)),
+      m_gid(static_cast<gid_t>(-1)),
+      m_setTime(false),
+      m_time()
+{
+}
+
+/*
+Function: ~AttributeChanger
+Description: Nothing to release.
+Parameters: None
+Return: None
+*/
+AttributeChanger::~AttributeChanger()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Public interface
+// ---------------------------------------------------------------------------
+
+/*
+Function: SetChanges
+Description: Parses the mode and time and resolves the owner and group,
+             stopping at the first field that is wrong.
+Parameters: changes - what to change
+            error   - set to the reason on failure
+Return: true if every field is valid
+*/
+bool AttributeChanger::SetChanges(const Changes& changes, string& error)
+{
+    m_changes = changes;
+    m_setMode = !changes.mode.empty();
+    m_setTime = !changes.modified.empty();
+    m_uid     = static_cast<uid_t>(-1);
+    m_gid     = static_cast<gid_t>(-1);
+
+    if (m_setMode && !ParseMode(changes.mode))
+    {
+        error = "Invalid mode \"" + changes.mode + "\" (use e.g. 755 or u+rwX,go-w).";
+        m_setMode = false;
+        return false;
+    }
+    if (!changes.owner.empty() && !LookUpUser(changes.owner, m_uid))
+    {
+        error = "Unknown user \"" + changes.owner + "\".";
+        m_uid = static_cast<uid_t>(-1);
+        return false;
+    }
+    if (!changes.group.empty() && !LookUpGroup(changes.group, m_gid))
+    {
+        error = "Unknown group \"" + changes.group + "\".";
+        m_gid = static_cast<gid_t>(-1);
+        return false;
+    }
+    if (m_setTime && !ParseTime(changes.modified, m_time))
+    {
+        error = "Invalid time \"" + changes.modified + "\" (use now or YYYY-MM-DD HH:MM:SS).";
+        m_setTime = false;
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: HasChanges
+Description: Reports whether Apply() would change anything at all.
+Parameters: None
+Return: true if a mode, owner, group or time is set
+*/
+bool AttributeChanger::HasChanges() const
+{
+    return m_setMode || m_setTime || m_uid != static_cast<uid_t>(-1) || m_gid != static_cast<gid_t>(-1);
+}
+
+/*
+Function: Apply
+Description: Walks the selection and changes each entry that passes the
+             filters: owner and group first (which may clear set-id bits),
+             then the mode, then the times.  Symbolic links get their own
+             owner and times changed; they have no mode of their own.
+             Folder modes that take away the owner's read or search
+             permission are collected and applied after the walk, deepest
+             first; a cancelled job leaves them alone.
+Parameters: pool     - threads for the walk
+            paths    - entries to change
+            progress - entry count and current path; polled for cancellation
+            result   - counts and first errors
+Return: false if the job was cancelled
+*/
+bool AttributeChanger::Apply(ThreadPool& pool, const vector<string>& paths, JobProgress& progress,
+                             Result& result) const
+{
+    atomic<size_t> changed(0);
+    atomic<size_t> unchanged(0);
+    atomic<size_t> skipped(0);
+    atomic<size_t> failed(0);
+    mutex           lock;
+    vector<string>  errors;
+    vector<LockOut> lockOuts;
+
+    auto fail = [&](const string& path)
+    {
+        string message = path + ": " + strerror(errno);
+        ++failed;
+        lock_guard<mutex> guard(lock);
+        if (errors.size() < MAX_ERRORS)
+        {
+            errors.push_back(message);
+        }
+    };
+
+    ParallelTreeWalker walker(pool);
+    bool finished = walker.Walk(paths, m_changes.recursive,
+        [&](int folder, const char* name, const string& path, const struct stat& info)
+    {
+        if (Matches(m_changes.exclude, name))
+        {
+            ++skipped;
+            return false;
+        }
+        if (!m_changes.include.empty() && !Matches(m_changes.include, name))
+        {
+            ++skipped;
+            return true;
+        }
+
+        bool isLink = S_ISLNK(info.st_mode);
+
+        uid_t uid     = m_uid == static_cast<uid_t>(-1) ? info.st_uid : m_uid;
+        gid_t gid     = m_gid == static_cast<gid_t>(-1) ? info.st_gid : m_gid;
+        bool setOwner = uid != info.st_uid || gid != info.st_gid;
+
+        mode_t current = info.st_mode & 07777;
+        mode_t mode    = NewMode(info.st_mode);
+        // A new owner may have cleared set-id bits the mode keeps.
+        bool setIdCleared = setOwner && (current & (S_ISUID | S_ISGID)) != 0;
+        bool setMode      = m_setMode && !isLink && (mode != current || setIdCleared);
+        bool deferred     = setMode && S_ISDIR(info.st_mode) && m_changes.recursive &&
+                            (current & ~mode & (S_IRUSR | S_IXUSR)) != 0;
+
+        bool now     = m_time.tv_nsec == UTIME_NOW;
+        bool setTime = m_setTime &&
+                       (now || info.st_mtim.tv_sec != m_time.tv_sec || info.st_mtim.tv_nsec != m_time.tv_nsec ||
+                        (m_changes.accessed &&
+                         (info.st_atim.tv_sec != m_time.tv_sec || info.st_atim.tv_nsec != m_time.tv_nsec)));
+
+        if (!setOwner && !setMode && !setTime)
+        {
+            ++unchanged;
+            return true;
+        }
+
+        int entry = OpenEntry(folder, name, info);
+        if (entry < 0)
+        {
+            fail(path);
+            return true;
+        }
+
+        bool didChange = false;
+        bool ok        = true;
+        if (setOwner)
+        {
+            ok        = ::fchownat(entry, "", m_uid, m_gid, AT_EMPTY_PATH) == 0;
+            didChange = ok;
+        }
+        if (ok && setMode && !deferred)
+        {
+            ok        = ChangeMode(entry, mode) == 0;
+            didChange = didChange || ok;
+        }
+        if (ok && setTime)
+        {
+            struct timespec times[2];
+            times[0] = m_time;
+            times[1] = m_time;
+            if (!m_changes.accessed)
+            {
+                times[0].tv_nsec = UTIME_OMIT;
+            }
+            ok        = ::utimensat(entry, "", times, AT_EMPTY_PATH) == 0;
+            didChange = didChange || ok;
+        }
+
+        if (!ok)
+        {
+            fail(path);
+            ::close(entry);
+            return true;
+        }
+        if (deferred)
+        {
+            lock_guard<mutex> guard(lock);
+            lockOuts.push_back({ path, entry, mode, didChange });
+        }
+        else
+        {
+            ::close(entry);
+        }
+        if (didChange)
+        {
+            ++changed;
+        }
+        else if (!deferred)
+        {
+            ++unchanged;
+        }
+        return true;
+    }, progress);
+
+    if (finished)
+    {
+        sort(lockOuts.begin(), lockOuts.end(), [](const LockOut& a, const LockOut& b)
+        {
+            return Depth(a.path) > Depth(b.path);
+        });
+        for (const LockOut& lockOut : lockOuts)
+        {
+            if (ChangeMode(lockOut.fd, lockOut.mode) != 0)
+            {
+                fail(lockOut.path);
+            }
+            else if (!lockOut.counted)
+            {
+                ++changed;
+            }
+        }
+    }
+    for (const LockOut& lockOut : lockOuts)
+    {
+        ::close(lockOut.fd);
+    }
+
+    result.changed   = changed;
+    result.unchanged = unchanged;
+    result.skipped   = skipped;
+    result.failed    = failed + walker.GetUnreadableFolders();
+    result.errors    = errors;
+    if (!walker.GetFirstError().empty() && result.errors.size() < MAX_ERRORS)
+    {
+        result.errors.insert(result.errors.begin(), walker.GetFirstError());
+    }
+    return finished;
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: ParseMode
+Description: Accepts an octal mode of up to four digits, or chmod clauses
+             separated by commas: classes [ugoa]* then one or more
+             operators [+-=] each followed by permissions [rwxXst]*.  No
+             class means all three, without regard to the umask.
+Parameters: text - the mode as typed
+Return: true if it parses
+*/
+bool AttributeChanger::ParseMode(const string& text)
+{
+    m_actions.clear();
+    m_absoluteMode = false;
+
+    if (text.size() <= 4 && text.find_first_not_of("01234567") == string::npos)
+    {
+        m_absoluteMode = true;
+        m_mode         = static_cast<mode_t>(strtoul(text.c_str(), nullptr, 8));
+        return true;
+    }
+
+    size_t start = 0;
+    while (start <= text.size())
+    {
+        size_t end = text.find(',', start);
+        if (end == string::npos)
+        {
+            end = text.size();
+        }
+
+        size_t position = start;
+        mode_t who      = 0;
+        for (; position < end && strchr("ugoa", text[position]) != nullptr; ++position)
+        {
+            switch (text[position])
+            {
+            case 'u': who |= USER_BITS;  break;
+            case 'g': who |= GROUP_BITS; break;
+            case 'o': who |= OTHER_BITS; break;
+            default:  who |= USER_BITS | GROUP_BITS | OTHER_BITS; break;
+            }
+        }
+        if (who == 0)
+        {
+            who = USER_BITS | GROUP_BITS | OTHER_BITS;
+        }
+        if (position == end)
+        {
+            return false;   // classes without an operator, or an empty clause
+        }
+
+        while (position < end)
+        {
+            ModeAction action;
+            action.op         = text[position++];
+            action.who        = who;
+            action.bits       = 0;
+            action.searchBits = 0;
+            if (strchr("+-=", action.op) == nullptr)
+            {
+                return false;
+            }
+            for (; position < end && strchr("+-=", text[position]) == nullptr; ++position)
+            {
+                switch (text[position])
+                {
+                case 'r': action.bits       |= who & (S_IRUSR | S_IRGRP | S_IROTH); break;
+                case 'w': action.bits       |= who & (S_IWUSR | S_IWGRP | S_IWOTH); break;
+                case 'x': action.bits       |= who & (S_IXUSR | S_IXGRP | S_IXOTH); break;
+                case 'X': action.searchBits |= who & (S_IXUSR | S_IXGRP | S_IXOTH); break;
+                case 's': action.bits       |= who & (S_ISUID | S_ISGID);           break;
+                case 't': action.bits       |= who & S_ISVTX;                       break;
+                default:  return false;
+                }
+            }
+            m_actions.push_back(action);
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+/*
+Function: NewMode
+Description: Applies the parsed mode to an entry's current one.  X adds
+             search permission to folders and to files that are already
+             executable by someone, judged as the clauses apply.
+Parameters: mode - the entry's st_mode
+Return: The new permission bits
+*/
+mode_t AttributeChanger::NewMode(mode_t mode) const
+{
+    if (m_absoluteMode)
+    {
+        return m_mode;
+    }
+
+    bool   isFolder = S_ISDIR(mode);
+    mode_t bits     = mode & 07777;
+    for (const ModeAction& action : m_actions)
+    {
+        mode_t change = action.bits;
+        if (isFolder || (bits & (S_IXUSR | S_IXGRP | S_IXOTH)) != 0)
+        {
+            change |= action.searchBits;
+        }
+        switch (action.op)
+        {
+        case '+': bits |= change;                       break;
+        case '-': bits &= ~change;                      break;
+        default:  bits  = (bits & ~action.who) | change; break;
+        }
+    }
+    return bits;
+}
+
+/*
+Function: ParseTime
+Description: Parses "now" or a local date and time in one of
+             TIME_FORMATS.
+Parameters: text - the time as typed
+            time - set to the result; tv_nsec is UTIME_NOW for "now"
+Return: true if it parses
+*/
+bool AttributeChanger::ParseTime(const string& text, struct timespec& time)
+{
+    if (strcasecmp(text.c_str(), "now") == 0)
+    {
+        time.tv_sec  = 0;
+        time.tv_nsec = UTIME_NOW;
+        return true;
+    }
+    for (const char* format : TIME_FORMATS)
+    {
+        struct tm parts;
+        memset(&parts, 0, sizeof(parts));
+        const char* end = strptime(text.c_str(), format, &parts);
+        if (end != nullptr && *end == '\0')
+        {
+            parts.tm_isdst = -1;
+            time.tv_sec    = mktime(&parts);
+            time.tv_nsec   = 0;
+            return time.tv_sec != static_cast<time_t>(-1);
+        }
+    }
+    return false;
+}
+
+/*
+Function: Matches
+Description: Tests a name against shell patterns.
+Parameters: patterns - e.g. "*.txt"
+            name     - entry name
+Return: true if any pattern matches
+*/
+bool AttributeChanger::Matches(const vector<string>& patterns, const char* name)
+{
+    for (const string& pattern : patterns)
+    {
+        if (fnmatch(pattern.c_str(), name, 0) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,100 @@
+/*
+Author: Guo Jia
+Description: Declaration of AttributeChanger – changes the mode, owner,
+             group and timestamps of a selection and, optionally, of
+             everything below it.  Modes use chmod syntax ("755",
+             "u+rwX,go-w"), owners and groups are names or numbers, and the
+             entries changed can be narrowed by name patterns.  The trees are
+             walked by ParallelTreeWalker and each entry is changed through
+             a descriptor opened relative to its folder without following
+             links, so the per-entry latency of network file systems
+             overlaps across threads and a name swapped for a link mid-walk
+             is never followed out of the tree.
+Date: 2026-10-18
+*/
+
+#ifndef ATTRIBUTECHANGER_H
+#define ATTRIBUTECHANGER_H
+
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+class ThreadPool;
+class JobProgress;
+
+class AttributeChanger
+{
+public:
+    struct Changes
+    {
+        std::string mode;        // octal or chmod clauses; "" = keep
+        std::string owner;       // user name or uid; "" = keep
+        std::string group;       // group name or gid; "" = keep
+        std::string modified;    // "now" or "YYYY-MM-DD [HH:MM[:SS]]"; "" = keep
+        bool        accessed;    // set the access time to 'modified' too
+        bool        recursive;   // also change everything below folders
+        std::vector<std::string> include;   // name patterns to change; empty = all
+        std::vector<std::string> exclude;   // names to leave alone; folders are skipped whole
+
+        Changes();
+    };
+
+    struct Result
+    {
+        std::size_t              changed;
+        std::size_t              unchanged;   // already as asked
+        std::size_t              skipped;     // filtered out
+        std::size_t              failed;      // entries and unreadable folders
+        std::vector<std::string> errors;      // the first few failures
+
+        Result();
+    };
+
+    AttributeChanger();
+    virtual ~AttributeChanger();
+
+    // Parse and check the changes, resolving names to ids.  Returns false
+    // with 'error' saying which field is wrong.
+    bool SetChanges(const Changes& changes, std::string& error);
+
+    // True if SetChanges() was given something to change.
+    bool HasChanges() const;
+
+    // Apply the changes to 'paths' (and below them, if recursive) on
+    // 'pool'.  Failures are counted in 'result' and do not stop the job.
+    // Returns false if the job was cancelled.
+    bool Apply(ThreadPool& pool, const std::vector<std::string>& paths, JobProgress& progress,
+               Result& result) const;
+
+private:
+    // One "+rwx" part of a chmod clause.  'bits' applies to every entry,
+    // 'searchBits' (from X) only to folders and already executable files.
+    struct ModeAction
+    {
+        char   op;          // '+', '-' or '='
+        mode_t who;         // every bit of the classes named, for '='
+        mode_t bits;
+        mode_t searchBits;
+    };
+
+    Changes                 m_changes;
+    bool                    m_setMode;
+    bool                    m_absoluteMode;
+    mode_t                  m_mode;         // octal mode, if m_absoluteMode
+    std::vector<ModeAction> m_actions;      // otherwise, in order
+    uid_t                   m_uid;          // (uid_t)-1 = keep
+    gid_t                   m_gid;          // (gid_t)-1 = keep
+    bool                    m_setTime;
+    struct timespec         m_time;         // tv_nsec = UTIME_NOW for "now"
+
+    bool   ParseMode(const std::string& text);
+    mode_t NewMode(mode_t mode) const;
+
+    static bool ParseTime(const std::string& text, struct timespec& time);
+    static bool Matches(const std::vector<std::string>& patterns, const char* name);
+};
+
+#endif // ATTRIBUTECHANGER_H
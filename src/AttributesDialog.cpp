@@ -0,0 +1,165 @@
+/*
+Author: Guo Jia
+Description: Implementation of AttributesDialog.
+Date: 2026-10-18
+*/
+
+#include <wx/msgdlg.h>
+#include <wx/sizer.h>
+#include <wx/stattext.h>
+#include "AttributesDialog.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: AttributesDialog
+Description: Lays out one labelled field per attribute, the options and the
+             name filters.
+Parameters: parent - parent window
+            count  - number of entries selected
+Return: None
+*/
+AttributesDialog::AttributesDialog(wxWindow* parent, size_t count)
+    : wxDialog(parent, wxID_ANY,
+               wxString::Format("Change Attributes of %lu Item(s)", static_cast<unsigned long>(count)),
+               wxDefaultPosition, wxSize(520, -1), wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER),
+      m_changer(),
+      m_mode(nullptr),
+      m_owner(nullptr),
+      m_group(nullptr),
+      m_modified(nullptr),
+      m_accessed(nullptr),
+      m_recursive(nullptr),
+      m_include(nullptr),
+      m_exclude(nullptr)
+{
+    m_mode      = new wxTextCtrl(this, wxID_ANY);
+    m_owner     = new wxTextCtrl(this, wxID_ANY);
+    m_group     = new wxTextCtrl(this, wxID_ANY);
+    m_modified  = new wxTextCtrl(this, wxID_ANY);
+    m_accessed  = new wxCheckBox(this, wxID_ANY, "Set the access time too");
+    m_recursive = new wxCheckBox(this, wxID_ANY, "Apply to everything inside folders");
+    m_include   = new wxTextCtrl(this, wxID_ANY);
+    m_exclude   = new wxTextCtrl(this, wxID_ANY);
+    m_recursive->SetValue(true);
+
+    wxFlexGridSizer* fields = new wxFlexGridSizer(2, 4, 8);
+    fields->AddGrowableCol(1);
+    fields->Add(new wxStaticText(this, wxID_ANY, "Mode:"), 0, wxALIGN_CENTER_VERTICAL);
+    fields->Add(m_mode, 1, wxEXPAND);
+    fields->AddSpacer(0);
+    fields->Add(new wxStaticText(this, wxID_ANY, "e.g. 644, 755 or u+rwX,go-w"));
+    fields->Add(new wxStaticText(this, wxID_ANY, "Owner:"), 0, wxALIGN_CENTER_VERTICAL);
+    fields->Add(m_owner, 1, wxEXPAND);
+    fields->Add(new wxStaticText(this, wxID_ANY, "Group:"), 0, wxALIGN_CENTER_VERTICAL);
+    fields->Add(m_group, 1, wxEXPAND);
+    fields->Add(new wxStaticText(this, wxID_ANY, "Modified:"), 0, wxALIGN_CENTER_VERTICAL);
+    fields->Add(m_modified, 1, wxEXPAND);
+    fields->AddSpacer(0);
+    fields->Add(new wxStaticText(this, wxID_ANY, "now or YYYY-MM-DD HH:MM:SS"));
+    fields->AddSpacer(0);
+    fields->Add(m_accessed);
+    fields->AddSpacer(0);
+    fields->Add(m_recursive);
+    fields->Add(new wxStaticText(this, wxID_ANY, "Only names:"), 0, wxALIGN_CENTER_VERTICAL);
+    fields->Add(m_include, 1, wxEXPAND);
+    fields->Add(new wxStaticText(this, wxID_ANY, "Except names:"), 0, wxALIGN_CENTER_VERTICAL);
+    fields->Add(m_exclude, 1, wxEXPAND);
+    fields->AddSpacer(0);
+    fields->Add(new wxStaticText(this, wxID_ANY, "Patterns separated by ';', e.g. *.sh; .git"));
+
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(new wxStaticText(this, wxID_ANY, "Leave a field empty to keep it as it is."),
+               0, wxEXPAND | wxLEFT | wxRIGHT | wxTOP, 8);
+    sizer->Add(fields, 1, wxEXPAND | wxALL, 8);
+    sizer->Add(CreateButtonSizer(wxOK | wxCANCEL), 0, wxEXPAND | wxALL, 8);
+    SetSizerAndFit(sizer);
+
+    Bind(wxEVT_BUTTON, &AttributesDialog::OnApply, this, wxID_OK);
+}
+
+/*
+Function: ~AttributesDialog
+Description: Destructor.  Child controls are destroyed by wxWidgets.
+Parameters: None
+Return: None
+*/
+AttributesDialog::~AttributesDialog()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Event handlers
+// ---------------------------------------------------------------------------
+
+/*
+Function: OnApply
+Description: Hands the fields to the changer.  A field it rejects, or no
+             change at all, is reported and the dialog stays open.
+Parameters: event - the OK button event (unused)
+Return: None
+*/
+void AttributesDialog::OnApply(wxCommandEvent& /*event*/)
+{
+    AttributeChanger::Changes changes;
+    changes.mode      = m_mode->GetValue().Trim().Trim(false).ToStdString();
+    changes.owner     = m_owner->GetValue().Trim().Trim(false).ToStdString();
+    changes.group     = m_group->GetValue().Trim().Trim(false).ToStdString();
+    changes.modified  = m_modified->GetValue().Trim().Trim(false).ToStdString();
+    changes.accessed  = m_accessed->GetValue();
+    changes.recursive = m_recursive->GetValue();
+    changes.include   = SplitPatterns(m_include->GetValue());
+    changes.exclude   = SplitPatterns(m_exclude->GetValue());
+
+    string error;
+    if (!m_changer.SetChanges(changes, error))
+    {
+        wxMessageBox(wxString::FromUTF8(error), "Change Attributes", wxOK | wxICON_WARNING, this);
+        return;
+    }
+    if (!m_changer.HasChanges())
+    {
+        wxMessageBox("Enter a mode, owner, group or time to set.",
+                     "Change Attributes", wxOK | wxICON_WARNING, this);
+        return;
+    }
+    EndModal(wxID_OK);
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: SplitPatterns
+Description: Splits a ';'-separated list of name patterns, dropping
+             surrounding blanks and empty items.
+Parameters: text - the field's value
+Return: Patterns in UTF-8
+*/
+vector<string> AttributesDialog::SplitPatterns(const wxString& text)
+{
+    vector<string> patterns;
+    string list = text.ToStdString();
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t end = list.find(';', start);
+        if (end == string::npos)
+        {
+            end = list.size();
+        }
+        size_t first = list.find_first_not_of(" \t", start);
+        if (first < end)
+        {
+            size_t last = list.find_last_not_of(" \t", end - 1);
+            patterns.push_back(list.substr(first, last - first + 1));
+        }
+        start = end + 1;
+    }
+    return patterns;
+}
@@ -0,0 +1,49 @@
+/*
+Author: Guo Jia
+Description: Declaration of AttributesDialog – asks for the mode, owner,
+             group and time to set on a selection, whether to go into
+             folders, and which names to change.  Empty fields are left as
+             they are.  The fields are checked by AttributeChanger when OK
+             is pressed, and the dialog stays open on a mistake.
+Date: 2026-10-18
+*/
+
+#ifndef ATTRIBUTESDIALOG_H
+#define ATTRIBUTESDIALOG_H
+
+#include <string>
+#include <vector>
+#include <wx/checkbox.h>
+#include <wx/dialog.h>
+#include <wx/textctrl.h>
+#include "AttributeChanger.h"
+
+class AttributesDialog : public wxDialog
+{
+public:
+    // 'count' is the number of entries selected, for the title.
+    AttributesDialog(wxWindow* parent, std::size_t count);
+    virtual ~AttributesDialog();
+
+    // Ready to Apply() once the dialog returned wxID_OK.
+    const AttributeChanger& GetChanger() const { return m_changer; }
+
+private:
+    AttributeChanger m_changer;
+
+    wxTextCtrl* m_mode;
+    wxTextCtrl* m_owner;
+    wxTextCtrl* m_group;
+    wxTextCtrl* m_modified;
+    wxCheckBox* m_accessed;
+    wxCheckBox* m_recursive;
+    wxTextCtrl* m_include;
+    wxTextCtrl* m_exclude;
+
+    void OnApply(wxCommandEvent& event);
+
+    // Split "*.txt; *.md" into patterns.
+    static std::vector<std::string> SplitPatterns(const wxString& text);
+};
+
+#endif // ATTRIBUTESDIALOG_H
@@ -0,0 +1,279 @@
+/*
+Author: Guo Jia
+Description: Implementation of BatchRenameDialog.  Every control change
+             recompiles the rules and repaints the preview; the list asks
+             for the text of visible rows only.
+Date: 2026-10-18
+*/
+
+#include <wx/msgdlg.h>
+#include <wx/sizer.h>
+#include <wx/utils.h>
+#include "BatchRenameDialog.h"
+#include "FileListCtrl.h"
+
+using namespace std;
+
+namespace
+{
+    enum Column
+    {
+        COLUMN_NAME = 0,
+        COLUMN_NEW_NAME,
+        COLUMN_PROBLEM
+    };
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: BatchRenameDialog
+Description: Lays out the rule controls above the preview list and binds
+             every control to OnRulesChanged.
+Parameters: parent    - parent window
+            directory - folder holding the entries
+            names     - entries to rename, in selection order
+Return: None
+*/
+BatchRenameDialog::BatchRenameDialog(wxWindow* parent, const wxString& directory,
+                                     const vector<wxString>& names)
+    : wxDialog(parent, wxID_ANY, "Batch Rename", wxDefaultPosition, wxSize(800, 600),
+               wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER),
+      m_directory(directory.ToStdString()),
+      m_names(),
+      m_renamer(),
+      m_plan(),
+      m_planned(false),
+      m_find(nullptr),
+      m_replace(nullptr),
+      m_useRegex(nullptr),
+      m_ignoreCase(nullptr),
+      m_format(nullptr),
+      m_caseChange(nullptr),
+      m_counterStart(nullptr),
+      m_counterStep(nullptr),
+      m_counterWidth(nullptr),
+      m_preview(nullptr),
+      m_status(nullptr)
+{
+    m_names.reserve(names.size());
+    for (const wxString& name : names)
+    {
+        m_names.push_back(name.ToStdString());
+    }
+
+    m_find         = new wxTextCtrl(this, wxID_ANY);
+    m_replace      = new wxTextCtrl(this, wxID_ANY);
+    m_useRegex     = new wxCheckBox(this, wxID_ANY, "Regular expression ($1, $2 in the replacement)");
+    m_ignoreCase   = new wxCheckBox(this, wxID_ANY, "Ignore case");
+    m_format       = new wxTextCtrl(this, wxID_ANY, "{name}{ext}");
+    m_caseChange   = new wxChoice(this, wxID_ANY);
+    m_caseChange->Append("Keep case");
+    m_caseChange->Append("lower case");
+    m_caseChange->Append("UPPER CASE");
+    m_caseChange->Append("Title Case");
+    m_caseChange->SetSelection(0);
+    m_counterStart = new wxSpinCtrl(this, wxID_ANY, "1", wxDefaultPosition, wxDefaultSize,
+                                    wxSP_ARROW_KEYS, 0, 1000000000, 1);
+    m_counterStep  = new wxSpinCtrl(this, wxID_ANY, "1", wxDefaultPosition, wxDefaultSize,
+                                    wxSP_ARROW_KEYS, -1000, 1000, 1);
+    m_counterWidth = new wxSpinCtrl(this, wxID_ANY, "1", wxDefaultPosition, wxDefaultSize,
+                                    wxSP_ARROW_KEYS, 1, 12, 1);
+
+    m_preview = new FileListCtrl(this, [this](long row, long column) { return GetCellText(row, column); });
+    m_preview->InsertColumn(COLUMN_NAME,     "Name",     wxLIST_FORMAT_LEFT, 280);
+    m_preview->InsertColumn(COLUMN_NEW_NAME, "New name", wxLIST_FORMAT_LEFT, 280);
+    m_preview->InsertColumn(COLUMN_PROBLEM,  "Problem",  wxLIST_FORMAT_LEFT, 180);
+    m_preview->SetItemCount(static_cast<long>(m_names.size()));
+
+    m_status = new wxStaticText(this, wxID_ANY, "");
+
+    wxFlexGridSizer* rules = new wxFlexGridSizer(2, 4, 8);
+    rules->AddGrowableCol(1);
+    rules->Add(new wxStaticText(this, wxID_ANY, "Find:"), 0, wxALIGN_CENTER_VERTICAL);
+    rules->Add(m_find, 1, wxEXPAND);
+    rules->Add(new wxStaticText(this, wxID_ANY, "Replace with:"), 0, wxALIGN_CENTER_VERTICAL);
+    rules->Add(m_replace, 1, wxEXPAND);
+    rules->AddSpacer(0);
+    wxBoxSizer* options = new wxBoxSizer(wxHORIZONTAL);
+    options->Add(m_useRegex, 0, wxRIGHT, 16);
+    options->Add(m_ignoreCase);
+    rules->Add(options);
+    rules->Add(new wxStaticText(this, wxID_ANY, "New name:"), 0, wxALIGN_CENTER_VERTICAL);
+    rules->Add(m_format, 1, wxEXPAND);
+    rules->AddSpacer(0);
+    rules->Add(new wxStaticText(this, wxID_ANY, "{name} old name    {ext} extension    {n} counter"));
+    rules->Add(new wxStaticText(this, wxID_ANY, "Counter:"), 0, wxALIGN_CENTER_VERTICAL);
+    wxBoxSizer* counter = new wxBoxSizer(wxHORIZONTAL);
+    counter->Add(new wxStaticText(this, wxID_ANY, "start"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 4);
+    counter->Add(m_counterStart, 0, wxRIGHT, 12);
+    counter->Add(new wxStaticText(this, wxID_ANY, "step"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 4);
+    counter->Add(m_counterStep, 0, wxRIGHT, 12);
+    counter->Add(new wxStaticText(this, wxID_ANY, "digits"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 4);
+    counter->Add(m_counterWidth);
+    rules->Add(counter);
+    rules->Add(new wxStaticText(this, wxID_ANY, "Case:"), 0, wxALIGN_CENTER_VERTICAL);
+    rules->Add(m_caseChange);
+
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(rules, 0, wxEXPAND | wxALL, 8);
+    sizer->Add(m_preview, 1, wxEXPAND | wxLEFT | wxRIGHT, 8);
+    sizer->Add(m_status, 0, wxEXPAND | wxALL, 8);
+    sizer->Add(CreateButtonSizer(wxOK | wxCANCEL), 0, wxEXPAND | wxALL, 8);
+    SetSizer(sizer);
+
+    for (wxTextCtrl* text : { m_find, m_replace, m_format })
+    {
+        text->Bind(wxEVT_TEXT, &BatchRenameDialog::OnRulesChanged, this);
+    }
+    m_useRegex->Bind(wxEVT_CHECKBOX, &BatchRenameDialog::OnRulesChanged, this);
+    m_ignoreCase->Bind(wxEVT_CHECKBOX, &BatchRenameDialog::OnRulesChanged, this);
+    m_caseChange->Bind(wxEVT_CHOICE, &BatchRenameDialog::OnRulesChanged, this);
+    for (wxSpinCtrl* spin : { m_counterStart, m_counterStep, m_counterWidth })
+    {
+        spin->Bind(wxEVT_SPINCTRL, &BatchRenameDialog::OnRulesChanged, this);
+    }
+    Bind(wxEVT_BUTTON, &BatchRenameDialog::OnRename, this, wxID_OK);
+
+    m_status->SetLabel(wxString::Format("%lu entries selected", static_cast<unsigned long>(m_names.size())));
+}
+
+/*
+Function: ~BatchRenameDialog
+Description: Destructor.  Child controls are destroyed by wxWidgets.
+Parameters: None
+Return: None
+*/
+BatchRenameDialog::~BatchRenameDialog()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Event handlers
+// ---------------------------------------------------------------------------
+
+/*
+Function: OnRulesChanged
+Description: Reads the controls into new rules and repaints the preview.
+             A regular expression that does not compile is reported and
+             the preview keeps the last valid rules.
+Parameters: event - the control's event (unused)
+Return: None
+*/
+void BatchRenameDialog::OnRulesChanged(wxCommandEvent& /*event*/)
+{
+    BatchRenamer::Rules rules;
+    rules.find         = m_find->GetValue().ToStdString();
+    rules.replace      = m_replace->GetValue().ToStdString();
+    rules.useRegex     = m_useRegex->GetValue();
+    rules.ignoreCase   = m_ignoreCase->GetValue();
+    rules.format       = m_format->GetValue().ToStdString();
+    rules.caseChange   = static_cast<BatchRenamer::CaseChange>(m_caseChange->GetSelection());
+    rules.counterStart = m_counterStart->GetValue();
+    rules.counterStep  = m_counterStep->GetValue();
+    rules.counterWidth = m_counterWidth->GetValue();
+
+    string error;
+    if (!m_renamer.SetRules(rules, error))
+    {
+        m_status->SetLabel(wxString::FromUTF8(error));
+        return;
+    }
+    m_planned = false;
+    m_status->SetLabel(wxString::Format("%lu entries selected", static_cast<unsigned long>(m_names.size())));
+    m_preview->Refresh();
+}
+
+/*
+Function: OnRename
+Description: Plans the whole selection.  With conflicts the dialog stays
+             open, shows the Problem column and scrolls to the first one;
+             otherwise it closes with wxID_OK.
+Parameters: event - the OK button event (unused)
+Return: None
+*/
+void BatchRenameDialog::OnRename(wxCommandEvent& /*event*/)
+{
+    {
+        wxBusyCursor busy;
+        if (!m_renamer.BuildPlan(m_directory, m_names, m_plan))
+        {
+            wxMessageBox("Cannot read \"" + wxString::FromUTF8(m_directory) + "\".",
+                         "Error", wxOK | wxICON_ERROR, this);
+            return;
+        }
+    }
+    m_planned = true;
+    m_preview->Refresh();
+
+    if (m_plan.conflicts > 0)
+    {
+        for (size_t row = 0; row < m_plan.problems.size(); ++row)
+        {
+            if (m_plan.problems[row] != BatchRenamer::Problem::None)
+            {
+                m_preview->EnsureVisible(static_cast<long>(row));
+                break;
+            }
+        }
+        m_status->SetLabel(wxString::Format("%lu new names conflict; change the rules to rename.",
+                                            static_cast<unsigned long>(m_plan.conflicts)));
+        return;
+    }
+    if (m_plan.renamed == 0)
+    {
+        m_status->SetLabel("The rules do not change any name.");
+        return;
+    }
+    EndModal(wxID_OK);
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: GetCellText
+Description: Text provider of the preview list.  New names come from the
+             plan when it is current, otherwise they are computed for just
+             this row.
+Parameters: row    - row index (= position in the selection)
+            column - column index
+Return: Cell text
+*/
+wxString BatchRenameDialog::GetCellText(long row, long column) const
+{
+    size_t index = static_cast<size_t>(row);
+    if (index >= m_names.size())
+    {
+        return "";
+    }
+
+    switch (column)
+    {
+    case COLUMN_NAME:
+        return wxString::FromUTF8(m_names[index]);
+    case COLUMN_NEW_NAME:
+        return wxString::FromUTF8(m_planned ? m_plan.newNames[index] : m_renamer.NewName(m_names[index], index));
+    case COLUMN_PROBLEM:
+        if (!m_planned)
+        {
+            return "";
+        }
+        switch (m_plan.problems[index])
+        {
+        case BatchRenamer::Problem::Invalid:
+            return "Invalid name";
+        case BatchRenamer::Problem::Duplicate:
+            return "Same new name as another";
+        case BatchRenamer::Problem::Exists:
+            return "Name already taken";
+        default:
+            return "";
+        }
+    default:
+        return "";
+    }
+}
@@ -0,0 +1,60 @@
+/*
+Author: Guo Jia
+Description: Declaration of BatchRenameDialog – edits BatchRenamer rules
+             for a selection and previews the result.  The preview is a
+             virtual list, so only the rows on screen are computed after
+             each change; the full check for conflicts runs when Rename is
+             pressed, and the dialog stays open to show them.
+Date: 2026-10-18
+*/
+
+#ifndef BATCHRENAMEDIALOG_H
+#define BATCHRENAMEDIALOG_H
+
+#include <string>
+#include <vector>
+#include <wx/checkbox.h>
+#include <wx/choice.h>
+#include <wx/dialog.h>
+#include <wx/spinctrl.h>
+#include <wx/stattext.h>
+#include <wx/textctrl.h>
+#include "BatchRenamer.h"
+
+class FileListCtrl;
+
+class BatchRenameDialog : public wxDialog
+{
+public:
+    BatchRenameDialog(wxWindow* parent, const wxString& directory, const std::vector<wxString>& names);
+    virtual ~BatchRenameDialog();
+
+    // The conflict-free plan, once the dialog returned wxID_OK.
+    const BatchRenamer::Plan& GetPlan() const { return m_plan; }
+
+private:
+    std::string              m_directory;
+    std::vector<std::string> m_names;       // UTF-8, in selection order
+    BatchRenamer             m_renamer;
+    BatchRenamer::Plan       m_plan;
+    bool                     m_planned;     // m_plan matches the current rules
+
+    wxTextCtrl*   m_find;
+    wxTextCtrl*   m_replace;
+    wxCheckBox*   m_useRegex;
+    wxCheckBox*   m_ignoreCase;
+    wxTextCtrl*   m_format;
+    wxChoice*     m_caseChange;
+    wxSpinCtrl*   m_counterStart;
+    wxSpinCtrl*   m_counterStep;
+    wxSpinCtrl*   m_counterWidth;
+    FileListCtrl* m_preview;
+    wxStaticText* m_status;
+
+    void OnRulesChanged(wxCommandEvent& event);
+    void OnRename(wxCommandEvent& event);
+
+    wxString GetCellText(long row, long column) const;
+};
+
+#endif // BATCHRENAMEDIALOG_H
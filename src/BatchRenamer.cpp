@@ -0,0 +1,506 @@
+/*
+Author: Guo Jia
+Description: Implementation of BatchRenamer.  New names come from one
+             compiled std::regex and a template scan; the plan is built with
+             hash maps from current and new names to entries, so checking
+             and ordering 100k renames stays linear.
+Date: 2026-10-18
+*/
+
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <sys/stat.h>
+#include "BatchRenamer.h"
+#include "JobProgress.h"
+
+using namespace std;
+
+namespace
+{
+    // Characters with a meaning in an ECMAScript regular expression.
+    const char* const REGEX_SPECIALS = "\\^$.|?*+()[]{}";
+
+    // Prefix of the names cycles are parked under for one rename.
+    const char* const TEMPORARY_PREFIX = ".batch-rename-";
+
+    // Rename inside 'folder' without ever replacing an entry.  File systems
+    // that do not support RENAME_NOREPLACE get a check before a plain
+    // rename, which is not atomic but still never replaces knowingly.
+    bool RenameNoReplace(int folder, const string& from, const string& to)
+    {
+        if (::renameat2(folder, from.c_str(), folder, to.c_str(), RENAME_NOREPLACE) == 0)
+        {
+            return true;
+        }
+        if (errno != EINVAL && errno != ENOSYS)
+        {
+            return false;
+        }
+        struct stat existing;
+        if (::fstatat(folder, to.c_str(), &existing, AT_SYMLINK_NOFOLLOW) == 0)
+        {
+            errno = EEXIST;
+            return false;
+        }
+        return ::renameat(folder, from.c_str(), folder, to.c_str()) == 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Rules / Plan
+// ---------------------------------------------------------------------------
+
+/*
+Function: Rules::Rules
+Description: Default rules leave every name as it is.
+Parameters: None
+Return: None
+*/
+BatchRenamer::Rules::Rules()
+    : find(),
+      replace(),
+      useRegex(false),
+      ignoreCase(false),
+      format(),
+      caseChange(CaseChange::Keep),
+      counterStart(1),
+      counterStep(1),
+      counterWidth(1)
+{
+}
+
+/*
+Function: Plan::Plan
+Description: Empty plan.
+Parameters: None
+Return: None
+*/
+BatchRenamer::Plan::Plan()
+    : newNames(),
+      problems(),
+      steps(),
+      renamed(0),
+      unchanged(0),
+      conflicts(0),
+      cycles(0)
+{
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: BatchRenamer
+Description: Starts with the default rules.
+Parameters: None
+Return: None
+*/
+BatchRenamer::BatchRenamer()
+    : m_rules(),
+      m_find(),
+      m_hasFind(false),
+      m_replacement()
+{
+}
+
+/*
+Function: ~BatchRenamer
+Description: Nothing to release.
+Parameters: None
+Return: None
+*/
+BatchRenamer::~BatchRenamer()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Rules
+// ---------------------------------------------------------------------------
+
+/*
+Function: SetRules
+Description: Compiles the find pattern once; plain text is escaped, and
+             '$' in its replacement doubled, so both kinds go through the
+             same regex_replace() and replace every match.
+Parameters: rules - the new rules
+            error - receives the reason a regular expression is rejected
+Return: true if the rules are in use
+*/
+bool BatchRenamer::SetRules(const Rules& rules, string& error)
+{
+    regex compiled;
+    if (!rules.find.empty())
+    {
+        string pattern;
+        if (rules.useRegex)
+        {
+            pattern = rules.find;
+        }
+        else
+        {
+            for (char c : rules.find)
+            {
+                if (strchr(REGEX_SPECIALS, c) != nullptr)
+                {
+                    pattern += '\\';
+                }
+                pattern += c;
+            }
+        }
+
+        try
+        {
+            regex::flag_type flags = regex::ECMAScript;
+            if (rules.ignoreCase)
+            {
+                flags |= regex::icase;
+            }
+            compiled.assign(pattern, flags);
+        }
+        catch (const regex_error& problem)
+        {
+            error = string("Invalid regular expression: ") + problem.what();
+            return false;
+        }
+    }
+
+    m_rules       = rules;
+    m_find        = compiled;
+    m_hasFind     = !rules.find.empty();
+    m_replacement = rules.replace;
+    if (!rules.useRegex)
+    {
+        for (size_t dollar = m_replacement.find('$'); dollar != string::npos;
+             dollar = m_replacement.find('$', dollar + 2))
+        {
+            m_replacement.insert(dollar, 1, '$');
+        }
+    }
+    return true;
+}
+
+/*
+Function: NewName
+Description: Splits off the extension (the part from the last dot, unless
+             the dot starts the name), runs find/replace on the rest, fills
+             in the template and changes the case.
+Parameters: name  - current name
+            index - position in the selection, for the counter
+Return: the new name (may be invalid; BuildPlan() reports that)
+*/
+string BatchRenamer::NewName(const string& name, size_t index) const
+{
+    size_t dot  = name.rfind('.');
+    bool   hasExtension = dot != string::npos && dot > 0;
+    string stem = hasExtension ? name.substr(0, dot) : name;
+    string extension = hasExtension ? name.substr(dot) : string();
+
+    if (m_hasFind)
+    {
+        stem = regex_replace(stem, m_find, m_replacement);
+    }
+
+    const string& format = m_rules.format.empty() ? string("{name}{ext}") : m_rules.format;
+    string result;
+    result.reserve(format.size() + stem.size() + extension.size());
+    for (size_t i = 0; i < format.size(); ++i)
+    {
+        if (format.compare(i, 6, "{name}") == 0)
+        {
+            result += stem;
+            i += 5;
+        }
+        else if (format.compare(i, 5, "{ext}") == 0)
+        {
+            result += extension;
+            i += 4;
+        }
+        else if (format.compare(i, 3, "{n}") == 0)
+        {
+            long   value  = m_rules.counterStart + m_rules.counterStep * static_cast<long>(index);
+            string digits = to_string(value < 0 ? -value : value);
+            if (static_cast<int>(digits.size()) < m_rules.counterWidth)
+            {
+                digits.insert(0, static_cast<size_t>(m_rules.counterWidth) - digits.size(), '0');
+            }
+            result += (value < 0 ? "-" : "") + digits;
+            i += 2;
+        }
+        else
+        {
+            result += format[i];
+        }
+    }
+    return ChangeCase(result, m_rules.caseChange);
+}
+
+// ---------------------------------------------------------------------------
+// Planning
+// ---------------------------------------------------------------------------
+
+/*
+Function: BuildPlan
+Description: Reads the folder's names into a hash set, then in single
+             passes: computes the new names, flags invalid ones, targets
+             shared by several entries, and targets taken by an entry that
+             stays.  Without conflicts, the renames form chains and cycles
+             (each name is the target of at most one rename).  A chain is
+             done from its end, whose target is free; a cycle parks one
+             entry under a temporary name first.
+Parameters: directory - the folder holding the entries
+            names     - the entries to rename
+            plan      - receives the result
+Return: false if the folder cannot be read
+*/
+bool BatchRenamer::BuildPlan(const string& directory, const vector<string>& names, Plan& plan) const
+{
+    plan = Plan();
+
+    unordered_set<string> existing;
+    DIR* folder = ::opendir(directory.c_str());
+    if (folder == nullptr)
+    {
+        return false;
+    }
+    while (struct dirent* entry = ::readdir(folder))
+    {
+        existing.insert(entry->d_name);
+    }
+    ::closedir(folder);
+
+    size_t count = names.size();
+    plan.newNames.resize(count);
+    plan.problems.assign(count, Problem::None);
+
+    unordered_map<string, size_t> bySource;   // current name -> entry, renamed entries only
+    unordered_map<string, size_t> byTarget;   // new name -> entry
+    for (size_t i = 0; i < count; ++i)
+    {
+        plan.newNames[i] = NewName(names[i], i);
+        if (plan.newNames[i] == names[i])
+        {
+            ++plan.unchanged;
+            continue;
+        }
+        if (!IsValidName(plan.newNames[i]))
+        {
+            plan.problems[i] = Problem::Invalid;
+            continue;
+        }
+        bySource.emplace(names[i], i);
+
+        auto claimed = byTarget.emplace(plan.newNames[i], i);
+        if (!claimed.second)
+        {
+            plan.problems[i] = Problem::Duplicate;
+            plan.problems[claimed.first->second] = Problem::Duplicate;
+        }
+    }
+
+    for (const auto& target : byTarget)
+    {
+        size_t i = target.second;
+        if (plan.problems[i] == Problem::None && existing.count(target.first) > 0 &&
+            bySource.count(target.first) == 0)
+        {
+            plan.problems[i] = Problem::Exists;
+        }
+    }
+    for (Problem problem : plan.problems)
+    {
+        if (problem != Problem::None)
+        {
+            ++plan.conflicts;
+        }
+    }
+    if (plan.conflicts > 0)
+    {
+        return true;
+    }
+
+    // --- Order the renames --------------------------------------------------
+    plan.renamed = bySource.size();
+    plan.steps.reserve(plan.renamed);
+    vector<bool> ordered(count, false);
+
+    // After entry k is renamed its old name is free for whoever wants it.
+    auto follow = [&](size_t k, size_t stop)
+    {
+        for (;;)
+        {
+            auto next = byTarget.find(names[k]);
+            if (next == byTarget.end() || next->second == stop)
+            {
+                return;
+            }
+            k = next->second;
+            plan.steps.push_back({ names[k], plan.newNames[k] });
+            ordered[k] = true;
+        }
+    };
+
+    for (const auto& source : bySource)
+    {
+        size_t i = source.second;
+        if (bySource.count(plan.newNames[i]) == 0)
+        {
+            plan.steps.push_back({ names[i], plan.newNames[i] });
+            ordered[i] = true;
+            follow(i, count);
+        }
+    }
+
+    size_t parked = 0;
+    for (const auto& source : bySource)
+    {
+        size_t i = source.second;
+        if (ordered[i])
+        {
+            continue;
+        }
+        string temporary;
+        do
+        {
+            temporary = TEMPORARY_PREFIX + to_string(parked++);
+        } while (existing.count(temporary) > 0 || byTarget.count(temporary) > 0);
+
+        plan.steps.push_back({ names[i], temporary });
+        ordered[i] = true;
+        follow(i, i);
+        plan.steps.push_back({ temporary, plan.newNames[i] });
+        ++plan.cycles;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Renaming
+// ---------------------------------------------------------------------------
+
+/*
+Function: Execute
+Description: Opens the folder once and renames relative to that
+             descriptor, so no path is looked up again per entry.  The steps
+             done are undone in reverse order when one fails.
+Parameters: directory - the folder the plan was built for
+            plan      - a plan without conflicts
+            progress  - counts renames; cancelling undoes the job
+            error     - receives what went wrong
+Return: true if the whole plan was applied
+*/
+bool BatchRenamer::Execute(const string& directory, const Plan& plan, JobProgress& progress, string& error)
+{
+    if (plan.conflicts > 0)
+    {
+        error = "The new names conflict";
+        return false;
+    }
+    int folder = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (folder < 0)
+    {
+        error = "Cannot open " + directory + ": " + strerror(errno);
+        return false;
+    }
+
+    progress.SetTotal(plan.steps.size());
+    size_t done = 0;
+    bool   ok   = true;
+    for (; done < plan.steps.size(); ++done)
+    {
+        const Step& step = plan.steps[done];
+        if (progress.IsCancelled())
+        {
+            error = "Cancelled";
+            ok = false;
+            break;
+        }
+        if (!RenameNoReplace(folder, step.from, step.to))
+        {
+            error = "Cannot rename \"" + step.from + "\" to \"" + step.to + "\": " + strerror(errno);
+            ok = false;
+            break;
+        }
+        progress.Advance(1);
+    }
+
+    if (!ok)
+    {
+        progress.SetMessage("Undoing renames");
+        while (done-- > 0)
+        {
+            const Step& step = plan.steps[done];
+            if (!RenameNoReplace(folder, step.to, step.from))
+            {
+                error += "; could not undo \"" + step.from + "\" -> \"" + step.to + "\"";
+            }
+        }
+    }
+    ::close(folder);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: IsValidName
+Description: A single path component the file system can hold.
+Parameters: name - candidate name
+Return: true if it can be used as a new name
+*/
+bool BatchRenamer::IsValidName(const string& name)
+{
+    return !name.empty() && name != "." && name != ".." &&
+           name.find('/') == string::npos && name.find('\0') == string::npos;
+}
+
+/*
+Function: ChangeCase
+Description: Changes ASCII letters only; UTF-8 sequences pass through as
+             they are.
+Parameters: name       - name to change
+            caseChange - the change
+Return: the changed name
+*/
+string BatchRenamer::ChangeCase(const string& name, CaseChange caseChange)
+{
+    if (caseChange == CaseChange::Keep)
+    {
+        return name;
+    }
+
+    string result = name;
+    bool   wordStart = true;
+    for (char& c : result)
+    {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (byte >= 0x80)
+        {
+            wordStart = false;
+            continue;
+        }
+        switch (caseChange)
+        {
+        case CaseChange::Lower:
+            c = static_cast<char>(tolower(byte));
+            break;
+        case CaseChange::Upper:
+            c = static_cast<char>(toupper(byte));
+            break;
+        default:
+            c = static_cast<char>(wordStart ? toupper(byte) : tolower(byte));
+            break;
+        }
+        wordStart = !isalnum(byte);
+    }
+    return result;
+}
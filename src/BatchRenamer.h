@@ -0,0 +1,113 @@
+/*
+Author: Guo Jia
+Description: Declaration of BatchRenamer – renames many entries of one
+             folder by rules: a find/replace (plain text or regular
+             expression), a name template with the old name, extension and
+             a counter, and a case change.  Planning checks every new name
+             for collisions with hash lookups and orders the renames so
+             chains and cycles (a -> b, b -> a) work; Execute() applies the
+             plan through one directory descriptor with renameat2(), which
+             refuses to replace anything, and undoes what it did if a rename
+             fails or the job is cancelled.
+Date: 2026-10-18
+*/
+
+#ifndef BATCHRENAMER_H
+#define BATCHRENAMER_H
+
+#include <cstddef>
+#include <regex>
+#include <string>
+#include <vector>
+
+class JobProgress;
+
+class BatchRenamer
+{
+public:
+    enum class CaseChange
+    {
+        Keep,
+        Lower,
+        Upper,
+        Title       // first letter of each word upper case, the rest lower
+    };
+
+    struct Rules
+    {
+        std::string find;           // replaced in the name without extension; "" = nothing
+        std::string replace;        // regex rules may use $1, $2, ...
+        bool        useRegex;       // 'find' is an ECMAScript regular expression
+        bool        ignoreCase;
+        std::string format;         // {name} {ext} {n}; "" = "{name}{ext}"
+        CaseChange  caseChange;     // applied to the whole new name
+        long        counterStart;   // {n} of the first entry
+        long        counterStep;
+        int         counterWidth;   // zero-padded to this many digits
+
+        Rules();
+    };
+
+    enum class Problem
+    {
+        None,
+        Invalid,     // empty, "." / "..", or contains '/' or NUL
+        Duplicate,   // several entries would get this name
+        Exists       // another entry that is not renamed has this name
+    };
+
+    // One rename of the plan, in execution order.
+    struct Step
+    {
+        std::string from;
+        std::string to;
+    };
+
+    struct Plan
+    {
+        std::vector<std::string> newNames;    // per entry, in the order given
+        std::vector<Problem>     problems;    // per entry
+        std::vector<Step>        steps;       // empty if there are conflicts
+        std::size_t              renamed;
+        std::size_t              unchanged;
+        std::size_t              conflicts;
+        std::size_t              cycles;      // broken through a temporary name
+
+        Plan();
+    };
+
+    BatchRenamer();
+    virtual ~BatchRenamer();
+
+    // Validate and compile the rules.  On a bad regular expression,
+    // returns false with 'error' saying why and keeps the previous rules.
+    bool SetRules(const Rules& rules, std::string& error);
+
+    // The new name of 'name', the entry at position 'index' of the
+    // selection (which sets its counter).  Cheap enough to call for each
+    // row as a list paints it.
+    std::string NewName(const std::string& name, std::size_t index) const;
+
+    // Compute every new name of 'names' (entries of 'directory'), find the
+    // problems, and order the renames.  Returns false if the folder cannot
+    // be read.
+    bool BuildPlan(const std::string& directory, const std::vector<std::string>& names,
+                   Plan& plan) const;
+
+    // Apply a conflict-free plan.  Nothing is ever replaced; on a failed
+    // rename or cancellation the renames done so far are undone, and
+    // 'error' says what happened.  Returns true if every rename was done.
+    static bool Execute(const std::string& directory, const Plan& plan, JobProgress& progress,
+                        std::string& error);
+
+private:
+    Rules       m_rules;
+    std::regex  m_find;
+    bool        m_hasFind;
+    std::string m_replacement;   // rules.replace in regex_replace() syntax
+
+    static bool        IsValidName(const std::string& name);
+    static std::string ChangeCase(const std::string& name, CaseChange caseChange);
+};
+
+#endif // BATCHRENAMER_H
@@ -0,0 +1,181 @@
+/*
+Author: Guo Jia
+Description: Implementation of CompareDialog.  Differences arrive sorted by
+             path, so parent folders are created on demand through a
+             path -> tree item map as entries are added.
+Date: 2026-10-18
+*/
+
+#include <wx/sizer.h>
+#include <wx/stattext.h>
+#include "CompareDialog.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: CompareDialog
+Description: Builds the two-tree layout, fills it from the difference list
+             and sizes the dialog.
+Parameters: parent      - parent window
+            leftPath    - root of the left tree
+            rightPath   - root of the right tree
+            differences - sorted output of DirectoryCompare
+            summary     - one-line summary shown above the trees
+Return: None
+*/
+CompareDialog::CompareDialog(wxWindow* parent, const wxString& leftPath, const wxString& rightPath,
+                             const vector<DirectoryCompare::Difference>& differences,
+                             const wxString& summary)
+    : wxDialog(parent, wxID_ANY, "Compare Folders", wxDefaultPosition, wxSize(900, 600),
+               wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER),
+      m_leftTree(nullptr),
+      m_rightTree(nullptr)
+{
+    m_leftTree  = new wxTreeCtrl(this, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                                 wxTR_DEFAULT_STYLE | wxTR_HIDE_ROOT);
+    m_rightTree = new wxTreeCtrl(this, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                                 wxTR_DEFAULT_STYLE | wxTR_HIDE_ROOT);
+
+    wxBoxSizer* leftColumn = new wxBoxSizer(wxVERTICAL);
+    leftColumn->Add(new wxStaticText(this, wxID_ANY, leftPath), 0, wxBOTTOM, 4);
+    leftColumn->Add(m_leftTree, 1, wxEXPAND);
+
+    wxBoxSizer* rightColumn = new wxBoxSizer(wxVERTICAL);
+    rightColumn->Add(new wxStaticText(this, wxID_ANY, rightPath), 0, wxBOTTOM, 4);
+    rightColumn->Add(m_rightTree, 1, wxEXPAND);
+
+    wxBoxSizer* trees = new wxBoxSizer(wxHORIZONTAL);
+    trees->Add(leftColumn,  1, wxEXPAND | wxRIGHT, 4);
+    trees->Add(rightColumn, 1, wxEXPAND | wxLEFT, 4);
+
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(new wxStaticText(this, wxID_ANY, summary), 0, wxEXPAND | wxALL, 8);
+    sizer->Add(trees, 1, wxEXPAND | wxLEFT | wxRIGHT, 8);
+    sizer->Add(new wxStaticText(this, wxID_ANY,
+                                "+ added (right only)    - removed (left only)    ~ changed"),
+               0, wxALL, 8);
+    sizer->Add(CreateButtonSizer(wxOK), 0, wxEXPAND | wxALL, 8);
+    SetSizer(sizer);
+
+    Populate(differences);
+}
+
+/*
+Function: ~CompareDialog
+Description: Destructor.  Child controls are destroyed by wxWidgets.
+Parameters: None
+Return: None
+*/
+CompareDialog::~CompareDialog()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: Populate
+Description: Adds every difference to the tree(s) it belongs in.  The trees
+             are only fully expanded when small enough for that to be fast.
+Parameters: differences - sorted difference list
+Return: None
+*/
+void CompareDialog::Populate(const vector<DirectoryCompare::Difference>& differences)
+{
+    // Created here rather than as globals: colours need wx to be initialised.
+    const wxColour addedColour(0, 128, 0);
+    const wxColour removedColour(192, 0, 0);
+    const wxColour changedColour(0, 64, 192);
+
+    m_leftTree->AddRoot("left");
+    m_rightTree->AddRoot("right");
+
+    map<string, wxTreeItemId> leftFolders;
+    map<string, wxTreeItemId> rightFolders;
+
+    size_t shown = 0;
+    for (const DirectoryCompare::Difference& difference : differences)
+    {
+        if (shown++ == MAX_SHOWN)
+        {
+            wxString more = wxString::Format("... %lu more",
+                static_cast<unsigned long>(differences.size() - MAX_SHOWN));
+            m_leftTree->AppendItem(m_leftTree->GetRootItem(), more);
+            m_rightTree->AppendItem(m_rightTree->GetRootItem(), more);
+            break;
+        }
+
+        size_t slash = difference.relativePath.rfind('/');
+        wxString name = wxString::FromUTF8(slash == string::npos
+                                           ? difference.relativePath
+                                           : difference.relativePath.substr(slash + 1));
+        if (difference.isDirectory)
+        {
+            name += "/";
+        }
+
+        switch (difference.change)
+        {
+        case DirectoryCompare::Change::Removed:
+            AddEntry(m_leftTree, leftFolders, difference.relativePath, "- " + name, removedColour);
+            break;
+        case DirectoryCompare::Change::Added:
+            AddEntry(m_rightTree, rightFolders, difference.relativePath, "+ " + name, addedColour);
+            break;
+        case DirectoryCompare::Change::Changed:
+            AddEntry(m_leftTree,  leftFolders,  difference.relativePath, "~ " + name, changedColour);
+            AddEntry(m_rightTree, rightFolders, difference.relativePath, "~ " + name, changedColour);
+            break;
+        }
+    }
+
+    if (differences.size() <= MAX_SHOWN / 10)
+    {
+        m_leftTree->ExpandAll();
+        m_rightTree->ExpandAll();
+    }
+}
+
+/*
+Function: AddEntry
+Description: Appends one entry below its parent folder, creating any
+             missing ancestor folder items first.
+Parameters: tree         - tree to add to
+            folders      - relative folder path -> item map for that tree
+            relativePath - entry path, '/'-separated
+            label        - text to show
+            colour       - text colour
+Return: The new item
+*/
+wxTreeItemId CompareDialog::AddEntry(wxTreeCtrl* tree, map<string, wxTreeItemId>& folders,
+                                     const string& relativePath, const wxString& label,
+                                     const wxColour& colour)
+{
+    wxTreeItemId parent = tree->GetRootItem();
+
+    size_t start = 0;
+    size_t slash = relativePath.find('/');
+    while (slash != string::npos)
+    {
+        string folder = relativePath.substr(0, slash);
+        auto found = folders.find(folder);
+        if (found == folders.end())
+        {
+            wxTreeItemId item = tree->AppendItem(parent,
+                wxString::FromUTF8(relativePath.substr(start, slash - start)) + "/");
+            found = folders.emplace(folder, item).first;
+        }
+        parent = found->second;
+        start = slash + 1;
+        slash = relativePath.find('/', start);
+    }
+
+    wxTreeItemId item = tree->AppendItem(parent, label);
+    tree->SetItemTextColour(item, colour);
+    return item;
+}
@@ -0,0 +1,43 @@
+/*
+Author: Guo Jia
+Description: Declaration of CompareDialog – shows the result of a
+             DirectoryCompare as two trees side by side: the left tree holds
+             removed and changed entries, the right tree added and changed
+             ones, each under its parent folders.
+Date: 2026-10-18
+*/
+
+#ifndef COMPAREDIALOG_H
+#define COMPAREDIALOG_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <wx/dialog.h>
+#include <wx/treectrl.h>
+#include "DirectoryCompare.h"
+
+class CompareDialog : public wxDialog
+{
+public:
+    CompareDialog(wxWindow* parent, const wxString& leftPath, const wxString& rightPath,
+                  const std::vector<DirectoryCompare::Difference>& differences,
+                  const wxString& summary);
+    virtual ~CompareDialog();
+
+private:
+    // Beyond this many differences the trees would take longer to build
+    // than to read; the rest is summarised instead.
+    static constexpr std::size_t MAX_SHOWN = 20000;
+
+    wxTreeCtrl* m_leftTree;
+    wxTreeCtrl* m_rightTree;
+
+    void Populate(const std::vector<DirectoryCompare::Difference>& differences);
+
+    static wxTreeItemId AddEntry(wxTreeCtrl* tree, std::map<std::string, wxTreeItemId>& folders,
+                                 const std::string& relativePath, const wxString& label,
+                                 const wxColour& colour);
+};
+
+#endif // COMPAREDIALOG_H
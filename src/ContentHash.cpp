@@ -0,0 +1,279 @@
+/*
+Author: Guo Jia
+Description: Implementation of ContentHash – XXH64.  Four independent
+             accumulators consume 32-byte stripes, which keeps the hash close
+             to memory bandwidth; the tail and final avalanche follow the
+             reference algorithm so digests match other XXH64 tools.
+Date: 2026-10-18
+*/
+
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ContentHash.h"
+
+using namespace std;
+
+namespace
+{
+    const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+    const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+    const uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+    const size_t FILE_BUFFER_SIZE = 1 << 20;
+
+    inline uint64_t RotateLeft(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    // memcpy keeps unaligned reads well-defined; compilers turn it into a
+    // single load.  Assumes a little-endian host like the reference code.
+    inline uint64_t Read64(const unsigned char* p)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t Read32(const unsigned char* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t Round(uint64_t accumulator, uint64_t input)
+    {
+        accumulator += input * PRIME2;
+        accumulator  = RotateLeft(accumulator, 31);
+        return accumulator * PRIME1;
+    }
+
+    inline uint64_t MergeRound(uint64_t accumulator, uint64_t value)
+    {
+        accumulator ^= Round(0, value);
+        return accumulator * PRIME1 + PRIME4;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: ContentHash
+Description: Starts a new hash with the given seed.
+Parameters: seed - seed value; different seeds give unrelated hashes
+Return: None
+*/
+ContentHash::ContentHash(uint64_t seed)
+    : m_seed(seed),
+      m_accumulators{ seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1 },
+      m_totalLength(0),
+      m_pending{},
+      m_pendingLength(0)
+{
+}
+
+/*
+Function: ~ContentHash
+Description: Destructor.  No resources to release.
+Parameters: None
+Return: None
+*/
+ContentHash::~ContentHash()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Streaming interface
+// ---------------------------------------------------------------------------
+
+/*
+Function: Update
+Description: Adds bytes to the hash.  Whole 32-byte stripes are mixed in
+             immediately; a trailing partial stripe is buffered until more
+             data (or Digest) arrives.
+Parameters: data   - bytes to add
+            length - number of bytes
+Return: None
+*/
+void ContentHash::Update(const void* data, size_t length)
+{
+    const unsigned char* input = static_cast<const unsigned char*>(data);
+    m_totalLength += length;
+
+    // Top up a partially filled stripe first.
+    if (m_pendingLength > 0)
+    {
+        size_t take = STRIPE_SIZE - m_pendingLength;
+        if (take > length)
+        {
+            take = length;
+        }
+        memcpy(m_pending + m_pendingLength, input, take);
+        m_pendingLength += take;
+        input  += take;
+        length -= take;
+
+        if (m_pendingLength < STRIPE_SIZE)
+        {
+            return;
+        }
+        ProcessStripe(m_pending);
+        m_pendingLength = 0;
+    }
+
+    while (length >= STRIPE_SIZE)
+    {
+        ProcessStripe(input);
+        input  += STRIPE_SIZE;
+        length -= STRIPE_SIZE;
+    }
+
+    if (length > 0)
+    {
+        memcpy(m_pending, input, length);
+        m_pendingLength = length;
+    }
+}
+
+/*
+Function: Digest
+Description: Folds the accumulators, mixes in the buffered tail and applies
+             the final avalanche.
+Parameters: None
+Return: 64-bit hash of all data passed to Update()
+*/
+uint64_t ContentHash::Digest() const
+{
+    uint64_t hash;
+    if (m_totalLength >= STRIPE_SIZE)
+    {
+        hash = RotateLeft(m_accumulators[0], 1)  + RotateLeft(m_accumulators[1], 7) +
+               RotateLeft(m_accumulators[2], 12) + RotateLeft(m_accumulators[3], 18);
+        for (uint64_t accumulator : m_accumulators)
+        {
+            hash = MergeRound(hash, accumulator);
+        }
+    }
+    else
+    {
+        hash = m_seed + PRIME5;
+    }
+
+    hash += m_totalLength;
+
+    const unsigned char* p   = m_pending;
+    const unsigned char* end = m_pending + m_pendingLength;
+
+    while (p + 8 <= end)
+    {
+        hash ^= Round(0, Read64(p));
+        hash  = RotateLeft(hash, 27) * PRIME1 + PRIME4;
+        p += 8;
+    }
+    if (p + 4 <= end)
+    {
+        hash ^= static_cast<uint64_t>(Read32(p)) * PRIME1;
+        hash  = RotateLeft(hash, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    while (p < end)
+    {
+        hash ^= static_cast<uint64_t>(*p) * PRIME5;
+        hash  = RotateLeft(hash, 11) * PRIME1;
+        ++p;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// ---------------------------------------------------------------------------
+// One-shot helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: Hash
+Description: Convenience wrapper hashing a single memory block.
+Parameters: data   - bytes to hash
+            length - number of bytes
+            seed   - hash seed
+Return: 64-bit hash
+*/
+uint64_t ContentHash::Hash(const void* data, size_t length, uint64_t seed)
+{
+    ContentHash hasher(seed);
+    hasher.Update(data, length);
+    return hasher.Digest();
+}
+
+/*
+Function: HashFile
+Description: Streams a file through the hash in 1 MiB reads so memory use
+             is constant regardless of file size.
+Parameters: path - file to hash
+            hash - receives the digest on success
+Return: true if the whole file was read
+*/
+bool ContentHash::HashFile(const string& path, uint64_t& hash)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    ContentHash hasher;
+    vector<unsigned char> buffer(FILE_BUFFER_SIZE);
+    bool ok = true;
+
+    while (true)
+    {
+        ssize_t got = read(fd, buffer.data(), buffer.size());
+        if (got == 0)
+        {
+            break;
+        }
+        if (got < 0)
+        {
+            ok = false;
+            break;
+        }
+        hasher.Update(buffer.data(), static_cast<size_t>(got));
+    }
+
+    close(fd);
+    if (ok)
+    {
+        hash = hasher.Digest();
+    }
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Internals
+// ---------------------------------------------------------------------------
+
+/*
+Function: ProcessStripe
+Description: Mixes one 32-byte stripe into the four accumulators.
+Parameters: stripe - pointer to 32 bytes
+Return: None
+*/
+void ContentHash::ProcessStripe(const unsigned char* stripe)
+{
+    m_accumulators[0] = Round(m_accumulators[0], Read64(stripe));
+    m_accumulators[1] = Round(m_accumulators[1], Read64(stripe + 8));
+    m_accumulators[2] = Round(m_accumulators[2], Read64(stripe + 16));
+    m_accumulators[3] = Round(m_accumulators[3], Read64(stripe + 24));
+}
@@ -0,0 +1,46 @@
+/*
+Author: Guo Jia
+Description: Declaration of ContentHash – a streaming 64-bit non-cryptographic
+             hash (XXH64 algorithm) used to compare file contents and blocks
+             without keeping the data around.
+Date: 2026-10-18
+*/
+
+#ifndef CONTENTHASH_H
+#define CONTENTHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class ContentHash
+{
+public:
+    explicit ContentHash(std::uint64_t seed = 0);
+    virtual ~ContentHash();
+
+    // Feed more bytes into the running hash.
+    void Update(const void* data, std::size_t length);
+
+    // Hash of everything fed so far.  Does not reset the state.
+    std::uint64_t Digest() const;
+
+    // One-shot hash of a memory block.
+    static std::uint64_t Hash(const void* data, std::size_t length, std::uint64_t seed = 0);
+
+    // Hash a whole file.  Returns false if the file cannot be read.
+    static bool HashFile(const std::string& path, std::uint64_t& hash);
+
+private:
+    static const std::size_t STRIPE_SIZE = 32;
+
+    std::uint64_t m_seed;
+    std::uint64_t m_accumulators[4];
+    std::uint64_t m_totalLength;
+    unsigned char m_pending[STRIPE_SIZE];   // partial stripe not yet mixed in
+    std::size_t   m_pendingLength;
+
+    void ProcessStripe(const unsigned char* stripe);
+};
+
+#endif // CONTENTHASH_H
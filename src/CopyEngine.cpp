@@ -0,0 +1,539 @@
+/*
+Author: Guo Jia
+Description: Implementation of CopyEngine – a recursive copy over POSIX
+             calls that tries, per file, a hard link to an earlier copy, a
+             FICLONE reflink, a SEEK_DATA/SEEK_HOLE walk over the data of
+             sparse files, and copy_file_range, falling back to read/write
+             where the file systems offer none of these.  Journaled copies
+             skip finished entries and continue partly copied files.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include "CopyEngine.h"
+#include "CopyJournal.h"
+#include "LargeFileCopier.h"
+
+using namespace std;
+
+namespace
+{
+    const size_t LINK_BUFFER = 4096;
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: CopyEngine
+Description: Starts with no files copied.  The inode map lives as long as
+             the engine, so links between separate Copy() calls on the same
+             engine are kept too.
+Parameters: progress - called for each piece of data copied
+Return: None
+*/
+CopyEngine::CopyEngine(const Progress& progress)
+    : m_progress(progress),
+      m_error(),
+      m_copiedInodes(),
+      m_buffer(),
+      m_haveCopyFileRange(true),
+      m_bytesWritten(0),
+      m_bytesCloned(0),
+      m_bytesSkipped(0),
+      m_linksMade(0),
+      m_journal(nullptr),
+      m_relative(),
+      m_source(),
+      m_checkpointed(0)
+{
+}
+
+/*
+Function: ~CopyEngine
+Description: Nothing to release.
+Parameters: None
+Return: None
+*/
+CopyEngine::~CopyEngine()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Public interface
+// ---------------------------------------------------------------------------
+
+/*
+Function: Copy
+Description: Copies one entry and, for a folder, everything under it.
+Parameters: src       - source path
+            dest      - destination path
+            overwrite - replace existing files and links
+Return: true if everything was copied
+*/
+bool CopyEngine::Copy(const string& src, const string& dest, bool overwrite)
+{
+    m_error.clear();
+    return CopyEntry(src, dest, "", overwrite);
+}
+
+// ---------------------------------------------------------------------------
+// Entries
+// ---------------------------------------------------------------------------
+
+/*
+Function: CopyEntry
+Description: Dispatches on the source's type (symbolic links are not
+             followed).  A regular file that has more than one name is
+             linked to its first copy when it shows up again.  Sockets,
+             devices and FIFOs are refused.
+             With a journal, every entry created is recorded by device and
+             inode.  Entries an earlier run finished are skipped if the
+             destination is still the one it created and looks complete,
+             entries it created but did not finish are replaced, and a
+             partly copied file is continued from its last checkpoint; an
+             entry the journal does not know is never reused.
+Parameters: src       - source path
+            dest      - destination path
+            relative  - path below the source given to Copy()
+            overwrite - replace existing files and links
+Return: true on success
+*/
+bool CopyEngine::CopyEntry(const string& src, const string& dest, const string& relative, bool overwrite)
+{
+    struct stat info;
+    if (::lstat(src.c_str(), &info) != 0)
+    {
+        return Fail("Cannot read " + src + ": " + strerror(errno));
+    }
+
+    if (S_ISDIR(info.st_mode))
+    {
+        struct stat existing;
+        bool merge = ::stat(dest.c_str(), &existing) == 0 && S_ISDIR(existing.st_mode);
+        if (!merge && ::mkdir(dest.c_str(), info.st_mode & 07777) != 0)
+        {
+            return Fail("Cannot create folder " + dest + ": " + strerror(errno));
+        }
+
+        DIR* folder = ::opendir(src.c_str());
+        if (folder == nullptr)
+        {
+            return Fail("Cannot open folder " + src + ": " + strerror(errno));
+        }
+        bool ok = true;
+        while (ok)
+        {
+            errno = 0;
+            struct dirent* entry = ::readdir(folder);
+            if (entry == nullptr)
+            {
+                if (errno != 0)
+                {
+                    ok = Fail("Cannot read folder " + src + ": " + strerror(errno));
+                }
+                break;
+            }
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            {
+                continue;
+            }
+            ok = CopyEntry(src + "/" + entry->d_name, dest + "/" + entry->d_name,
+                           relative.empty() ? string(entry->d_name) : relative + "/" + entry->d_name,
+                           overwrite);
+        }
+        ::closedir(folder);
+        return ok;
+    }
+
+    pair<dev_t, ino_t> inode(info.st_dev, info.st_ino);
+    struct stat        existing;
+    bool               exists = ::lstat(dest.c_str(), &existing) == 0;
+    bool own = exists && m_journal != nullptr && m_journal->IsLeftOver(relative, existing);
+    if (own && m_journal->IsDone(relative, info) &&
+        (S_ISLNK(info.st_mode) ? S_ISLNK(existing.st_mode)
+                               : S_ISREG(existing.st_mode) && existing.st_size == info.st_size))
+    {
+        if (S_ISREG(info.st_mode) && info.st_nlink > 1)
+        {
+            m_copiedInodes.emplace(inode, dest);
+        }
+        return true;
+    }
+
+    // Links and files replace what is at 'dest' only when asked to.
+    uint64_t resume = 0;
+    if (exists)
+    {
+        if (!overwrite && !own)
+        {
+            return Fail(dest + " already exists");
+        }
+        if (S_ISDIR(existing.st_mode))
+        {
+            return Fail("Cannot replace " + dest);
+        }
+        if (own && S_ISREG(info.st_mode) && S_ISREG(existing.st_mode))
+        {
+            resume = m_journal->ResumeOffset(relative, info);
+            if (resume > static_cast<uint64_t>(existing.st_size))
+            {
+                resume = 0;
+            }
+        }
+        if (resume == 0 && ::unlink(dest.c_str()) != 0)
+        {
+            return Fail("Cannot replace " + dest);
+        }
+    }
+
+    if (S_ISLNK(info.st_mode))
+    {
+        char target[LINK_BUFFER];
+        ssize_t length = ::readlink(src.c_str(), target, sizeof(target));
+        if (length < 0 || static_cast<size_t>(length) >= sizeof(target))
+        {
+            return Fail("Cannot read link " + src);
+        }
+        if (::symlink(string(target, static_cast<size_t>(length)).c_str(), dest.c_str()) != 0)
+        {
+            return Fail("Cannot create link " + dest + ": " + strerror(errno));
+        }
+        if (m_journal != nullptr)
+        {
+            Created(relative, dest);
+            m_journal->Done(relative, info);
+        }
+        return true;
+    }
+
+    if (!S_ISREG(info.st_mode))
+    {
+        return Fail(src + " is not a file, folder or link");
+    }
+
+    if (info.st_nlink > 1 && resume == 0)
+    {
+        auto copied = m_copiedInodes.find(inode);
+        if (copied != m_copiedInodes.end() && ::link(copied->second.c_str(), dest.c_str()) == 0)
+        {
+            ++m_linksMade;
+            if (m_journal != nullptr)
+            {
+                Created(relative, dest);
+                m_journal->Done(relative, info);
+            }
+            return true;
+        }
+    }
+
+    m_relative     = relative;
+    m_source       = info;
+    m_checkpointed = resume;
+    if (!CopyFile(src, dest, info, resume))
+    {
+        return false;
+    }
+    if (info.st_nlink > 1)
+    {
+        m_copiedInodes.emplace(inode, dest);
+    }
+    if (m_journal != nullptr)
+    {
+        m_journal->Done(relative, info);
+    }
+    return true;
+}
+
+/*
+Function: CopyFile
+Description: Copies one regular file by the cheapest means available: a
+             reflink clone shares the blocks and moves no data; otherwise a
+             sparse file (fewer blocks than its size) has only its data
+             extents copied; a large dense file goes to LargeFileCopier;
+             anything else is copied range by range.  A resumed file is
+             never cloned, since part of it is already written.
+Parameters: src    - source file
+            dest   - destination (known not to exist unless resuming)
+            info   - lstat of the source
+            resume - bytes of the destination already copied
+Return: true on success.  On failure a partial destination is removed,
+        unless a journal is attached: then it is left, with its Created
+        and offset records, for a resumed run to continue.
+*/
+bool CopyEngine::CopyFile(const string& src, const string& dest, const struct stat& info, uint64_t resume)
+{
+    uint64_t size   = static_cast<uint64_t>(info.st_size);
+    bool     sparse = static_cast<uint64_t>(info.st_blocks) * 512 < size;
+
+    int in = ::open(src.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0)
+    {
+        return Fail("Cannot open " + src + ": " + strerror(errno));
+    }
+    int out = resume > 0 ? ::open(dest.c_str(), O_WRONLY | O_CLOEXEC)
+                         : ::open(dest.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, info.st_mode & 07777);
+    if (out < 0)
+    {
+        int error = errno;
+        ::close(in);
+        return Fail("Cannot create " + dest + ": " + strerror(error));
+    }
+    struct stat created;
+    if (resume == 0 && m_journal != nullptr && ::fstat(out, &created) == 0)
+    {
+        m_journal->Created(m_relative, created);
+    }
+
+    bool ok = true;
+    if (resume == 0 && size > 0 && ::ioctl(out, FICLONE, in) == 0)
+    {
+        m_bytesCloned += size;
+    }
+    else if (!sparse && size >= LARGE_FILE_BYTES)
+    {
+        ::close(in);
+        ::close(out);
+        uint64_t        start   = resume - resume % LargeFileCopier::CHUNK;
+        uint64_t        reached = start;
+        LargeFileCopier copier([this, &reached](uint64_t bytes)
+        {
+            reached += bytes;
+            Checkpoint(reached);
+            return !m_progress || m_progress(bytes);
+        });
+        copier.SetKeepPartial(m_journal != nullptr);
+        if (!copier.Copy(src, dest, true, start))
+        {
+            return Fail(copier.GetError());
+        }
+        m_bytesWritten += size - start;
+        return true;
+    }
+    else
+    {
+        m_haveCopyFileRange = true;
+        bool handled = false;
+        if (sparse)
+        {
+            ok = CopyExtents(in, out, resume, size, handled);
+        }
+        if (ok && !handled)
+        {
+            ok = CopyRange(in, out, resume, size - resume);
+        }
+    }
+
+    ::close(in);
+    if (::close(out) != 0 && ok)
+    {
+        ok = Fail("Cannot write " + dest + ": " + strerror(errno));
+    }
+    if (!ok && m_journal == nullptr)
+    {
+        ::unlink(dest.c_str());
+    }
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Data
+// ---------------------------------------------------------------------------
+
+/*
+Function: CopyExtents
+Description: Walks the source with SEEK_DATA / SEEK_HOLE and copies each
+             data extent to the same offset; the gaps are never written, so
+             they stay holes in the destination, whose size is then set with
+             ftruncate() (covering a hole at the end).
+Parameters: in      - source descriptor
+            out     - destination descriptor (empty, or copied up to 'start')
+            start   - where to begin
+            size    - source size
+            handled - set false when extents cannot be listed here, so
+                      the caller copies the whole file instead
+Return: false on an error
+*/
+bool CopyEngine::CopyExtents(int in, int out, uint64_t start, uint64_t size, bool& handled)
+{
+    handled = false;
+    uint64_t offset = start;
+    while (offset < size)
+    {
+        off_t data = ::lseek(in, static_cast<off_t>(offset), SEEK_DATA);
+        if (data < 0)
+        {
+            if (errno == ENXIO)
+            {
+                break;   // only a hole is left
+            }
+            if (offset == start && (errno == EINVAL || errno == EOPNOTSUPP))
+            {
+                return true;
+            }
+            return Fail(string("Cannot find data: ") + strerror(errno));
+        }
+        off_t hole = ::lseek(in, data, SEEK_HOLE);
+        if (hole < 0)
+        {
+            return Fail(string("Cannot find hole: ") + strerror(errno));
+        }
+
+        uint64_t begin = static_cast<uint64_t>(data);
+        uint64_t end   = min(static_cast<uint64_t>(hole), size);
+        if (begin >= end)
+        {
+            break;
+        }
+        m_bytesSkipped += begin - offset;
+        if (!CopyRange(in, out, begin, end - begin))
+        {
+            return false;
+        }
+        offset = end;
+    }
+
+    if (offset < size)
+    {
+        m_bytesSkipped += size - offset;
+    }
+    if (::ftruncate(out, static_cast<off_t>(size)) != 0)
+    {
+        return Fail(string("Cannot set the size: ") + strerror(errno));
+    }
+    handled = true;
+    return true;
+}
+
+/*
+Function: CopyRange
+Description: Copies CHUNK at a time with copy_file_range, which lets the
+             kernel (or a network file system's server) move the data, and
+             may share blocks on file systems that support it.  Where the
+             call is not available between these two files, it switches to
+             pread/pwrite for the rest of the file.
+Parameters: in     - source descriptor
+            out    - destination descriptor
+            offset - where the range starts, in both files
+            length - bytes to copy
+Return: false on an error, cancellation, or if the source got shorter
+*/
+bool CopyEngine::CopyRange(int in, int out, uint64_t offset, uint64_t length)
+{
+    uint64_t done = 0;
+    while (done < length)
+    {
+        size_t  part = static_cast<size_t>(min<uint64_t>(CHUNK, length - done));
+        ssize_t copied;
+        if (m_haveCopyFileRange)
+        {
+            off_t inOffset  = static_cast<off_t>(offset + done);
+            off_t outOffset = inOffset;
+            copied = ::copy_file_range(in, &inOffset, out, &outOffset, part, 0);
+            if (copied < 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL ||
+                               errno == EOPNOTSUPP))
+            {
+                m_haveCopyFileRange = false;
+                continue;
+            }
+        }
+        else
+        {
+            m_buffer.resize(CHUNK);
+            copied = ::pread(in, m_buffer.data(), part, static_cast<off_t>(offset + done));
+            size_t written = 0;
+            while (copied > 0 && written < static_cast<size_t>(copied))
+            {
+                ssize_t n = ::pwrite(out, m_buffer.data() + written, static_cast<size_t>(copied) - written,
+                                     static_cast<off_t>(offset + done + written));
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n <= 0)
+                {
+                    copied = -1;
+                    break;
+                }
+                written += static_cast<size_t>(n);
+            }
+        }
+
+        if (copied < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (copied < 0)
+        {
+            return Fail(string("Copy error: ") + strerror(errno));
+        }
+        if (copied == 0)
+        {
+            return Fail("The source got shorter during the copy");
+        }
+
+        done += static_cast<uint64_t>(copied);
+        m_bytesWritten += static_cast<uint64_t>(copied);
+        Checkpoint(offset + done);
+        if (m_progress && !m_progress(static_cast<uint64_t>(copied)))
+        {
+            return Fail("Cancelled");
+        }
+    }
+    return true;
+}
+
+/*
+Function: Checkpoint
+Description: Journals the offset reached in the current file once
+             CHECKPOINT_BYTES more have been copied since the last record.
+             Everything before 'offset' must already be written, which
+             holds because files are copied front to back.
+Parameters: offset - bytes of the current file copied
+Return: None
+*/
+void CopyEngine::Checkpoint(uint64_t offset)
+{
+    if (m_journal != nullptr && offset >= m_checkpointed + CHECKPOINT_BYTES)
+    {
+        m_journal->Reached(m_relative, offset, m_source);
+        m_checkpointed = offset;
+    }
+}
+
+/*
+Function: Created
+Description: Journals the device and inode of a symbolic or hard link just
+             made, so a resumed run knows it may replace it.
+Parameters: relative - path below the source given to Copy()
+            dest     - the new link
+Return: None
+*/
+void CopyEngine::Created(const string& relative, const string& dest)
+{
+    struct stat created;
+    if (::lstat(dest.c_str(), &created) == 0)
+    {
+        m_journal->Created(relative, created);
+    }
+}
+
+/*
+Function: Fail
+Description: Records why the copy failed.
+Parameters: message - description of the failure
+Return: false, so callers can return Fail(...)
+*/
+bool CopyEngine::Fail(const string& message)
+{
+    m_error = message;
+    return false;
+}
@@ -0,0 +1,110 @@
+/*
+Author: Guo Jia
+Description: Declaration of CopyEngine – copies a file or folder tree
+             while keeping what makes it small on disk: files with several
+             names inside the tree become hard links again, files are
+             cloned (reflinked) where the file system can share their
+             blocks, holes in sparse files are skipped instead of written
+             out as zeros, and the remaining data moves with
+             copy_file_range so the kernel can copy it without a round trip
+             through user space.  With a CopyJournal attached, progress is
+             checkpointed so an interrupted copy can be resumed.
+Date: 2026-10-18
+*/
+
+#ifndef COPYENGINE_H
+#define COPYENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sys/stat.h>
+
+class CopyJournal;
+
+class CopyEngine
+{
+public:
+    // Told about every piece of data copied (bytes); returns false to
+    // cancel.  Cloned files and skipped holes are not reported.
+    using Progress = std::function<bool(std::uint64_t bytes)>;
+
+    explicit CopyEngine(const Progress& progress);
+    virtual ~CopyEngine();
+
+    CopyEngine(const CopyEngine&) = delete;
+    CopyEngine& operator=(const CopyEngine&) = delete;
+
+    // Copy 'src' (a folder with everything under it, a symbolic link as a
+    // link, or a regular file) to 'dest'.  Folders merge into an existing
+    // folder; existing files are replaced only if 'overwrite'.  Returns
+    // false on the first error with GetError() saying why.
+    bool Copy(const std::string& src, const std::string& dest, bool overwrite);
+
+    // Checkpoint into 'journal' and skip what it says an earlier run of
+    // the same job finished (nullptr: none).  The journal must outlive the
+    // copies made with it.
+    void SetJournal(CopyJournal* journal) { m_journal = journal; }
+
+    const std::string& GetError() const { return m_error; }
+
+    // What the copies so far did.
+    std::uint64_t GetBytesWritten() const { return m_bytesWritten; }
+    std::uint64_t GetBytesCloned() const { return m_bytesCloned; }
+    std::uint64_t GetBytesSkipped() const { return m_bytesSkipped; }   // holes
+    std::uint64_t GetLinksMade() const { return m_linksMade; }
+
+private:
+    static constexpr std::size_t CHUNK = 1024 * 1024;
+
+    // Dense files at least this large go through LargeFileCopier, which
+    // keeps them out of the page cache and preallocates the destination.
+    static constexpr std::uint64_t LARGE_FILE_BYTES = 256ULL * 1024 * 1024;
+
+    // Offsets inside a file are journaled at most this often.
+    static constexpr std::uint64_t CHECKPOINT_BYTES = 64ULL * 1024 * 1024;
+
+    Progress                                       m_progress;
+    std::string                                    m_error;
+    std::map<std::pair<dev_t, ino_t>, std::string> m_copiedInodes;   // multiply-linked source -> its copy
+    std::vector<char>                              m_buffer;         // read/write fallback only
+    bool                                           m_haveCopyFileRange;
+    std::uint64_t                                  m_bytesWritten;
+    std::uint64_t                                  m_bytesCloned;
+    std::uint64_t                                  m_bytesSkipped;
+    std::uint64_t                                  m_linksMade;
+    CopyJournal*                                   m_journal;
+    std::string                                    m_relative;       // file being copied, for the journal
+    struct stat                                    m_source;         // its lstat
+    std::uint64_t                                  m_checkpointed;   // offset last journaled
+
+    // 'relative' is the entry's path below the source given to Copy().
+    bool CopyEntry(const std::string& src, const std::string& dest, const std::string& relative,
+                   bool overwrite);
+
+    // Copy a regular file, continuing at 'resume' bytes into an existing
+    // partial destination when it is not 0.
+    bool CopyFile(const std::string& src, const std::string& dest, const struct stat& info,
+                  std::uint64_t resume);
+
+    // Copy only the data extents of a sparse file from 'start' on, leaving
+    // holes.  'handled' is false if the file system cannot list extents.
+    bool CopyExtents(int in, int out, std::uint64_t start, std::uint64_t size, bool& handled);
+
+    // Copy [offset, offset + length) to the same offset in 'out'.
+    bool CopyRange(int in, int out, std::uint64_t offset, std::uint64_t length);
+
+    // Journal that the current file is copied up to 'offset'.
+    void Checkpoint(std::uint64_t offset);
+
+    // Journal the identity of the link just made at 'dest'.
+    void Created(const std::string& relative, const std::string& dest);
+
+    bool Fail(const std::string& message);
+};
+
+#endif // COPYENGINE_H
@@ -0,0 +1,651 @@
+/*
+Author: Guo Jia
+Description: Implementation of CopyJournal – a line-per-record text file
+             appended with O_APPEND, loaded back on resume, and flushed in
+             the order destination first, journal second.
+Date: 2026-10-18
+*/
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include "CopyJournal.h"
+#include "ContentHash.h"
+
+using namespace std;
+
+namespace
+{
+    const char* const JOURNAL_PREFIX = "copy-";
+    const char* const JOURNAL_SUFFIX = ".journal";
+
+    string ParentOf(const string& path)
+    {
+        size_t slash = path.find_last_of('/');
+        if (slash == string::npos)
+        {
+            return ".";
+        }
+        return slash == 0 ? string("/") : path.substr(0, slash);
+    }
+
+    vector<string> SplitFields(const string& line)
+    {
+        vector<string> fields;
+        size_t start = 0;
+        for (;;)
+        {
+            size_t tab = line.find('\t', start);
+            fields.push_back(line.substr(start, tab == string::npos ? string::npos : tab - start));
+            if (tab == string::npos)
+            {
+                return fields;
+            }
+            start = tab + 1;
+        }
+    }
+
+    bool WriteAll(int fd, const string& data)
+    {
+        size_t done = 0;
+        while (done < data.size())
+        {
+            ssize_t part = ::write(fd, data.data() + done, data.size() - done);
+            if (part < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (part <= 0)
+            {
+                return false;
+            }
+            done += static_cast<size_t>(part);
+        }
+        return true;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: CopyJournal
+Description: Starts closed; Open() attaches it to a job.
+Parameters: None
+Return: None
+*/
+CopyJournal::CopyJournal()
+    : m_fd(-1),
+      m_destinationFd(-1),
+      m_path(),
+      m_resuming(false),
+      m_copied(false),
+      m_written(false),
+      m_done(),
+      m_partial(),
+      m_created(),
+      m_pending(),
+      m_lastSync()
+{
+}
+
+/*
+Function: ~CopyJournal
+Description: Writes what is still held back, so a failed job keeps all the
+             progress it made, and closes the files.
+Parameters: None
+Return: None
+*/
+CopyJournal::~CopyJournal()
+{
+    Sync();
+    Close();
+}
+
+// ---------------------------------------------------------------------------
+// Opening
+// ---------------------------------------------------------------------------
+
+/*
+Function: Open
+Description: Loads an existing journal of the same job and cuts off a torn
+             last line, or starts a new one whose header is flushed at once
+             (with its folder entry) so the job is found after a crash.
+Parameters: directory   - folder holding journals
+            source      - the job's source path
+            destination - the job's destination path
+            move        - whether the job is a move
+            overwrite   - whether the job replaces existing files
+Return: true if the journal is open for appending
+*/
+bool CopyJournal::Open(const string& directory, const string& source, const string& destination,
+                       bool move, bool overwrite)
+{
+    Close();
+    m_resuming = false;
+    m_written  = false;
+    m_pending.clear();
+    ::mkdir(directory.c_str(), 0700);
+    m_path = PathOf(directory, source, destination);
+
+    Job    job;
+    time_t startTime = 0;
+    long   length    = Load(m_path, job, startTime, this);
+    if (length >= 0 && job.source == source && job.destination == destination)
+    {
+        m_fd = ::open(m_path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+        if (m_fd < 0 || ::ftruncate(m_fd, static_cast<off_t>(length)) != 0)
+        {
+            Close();
+            return false;
+        }
+        m_resuming = true;
+    }
+    else
+    {
+        // Unreadable, torn in its header, or (in theory) another job with
+        // the same hash: start over.
+        m_done.clear();
+        m_partial.clear();
+        m_created.clear();
+        m_copied = false;
+        ::unlink(m_path.c_str());
+
+        startTime = time(nullptr);
+        m_fd = ::open(m_path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0600);
+        string header = string("J\t") + (move ? "1" : "0") + "\t" + (overwrite ? "1" : "0") + "\t" +
+                        to_string(static_cast<long long>(startTime)) + "\t" + Escape(source) + "\t" +
+                        Escape(destination) + "\n";
+        if (m_fd < 0 || !WriteAll(m_fd, header) || ::fdatasync(m_fd) != 0)
+        {
+            Close();
+            ::unlink(m_path.c_str());
+            return false;
+        }
+        int folder = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (folder >= 0)
+        {
+            ::fsync(folder);
+            ::close(folder);
+        }
+    }
+
+    m_destinationFd = ::open(ParentOf(destination).c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    m_lastSync      = chrono::steady_clock::now();
+    return true;
+}
+
+/*
+Function: Exists
+Description: Checks for a journal without opening it.
+Parameters: directory   - folder holding journals
+            source      - the job's source path
+            destination - the job's destination path
+Return: true if the job has a journal
+*/
+bool CopyJournal::Exists(const string& directory, const string& source, const string& destination)
+{
+    return ::access(PathOf(directory, source, destination).c_str(), F_OK) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Queries
+// ---------------------------------------------------------------------------
+
+/*
+Function: IsDone
+Description: Looks the entry up among the finished ones.
+Parameters: relative - entry path relative to the job's source
+            source   - current lstat of the source entry
+Return: true if it was finished and the source is unchanged since
+*/
+bool CopyJournal::IsDone(const string& relative, const struct stat& source) const
+{
+    auto done = m_done.find(relative);
+    return done != m_done.end() && Matches(done->second, source);
+}
+
+/*
+Function: ResumeOffset
+Description: Looks the entry up among the partly copied ones.
+Parameters: relative - entry path relative to the job's source
+            source   - current lstat of the source entry
+Return: bytes known to be copied, or 0 if the file starts over
+*/
+uint64_t CopyJournal::ResumeOffset(const string& relative, const struct stat& source) const
+{
+    auto partial = m_partial.find(relative);
+    if (partial == m_partial.end() || !Matches(partial->second, source))
+    {
+        return 0;
+    }
+    return partial->second.offset;
+}
+
+/*
+Function: IsLeftOver
+Description: Compares the existing entry with the one the earlier run
+             recorded creating there.  Anything else at that path – put
+             there by someone else, or replaced since – is not the job's
+             to touch.
+Parameters: relative    - entry path relative to the job's source
+            destination - lstat of the existing destination entry
+Return: true if it is safe to continue or replace as part of resuming
+*/
+bool CopyJournal::IsLeftOver(const string& relative, const struct stat& destination) const
+{
+    if (!m_resuming)
+    {
+        return false;
+    }
+    auto created = m_created.find(relative);
+    return created != m_created.end() &&
+           created->second.device == static_cast<uint64_t>(destination.st_dev) &&
+           created->second.inode == static_cast<uint64_t>(destination.st_ino);
+}
+
+// ---------------------------------------------------------------------------
+// Records
+// ---------------------------------------------------------------------------
+
+/*
+Function: Created
+Description: Records the identity of an entry the job has just created.
+             Unlike the other records it is appended straight away, without
+             a flush: after a crash of the program it is in the journal even
+             if the progress records are not, and if a power loss drops it
+             the entry is only refused, never wrongly replaced.
+Parameters: relative    - entry path relative to the job's source
+            destination - lstat of the created entry
+Return: None
+*/
+void CopyJournal::Created(const string& relative, const struct stat& destination)
+{
+    if (m_fd < 0)
+    {
+        return;
+    }
+    m_created[relative] = { static_cast<uint64_t>(destination.st_dev),
+                            static_cast<uint64_t>(destination.st_ino) };
+    if (WriteAll(m_fd, "N\t" + to_string(static_cast<unsigned long long>(destination.st_dev)) + "\t" +
+                       to_string(static_cast<unsigned long long>(destination.st_ino)) + "\t" +
+                       Escape(relative) + "\n"))
+    {
+        m_written = true;
+    }
+}
+
+/*
+Function: Reached
+Description: Records that the first 'offset' bytes of a file are copied.
+Parameters: relative - file path relative to the job's source
+            offset   - bytes copied
+            source   - lstat of the source file
+Return: None
+*/
+void CopyJournal::Reached(const string& relative, uint64_t offset, const struct stat& source)
+{
+    Append("P\t" + to_string(offset) + "\t" + Stamp(source) + "\t" + Escape(relative));
+}
+
+/*
+Function: Done
+Description: Records that an entry is completely copied.
+Parameters: relative - entry path relative to the job's source
+            source   - lstat of the source entry
+Return: None
+*/
+void CopyJournal::Done(const string& relative, const struct stat& source)
+{
+    Append("D\t" + Stamp(source) + "\t" + Escape(relative));
+}
+
+/*
+Function: Copied
+Description: Records that the copy half of a move completed, and flushes
+             at once since the source is deleted next.
+Parameters: None
+Return: None
+*/
+void CopyJournal::Copied()
+{
+    m_copied = true;
+    Append("C");
+    Sync();
+}
+
+/*
+Function: Sync
+Description: syncfs() on the destination's file system makes the data the
+             held-back records describe durable; only then are the records
+             written and flushed.  The two are never reversed, so a crash
+             between them loses records, not data.
+Parameters: None
+Return: None
+*/
+void CopyJournal::Sync()
+{
+    if (m_fd < 0 || m_pending.empty())
+    {
+        return;
+    }
+    if (m_destinationFd >= 0)
+    {
+        ::syncfs(m_destinationFd);
+    }
+    if (WriteAll(m_fd, m_pending))
+    {
+        ::fdatasync(m_fd);
+        m_written = true;
+    }
+    m_pending.clear();
+    m_lastSync = chrono::steady_clock::now();
+}
+
+/*
+Function: Remove
+Description: Deletes the journal; records still held back are dropped.
+Parameters: None
+Return: None
+*/
+void CopyJournal::Remove()
+{
+    m_pending.clear();
+    if (!m_path.empty())
+    {
+        ::unlink(m_path.c_str());
+    }
+    Close();
+}
+
+// ---------------------------------------------------------------------------
+// Interrupted jobs
+// ---------------------------------------------------------------------------
+
+/*
+Function: FindInterrupted
+Description: Reads the header of every journal in the folder.  Journals
+             that cannot be read are skipped.
+Parameters: directory - folder holding journals
+Return: the jobs, in no particular order
+*/
+vector<CopyJournal::Job> CopyJournal::FindInterrupted(const string& directory)
+{
+    vector<Job> jobs;
+    DIR* folder = ::opendir(directory.c_str());
+    if (folder == nullptr)
+    {
+        return jobs;
+    }
+
+    size_t prefixLength = strlen(JOURNAL_PREFIX);
+    size_t suffixLength = strlen(JOURNAL_SUFFIX);
+    while (struct dirent* entry = ::readdir(folder))
+    {
+        string name = entry->d_name;
+        if (name.size() <= prefixLength + suffixLength || name.compare(0, prefixLength, JOURNAL_PREFIX) != 0 ||
+            name.compare(name.size() - suffixLength, suffixLength, JOURNAL_SUFFIX) != 0)
+        {
+            continue;
+        }
+        Job    job;
+        time_t startTime;
+        if (Load(directory + "/" + name, job, startTime, nullptr) >= 0)
+        {
+            jobs.push_back(job);
+        }
+    }
+    ::closedir(folder);
+    return jobs;
+}
+
+/*
+Function: Discard
+Description: Deletes a journal the user chose not to resume.
+Parameters: journal - path of the journal file
+Return: None
+*/
+void CopyJournal::Discard(const string& journal)
+{
+    ::unlink(journal.c_str());
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: Append
+Description: Holds a record back until the next Sync(), which happens once
+             SYNC_INTERVAL has passed since the last one.
+Parameters: record - one line without its newline
+Return: None
+*/
+void CopyJournal::Append(const string& record)
+{
+    if (m_fd < 0)
+    {
+        return;
+    }
+    m_pending += record;
+    m_pending += '\n';
+    if (chrono::steady_clock::now() - m_lastSync >= SYNC_INTERVAL)
+    {
+        Sync();
+    }
+}
+
+/*
+Function: Close
+Description: Closes the journal and the destination folder.
+Parameters: None
+Return: None
+*/
+void CopyJournal::Close()
+{
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    if (m_destinationFd >= 0)
+    {
+        ::close(m_destinationFd);
+        m_destinationFd = -1;
+    }
+}
+
+/*
+Function: Load
+Description: Lines are "J move overwrite start source destination" (the
+             header), "N device inode path", "P offset size seconds
+             nanoseconds path", "D size seconds nanoseconds path" and "C",
+             with tab-separated fields.
+             Later lines for a path supersede earlier ones; a finished entry
+             is no longer partial.  Text after the last newline is a torn
+             write and is ignored, as are lines not understood.
+Parameters: path      - journal file
+            job       - receives the header
+            startTime - receives when the job first started
+            into      - journal whose maps receive the records, or nullptr
+Return: length of the complete lines, or -1 if there is no valid header
+*/
+long CopyJournal::Load(const string& path, Job& job, time_t& startTime, CopyJournal* into)
+{
+    ifstream in(path, ios::binary);
+    if (!in)
+    {
+        return -1;
+    }
+    ostringstream content;
+    content << in.rdbuf();
+    string text = content.str();
+
+    size_t complete = text.rfind('\n');
+    if (complete == string::npos)
+    {
+        return -1;
+    }
+    ++complete;
+
+    size_t start = 0;
+    bool   header = true;
+    while (start < complete)
+    {
+        size_t         end    = text.find('\n', start);
+        vector<string> fields = SplitFields(text.substr(start, end - start));
+        start = end + 1;
+
+        if (header)
+        {
+            if (fields.size() != 6 || fields[0] != "J")
+            {
+                return -1;
+            }
+            job.journal     = path;
+            job.move        = fields[1] == "1";
+            job.overwrite   = fields[2] == "1";
+            startTime       = static_cast<time_t>(strtoll(fields[3].c_str(), nullptr, 10));
+            job.source      = Unescape(fields[4]);
+            job.destination = Unescape(fields[5]);
+            header          = false;
+            if (into == nullptr)
+            {
+                break;
+            }
+            continue;
+        }
+
+        Checkpoint checkpoint;
+        if (fields[0] == "N" && fields.size() == 4)
+        {
+            Identity identity;
+            identity.device = strtoull(fields[1].c_str(), nullptr, 10);
+            identity.inode  = strtoull(fields[2].c_str(), nullptr, 10);
+            into->m_created[Unescape(fields[3])] = identity;
+        }
+        else if (fields[0] == "P" && fields.size() == 6)
+        {
+            checkpoint.offset      = strtoull(fields[1].c_str(), nullptr, 10);
+            checkpoint.size        = strtoull(fields[2].c_str(), nullptr, 10);
+            checkpoint.seconds     = strtoll(fields[3].c_str(), nullptr, 10);
+            checkpoint.nanoseconds = strtol(fields[4].c_str(), nullptr, 10);
+            into->m_partial[Unescape(fields[5])] = checkpoint;
+        }
+        else if (fields[0] == "D" && fields.size() == 5)
+        {
+            checkpoint.size        = strtoull(fields[1].c_str(), nullptr, 10);
+            checkpoint.seconds     = strtoll(fields[2].c_str(), nullptr, 10);
+            checkpoint.nanoseconds = strtol(fields[3].c_str(), nullptr, 10);
+            checkpoint.offset      = checkpoint.size;
+            string relative = Unescape(fields[4]);
+            into->m_partial.erase(relative);
+            into->m_done[relative] = checkpoint;
+        }
+        else if (fields[0] == "C" && fields.size() == 1)
+        {
+            into->m_copied = true;
+        }
+    }
+    return static_cast<long>(complete);
+}
+
+/*
+Function: PathOf
+Description: Journals are named after a hash of the job's two paths, so
+             re-running the same job finds its journal.
+Parameters: directory   - folder holding journals
+            source      - the job's source path
+            destination - the job's destination path
+Return: path of the job's journal
+*/
+string CopyJournal::PathOf(const string& directory, const string& source, const string& destination)
+{
+    string   key  = source + '\0' + destination;
+    uint64_t hash = ContentHash::Hash(key.data(), key.size());
+    char     name[17];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+    return directory + "/" + JOURNAL_PREFIX + name + JOURNAL_SUFFIX;
+}
+
+/*
+Function: Escape
+Description: Makes a path safe to store in a tab-separated line.
+Parameters: text - path
+Return: the escaped path
+*/
+string CopyJournal::Escape(const string& text)
+{
+    string escaped;
+    escaped.reserve(text.size());
+    for (char c : text)
+    {
+        switch (c)
+        {
+            case '\\': escaped += "\\\\"; break;
+            case '\t': escaped += "\\t";  break;
+            case '\n': escaped += "\\n";  break;
+            default:   escaped += c;      break;
+        }
+    }
+    return escaped;
+}
+
+/*
+Function: Unescape
+Description: Reverses Escape().
+Parameters: text - escaped path
+Return: the original path
+*/
+string CopyJournal::Unescape(const string& text)
+{
+    string plain;
+    plain.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] == '\\' && i + 1 < text.size())
+        {
+            ++i;
+            plain += text[i] == 't' ? '\t' : text[i] == 'n' ? '\n' : text[i];
+        }
+        else
+        {
+            plain += text[i];
+        }
+    }
+    return plain;
+}
+
+/*
+Function: Stamp
+Description: Formats the size and modification time fields of a record.
+Parameters: source - lstat of the source entry
+Return: "size<TAB>seconds<TAB>nanoseconds"
+*/
+string CopyJournal::Stamp(const struct stat& source)
+{
+    return to_string(static_cast<unsigned long long>(source.st_size)) + "\t" +
+           to_string(static_cast<long long>(source.st_mtim.tv_sec)) + "\t" +
+           to_string(static_cast<long>(source.st_mtim.tv_nsec));
+}
+
+/*
+Function: Matches
+Description: Compares a record with the source as it is now.
+Parameters: checkpoint - the record
+            source     - current lstat of the source entry
+Return: true if size and modification time are unchanged
+*/
+bool CopyJournal::Matches(const Checkpoint& checkpoint, const struct stat& source)
+{
+    return checkpoint.size == static_cast<uint64_t>(source.st_size) &&
+           checkpoint.seconds == static_cast<int64_t>(source.st_mtim.tv_sec) &&
+           checkpoint.nanoseconds == static_cast<long>(source.st_mtim.tv_nsec);
+}
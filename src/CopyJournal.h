@@ -0,0 +1,145 @@
+/*
+Author: Guo Jia
+Description: Declaration of CopyJournal – the checkpoint file of one copy
+             (or cross-device move) job, so a job cut short by a crash or
+             power loss continues where it stopped instead of starting
+             over.  Records are only ever appended: the job itself, the
+             device and inode of every entry it creates, offsets reached
+             inside big files, and entries finished together with the
+             source's size and modification time.  Progress records are held
+             back until the destination has been flushed, and written at
+             most every SYNC_INTERVAL, so the journal never claims data that
+             is not on disk.
+Date: 2026-10-18
+*/
+
+#ifndef COPYJOURNAL_H
+#define COPYJOURNAL_H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/stat.h>
+
+class CopyJournal
+{
+public:
+    // An interrupted job found on disk.
+    struct Job
+    {
+        std::string journal;       // path of the journal file
+        std::string source;
+        std::string destination;
+        bool        move;
+        bool        overwrite;
+    };
+
+    CopyJournal();
+    virtual ~CopyJournal();
+
+    CopyJournal(const CopyJournal&) = delete;
+    CopyJournal& operator=(const CopyJournal&) = delete;
+
+    // Open the journal of copying 'source' to 'destination' in 'directory'
+    // (created if needed), loading what an earlier run of the same job
+    // recorded.  Returns false if no journal can be kept; the job then
+    // runs without one.
+    bool Open(const std::string& directory, const std::string& source,
+              const std::string& destination, bool move, bool overwrite);
+
+    // Whether an earlier run of the job left a journal in 'directory'.
+    static bool Exists(const std::string& directory, const std::string& source,
+                       const std::string& destination);
+
+    // Whether an earlier run of the job left its journal behind.
+    bool IsResuming() const { return m_resuming; }
+
+    // What the earlier run did, by path relative to the job's source (""
+    // for the source itself).  An entry counts as finished, or as copied
+    // up to an offset, only while the source keeps the size and
+    // modification time it had then.
+    bool          IsDone(const std::string& relative, const struct stat& source) const;
+    std::uint64_t ResumeOffset(const std::string& relative, const struct stat& source) const;
+
+    // Whether 'destination' is the entry an earlier run of this job
+    // created at 'relative' (same device and inode as recorded), so it may
+    // be continued or replaced even when the job does not overwrite.
+    bool IsLeftOver(const std::string& relative, const struct stat& destination) const;
+
+    // For moves: whether the copy half already completed, so only the
+    // source is left to delete.
+    bool WasCopied() const { return m_copied; }
+
+    // Records of this run.  Created() is written at once: it claims no
+    // data, and an entry whose record is lost is merely not reused.
+    void Created(const std::string& relative, const struct stat& destination);
+    void Reached(const std::string& relative, std::uint64_t offset, const struct stat& source);
+    void Done(const std::string& relative, const struct stat& source);
+    void Copied();
+
+    // Flush the destination, then write and flush the held-back records.
+    void Sync();
+
+    // Whether the journal is worth keeping after a failure.
+    bool HasProgress() const { return m_resuming || !m_pending.empty() || m_written; }
+
+    // The job finished (or recorded nothing): delete the journal.
+    void Remove();
+
+    // Unfinished jobs in 'directory', and dropping one without resuming.
+    static std::vector<Job> FindInterrupted(const std::string& directory);
+    static void             Discard(const std::string& journal);
+
+private:
+    // At most this long between flushes while records are coming in.
+    static constexpr std::chrono::seconds SYNC_INTERVAL{2};
+
+    struct Checkpoint
+    {
+        std::uint64_t size;       // source size and mtime at the time
+        std::int64_t  seconds;
+        long          nanoseconds;
+        std::uint64_t offset;     // bytes copied so far
+    };
+
+    struct Identity
+    {
+        std::uint64_t device;     // of an entry the job created
+        std::uint64_t inode;
+    };
+
+    int                                         m_fd;
+    int                                         m_destinationFd;   // for syncfs()
+    std::string                                 m_path;
+    bool                                        m_resuming;
+    bool                                        m_copied;
+    bool                                        m_written;         // records written this run
+    std::unordered_map<std::string, Checkpoint> m_done;
+    std::unordered_map<std::string, Checkpoint> m_partial;
+    std::unordered_map<std::string, Identity>   m_created;
+    std::string                                 m_pending;         // not yet safe to write
+    std::chrono::steady_clock::time_point       m_lastSync;
+
+    void Append(const std::string& record);
+    void Close();
+
+    // Parse the journal at 'path' into 'job' and this object's maps
+    // ('into' may be nullptr for the header only).  Returns the length of
+    // its complete lines, or -1 if it is not a journal.
+    static long Load(const std::string& path, Job& job, std::time_t& startTime, CopyJournal* into);
+
+    static std::string PathOf(const std::string& directory, const std::string& source,
+                              const std::string& destination);
+
+    // Tabs, newlines and backslashes in paths are escaped.
+    static std::string Escape(const std::string& text);
+    static std::string Unescape(const std::string& text);
+
+    static std::string Stamp(const struct stat& source);
+    static bool        Matches(const Checkpoint& checkpoint, const struct stat& source);
+};
+
+#endif // COPYJOURNAL_H
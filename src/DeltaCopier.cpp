@@ -0,0 +1,433 @@
+/*
+Author: Guo Jia
+Description: Implementation of DeltaCopier.  The algorithm is the classic
+             rsync one, run locally:
+               1. Signature: hash every full block of the basis with a weak
+                  rolling checksum and a strong 64-bit ContentHash.
+               2. Scan: slide a block-sized window over the source.  When
+                  the weak checksum hits the index and the strong hash
+                  agrees, the block is copied from the basis and the window
+                  jumps a whole block; otherwise it rolls one byte and the
+                  byte it leaves behind becomes literal data.
+             Run locally this is not cheaper in I/O than a plain copy: the
+             whole basis is hashed, the whole source is scanned, matched
+             blocks are read again from the basis, and the full file is
+             written out.  The literal/matched split only tells how much of
+             the file actually changed.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "DeltaCopier.h"
+#include "RollingChecksum.h"
+#include "ContentHash.h"
+#include "JobProgress.h"
+
+using namespace std;
+
+namespace
+{
+    const size_t MIN_BLOCK_SIZE = 4 * 1024;
+    const size_t MAX_BLOCK_SIZE = 1024 * 1024;
+    const size_t SCAN_CHUNK     = 4 * 1024 * 1024;   // source read size
+    const char*  TEMP_SUFFIX    = ".fmsync.tmp";
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: DeltaCopier
+Description: Creates a copier with no signature loaded.
+Parameters: None
+Return: None
+*/
+DeltaCopier::DeltaCopier()
+    : m_blockSize(MIN_BLOCK_SIZE),
+      m_blocks(),
+      m_index(),
+      m_copyBuffer(),
+      m_literalBytes(0),
+      m_matchedBytes(0)
+{
+}
+
+/*
+Function: ~DeltaCopier
+Description: Destructor.  Buffers are released by their containers.
+Parameters: None
+Return: None
+*/
+DeltaCopier::~DeltaCopier()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Public interface
+// ---------------------------------------------------------------------------
+
+/*
+Function: Update
+Description: Builds the basis signature, scans the source into a temporary
+             file beside the basis, flushes it, then atomically renames it
+             into place.  Without the flush a crash after the rename could
+             leave the new name pointing at unwritten data.
+Parameters: sourcePath - up-to-date file
+            basisPath  - stale file to be brought up to date
+            progress   - optional progress sink (advanced by source bytes)
+Return: true if the basis now matches the source
+*/
+bool DeltaCopier::Update(const string& sourcePath, const string& basisPath,
+                         JobProgress* progress)
+{
+    m_literalBytes = 0;
+    m_matchedBytes = 0;
+
+    int sourceFd = open(sourcePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd < 0)
+    {
+        return false;
+    }
+    int basisFd = open(basisPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (basisFd < 0)
+    {
+        close(sourceFd);
+        return false;
+    }
+
+    struct stat sourceInfo;
+    struct stat basisInfo;
+    if (fstat(sourceFd, &sourceInfo) != 0 || fstat(basisFd, &basisInfo) != 0)
+    {
+        close(sourceFd);
+        close(basisFd);
+        return false;
+    }
+
+    string tempPath = basisPath + TEMP_SUFFIX;
+    int outFd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                     sourceInfo.st_mode & 07777);
+    if (outFd < 0)
+    {
+        close(sourceFd);
+        close(basisFd);
+        return false;
+    }
+
+    bool ok = BuildSignature(basisFd, static_cast<uint64_t>(basisInfo.st_size), progress) &&
+              Scan(sourceFd, basisFd, outFd, progress);
+
+    ok = ok && fdatasync(outFd) == 0;
+    ok = (close(outFd) == 0) && ok;
+    close(sourceFd);
+    close(basisFd);
+
+    if (ok && rename(tempPath.c_str(), basisPath.c_str()) == 0)
+    {
+        return true;
+    }
+
+    unlink(tempPath.c_str());
+    return false;
+}
+
+/*
+Function: ChooseBlockSize
+Description: rsync's heuristic – sqrt(file size) balances signature size
+             against match granularity.  Rounded to 1 KiB and clamped.
+Parameters: fileSize - basis size in bytes
+Return: Block size in bytes
+*/
+size_t DeltaCopier::ChooseBlockSize(uint64_t fileSize)
+{
+    size_t size = static_cast<size_t>(sqrt(static_cast<double>(fileSize)));
+    size = (size + 1023) & ~static_cast<size_t>(1023);
+    return min(max(size, MIN_BLOCK_SIZE), MAX_BLOCK_SIZE);
+}
+
+// ---------------------------------------------------------------------------
+// Signature
+// ---------------------------------------------------------------------------
+
+/*
+Function: BuildSignature
+Description: Reads the basis block by block and records the weak and strong
+             hash of every full block.  A trailing partial block is left out;
+             any matching bytes there are simply sent as literals.
+Parameters: basisFd   - open basis file
+            basisSize - basis length in bytes
+            progress  - checked for cancellation
+Return: false on read error or cancellation
+*/
+bool DeltaCopier::BuildSignature(int basisFd, uint64_t basisSize, JobProgress* progress)
+{
+    m_blockSize = ChooseBlockSize(basisSize);
+    m_blocks.clear();
+    m_index.clear();
+    m_copyBuffer.assign(m_blockSize, 0);
+
+    uint64_t blockCount = basisSize / m_blockSize;
+    m_blocks.reserve(static_cast<size_t>(blockCount));
+
+    for (uint64_t i = 0; i < blockCount; ++i)
+    {
+        if (progress != nullptr && progress->IsCancelled())
+        {
+            return false;
+        }
+
+        uint64_t offset = i * m_blockSize;
+        ssize_t got = pread(basisFd, m_copyBuffer.data(), m_blockSize, static_cast<off_t>(offset));
+        if (got != static_cast<ssize_t>(m_blockSize))
+        {
+            return false;
+        }
+
+        Block block;
+        block.strong = ContentHash::Hash(m_copyBuffer.data(), m_blockSize);
+        block.offset = offset;
+
+        uint32_t weak = RollingChecksum::Compute(m_copyBuffer.data(), m_blockSize);
+        m_index[weak].push_back(m_blocks.size());
+        m_blocks.push_back(block);
+    }
+    return true;
+}
+
+/*
+Function: FindBlock
+Description: Looks the weak checksum up in the index and confirms a hit with
+             the strong hash, which is computed only when needed.
+Parameters: weak   - rolling checksum of the window
+            window - m_blockSize bytes of source data
+Return: Matching basis block, or nullptr
+*/
+const DeltaCopier::Block* DeltaCopier::FindBlock(uint32_t weak, const unsigned char* window) const
+{
+    auto found = m_index.find(weak);
+    if (found == m_index.end())
+    {
+        return nullptr;
+    }
+
+    uint64_t strong = ContentHash::Hash(window, m_blockSize);
+    for (size_t blockIndex : found->second)
+    {
+        if (m_blocks[blockIndex].strong == strong)
+        {
+            return &m_blocks[blockIndex];
+        }
+    }
+    return nullptr;
+}
+
+/*
+Function: CopyBlock
+Description: Appends one basis block to the output file.
+Parameters: basisFd - open basis file
+            block   - block to copy
+            outFd   - output file
+Return: true on success
+*/
+bool DeltaCopier::CopyBlock(int basisFd, const Block& block, int outFd)
+{
+    ssize_t got = pread(basisFd, m_copyBuffer.data(), m_blockSize, static_cast<off_t>(block.offset));
+    if (got != static_cast<ssize_t>(m_blockSize))
+    {
+        return false;
+    }
+    m_matchedBytes += m_blockSize;
+    return WriteAll(outFd, m_copyBuffer.data(), m_blockSize);
+}
+
+// ---------------------------------------------------------------------------
+// Scan
+// ---------------------------------------------------------------------------
+
+/*
+Function: Scan
+Description: Streams the source through a buffer of SCAN_CHUNK + one block.
+             [literalStart, start) is the pending literal run and
+             [start, start + blockSize) the current window.  Before the
+             buffer is compacted the pending literals are flushed, so the
+             buffer never has to grow.  The rolling checksum holds plain sums
+             and survives compaction unchanged.
+Parameters: sourceFd - open source file
+            basisFd  - open basis file
+            outFd    - output file
+            progress - optional progress/cancel sink
+Return: true if the whole source was reproduced in the output
+*/
+bool DeltaCopier::Scan(int sourceFd, int basisFd, int outFd, JobProgress* progress)
+{
+    const size_t blockSize = m_blockSize;
+    vector<unsigned char> buffer(SCAN_CHUNK + blockSize);
+
+    size_t start        = 0;
+    size_t end          = 0;
+    size_t literalStart = 0;
+    bool   eof          = false;
+    bool   haveWindow   = false;
+    RollingChecksum rolling;
+
+    while (true)
+    {
+        // Rolling needs the byte after the window, so refill while fewer
+        // than blockSize + 1 bytes are buffered.
+        if (end - start <= blockSize && !eof)
+        {
+            if (progress != nullptr)
+            {
+                if (progress->IsCancelled())
+                {
+                    return false;
+                }
+                progress->Advance(start);
+            }
+
+            if (!WriteAll(outFd, buffer.data() + literalStart, start - literalStart))
+            {
+                return false;
+            }
+            m_literalBytes += start - literalStart;
+
+            memmove(buffer.data(), buffer.data() + start, end - start);
+            end -= start;
+            start = 0;
+            literalStart = 0;
+
+            while (end < buffer.size())
+            {
+                ssize_t got = read(sourceFd, buffer.data() + end, buffer.size() - end);
+                if (got < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+                if (got == 0)
+                {
+                    eof = true;
+                    break;
+                }
+                end += static_cast<size_t>(got);
+            }
+            continue;
+        }
+
+        if (end - start < blockSize || m_blocks.empty())
+        {
+            break;   // tail shorter than a block, or nothing to match
+        }
+
+        if (!haveWindow)
+        {
+            rolling.Reset(buffer.data() + start, blockSize);
+            haveWindow = true;
+        }
+
+        const Block* match = FindBlock(rolling.Digest(), buffer.data() + start);
+        if (match != nullptr)
+        {
+            if (!WriteAll(outFd, buffer.data() + literalStart, start - literalStart) ||
+                !CopyBlock(basisFd, *match, outFd))
+            {
+                return false;
+            }
+            m_literalBytes += start - literalStart;
+            start += blockSize;
+            literalStart = start;
+            haveWindow = false;
+        }
+        else if (end - start > blockSize)
+        {
+            rolling.Roll(buffer[start], buffer[start + blockSize]);
+            ++start;
+        }
+        else
+        {
+            break;   // at EOF with exactly one unmatched window left
+        }
+    }
+
+    // Everything left (pending literals plus the unmatched tail).
+    if (!WriteAll(outFd, buffer.data() + literalStart, end - literalStart))
+    {
+        return false;
+    }
+    m_literalBytes += end - literalStart;
+
+    // Drain the rest of the source when matching stopped early (no blocks).
+    while (!eof)
+    {
+        ssize_t got = read(sourceFd, buffer.data(), buffer.size());
+        if (got < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (got < 0)
+        {
+            return false;
+        }
+        if (got == 0)
+        {
+            break;
+        }
+        if (!WriteAll(outFd, buffer.data(), static_cast<size_t>(got)))
+        {
+            return false;
+        }
+        m_literalBytes += static_cast<uint64_t>(got);
+        if (progress != nullptr)
+        {
+            if (progress->IsCancelled())
+            {
+                return false;
+            }
+            progress->Advance(static_cast<uint64_t>(got));
+        }
+    }
+
+    if (progress != nullptr)
+    {
+        progress->Advance(end);
+    }
+    return true;
+}
+
+/*
+Function: WriteAll
+Description: write() until every byte is out, retrying on EINTR and short
+             writes.
+Parameters: fd     - destination descriptor
+            data   - bytes to write
+            length - number of bytes
+Return: true if all bytes were written
+*/
+bool DeltaCopier::WriteAll(int fd, const unsigned char* data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fd, data, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data   += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+/*
+Author: Guo Jia
+Description: Declaration of DeltaCopier – brings an existing (basis) file up
+             to date with a source file rsync-style: the basis is split into
+             fixed blocks, the source is scanned with a rolling checksum, and
+             the new file is assembled from basis blocks plus the source
+             bytes that match none of them.
+Date: 2026-10-18
+*/
+
+#ifndef DELTACOPIER_H
+#define DELTACOPIER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class JobProgress;
+
+class DeltaCopier
+{
+public:
+    DeltaCopier();
+    virtual ~DeltaCopier();
+
+    // Rewrite basisPath so its contents equal sourcePath.  The new file is
+    // assembled next to the basis, flushed, and renamed over it, so a
+    // failure, cancellation or crash leaves the old basis untouched.
+    // progress may be null.  Returns true on success.
+    bool Update(const std::string& sourcePath, const std::string& basisPath,
+                JobProgress* progress);
+
+    // Statistics of the last Update(): bytes taken from the source versus
+    // bytes reused from the basis.
+    std::uint64_t GetLiteralBytes() const { return m_literalBytes; }
+    std::uint64_t GetMatchedBytes() const { return m_matchedBytes; }
+
+    // Block size used for a basis of the given size (about sqrt(size),
+    // clamped to a sensible range).
+    static std::size_t ChooseBlockSize(std::uint64_t fileSize);
+
+private:
+    struct Block
+    {
+        std::uint64_t strong;   // ContentHash of the block
+        std::uint64_t offset;   // block position in the basis
+    };
+
+    std::size_t                                           m_blockSize;
+    std::vector<Block>                                    m_blocks;
+    std::unordered_map<std::uint32_t, std::vector<std::size_t>> m_index;   // weak -> m_blocks
+    std::vector<unsigned char>                            m_copyBuffer;
+    std::uint64_t                                         m_literalBytes;
+    std::uint64_t                                         m_matchedBytes;
+
+    bool BuildSignature(int basisFd, std::uint64_t basisSize, JobProgress* progress);
+    const Block* FindBlock(std::uint32_t weak, const unsigned char* window) const;
+    bool CopyBlock(int basisFd, const Block& block, int outFd);
+    bool Scan(int sourceFd, int basisFd, int outFd, JobProgress* progress);
+
+    static bool WriteAll(int fd, const unsigned char* data, std::size_t length);
+};
+
+#endif // DELTACOPIER_H
@@ -0,0 +1,611 @@
+/*
+Author: Guo Jia
+Description: Implementation of DirectoryCompare.  The work runs in phases:
+               1. Scan   – parallel walk of both trees (one pool task per
+                           directory) recording each entry's stat tuple.
+               2. Sign   – bottom-up, every directory's signature becomes the
+                           hash of its own stat tuple and its children's
+                           names and signatures.
+               3. Resolve – top-down cache lookups over both trees at once.
+                           A pair of directories whose cached hashes agree
+                           is not descended into at all, and a hit on an
+                           unmatched directory supplies its whole subtree.
+               4. Hash   – only files still unknown are read, in parallel.
+               5. Aggregate/Diff – directory hashes are folded bottom-up and
+                           the two trees are diffed, pruning equal subtrees.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "DirectoryCompare.h"
+#include "ThreadPool.h"
+#include "JobProgress.h"
+#include "TreeHashCache.h"
+#include "ContentHash.h"
+
+using namespace std;
+
+namespace
+{
+    const uint64_t DIRECTORY_SEED = 0x4449524543544F52ULL;   // "DIRECTOR"
+    const uint64_t AGGREGATE_SEED = 0x4147475245474154ULL;   // "AGGREGAT"
+    const uint64_t SPECIAL_SEED   = 0x5350454349414C21ULL;   // "SPECIAL!"
+
+    // Batch many small files into one task; a big file gets its own.
+    const size_t   HASH_BATCH_FILES = 64;
+    const uint64_t HASH_BATCH_BYTES = 64ULL * 1024 * 1024;
+
+    int64_t MtimeNanoseconds(const struct stat& info)
+    {
+#ifdef __APPLE__
+        return static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+        return static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+#endif
+    }
+
+    string JoinPath(const string& directory, const string& name)
+    {
+        if (!directory.empty() && directory.back() == '/')
+        {
+            return directory + name;
+        }
+        return directory + "/" + name;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: DirectoryCompare
+Description: Stores the two roots and the shared cache and pool.
+Parameters: left  - first tree ("before")
+            right - second tree ("after")
+            cache - persistent signature -> hash cache
+            pool  - worker pool for scanning and hashing
+Return: None
+*/
+DirectoryCompare::DirectoryCompare(const string& left, const string& right,
+                                   TreeHashCache& cache, ThreadPool& pool)
+    : m_left(left),
+      m_right(right),
+      m_cache(cache),
+      m_pool(pool),
+      m_mutex(),
+      m_idle(),
+      m_pendingTasks(0),
+      m_scanFailed(false),
+      m_differences(),
+      m_filesHashed(0),
+      m_bytesHashed(0),
+      m_hashesReused(0)
+{
+}
+
+/*
+Function: ~DirectoryCompare
+Description: Destructor.  Run() waits for all of its tasks before returning.
+Parameters: None
+Return: None
+*/
+DirectoryCompare::~DirectoryCompare()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Driver
+// ---------------------------------------------------------------------------
+
+/*
+Function: Run
+Description: Executes all phases and leaves the sorted difference list in
+             m_differences.  The cache is saved afterwards so the next run
+             over mostly-unchanged trees only rehashes what changed.
+Parameters: progress - status/cancel sink (byte total set for the hash phase)
+Return: true if the comparison completed
+*/
+bool DirectoryCompare::Run(JobProgress& progress)
+{
+    m_differences.clear();
+    m_filesHashed  = 0;
+    m_bytesHashed  = 0;
+    m_hashesReused = 0;
+    m_scanFailed   = false;
+
+    progress.SetMessage("Loading hash cache");
+    m_cache.Load();
+
+    Node leftRoot{ "", true, 0, 0, 0, false, false, {} };
+    Node rightRoot{ "", true, 0, 0, 0, false, false, {} };
+
+    struct stat info;
+    if (stat(m_left.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+    {
+        return false;
+    }
+    leftRoot.signature = TreeHashCache::FileSignature(info.st_dev, info.st_ino, MtimeNanoseconds(info), info.st_size);
+    if (stat(m_right.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+    {
+        return false;
+    }
+    rightRoot.signature = TreeHashCache::FileSignature(info.st_dev, info.st_ino, MtimeNanoseconds(info), info.st_size);
+
+    // Phase 1: both walks share the pool, so they proceed side by side.
+    EnqueueScan(&leftRoot, m_left, progress);
+    EnqueueScan(&rightRoot, m_right, progress);
+    WaitForTasks();
+    if (m_scanFailed || progress.IsCancelled())
+    {
+        return false;
+    }
+
+    // Phases 2 and 3.
+    progress.SetMessage("Checking cache");
+    ComputeSignature(&leftRoot);
+    ComputeSignature(&rightRoot);
+
+    vector<HashJob> jobs;
+    ResolvePair(&leftRoot, m_left, &rightRoot, m_right, jobs);
+
+    // Phase 4.
+    if (!HashFiles(jobs, progress))
+    {
+        return false;
+    }
+
+    // Phase 5.
+    AggregateHash(&leftRoot);
+    AggregateHash(&rightRoot);
+    Diff(leftRoot, rightRoot, "");
+
+    sort(m_differences.begin(), m_differences.end(),
+         [](const Difference& a, const Difference& b) { return a.relativePath < b.relativePath; });
+
+    progress.SetMessage("Saving hash cache");
+    m_cache.Save();
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Phase 1: parallel scan
+// ---------------------------------------------------------------------------
+
+/*
+Function: EnqueueScan
+Description: Counts a pending directory and queues its scan on the pool.
+Parameters: node     - directory node to fill
+            path     - its full path
+            progress - status/cancel sink
+Return: None
+*/
+void DirectoryCompare::EnqueueScan(Node* node, const string& path, JobProgress& progress)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        ++m_pendingTasks;
+    }
+
+    m_pool.Submit([this, node, path, &progress]()
+    {
+        try
+        {
+            ScanDirectory(node, path, progress);
+        }
+        catch (const exception&)
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_scanFailed = true;
+        }
+
+        lock_guard<mutex> lock(m_mutex);
+        if (--m_pendingTasks == 0)
+        {
+            m_idle.notify_all();
+        }
+    });
+}
+
+/*
+Function: ScanDirectory
+Description: Lists one directory with readdir + fstatat (relative to the
+             open directory, so no path is re-resolved per entry) and
+             creates a child node per entry.  Symlink targets and special
+             files are hashed on the spot since that needs no file reads.
+             Subdirectories are queued as separate tasks.  A subdirectory
+             that cannot be opened is treated as empty rather than failing
+             the whole comparison; only unreadable roots are fatal.
+Parameters: node     - directory node to fill
+            path     - its full path
+            progress - status/cancel sink
+Return: None
+*/
+void DirectoryCompare::ScanDirectory(Node* node, const string& path, JobProgress& progress)
+{
+    if (progress.IsCancelled())
+    {
+        return;
+    }
+    progress.SetMessage("Scanning " + path);
+
+    DIR* directory = opendir(path.c_str());
+    if (directory == nullptr)
+    {
+        if (path == m_left || path == m_right)
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_scanFailed = true;
+        }
+        return;
+    }
+    int directoryFd = dirfd(directory);
+
+    while (struct dirent* entry = readdir(directory))
+    {
+        string name = entry->d_name;
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+
+        struct stat info;
+        if (fstatat(directoryFd, entry->d_name, &info, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+            continue;   // vanished between readdir and stat
+        }
+
+        unique_ptr<Node> child(new Node{ name, S_ISDIR(info.st_mode), static_cast<uint64_t>(info.st_size),
+                                         TreeHashCache::FileSignature(info.st_dev, info.st_ino,
+                                                                      MtimeNanoseconds(info), info.st_size),
+                                         0, false, false, {} });
+
+        if (S_ISLNK(info.st_mode))
+        {
+            char target[4096];
+            ssize_t length = readlinkat(directoryFd, entry->d_name, target, sizeof(target));
+            child->hash = ContentHash::Hash(target, length > 0 ? static_cast<size_t>(length) : 0, SPECIAL_SEED);
+            child->hashKnown = true;
+        }
+        else if (!S_ISDIR(info.st_mode) && !S_ISREG(info.st_mode))
+        {
+            uint64_t type = static_cast<uint64_t>(info.st_mode & S_IFMT);
+            child->hash = ContentHash::Hash(&type, sizeof(type), SPECIAL_SEED);
+            child->hashKnown = true;
+        }
+
+        node->children.push_back(move(child));
+    }
+    closedir(directory);
+
+    sort(node->children.begin(), node->children.end(),
+         [](const unique_ptr<Node>& a, const unique_ptr<Node>& b) { return a->name < b->name; });
+
+    for (const unique_ptr<Node>& child : node->children)
+    {
+        if (child->isDirectory)
+        {
+            EnqueueScan(child.get(), JoinPath(path, child->name), progress);
+        }
+    }
+}
+
+/*
+Function: WaitForTasks
+Description: Blocks until every queued scan task has finished.
+Parameters: None
+Return: None
+*/
+void DirectoryCompare::WaitForTasks()
+{
+    unique_lock<mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_pendingTasks == 0; });
+}
+
+// ---------------------------------------------------------------------------
+// Phases 2-4: signatures, cache, hashing
+// ---------------------------------------------------------------------------
+
+/*
+Function: ComputeSignature
+Description: Post-order pass turning each directory's own stat signature
+             into a subtree signature.  Any change anywhere below (content,
+             rename, add, delete) alters some stat tuple on the path up to
+             here, so an equal subtree signature means an unchanged subtree.
+Parameters: node - subtree root
+Return: None
+*/
+void DirectoryCompare::ComputeSignature(Node* node)
+{
+    if (!node->isDirectory)
+    {
+        return;
+    }
+
+    ContentHash signature(DIRECTORY_SEED);
+    signature.Update(&node->signature, sizeof(node->signature));
+    for (const unique_ptr<Node>& child : node->children)
+    {
+        ComputeSignature(child.get());
+        signature.Update(child->name.c_str(), child->name.size() + 1);   // include the NUL as separator
+        signature.Update(&child->signature, sizeof(child->signature));
+    }
+    node->signature = signature.Digest();
+}
+
+/*
+Function: ResolvePair
+Description: Resolves two nodes at the same relative path.  If both hashes
+             come from the cache and agree, the subtrees are identical and
+             nothing below them is needed.  Otherwise matching children are
+             resolved pairwise (Diff will descend into them) and unmatched
+             children on their own.
+Parameters: left      - node in the left tree
+            leftPath  - its full path
+            right     - node at the same relative path in the right tree
+            rightPath - its full path
+            jobs      - receives the files that still need reading
+Return: None
+*/
+void DirectoryCompare::ResolvePair(Node* left, const string& leftPath,
+                                   Node* right, const string& rightPath, vector<HashJob>& jobs)
+{
+    left->visited  = true;
+    right->visited = true;
+    LookupCache(left);
+    LookupCache(right);
+
+    if (left->hashKnown && right->hashKnown && left->hash == right->hash)
+    {
+        return;
+    }
+
+    if (!left->isDirectory || !right->isDirectory)
+    {
+        ResolveSingle(left, leftPath, jobs);
+        ResolveSingle(right, rightPath, jobs);
+        return;
+    }
+
+    size_t l = 0;
+    size_t r = 0;
+    while (l < left->children.size() || r < right->children.size())
+    {
+        Node* leftChild  = l < left->children.size()  ? left->children[l].get()  : nullptr;
+        Node* rightChild = r < right->children.size() ? right->children[r].get() : nullptr;
+
+        if (rightChild == nullptr || (leftChild != nullptr && leftChild->name < rightChild->name))
+        {
+            ResolveSingle(leftChild, JoinPath(leftPath, leftChild->name), jobs);
+            ++l;
+        }
+        else if (leftChild == nullptr || rightChild->name < leftChild->name)
+        {
+            ResolveSingle(rightChild, JoinPath(rightPath, rightChild->name), jobs);
+            ++r;
+        }
+        else
+        {
+            ResolvePair(leftChild, JoinPath(leftPath, leftChild->name),
+                        rightChild, JoinPath(rightPath, rightChild->name), jobs);
+            ++l;
+            ++r;
+        }
+    }
+}
+
+/*
+Function: ResolveSingle
+Description: Makes sure one node's hash will be known.  A cache hit on a
+             directory stops the descent – the whole subtree is known.
+             Regular files that miss are queued for hashing.
+Parameters: node - subtree root
+            path - its full path
+            jobs - receives the files that still need reading
+Return: None
+*/
+void DirectoryCompare::ResolveSingle(Node* node, const string& path, vector<HashJob>& jobs)
+{
+    node->visited = true;
+    LookupCache(node);
+    if (node->hashKnown)
+    {
+        return;
+    }
+
+    if (node->isDirectory)
+    {
+        for (const unique_ptr<Node>& child : node->children)
+        {
+            ResolveSingle(child.get(), JoinPath(path, child->name), jobs);
+        }
+    }
+    else
+    {
+        jobs.emplace_back(node, path);
+    }
+}
+
+/*
+Function: LookupCache
+Description: Fills in a node's hash from the cache if it is not known yet.
+Parameters: node - node to look up
+Return: None
+*/
+void DirectoryCompare::LookupCache(Node* node)
+{
+    if (!node->hashKnown && m_cache.Lookup(node->signature, node->hash))
+    {
+        node->hashKnown = true;
+        ++m_hashesReused;
+    }
+}
+
+/*
+Function: HashFiles
+Description: Reads and hashes the uncached files on the pool, batching small
+             files to keep task overhead low.  New hashes go into the cache.
+             An unreadable file gets a hash derived from its signature so it
+             compares as different without poisoning the cache.
+Parameters: jobs     - files to hash
+            progress - byte progress / cancel sink
+Return: false if cancelled
+*/
+bool DirectoryCompare::HashFiles(vector<HashJob>& jobs, JobProgress& progress)
+{
+    uint64_t totalBytes = 0;
+    for (const HashJob& job : jobs)
+    {
+        totalBytes += job.first->size;
+    }
+    progress.SetTotal(totalBytes);
+    progress.SetMessage("Hashing " + to_string(jobs.size()) + " file(s)");
+
+    vector<future<void>> batches;
+    size_t batchStart = 0;
+    while (batchStart < jobs.size())
+    {
+        size_t   batchEnd   = batchStart;
+        uint64_t batchBytes = 0;
+        while (batchEnd < jobs.size() && batchEnd - batchStart < HASH_BATCH_FILES &&
+               (batchBytes == 0 || batchBytes + jobs[batchEnd].first->size <= HASH_BATCH_BYTES))
+        {
+            batchBytes += jobs[batchEnd].first->size;
+            ++batchEnd;
+        }
+
+        batches.push_back(m_pool.Submit([this, &jobs, batchStart, batchEnd, &progress]()
+        {
+            for (size_t i = batchStart; i < batchEnd && !progress.IsCancelled(); ++i)
+            {
+                Node* node = jobs[i].first;
+                if (ContentHash::HashFile(jobs[i].second, node->hash))
+                {
+                    m_cache.Store(node->signature, node->hash);
+                }
+                else
+                {
+                    node->hash = node->signature ^ SPECIAL_SEED;
+                }
+                node->hashKnown = true;
+                progress.Advance(node->size);
+            }
+        }));
+        batchStart = batchEnd;
+    }
+
+    for (future<void>& batch : batches)
+    {
+        batch.get();
+    }
+
+    m_filesHashed = jobs.size();
+    m_bytesHashed = totalBytes;
+    return !progress.IsCancelled();
+}
+
+/*
+Function: AggregateHash
+Description: Folds child hashes into a directory hash (names and types
+             included, so renames show up) and caches it under the subtree
+             signature.  Visited children are always processed, because a
+             directory known from the cache may still have children that
+             Diff will look at.  A directory that was unknown had all of its
+             children visited, so its fold never sees a missing hash.
+Parameters: node - subtree root
+Return: None
+*/
+void DirectoryCompare::AggregateHash(Node* node)
+{
+    if (!node->isDirectory)
+    {
+        return;
+    }
+
+    for (const unique_ptr<Node>& child : node->children)
+    {
+        if (child->visited)
+        {
+            AggregateHash(child.get());
+        }
+    }
+
+    if (node->hashKnown)
+    {
+        return;
+    }
+
+    ContentHash aggregate(AGGREGATE_SEED);
+    for (const unique_ptr<Node>& child : node->children)
+    {
+        unsigned char type = child->isDirectory ? 1 : 0;
+        aggregate.Update(child->name.c_str(), child->name.size() + 1);
+        aggregate.Update(&type, sizeof(type));
+        aggregate.Update(&child->hash, sizeof(child->hash));
+    }
+
+    node->hash = aggregate.Digest();
+    node->hashKnown = true;
+    m_cache.Store(node->signature, node->hash);
+}
+
+// ---------------------------------------------------------------------------
+// Phase 5: diff
+// ---------------------------------------------------------------------------
+
+/*
+Function: Diff
+Description: Merges the two sorted child lists.  Subtrees whose aggregate
+             hashes match are skipped without descending, which is what
+             makes comparing two mostly-identical trees cheap.
+Parameters: left         - node from the left tree
+            right        - node at the same relative path in the right tree
+            relativePath - that path
+Return: None
+*/
+void DirectoryCompare::Diff(const Node& left, const Node& right, const string& relativePath)
+{
+    if (left.hash == right.hash)
+    {
+        return;
+    }
+
+    size_t l = 0;
+    size_t r = 0;
+    while (l < left.children.size() || r < right.children.size())
+    {
+        const Node* leftChild  = l < left.children.size()  ? left.children[l].get()  : nullptr;
+        const Node* rightChild = r < right.children.size() ? right.children[r].get() : nullptr;
+
+        if (rightChild == nullptr || (leftChild != nullptr && leftChild->name < rightChild->name))
+        {
+            m_differences.push_back({ relativePath + leftChild->name, Change::Removed, leftChild->isDirectory });
+            ++l;
+        }
+        else if (leftChild == nullptr || rightChild->name < leftChild->name)
+        {
+            m_differences.push_back({ relativePath + rightChild->name, Change::Added, rightChild->isDirectory });
+            ++r;
+        }
+        else
+        {
+            string childPath = relativePath + leftChild->name;
+            if (leftChild->isDirectory && rightChild->isDirectory)
+            {
+                Diff(*leftChild, *rightChild, childPath + "/");
+            }
+            else if (leftChild->isDirectory != rightChild->isDirectory || leftChild->hash != rightChild->hash)
+            {
+                m_differences.push_back({ childPath, Change::Changed, rightChild->isDirectory });
+            }
+            ++l;
+            ++r;
+        }
+    }
+}
@@ -0,0 +1,349 @@
+/*
+Author: Guo Jia
+Description: Implementation of DirectoryHistory.  The file holds one folder
+             per line as "rank<TAB>last visit<TAB>path", written to a
+             temporary file and renamed so a crash never leaves a torn
+             history behind.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include "DirectoryHistory.h"
+
+using namespace std;
+
+namespace
+{
+    const int64_t HOUR = 3600;
+    const int64_t DAY  = 24 * HOUR;
+    const int64_t WEEK = 7 * DAY;
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: DirectoryHistory
+Description: Creates an empty history bound to a storage file.  Nothing is
+             read until Load() is called.
+Parameters: storagePath - history file location
+Return: None
+*/
+DirectoryHistory::DirectoryHistory(const string& storagePath)
+    : m_storagePath(storagePath),
+      m_entries(),
+      m_index(),
+      m_totalRank(0)
+{
+}
+
+/*
+Function: ~DirectoryHistory
+Description: Destructor.  Does not save; the owner calls Save().
+Parameters: None
+Return: None
+*/
+DirectoryHistory::~DirectoryHistory()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Persistence
+// ---------------------------------------------------------------------------
+
+/*
+Function: Load
+Description: Replaces the history with the file's.  Malformed lines are
+             skipped, lines for the same folder spelled differently (from
+             before paths were normalised) are merged, and a file grown
+             past the limits is aged and trimmed as if it had been built up
+             in this session.
+Parameters: None
+Return: false if the file exists but could not be read
+*/
+bool DirectoryHistory::Load()
+{
+    m_entries.clear();
+    m_index.clear();
+    m_totalRank = 0;
+
+    ifstream in(m_storagePath);
+    if (!in)
+    {
+        return true;
+    }
+
+    string line;
+    while (getline(in, line))
+    {
+        size_t firstTab  = line.find('\t');
+        size_t secondTab = firstTab == string::npos ? string::npos : line.find('\t', firstTab + 1);
+        if (secondTab == string::npos || secondTab + 1 == line.size())
+        {
+            continue;
+        }
+
+        Entry entry;
+        entry.rank      = strtod(line.c_str(), nullptr);
+        entry.lastVisit = strtoll(line.c_str() + firstTab + 1, nullptr, 10);
+        entry.path      = Normalise(line.substr(secondTab + 1));
+        if (entry.rank <= 0)
+        {
+            continue;
+        }
+        auto found = m_index.find(entry.path);
+        if (found != m_index.end())
+        {
+            Entry& existing = m_entries[found->second];
+            existing.rank      += entry.rank;
+            existing.lastVisit  = max(existing.lastVisit, entry.lastVisit);
+            m_totalRank        += entry.rank;
+            continue;
+        }
+        m_index.emplace(entry.path, m_entries.size());
+        m_totalRank += entry.rank;
+        m_entries.push_back(move(entry));
+    }
+    if (in.bad())
+    {
+        return false;
+    }
+
+    int64_t newest = 0;
+    for (const Entry& entry : m_entries)
+    {
+        newest = max(newest, entry.lastVisit);
+    }
+    Age(newest);
+    Trim(newest);
+    return true;
+}
+
+/*
+Function: Save
+Description: Writes the history atomically.
+Parameters: None
+Return: true if the file was written
+*/
+bool DirectoryHistory::Save() const
+{
+    string tempPath = m_storagePath + ".tmp";
+    {
+        ofstream out(tempPath, ios::trunc);
+        char number[64];
+        for (const Entry& entry : m_entries)
+        {
+            snprintf(number, sizeof(number), "%.3f\t%lld\t", entry.rank,
+                     static_cast<long long>(entry.lastVisit));
+            out << number << entry.path << '\n';
+        }
+        if (!out)
+        {
+            return false;
+        }
+    }
+    return rename(tempPath.c_str(), m_storagePath.c_str()) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Visits
+// ---------------------------------------------------------------------------
+
+/*
+Function: Record
+Description: Adds one to the folder's rank and stamps the visit, adding
+             the folder if it is new.  Paths with a line break cannot be
+             stored and are ignored.
+Parameters: visited - folder visited
+            now     - time of the visit
+Return: None
+*/
+void DirectoryHistory::Record(const string& visited, int64_t now)
+{
+    string path = Normalise(visited);
+    if (path.empty() || path.find('\n') != string::npos)
+    {
+        return;
+    }
+
+    auto found = m_index.find(path);
+    if (found == m_index.end())
+    {
+        m_index.emplace(path, m_entries.size());
+        m_entries.push_back(Entry{ path, 1.0, now });
+    }
+    else
+    {
+        Entry& entry = m_entries[found->second];
+        entry.rank     += 1.0;
+        entry.lastVisit = now;
+    }
+    m_totalRank += 1.0;
+
+    Age(now);
+    Trim(now);
+}
+
+/*
+Function: Remove
+Description: Forgets a folder.  The last entry takes its place.
+Parameters: path - folder to forget
+Return: None
+*/
+void DirectoryHistory::Remove(const string& path)
+{
+    auto found = m_index.find(Normalise(path));
+    if (found == m_index.end())
+    {
+        return;
+    }
+    size_t position = found->second;
+    m_totalRank -= m_entries[position].rank;
+    m_index.erase(found);
+
+    if (position + 1 != m_entries.size())
+    {
+        m_entries[position] = move(m_entries.back());
+        m_index[m_entries[position].path] = position;
+    }
+    m_entries.pop_back();
+}
+
+/*
+Function: Normalise
+Description: Rebuilds the path from its non-empty components other than
+             ".", keeping a leading separator.  The root stays "/".
+Parameters: path - folder path as typed or listed
+Return: The normalised path ("" stays "")
+*/
+string DirectoryHistory::Normalise(const string& path)
+{
+    string normalised;
+    if (!path.empty() && path[0] == '/')
+    {
+        normalised = "/";
+    }
+    size_t start = 0;
+    while (start < path.size())
+    {
+        size_t end = path.find('/', start);
+        if (end == string::npos)
+        {
+            end = path.size();
+        }
+        if (end > start && path.compare(start, end - start, ".") != 0)
+        {
+            if (!normalised.empty() && normalised.back() != '/')
+            {
+                normalised += '/';
+            }
+            normalised.append(path, start, end - start);
+        }
+        start = end + 1;
+    }
+    return normalised;
+}
+
+/*
+Function: Frecency
+Description: The rank, four times over within the hour of the visit, twice
+             within the day, halved within the week and quartered after.
+Parameters: entry - the folder
+            now   - current time
+Return: The score; higher is better
+*/
+double DirectoryHistory::Frecency(const Entry& entry, int64_t now)
+{
+    int64_t age = now - entry.lastVisit;
+    if (age < HOUR)
+    {
+        return entry.rank * 4.0;
+    }
+    if (age < DAY)
+    {
+        return entry.rank * 2.0;
+    }
+    if (age < WEEK)
+    {
+        return entry.rank * 0.5;
+    }
+    return entry.rank * 0.25;
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: Age
+Description: Once the ranks add up to more than MAX_TOTAL_RANK, scales
+             them all so they add up to 90% of it and drops those left
+             below MIN_RANK, unless visited within the day.  Relative order
+             is kept; folders visited once long ago fade out.
+Parameters: now - current time
+Return: None
+*/
+void DirectoryHistory::Age(int64_t now)
+{
+    if (m_totalRank <= MAX_TOTAL_RANK)
+    {
+        return;
+    }
+
+    double factor = 0.9 * MAX_TOTAL_RANK / m_totalRank;
+    auto   faded  = [now](const Entry& entry) { return entry.rank < MIN_RANK && now - entry.lastVisit >= DAY; };
+    m_totalRank = 0;
+    for (Entry& entry : m_entries)
+    {
+        entry.rank  *= factor;
+        m_totalRank += faded(entry) ? 0 : entry.rank;
+    }
+    m_entries.erase(remove_if(m_entries.begin(), m_entries.end(), faded), m_entries.end());
+    Reindex();
+}
+
+/*
+Function: Trim
+Description: Past MAX_ENTRIES folders, drops the least frecent tenth.
+Parameters: now - current time, for the frecency
+Return: None
+*/
+void DirectoryHistory::Trim(int64_t now)
+{
+    if (m_entries.size() <= MAX_ENTRIES)
+    {
+        return;
+    }
+
+    size_t keep = MAX_ENTRIES - MAX_ENTRIES / 10;
+    nth_element(m_entries.begin(), m_entries.begin() + static_cast<ptrdiff_t>(keep), m_entries.end(),
+                [now](const Entry& a, const Entry& b) { return Frecency(a, now) > Frecency(b, now); });
+    m_entries.resize(keep);
+
+    m_totalRank = 0;
+    for (const Entry& entry : m_entries)
+    {
+        m_totalRank += entry.rank;
+    }
+    Reindex();
+}
+
+/*
+Function: Reindex
+Description: Rebuilds the path index after entries moved.
+Parameters: None
+Return: None
+*/
+void DirectoryHistory::Reindex()
+{
+    m_index.clear();
+    m_index.reserve(m_entries.size());
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        m_index.emplace(m_entries[i].path, i);
+    }
+}
@@ -0,0 +1,80 @@
+/*
+Author: Guo Jia
+Description: Declaration of DirectoryHistory – every folder the user has
+             opened, with a visit rank and the time of the last visit, kept
+             between sessions.  Folders are ordered by "frecency": the rank
+             weighted by how recently the folder was visited, so both
+             favourite and current folders come first.  When the ranks add
+             up to too much they are all scaled down and folders that have
+             faded out are forgotten.  Not thread-safe; used on the GUI
+             thread only.
+Date: 2026-10-18
+*/
+
+#ifndef DIRECTORYHISTORY_H
+#define DIRECTORYHISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class DirectoryHistory
+{
+public:
+    struct Entry
+    {
+        std::string  path;
+        double       rank;        // visits, aged
+        std::int64_t lastVisit;   // seconds since the epoch
+    };
+
+    // storagePath is where Load()/Save() keep the history between sessions.
+    explicit DirectoryHistory(const std::string& storagePath);
+    virtual ~DirectoryHistory();
+
+    // Read the history file (a missing file is an empty history) and write
+    // it back.  Both return false on I/O errors.
+    bool Load();
+    bool Save() const;
+
+    // Count a visit to 'path' at time 'now'.  Paths are normalised first
+    // (see Normalise()), so spellings of one folder share an entry.
+    void Record(const std::string& path, std::int64_t now);
+
+    // Forget a folder, e.g. one that no longer exists.
+    void Remove(const std::string& path);
+
+    // All folders, in no particular order.
+    const std::vector<Entry>& GetEntries() const { return m_entries; }
+
+    // A folder's score at time 'now'.
+    static double Frecency(const Entry& entry, std::int64_t now);
+
+    // 'path' with repeated separators, "." components and trailing
+    // separators removed: "/a//./b/" becomes "/a/b".  ".." is kept, since
+    // it cannot be resolved without following symbolic links.
+    static std::string Normalise(const std::string& path);
+
+private:
+    // Past this total rank every rank is scaled down so the total is 90%
+    // of it; entries left below MIN_RANK and not visited today are
+    // dropped.
+    static constexpr double MAX_TOTAL_RANK = 1000000.0;
+    static constexpr double MIN_RANK       = 1.0;
+
+    // Past this many folders the least frecent tenth is dropped.
+    static constexpr std::size_t MAX_ENTRIES = 100000;
+
+    std::string                                  m_storagePath;
+    std::vector<Entry>                           m_entries;
+    std::unordered_map<std::string, std::size_t> m_index;       // path -> position in m_entries
+    double                                       m_totalRank;
+
+    void Age(std::int64_t now);
+    void Trim(std::int64_t now);
+    void Reindex();
+};
+
+#endif // DIRECTORYHISTORY_H
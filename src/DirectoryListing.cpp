@@ -0,0 +1,283 @@
+/*
+Author: Guo Jia
+Description: Implementation of DirectoryListing.  Enumeration goes through
+             FileSystemBackend; on local disks that is readdir plus one
+             fstatat per entry relative to the open directory – the old
+             wxFileName-based code stat'ed every entry three or four times by
+             full path.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "DirectoryListing.h"
+#include "FileSystemBackend.h"
+
+using namespace std;
+
+namespace
+{
+    const char SNAPSHOT_MAGIC[8] = { 'F', 'M', 'S', 'N', 'A', 'P', '0', '2' };
+
+    template <typename T>
+    void WriteValue(ostream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    bool ReadValue(istream& in, T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: DirectoryListing
+Description: Creates an empty listing with no path.
+Parameters: None
+Return: None
+*/
+DirectoryListing::DirectoryListing()
+    : m_path(""),
+      m_entries(),
+      m_virtual(false)
+{
+}
+
+/*
+Function: ~DirectoryListing
+Description: Destructor.  No resources to release.
+Parameters: None
+Return: None
+*/
+DirectoryListing::~DirectoryListing()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Enumeration
+// ---------------------------------------------------------------------------
+
+/*
+Function: Load
+Description: Reads every entry of a directory (hidden ones included, '.'
+             and '..' excluded) through the current FileSystemBackend.
+             Symlinks are followed like the old wxFileName checks did, so a
+             link to a folder lists as a folder.
+Parameters: path - directory to enumerate
+Return: true if the directory was read
+*/
+bool DirectoryListing::Load(const string& path)
+{
+    vector<Entry> entries;
+    if (!FileSystemBackend::Current().Enumerate(path, entries))
+    {
+        return false;
+    }
+
+    sort(entries.begin(), entries.end(),
+         [](const Entry& a, const Entry& b) { return a.name < b.name; });
+
+    m_path    = path;
+    m_virtual = false;
+    m_entries.swap(entries);
+    return true;
+}
+
+/*
+Function: SetEntries
+Description: Installs entries produced elsewhere, sorted by name like
+             Load() leaves them.
+Parameters: path    - path the entries are shown under
+            entries - the entries
+Return: None
+*/
+void DirectoryListing::SetEntries(const string& path, vector<Entry> entries)
+{
+    sort(entries.begin(), entries.end(),
+         [](const Entry& a, const Entry& b) { return a.name < b.name; });
+
+    m_path    = path;
+    m_virtual = true;
+    m_entries.swap(entries);
+}
+
+/*
+Function: Find
+Description: Binary search for an entry by name.
+Parameters: name - entry name
+Return: Index of the entry, or -1 if absent
+*/
+long DirectoryListing::Find(const string& name) const
+{
+    auto found = lower_bound(m_entries.begin(), m_entries.end(), name,
+                             [](const Entry& entry, const string& key) { return entry.name < key; });
+    if (found == m_entries.end() || found->name != name)
+    {
+        return -1;
+    }
+    return static_cast<long>(found - m_entries.begin());
+}
+
+/*
+Function: CountChanges
+Description: Merges the two sorted listings and counts entries that were
+             added, removed, or whose type, size, mtime or inode differ.
+Parameters: other - the newer listing
+Return: Number of changed entries
+*/
+size_t DirectoryListing::CountChanges(const DirectoryListing& other) const
+{
+    size_t changes = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < m_entries.size() && j < other.m_entries.size())
+    {
+        const Entry& before = m_entries[i];
+        const Entry& after  = other.m_entries[j];
+        if (before.name < after.name)
+        {
+            ++changes;
+            ++i;
+        }
+        else if (after.name < before.name)
+        {
+            ++changes;
+            ++j;
+        }
+        else
+        {
+            if (before.isDirectory != after.isDirectory || before.size != after.size ||
+                before.modified != after.modified || before.inode != after.inode)
+            {
+                ++changes;
+            }
+            ++i;
+            ++j;
+        }
+    }
+    return changes + (m_entries.size() - i) + (other.m_entries.size() - j);
+}
+
+// ---------------------------------------------------------------------------
+// Snapshot persistence
+// ---------------------------------------------------------------------------
+
+/*
+Function: SaveSnapshot
+Description: Serialises the listing as magic, path, count, then one fixed
+             header (flags, size, mtime, device, inode, name length) plus name
+             per entry.
+             The file is built in memory and written via a temporary file
+             and rename, so a crash leaves the previous snapshot intact.
+Parameters: file       - snapshot file path
+            maxEntries - cap on the number of entries written
+Return: true if the snapshot was written
+*/
+bool DirectoryListing::SaveSnapshot(const string& file, size_t maxEntries) const
+{
+    ostringstream buffer;
+    uint32_t pathLength = static_cast<uint32_t>(m_path.size());
+    uint32_t count      = static_cast<uint32_t>(min(m_entries.size(), maxEntries));
+
+    buffer.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    WriteValue(buffer, pathLength);
+    buffer.write(m_path.data(), pathLength);
+    WriteValue(buffer, count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const Entry& entry = m_entries[i];
+        uint8_t  flags      = entry.isDirectory ? 1 : 0;
+        uint16_t nameLength = static_cast<uint16_t>(min<size_t>(entry.name.size(), 0xFFFF));
+        WriteValue(buffer, flags);
+        WriteValue(buffer, entry.size);
+        WriteValue(buffer, entry.modified);
+        WriteValue(buffer, entry.device);
+        WriteValue(buffer, entry.inode);
+        WriteValue(buffer, nameLength);
+        buffer.write(entry.name.data(), nameLength);
+    }
+
+    string tempFile = file + ".tmp";
+    {
+        ofstream out(tempFile, ios::binary | ios::trunc);
+        string data = buffer.str();
+        out.write(data.data(), static_cast<streamsize>(data.size()));
+        if (!out)
+        {
+            return false;
+        }
+    }
+    return rename(tempFile.c_str(), file.c_str()) == 0;
+}
+
+/*
+Function: LoadSnapshot
+Description: Reads a snapshot written by SaveSnapshot().  The whole file is
+             read in one go; any truncation or bad magic rejects it and
+             leaves the listing unchanged.
+Parameters: file - snapshot file path
+Return: true if a valid snapshot was loaded
+*/
+bool DirectoryListing::LoadSnapshot(const string& file)
+{
+    ifstream in(file, ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+    stringstream buffer;
+    buffer << in.rdbuf();
+
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    uint32_t pathLength = 0;
+    if (!buffer.read(magic, sizeof(magic)) || memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 ||
+        !ReadValue(buffer, pathLength))
+    {
+        return false;
+    }
+
+    string path(pathLength, '\0');
+    uint32_t count = 0;
+    if (!buffer.read(&path[0], pathLength) || !ReadValue(buffer, count))
+    {
+        return false;
+    }
+
+    vector<Entry> entries;
+    entries.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint8_t  flags      = 0;
+        uint16_t nameLength = 0;
+        Entry entry;
+        if (!ReadValue(buffer, flags) || !ReadValue(buffer, entry.size) ||
+            !ReadValue(buffer, entry.modified) || !ReadValue(buffer, entry.device) ||
+            !ReadValue(buffer, entry.inode) || !ReadValue(buffer, nameLength))
+        {
+            return false;
+        }
+        entry.name.resize(nameLength);
+        if (!buffer.read(&entry.name[0], nameLength))
+        {
+            return false;
+        }
+        entry.isDirectory = (flags & 1) != 0;
+        entries.push_back(move(entry));
+    }
+
+    m_path    = path;
+    m_virtual = false;
+    m_entries.swap(entries);
+    return true;
+}
@@ -0,0 +1,67 @@
+/*
+Author: Guo Jia
+Description: Declaration of DirectoryListing – the sorted contents of one
+             directory (name, type, size, mtime, identity) as plain data,
+             independent of any widget.  Can be produced off the GUI thread
+             and saved to / restored from a compact snapshot file.
+Date: 2026-10-18
+*/
+
+#ifndef DIRECTORYLISTING_H
+#define DIRECTORYLISTING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class DirectoryListing
+{
+public:
+    struct Entry
+    {
+        std::string   name;
+        bool          isDirectory;
+        std::uint64_t size;       // bytes; 0 for directories
+        std::int64_t  modified;   // seconds since the epoch
+        std::uint64_t device;     // st_dev and st_ino: with 'modified' they
+        std::uint64_t inode;      // identify this version of the file
+    };
+
+    DirectoryListing();
+    virtual ~DirectoryListing();
+
+    // Enumerate 'path' and sort the entries by name.  Returns false (and
+    // leaves the listing unchanged) if the directory cannot be opened.
+    bool Load(const std::string& path);
+
+    // Take 'entries' (sorted here) as the listing of 'path' without reading
+    // anything.  Used for folders inside archives, which Load() cannot
+    // open; IsVirtual() tells such listings apart.
+    void SetEntries(const std::string& path, std::vector<Entry> entries);
+
+    const std::string&        GetPath() const { return m_path; }
+    bool                      IsVirtual() const { return m_virtual; }
+    const std::vector<Entry>& GetEntries() const { return m_entries; }
+    std::size_t               GetCount() const { return m_entries.size(); }
+    bool                      IsEmpty() const { return m_entries.empty(); }
+
+    // Index of the entry with the given name, or -1.  Binary search.
+    long Find(const std::string& name) const;
+
+    // Number of entries added, removed or modified going from this listing
+    // to 'other'.  Both must be sorted (as Load() leaves them).
+    std::size_t CountChanges(const DirectoryListing& other) const;
+
+    // Persist / restore the listing in a small binary file.  Save keeps at
+    // most maxEntries entries.  Both return false on I/O or format errors.
+    bool SaveSnapshot(const std::string& file, std::size_t maxEntries) const;
+    bool LoadSnapshot(const std::string& file);
+
+private:
+    std::string        m_path;
+    std::vector<Entry> m_entries;
+    bool               m_virtual;   // set by SetEntries(), cleared by Load()
+};
+
+#endif // DIRECTORYLISTING_H
@@ -0,0 +1,194 @@
+/*
+Author: Guo Jia
+Description: Implementation of DirectoryPrefetcher.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <memory>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "DirectoryPrefetcher.h"
+#include "DirectoryListing.h"
+#include "ListingCache.h"
+
+using namespace std;
+
+namespace
+{
+#ifdef __linux__
+    // From linux/ioprio.h, which glibc does not wrap.
+    const int IOPRIO_CLASS_IDLE  = 3;
+    const int IOPRIO_CLASS_SHIFT = 13;
+    const int IOPRIO_WHO_PROCESS = 1;
+
+    const int LOWEST_CPU_PRIORITY = 19;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: DirectoryPrefetcher
+Description: Starts the prefetch thread.
+Parameters: cache - where prefetched listings are stored
+Return: None
+*/
+DirectoryPrefetcher::DirectoryPrefetcher(ListingCache& cache)
+    : m_cache(cache),
+      m_queue(),
+      m_lastRequest(),
+      m_suspendCount(0),
+      m_stopping(false),
+      m_mutex(),
+      m_wakeup(),
+      m_thread()
+{
+    m_thread = thread(&DirectoryPrefetcher::WorkerLoop, this);
+}
+
+/*
+Function: ~DirectoryPrefetcher
+Description: Stops the thread, abandoning queued requests.  A listing in
+             progress is finished first.
+Parameters: None
+Return: None
+*/
+DirectoryPrefetcher::~DirectoryPrefetcher()
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+    m_thread.join();
+}
+
+// ---------------------------------------------------------------------------
+// Requests
+// ---------------------------------------------------------------------------
+
+/*
+Function: Request
+Description: Queues a path as the newest request, dropping it if already
+             cached and dropping the oldest request when the queue is full.
+             Restarts the debounce timer.
+Parameters: path - directory to prefetch
+Return: None
+*/
+void DirectoryPrefetcher::Request(const string& path)
+{
+    if (m_cache.Contains(path))
+    {
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_queue.erase(remove(m_queue.begin(), m_queue.end(), path), m_queue.end());
+        m_queue.push_back(path);
+        if (m_queue.size() > MAX_QUEUED)
+        {
+            m_queue.pop_front();
+        }
+        m_lastRequest = chrono::steady_clock::now();
+    }
+    m_wakeup.notify_all();
+}
+
+/*
+Function: Suspend
+Description: Pauses prefetching until the matching Resume().
+Parameters: None
+Return: None
+*/
+void DirectoryPrefetcher::Suspend()
+{
+    lock_guard<mutex> lock(m_mutex);
+    ++m_suspendCount;
+}
+
+/*
+Function: Resume
+Description: Undoes one Suspend().
+Parameters: None
+Return: None
+*/
+void DirectoryPrefetcher::Resume()
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_suspendCount = max(0, m_suspendCount - 1);
+    }
+    m_wakeup.notify_all();
+}
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+/*
+Function: WorkerLoop
+Description: Waits for work, for the debounce period to pass and for no
+             foreground job to be running, then lists the newest request and
+             stores it in the cache.
+Parameters: None
+Return: None
+*/
+void DirectoryPrefetcher::WorkerLoop()
+{
+    LowerThreadPriority();
+
+    unique_lock<mutex> lock(m_mutex);
+    while (true)
+    {
+        m_wakeup.wait(lock, [this]()
+        {
+            return m_stopping || (!m_queue.empty() && m_suspendCount == 0);
+        });
+        if (m_stopping)
+        {
+            return;
+        }
+
+        chrono::steady_clock::time_point due = m_lastRequest + chrono::milliseconds(DEBOUNCE_MS);
+        if (chrono::steady_clock::now() < due)
+        {
+            m_wakeup.wait_until(lock, due);
+            continue;   // re-check everything; a newer request moves 'due'
+        }
+
+        string path = m_queue.back();
+        m_queue.pop_back();
+        lock.unlock();
+
+        if (!m_cache.Contains(path))
+        {
+            int error = 0;
+            m_cache.Load(path, true, false, error);   // a navigation meanwhile reads on its own
+        }
+
+        lock.lock();
+    }
+}
+
+/*
+Function: LowerThreadPriority
+Description: On Linux both ioprio_set and setpriority with a zero id apply
+             to the calling thread only, so the GUI and the worker pool keep
+             their normal priority.
+Parameters: None
+Return: None
+*/
+void DirectoryPrefetcher::LowerThreadPriority()
+{
+#ifdef __linux__
+    syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT);
+    setpriority(PRIO_PROCESS, 0, LOWEST_CPU_PRIORITY);
+#endif
+}
@@ -0,0 +1,64 @@
+/*
+Author: Guo Jia
+Description: Declaration of DirectoryPrefetcher – lists directories the user
+             is likely to open next (the selected or hovered folder) on one
+             background thread at idle I/O priority, and stores the results
+             in a ListingCache.  Requests are debounced and only the newest
+             few are kept, and prefetching pauses while a foreground job is
+             running, so it never competes with work the user asked for.
+Date: 2026-10-18
+*/
+
+#ifndef DIRECTORYPREFETCHER_H
+#define DIRECTORYPREFETCHER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class ListingCache;
+
+class DirectoryPrefetcher
+{
+public:
+    explicit DirectoryPrefetcher(ListingCache& cache);
+    virtual ~DirectoryPrefetcher();
+
+    DirectoryPrefetcher(const DirectoryPrefetcher&) = delete;
+    DirectoryPrefetcher& operator=(const DirectoryPrefetcher&) = delete;
+
+    // Ask for 'path' to be listed soon.  Cheap; call from the GUI thread on
+    // every selection / hover change.
+    void Request(const std::string& path);
+
+    // Stop / restart prefetching around foreground I/O.  Nested calls are
+    // counted.
+    void Suspend();
+    void Resume();
+
+private:
+    // Wait this long after the last request before reading anything, so
+    // sweeping the mouse over a column of folders lists none of them.
+    static constexpr int         DEBOUNCE_MS = 150;
+    static constexpr std::size_t MAX_QUEUED  = 4;
+
+    ListingCache&                          m_cache;
+    std::deque<std::string>                m_queue;         // back = newest
+    std::chrono::steady_clock::time_point  m_lastRequest;
+    int                                    m_suspendCount;
+    bool                                   m_stopping;
+    std::mutex                             m_mutex;
+    std::condition_variable                m_wakeup;
+    std::thread                            m_thread;
+
+    void WorkerLoop();
+
+    // Put the calling thread in the idle I/O class and at the lowest CPU
+    // priority (Linux only; a no-op elsewhere).
+    static void LowerThreadPriority();
+};
+
+#endif // DIRECTORYPREFETCHER_H
@@ -0,0 +1,610 @@
+/*
+Author: Guo Jia
+Description: Implementation of DirectorySync.  Planning fans out one pool
+             task per directory: each task lists the source and destination
+             directory side by side, records what differs, and queues its
+             subdirectories as new tasks.  A pending-task counter tells
+             BuildPlan() when the walk is over.  Execution runs the file
+             copies on the same pool; directory creation and deletions are
+             done serially because their order matters.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <unordered_map>
+#include "DirectorySync.h"
+#include "ThreadPool.h"
+#include "JobProgress.h"
+#include "ContentHash.h"
+#include "DeltaCopier.h"
+
+using namespace std;
+using namespace std::filesystem;
+
+// ---------------------------------------------------------------------------
+// Nested type constructors
+// ---------------------------------------------------------------------------
+
+/*
+Function: Options
+Description: Default sync options: size+mtime comparison, no deletions,
+             delta transfer for changed files of 64 MiB and up.
+Parameters: None
+Return: None
+*/
+DirectorySync::Options::Options()
+    : compareByHash(false),
+      deleteExtras(false),
+      deltaThreshold(64ULL * 1024 * 1024)
+{
+}
+
+/*
+Function: Plan
+Description: Creates an empty plan with all totals at zero.
+Parameters: None
+Return: None
+*/
+DirectorySync::Plan::Plan()
+    : items(),
+      newFiles(0),
+      changedFiles(0),
+      deltaFiles(0),
+      unchangedFiles(0),
+      createdDirectories(0),
+      deletedEntries(0),
+      newBytes(0),
+      changedBytes(0),
+      deletedBytes(0)
+{
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: DirectorySync
+Description: Stores the two tree roots, the options and the worker pool.
+Parameters: source      - directory whose contents are authoritative
+            destination - directory to bring in line with the source
+            options     - comparison / deletion / delta settings
+            pool        - worker pool used for the walk and the copies
+Return: None
+*/
+DirectorySync::DirectorySync(const string& source, const string& destination,
+                             const Options& options, ThreadPool& pool)
+    : m_source(source),
+      m_destination(destination),
+      m_options(options),
+      m_pool(pool),
+      m_mutex(),
+      m_idle(),
+      m_pendingTasks(0),
+      m_walkFailed(false),
+      m_walkItems(),
+      m_walkUnchanged(0),
+      m_bytesCopied(0),
+      m_bytesReused(0)
+{
+}
+
+/*
+Function: ~DirectorySync
+Description: Destructor.  BuildPlan/Execute always wait for their tasks, so
+             nothing can still reference this object.
+Parameters: None
+Return: None
+*/
+DirectorySync::~DirectorySync()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Planning (dry run)
+// ---------------------------------------------------------------------------
+
+/*
+Function: BuildPlan
+Description: Runs the parallel walk, waits for it to drain, then sorts the
+             items (parents before children) and totals them up.
+Parameters: plan     - receives the items and totals
+            progress - status/cancel sink
+Return: true if the comparison completed
+*/
+bool DirectorySync::BuildPlan(Plan& plan, JobProgress& progress)
+{
+    plan = Plan();
+
+    error_code ec;
+    if (!is_directory(path(m_source), ec))
+    {
+        return false;
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_walkFailed = false;
+        m_walkItems.clear();
+        m_walkUnchanged = 0;
+    }
+
+    bool destinationMissing = !is_directory(path(m_destination), ec);
+    EnqueueCompare("", destinationMissing, progress);
+
+    {
+        unique_lock<mutex> lock(m_mutex);
+        m_idle.wait(lock, [this]() { return m_pendingTasks == 0; });
+
+        plan.items.swap(m_walkItems);
+        plan.unchangedFiles = m_walkUnchanged;
+        if (m_walkFailed)
+        {
+            return false;
+        }
+    }
+
+    if (progress.IsCancelled())
+    {
+        return false;
+    }
+
+    sort(plan.items.begin(), plan.items.end(),
+         [](const Item& a, const Item& b) { return a.relativePath < b.relativePath; });
+
+    for (const Item& item : plan.items)
+    {
+        switch (item.action)
+        {
+        case Action::CreateDirectory:
+            ++plan.createdDirectories;
+            break;
+        case Action::CopyNew:
+            ++plan.newFiles;
+            plan.newBytes += item.bytes;
+            break;
+        case Action::UpdateChanged:
+            ++plan.changedFiles;
+            plan.changedBytes += item.bytes;
+            if (item.useDelta)
+            {
+                ++plan.deltaFiles;
+            }
+            break;
+        case Action::DeleteExtra:
+            ++plan.deletedEntries;
+            plan.deletedBytes += item.bytes;
+            break;
+        case Action::RemoveConflict:
+            break;
+        }
+    }
+    return true;
+}
+
+/*
+Function: EnqueueCompare
+Description: Counts a new pending directory and hands it to the pool.  The
+             last task to finish wakes BuildPlan().
+Parameters: relativePath       - directory relative to both roots
+            destinationMissing - true if the destination side does not exist
+            progress           - status/cancel sink
+Return: None
+*/
+void DirectorySync::EnqueueCompare(const string& relativePath, bool destinationMissing,
+                                   JobProgress& progress)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        ++m_pendingTasks;
+    }
+
+    m_pool.Submit([this, relativePath, destinationMissing, &progress]()
+    {
+        try
+        {
+            CompareDirectory(relativePath, destinationMissing, progress);
+        }
+        catch (const exception&)
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_walkFailed = true;
+        }
+
+        lock_guard<mutex> lock(m_mutex);
+        if (--m_pendingTasks == 0)
+        {
+            m_idle.notify_all();
+        }
+    });
+}
+
+/*
+Function: CompareDirectory
+Description: Compares one directory level.  The destination listing goes
+             into a hash map first so every source entry is matched in O(1);
+             whatever is left in the map afterwards only exists on the
+             destination side.  Subdirectories are queued instead of
+             recursed into, which is what spreads the walk over the pool.
+Parameters: relativePath       - directory relative to both roots
+            destinationMissing - skip listing the destination side
+            progress           - status/cancel sink
+Return: None
+*/
+void DirectorySync::CompareDirectory(const string& relativePath, bool destinationMissing,
+                                     JobProgress& progress)
+{
+    if (progress.IsCancelled())
+    {
+        return;
+    }
+    progress.SetMessage("Comparing " + (relativePath.empty() ? string(".") : relativePath));
+
+    string sourceDir      = JoinPath(m_source, relativePath);
+    string destinationDir = JoinPath(m_destination, relativePath);
+
+    vector<Item> items;
+    size_t unchanged = 0;
+    error_code ec;
+
+    unordered_map<string, directory_entry> destinationEntries;
+    if (!destinationMissing)
+    {
+        for (directory_iterator it(destinationDir, ec), end; !ec && it != end; it.increment(ec))
+        {
+            destinationEntries.emplace(it->path().filename().string(), *it);
+        }
+        if (ec)
+        {
+            // Entries not read would look like they are missing.
+            lock_guard<mutex> lock(m_mutex);
+            m_walkFailed = true;
+            return;
+        }
+    }
+
+    directory_iterator sourceIt(sourceDir, ec);
+    if (ec)
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_walkFailed = true;
+        return;
+    }
+
+    for (directory_iterator end; sourceIt != end; sourceIt.increment(ec))
+    {
+        if (ec)
+        {
+            // A partial source list would plan its unread entries'
+            // counterparts for deletion.
+            lock_guard<mutex> lock(m_mutex);
+            m_walkFailed = true;
+            return;
+        }
+        if (progress.IsCancelled())
+        {
+            break;
+        }
+
+        string name      = sourceIt->path().filename().string();
+        string childPath = relativePath.empty() ? name : relativePath + "/" + name;
+
+        file_status sourceStatus = sourceIt->symlink_status(ec);
+        bool destinationExists = false;
+
+        auto found = destinationEntries.find(name);
+        if (found != destinationEntries.end())
+        {
+            file_status destinationStatus = found->second.symlink_status(ec);
+            destinationExists = destinationStatus.type() == sourceStatus.type();
+            if (!destinationExists)
+            {
+                items.push_back({ Action::RemoveConflict, childPath, 0, false });
+            }
+            destinationEntries.erase(found);
+        }
+
+        if (is_directory(sourceStatus))
+        {
+            if (!destinationExists)
+            {
+                items.push_back({ Action::CreateDirectory, childPath, 0, false });
+            }
+            EnqueueCompare(childPath, !destinationExists, progress);
+            continue;
+        }
+
+        uint64_t size = is_regular_file(sourceStatus) ? sourceIt->file_size(ec) : 0;
+
+        if (!destinationExists)
+        {
+            items.push_back({ Action::CopyNew, childPath, size, false });
+        }
+        else if (FilesDiffer(sourceIt->path().string(), JoinPath(m_destination, childPath)))
+        {
+            bool useDelta = is_regular_file(sourceStatus) && size >= m_options.deltaThreshold;
+            items.push_back({ Action::UpdateChanged, childPath, size, useDelta });
+        }
+        else
+        {
+            ++unchanged;
+        }
+    }
+
+    if (m_options.deleteExtras)
+    {
+        for (const auto& extra : destinationEntries)
+        {
+            string childPath = relativePath.empty() ? extra.first : relativePath + "/" + extra.first;
+            items.push_back({ Action::DeleteExtra, childPath, TreeSize(extra.second.path().string()), false });
+        }
+    }
+
+    lock_guard<mutex> lock(m_mutex);
+    m_walkItems.insert(m_walkItems.end(), items.begin(), items.end());
+    m_walkUnchanged += unchanged;
+}
+
+/*
+Function: FilesDiffer
+Description: Decides whether a destination entry of the same type needs
+             updating.  Symlinks compare their targets.  Regular files differ
+             if their sizes differ; with equal sizes they are compared by
+             content hash when requested, otherwise by modification time
+             (Execute copies the source mtime, so synced files compare equal).
+Parameters: sourcePath      - source entry
+            destinationPath - destination entry of the same type
+Return: true if the destination must be updated
+*/
+bool DirectorySync::FilesDiffer(const string& sourcePath, const string& destinationPath) const
+{
+    error_code ec;
+    path sourceP(sourcePath);
+    path destinationP(destinationPath);
+
+    if (is_symlink(symlink_status(sourceP, ec)))
+    {
+        return read_symlink(sourceP, ec) != read_symlink(destinationP, ec);
+    }
+
+    uintmax_t sourceSize      = file_size(sourceP, ec);
+    uintmax_t destinationSize = file_size(destinationP, ec);
+    if (ec || sourceSize != destinationSize)
+    {
+        return true;
+    }
+
+    if (m_options.compareByHash)
+    {
+        uint64_t sourceHash      = 0;
+        uint64_t destinationHash = 0;
+        if (!ContentHash::HashFile(sourcePath, sourceHash) ||
+            !ContentHash::HashFile(destinationPath, destinationHash))
+        {
+            return true;
+        }
+        return sourceHash != destinationHash;
+    }
+
+    return last_write_time(sourceP, ec) != last_write_time(destinationP, ec);
+}
+
+// ---------------------------------------------------------------------------
+// Execution
+// ---------------------------------------------------------------------------
+
+/*
+Function: Execute
+Description: Applies a plan in four phases: remove type conflicts, create
+             directories (sorted, so parents come first), copy files in
+             parallel, and finally delete extras – only if every copy worked,
+             so a failed sync never loses data on the destination.
+Parameters: plan     - plan produced by BuildPlan()
+            progress - byte progress / cancel sink
+            error    - receives a description of the first failure
+Return: true if every item was applied
+*/
+bool DirectorySync::Execute(const Plan& plan, JobProgress& progress, string& error)
+{
+    m_bytesCopied = 0;
+    m_bytesReused = 0;
+    progress.SetTotal(plan.newBytes + plan.changedBytes);
+
+    error_code ec;
+    create_directories(path(m_destination), ec);
+
+    for (const Item& item : plan.items)
+    {
+        if (item.action == Action::RemoveConflict)
+        {
+            remove_all(path(JoinPath(m_destination, item.relativePath)), ec);
+        }
+    }
+
+    for (const Item& item : plan.items)
+    {
+        if (item.action == Action::CreateDirectory)
+        {
+            create_directory(path(JoinPath(m_destination, item.relativePath)), ec);
+            if (ec)
+            {
+                error = "Could not create directory " + item.relativePath;
+                return false;
+            }
+        }
+    }
+
+    // Copies – one task per file.
+    vector<future<void>> copies;
+    vector<string> failures;
+    mutex failuresMutex;
+
+    for (const Item& item : plan.items)
+    {
+        if (item.action != Action::CopyNew && item.action != Action::UpdateChanged)
+        {
+            continue;
+        }
+
+        copies.push_back(m_pool.Submit([this, &item, &progress, &failures, &failuresMutex]()
+        {
+            if (progress.IsCancelled())
+            {
+                return;
+            }
+            progress.SetMessage("Copying " + item.relativePath);
+            if (!SyncFile(item, progress))
+            {
+                lock_guard<mutex> lock(failuresMutex);
+                failures.push_back(item.relativePath);
+            }
+        }));
+    }
+
+    for (future<void>& copy : copies)
+    {
+        try
+        {
+            copy.get();
+        }
+        catch (const exception&)
+        {
+            lock_guard<mutex> lock(failuresMutex);
+            failures.push_back("(internal error)");
+        }
+    }
+
+    if (!failures.empty())
+    {
+        sort(failures.begin(), failures.end());
+        error = "Could not copy " + failures.front();
+        if (failures.size() > 1)
+        {
+            error += " and " + to_string(failures.size() - 1) + " other file(s)";
+        }
+        return false;
+    }
+    if (progress.IsCancelled())
+    {
+        error = "Cancelled";
+        return false;
+    }
+
+    for (const Item& item : plan.items)
+    {
+        if (item.action == Action::DeleteExtra)
+        {
+            progress.SetMessage("Deleting " + item.relativePath);
+            remove_all(path(JoinPath(m_destination, item.relativePath)), ec);
+            if (ec)
+            {
+                error = "Could not delete " + item.relativePath;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+Function: SyncFile
+Description: Copies one file or symlink.  Large changed files go through
+             DeltaCopier; everything else is a plain copy.  The source mtime
+             is copied so the next size+mtime comparison sees them as equal.
+Parameters: item     - CopyNew or UpdateChanged item
+            progress - byte progress sink
+Return: true on success
+*/
+bool DirectorySync::SyncFile(const Item& item, JobProgress& progress)
+{
+    path sourceP(JoinPath(m_source, item.relativePath));
+    path destinationP(JoinPath(m_destination, item.relativePath));
+    error_code ec;
+
+    if (is_symlink(symlink_status(sourceP, ec)))
+    {
+        remove(destinationP, ec);
+        copy_symlink(sourceP, destinationP, ec);
+        return !ec;
+    }
+
+    uint64_t copied = item.bytes;
+    uint64_t reused = 0;
+    if (item.useDelta)
+    {
+        DeltaCopier delta;
+        if (!delta.Update(sourceP.string(), destinationP.string(), &progress))
+        {
+            return false;
+        }
+        copied = delta.GetLiteralBytes();
+        reused = delta.GetMatchedBytes();
+    }
+    else
+    {
+        copy_file(sourceP, destinationP, copy_options::overwrite_existing, ec);
+        if (ec)
+        {
+            return false;
+        }
+        progress.Advance(item.bytes);
+    }
+
+    last_write_time(destinationP, last_write_time(sourceP, ec), ec);
+
+    lock_guard<mutex> lock(m_mutex);
+    m_bytesCopied += copied;
+    m_bytesReused += reused;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: TreeSize
+Description: Total size of the regular files at or below a path, used to
+             report how much a deletion frees.
+Parameters: pathString - file or directory
+Return: Size in bytes (0 if unreadable)
+*/
+uint64_t DirectorySync::TreeSize(const string& pathString)
+{
+    error_code ec;
+    path root(pathString);
+
+    if (!is_directory(symlink_status(root, ec)))
+    {
+        return is_regular_file(symlink_status(root, ec)) ? file_size(root, ec) : 0;
+    }
+
+    uint64_t total = 0;
+    for (recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec))
+    {
+        if (it->is_regular_file(ec) && !it->is_symlink(ec))
+        {
+            total += it->file_size(ec);
+        }
+    }
+    return total;
+}
+
+/*
+Function: JoinPath
+Description: Joins a tree root with a '/'-separated relative path.
+Parameters: base     - tree root
+            relative - path below the root ("" for the root itself)
+Return: Combined path
+*/
+string DirectorySync::JoinPath(const string& base, const string& relative)
+{
+    if (relative.empty())
+    {
+        return base;
+    }
+    return (path(base) / relative).string();
+}
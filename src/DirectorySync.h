@@ -0,0 +1,114 @@
+/*
+Author: Guo Jia
+Description: Declaration of DirectorySync – one-way mirroring of a source
+             directory tree onto a destination.  Planning walks both trees in
+             parallel and produces a dry-run Plan; Execute() then copies only
+             new or changed files (large changed files via DeltaCopier) and
+             optionally deletes extras.
+Date: 2026-10-18
+*/
+
+#ifndef DIRECTORYSYNC_H
+#define DIRECTORYSYNC_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+class JobProgress;
+
+class DirectorySync
+{
+public:
+    struct Options
+    {
+        bool          compareByHash;    // same size -> compare contents, ignore mtime
+        bool          deleteExtras;     // remove destination entries missing in source
+        std::uint64_t deltaThreshold;   // changed files at least this big use DeltaCopier
+
+        Options();
+    };
+
+    enum class Action
+    {
+        RemoveConflict,    // destination entry has the wrong type; remove it first
+        CreateDirectory,
+        CopyNew,
+        UpdateChanged,
+        DeleteExtra
+    };
+
+    struct Item
+    {
+        Action        action;
+        std::string   relativePath;
+        std::uint64_t bytes;        // bytes to copy, or bytes freed by a delete
+        bool          useDelta;     // UpdateChanged only
+    };
+
+    struct Plan
+    {
+        std::vector<Item> items;
+        std::size_t   newFiles;
+        std::size_t   changedFiles;
+        std::size_t   deltaFiles;
+        std::size_t   unchangedFiles;
+        std::size_t   createdDirectories;
+        std::size_t   deletedEntries;
+        std::uint64_t newBytes;
+        std::uint64_t changedBytes;
+        std::uint64_t deletedBytes;
+
+        Plan();
+    };
+
+    DirectorySync(const std::string& source, const std::string& destination,
+                  const Options& options, ThreadPool& pool);
+    virtual ~DirectorySync();
+
+    // Dry run: compare the trees and fill 'plan' without touching anything.
+    // Returns false if the source cannot be read or the job was cancelled.
+    bool BuildPlan(Plan& plan, JobProgress& progress);
+
+    // Apply a plan from BuildPlan().  On failure 'error' names the first
+    // entry that could not be synced.  Returns true if every item succeeded.
+    bool Execute(const Plan& plan, JobProgress& progress, std::string& error);
+
+    // Bytes of the last Execute() taken from the source, and bytes of
+    // changed files that delta transfer took from the old destination file
+    // instead.  Every synced file is still written out in full.
+    std::uint64_t GetBytesCopied() const { return m_bytesCopied; }
+    std::uint64_t GetBytesReused() const { return m_bytesReused; }
+
+private:
+    std::string             m_source;
+    std::string             m_destination;
+    Options                 m_options;
+    ThreadPool&             m_pool;
+
+    // Parallel-walk bookkeeping, guarded by m_mutex.
+    std::mutex              m_mutex;
+    std::condition_variable m_idle;
+    std::size_t             m_pendingTasks;
+    bool                    m_walkFailed;
+    std::vector<Item>       m_walkItems;
+    std::size_t             m_walkUnchanged;
+    std::uint64_t           m_bytesCopied;
+    std::uint64_t           m_bytesReused;
+
+    void EnqueueCompare(const std::string& relativePath, bool destinationMissing,
+                        JobProgress& progress);
+    void CompareDirectory(const std::string& relativePath, bool destinationMissing,
+                          JobProgress& progress);
+    bool FilesDiffer(const std::string& sourcePath, const std::string& destinationPath) const;
+    bool SyncFile(const Item& item, JobProgress& progress);
+
+    static std::uint64_t TreeSize(const std::string& pathString);
+    static std::string   JoinPath(const std::string& base, const std::string& relative);
+};
+
+#endif // DIRECTORYSYNC_H
@@ -0,0 +1,235 @@
+/*
+Author: Guo Jia
+Description: Implementation of EntryDetails.
+Date: 2026-10-18
+*/
+
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "EntryDetails.h"
+
+using namespace std;
+
+namespace
+{
+#ifdef STATX_BASIC_STATS
+    // Cleared the first time statx turns out to be unsupported by the
+    // running kernel, after which fstatat is used directly.
+    atomic<bool> g_haveStatx(true);
+
+    unsigned int StatxMask(unsigned int fields)
+    {
+        unsigned int mask = 0;
+        if (fields & EntryDetails::FIELD_MODE)
+        {
+            mask |= STATX_TYPE | STATX_MODE;
+        }
+        if (fields & EntryDetails::FIELD_OWNER)
+        {
+            mask |= STATX_UID;
+        }
+        if (fields & EntryDetails::FIELD_GROUP)
+        {
+            mask |= STATX_GID;
+        }
+        if (fields & EntryDetails::FIELD_LINKS)
+        {
+            mask |= STATX_NLINK;
+        }
+        if (fields & EntryDetails::FIELD_ALLOCATED)
+        {
+            mask |= STATX_BLOCKS;
+        }
+        return mask;
+    }
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: EntryDetails
+Description: Opens the directory as an O_PATH handle: no read permission
+             is needed and nothing is read from it; it only anchors the
+             relative lookups in Read().
+Parameters: directory - directory whose entries will be read
+Return: None
+*/
+EntryDetails::EntryDetails(const string& directory)
+    : m_directory(-1)
+{
+#ifdef O_PATH
+    m_directory = open(directory.c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+#else
+    m_directory = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+#endif
+}
+
+/*
+Function: ~EntryDetails
+Description: Closes the directory handle.
+Parameters: None
+Return: None
+*/
+EntryDetails::~EntryDetails()
+{
+    if (m_directory >= 0)
+    {
+        close(m_directory);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Reading
+// ---------------------------------------------------------------------------
+
+/*
+Function: Read
+Description: statx with only the requested fields in the mask.  Local file
+             systems fill everything anyway, but network ones can skip
+             fetching what was not asked for, and AT_STATX_DONT_SYNC lets
+             them answer from cached attributes.
+Parameters: name   - entry name inside the directory
+            fields - FIELD_* bits wanted
+            record - receives the fields
+Return: true if the entry was read
+*/
+bool EntryDetails::Read(const string& name, unsigned int fields, Record& record) const
+{
+    if (m_directory < 0)
+    {
+        record.readable = false;
+        record.fields  |= fields;
+        return false;
+    }
+
+#ifdef STATX_BASIC_STATS
+    if (g_haveStatx)
+    {
+        struct statx info;
+        unsigned int mask = StatxMask(fields);
+        int result = statx(m_directory, name.c_str(), AT_STATX_DONT_SYNC, mask, &info);
+        if (result != 0 && errno != ENOSYS)
+        {
+            result = statx(m_directory, name.c_str(), AT_STATX_DONT_SYNC | AT_SYMLINK_NOFOLLOW, mask, &info);
+        }
+        if (result != 0 && errno == ENOSYS)
+        {
+            g_haveStatx = false;
+            return ReadWithStat(name, fields, record);
+        }
+
+        record.fields  |= fields;
+        record.readable = (result == 0);
+        if (result != 0)
+        {
+            return false;
+        }
+        if (fields & FIELD_MODE)
+        {
+            record.mode = info.stx_mode;
+        }
+        if (fields & FIELD_OWNER)
+        {
+            record.uid = info.stx_uid;
+        }
+        if (fields & FIELD_GROUP)
+        {
+            record.gid = info.stx_gid;
+        }
+        if (fields & FIELD_LINKS)
+        {
+            record.links = info.stx_nlink;
+        }
+        if (fields & FIELD_ALLOCATED)
+        {
+            record.allocated = static_cast<uint64_t>(info.stx_blocks) * 512;
+        }
+        return true;
+    }
+#endif
+    return ReadWithStat(name, fields, record);
+}
+
+/*
+Function: FormatMode
+Description: File-type character followed by three rwx triplets, with the
+             set-id and sticky bits shown as s/S and t/T in the execute
+             positions.
+Parameters: mode - st_mode value
+Return: Ten-character permission string
+*/
+string EntryDetails::FormatMode(uint32_t mode)
+{
+    string text(10, '-');
+    switch (mode & S_IFMT)
+    {
+    case S_IFDIR:  text[0] = 'd'; break;
+    case S_IFLNK:  text[0] = 'l'; break;
+    case S_IFCHR:  text[0] = 'c'; break;
+    case S_IFBLK:  text[0] = 'b'; break;
+    case S_IFIFO:  text[0] = 'p'; break;
+    case S_IFSOCK: text[0] = 's'; break;
+    default:       break;
+    }
+
+    const char LETTERS[] = "rwx";
+    for (int bit = 0; bit < 9; ++bit)
+    {
+        if (mode & (0400u >> bit))
+        {
+            text[1 + bit] = LETTERS[bit % 3];
+        }
+    }
+
+    if (mode & S_ISUID)
+    {
+        text[3] = (mode & S_IXUSR) ? 's' : 'S';
+    }
+    if (mode & S_ISGID)
+    {
+        text[6] = (mode & S_IXGRP) ? 's' : 'S';
+    }
+    if (mode & S_ISVTX)
+    {
+        text[9] = (mode & S_IXOTH) ? 't' : 'T';
+    }
+    return text;
+}
+
+/*
+Function: ReadWithStat
+Description: Fallback for systems without statx: fstatat always fills
+             every field, so the mask is simply ignored.
+Parameters: name   - entry name inside the directory
+            fields - FIELD_* bits wanted
+            record - receives the fields
+Return: true if the entry was read
+*/
+bool EntryDetails::ReadWithStat(const string& name, unsigned int fields, Record& record) const
+{
+    struct stat info;
+    int result = fstatat(m_directory, name.c_str(), &info, 0);
+    if (result != 0)
+    {
+        result = fstatat(m_directory, name.c_str(), &info, AT_SYMLINK_NOFOLLOW);
+    }
+
+    record.fields  |= fields;
+    record.readable = (result == 0);
+    if (result != 0)
+    {
+        return false;
+    }
+    record.mode      = static_cast<uint32_t>(info.st_mode);
+    record.uid       = static_cast<uint32_t>(info.st_uid);
+    record.gid       = static_cast<uint32_t>(info.st_gid);
+    record.links     = static_cast<uint64_t>(info.st_nlink);
+    record.allocated = static_cast<uint64_t>(info.st_blocks) * 512;
+    return true;
+}
@@ -0,0 +1,64 @@
+/*
+Author: Guo Jia
+Description: Implementation of FileListCtrl – forwards the virtual list's
+             text callback to the owner-supplied provider.
+Date: 2026-10-18
+*/
+
+#include "FileListCtrl.h"
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: FileListCtrl
+Description: Creates a multiple-selection virtual report list.
+Parameters: parent       - parent window
+            textProvider - callback producing the text for a cell
+Return: None
+*/
+FileListCtrl::FileListCtrl(wxWindow* parent, const TextProvider& textProvider)
+    : wxListCtrl(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                 wxLC_REPORT | wxLC_VIRTUAL),
+      m_textProvider(textProvider),
+      m_imageProvider()
+{
+}
+
+/*
+Function: ~FileListCtrl
+Description: Destructor.  No resources to release.
+Parameters: None
+Return: None
+*/
+FileListCtrl::~FileListCtrl()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Virtual list callbacks
+// ---------------------------------------------------------------------------
+
+/*
+Function: OnGetItemText
+Description: Called by wxWidgets for each visible cell that needs painting.
+Parameters: item   - row index
+            column - column index
+Return: Cell text
+*/
+wxString FileListCtrl::OnGetItemText(long item, long column) const
+{
+    return m_textProvider(item, column);
+}
+
+/*
+Function: OnGetItemImage
+Description: Called by wxWidgets for the image in front of a visible row.
+Parameters: item - row index
+Return: Image-list index, or -1 for none
+*/
+int FileListCtrl::OnGetItemImage(long item) const
+{
+    return m_imageProvider ? m_imageProvider(item) : -1;
+}
@@ -0,0 +1,40 @@
+/*
+Author: Guo Jia
+Description: Declaration of FileListCtrl – a virtual (wxLC_VIRTUAL) report
+             list.  Rows are not stored in the control; it asks its owner
+             for cell text only when a row is painted, so showing a
+             directory of any size costs the same.
+Date: 2026-10-18
+*/
+
+#ifndef FILELISTCTRL_H
+#define FILELISTCTRL_H
+
+#include <functional>
+#include <wx/listctrl.h>
+
+class FileListCtrl : public wxListCtrl
+{
+public:
+    // Returns the text of (row, column).
+    typedef std::function<wxString(long, long)> TextProvider;
+
+    // Returns the image-list index shown in front of a row, or -1.
+    typedef std::function<int(long)> ImageProvider;
+
+    FileListCtrl(wxWindow* parent, const TextProvider& textProvider);
+    virtual ~FileListCtrl();
+
+    // Rows have no image until a provider is set.
+    void SetImageProvider(const ImageProvider& imageProvider) { m_imageProvider = imageProvider; }
+
+protected:
+    virtual wxString OnGetItemText(long item, long column) const override;
+    virtual int      OnGetItemImage(long item) const override;
+
+private:
+    TextProvider  m_textProvider;
+    ImageProvider m_imageProvider;
+};
+
+#endif // FILELISTCTRL_H
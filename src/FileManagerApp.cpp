@@ -4,18 +4,28 @@ Description: Application entry point for the file manager.
 Date: 2026-01-31
 */
 
+#include <cstdio>
+#include <string>
+#include <wx/cmdline.h>
 #include "FileManagerApp.h"
 #include "MainFrame.h"
+#include "FileSystemBackend.h"
+#include "ResponsivenessProbe.h"
 
 #include <wx/wx.h>
 #include <wx/app.h> 
 /*
 Function: FileManagerApp
-Description: Constructs the application object.
+Description: Constructs the application object.  The launch clock starts
+             here so the startup time reported by MainFrame includes wx
+             initialisation, not just the frame's own constructor.
 Parameters: None
 Return: None
 */
 FileManagerApp::FileManagerApp()
+    : m_launchClock(),
+      m_probeWanted(false),
+      m_probe()
 {
 }
 
@@ -32,14 +42,85 @@ FileManagerApp::~FileManagerApp()
 /*
 Function: OnInit
 Description: Initializes the application and creates the main window.
+             The base class parses the command line first.  The image
+             handlers are registered for the thumbnail view.
 Parameters: None
 Return: True if initialization succeeds, false otherwise
 */
 bool FileManagerApp::OnInit()
 {
-    MainFrame* frame = new MainFrame("Simple File Manager");
+    if (!wxApp::OnInit())
+    {
+        return false;
+    }
+    wxInitAllImageHandlers();
+    MainFrame* frame = new MainFrame("Simple File Manager", m_launchClock.Time());
     frame->Show(true);
+
+    if (m_probeWanted)
+    {
+        m_probe.reset(new ResponsivenessProbe());
+        m_probe->Begin();
+    }
     return true;
 }
 
+/*
+Function: OnExit
+Description: Prints the responsiveness report, if the probe ran.
+Parameters: None
+Return: The base class's exit code
+*/
+int FileManagerApp::OnExit()
+{
+    if (m_probe)
+    {
+        m_probe->Stop();
+        fprintf(stderr, "%s\n", m_probe->GetReport().c_str());
+        m_probe.reset();
+    }
+    return wxApp::OnExit();
+}
+
+/*
+Function: OnInitCmdLine
+Description: Adds the --backend option and the --probe switch to the
+             standard ones.
+Parameters: parser - the command-line parser
+Return: None
+*/
+void FileManagerApp::OnInitCmdLine(wxCmdLineParser& parser)
+{
+    wxApp::OnInitCmdLine(parser);
+    parser.AddOption("", "backend",
+                     "file system to browse: posix (default) or "
+                     "simulated[:latency=MS,jitter=MS,failures=RATE,folders=N,files=N,depth=N]");
+    parser.AddSwitch("", "probe", "measure how responsive the window stays and report it on exit");
+}
+
+/*
+Function: OnCmdLineParsed
+Description: Installs the backend asked for before any window or thread
+             uses one.  A description that does not parse stops the start.
+Parameters: parser - the parsed command line
+Return: false to exit
+*/
+bool FileManagerApp::OnCmdLineParsed(wxCmdLineParser& parser)
+{
+    wxString description;
+    if (parser.Found("backend", &description))
+    {
+        std::string error;
+        std::unique_ptr<FileSystemBackend> backend = FileSystemBackend::Create(description.ToStdString(), error);
+        if (!backend)
+        {
+            fprintf(stderr, "%s\n", error.c_str());
+            return false;
+        }
+        FileSystemBackend::SetCurrent(std::move(backend));
+    }
+    m_probeWanted = parser.Found("probe");
+    return wxApp::OnCmdLineParsed(parser);
+}
+
 wxIMPLEMENT_APP(FileManagerApp);
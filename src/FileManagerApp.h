@@ -1,7 +1,11 @@
 #ifndef FILEMANAGERAPP_H
 #define FILEMANAGERAPP_H
 
+#include <memory>
 #include <wx/wx.h>
+#include <wx/stopwatch.h>
+
+class ResponsivenessProbe;
 
 class FileManagerApp : public wxApp
 {
@@ -10,8 +14,17 @@ public:
     virtual ~FileManagerApp();
 
     virtual bool OnInit() override;
+    virtual int  OnExit() override;
+
+    // --backend=<description> picks the FileSystemBackend, --probe turns
+    // on the ResponsivenessProbe.
+    virtual void OnInitCmdLine(wxCmdLineParser& parser) override;
+    virtual bool OnCmdLineParsed(wxCmdLineParser& parser) override;
 
 private:
+    wxStopWatch                          m_launchClock;   // started with the application object
+    bool                                 m_probeWanted;
+    std::unique_ptr<ResponsivenessProbe> m_probe;
 };
 
 #endif
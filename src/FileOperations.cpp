@@ -1,16 +1,121 @@
 /*
 Author: Guo Jia
-Description: Implementation of FileOperations – wraps std::filesystem calls
-             for all file/directory manipulation the file manager performs.
+Description: Implementation of FileOperations – wraps the FileSystemBackend
+             and std::filesystem calls for all file/directory manipulation
+             the file manager performs.  On local disks copies go through
+             CopyEngine, whose progress is charged to the IoScheduler so
+             that copies can be throttled per device, and checkpointed in a
+             CopyJournal so they can be resumed.  Other backends get whole
+             copies and moves handed to them.
 Date: 2026-02-02
 */
 
+#include <atomic>
 #include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
 #include <wx/utils.h>
 #include "FileOperations.h"
+#include "IoScheduler.h"
+#include "CopyEngine.h"
+#include "CopyJournal.h"
+#include "FileSystemBackend.h"
 
 using namespace std::filesystem;
 
+namespace
+{
+    std::atomic<IoScheduler*> g_scheduler(nullptr);
+    std::mutex                g_journalLock;
+    std::string               g_journalDirectory;   // empty: copies are not journaled
+
+    std::string JournalDirectory()
+    {
+        std::lock_guard<std::mutex> guard(g_journalLock);
+        return g_journalDirectory;
+    }
+
+    // Open the job's journal, if journaling is on.
+    bool OpenJournal(CopyJournal& journal, const std::string& from, const std::string& to,
+                     bool move, bool overwrite)
+    {
+        std::string directory = JournalDirectory();
+        return !directory.empty() && journal.Open(directory, from, to, move, overwrite);
+    }
+
+    // A finished job, or one that got nowhere, leaves no journal behind.
+    void CloseJournal(CopyJournal& journal, bool finished)
+    {
+        if (finished || !journal.HasProgress())
+        {
+            journal.Remove();
+        }
+    }
+
+    // Run 'work' under the installed scheduler, or directly without one.
+    bool Scheduled(const std::vector<std::string>& paths, IoScheduler::Priority priority,
+                   const std::function<bool()>& work)
+    {
+        IoScheduler* scheduler = g_scheduler;
+        return scheduler != nullptr ? scheduler->Run(paths, priority, work) : work();
+    }
+
+    // Copy with CopyEngine, charging the data to both devices' bandwidth
+    // and checkpointing into 'journal' (may be nullptr).
+    bool CopyCharged(const std::string& from, const std::string& to, bool overwrite, CopyJournal* journal)
+    {
+        dev_t fromDevice = 0;
+        dev_t toDevice   = 0;
+        IoScheduler::DeviceOf(from, fromDevice);
+        IoScheduler::DeviceOf(to, toDevice);
+
+        IoScheduler* scheduler = g_scheduler;
+        CopyEngine engine([scheduler, fromDevice, toDevice](std::uint64_t bytes)
+        {
+            if (scheduler != nullptr)
+            {
+                scheduler->Transfer(fromDevice, bytes);
+                if (toDevice != fromDevice)
+                {
+                    scheduler->Transfer(toDevice, bytes);
+                }
+            }
+            return true;
+        });
+        engine.SetJournal(journal);
+        return engine.Copy(from, to, overwrite);
+    }
+
+    // remove_all() through a backend: folders are emptied depth first.  A
+    // link is removed itself; what it points to is left alone.
+    bool RemoveTree(FileSystemBackend& backend, const std::string& target)
+    {
+        DirectoryListing::Entry entry;
+        if (!backend.LinkStat(target, entry))
+        {
+            return false;
+        }
+        if (entry.isDirectory)
+        {
+            std::vector<DirectoryListing::Entry> children;
+            if (!backend.Enumerate(target, children))
+            {
+                return false;
+            }
+            for (const DirectoryListing::Entry& child : children)
+            {
+                if (!RemoveTree(backend, target + "/" + child.name))
+                {
+                    return false;
+                }
+            }
+        }
+        return backend.Unlink(target);
+    }
+}
+
 // ---------------------------------------------------------------------------
 // Construction / destruction
 // ---------------------------------------------------------------------------
@@ -62,56 +167,60 @@ Return: true if the directory was created successfully
 */
 bool FileOperations::CreateDirectory(const wxString& path)
 {
-    try
-    {
-        return create_directory(path.ToStdString());
-    }
-    catch (const filesystem_error&)
+    std::string target = path.ToStdString();
+    return Scheduled({ target }, IoScheduler::PRIORITY_HIGH, [&]()
     {
-        return false;
-    }
+        return FileSystemBackend::Current().MakeDirectory(target);
+    });
 }
 
 /*
 Function: Rename
 Description: Renames (or moves within the same parent) a file or directory.
-             Wraps std::filesystem::rename.
+             Goes to the FileSystemBackend (rename(2) on local disks).
 Parameters: oldPath - current full path of the item
             newPath - desired full path after rename
 Return: true if the rename succeeded
 */
 bool FileOperations::Rename(const wxString& oldPath, const wxString& newPath)
 {
-    try
+    std::string from = oldPath.ToStdString();
+    std::string to   = newPath.ToStdString();
+    return Scheduled({ from, to }, IoScheduler::PRIORITY_HIGH, [&]()
     {
-        rename(oldPath.ToStdString(), newPath.ToStdString());
-        return true;
-    }
-    catch (const filesystem_error&)
-    {
-        return false;
-    }
+        return FileSystemBackend::Current().Rename(from, to);
+    });
 }
 
 /*
 Function: Delete
 Description: Deletes a file or directory.  For directories the removal is
              recursive (all contents are deleted first).  Uses
-             std::filesystem::remove_all for both cases for simplicity.
+             std::filesystem::remove_all for both cases on local disks, and
+             the backend's Unlink() entry by entry elsewhere.
 Parameters: path - full path of the item to delete
 Return: true if the item was removed successfully
 */
 bool FileOperations::Delete(const wxString& path)
 {
-    try
-    {
-        remove_all(path.ToStdString());
-        return true;
-    }
-    catch (const filesystem_error&)
+    std::string target = path.ToStdString();
+    return Scheduled({ target }, IoScheduler::PRIORITY_NORMAL, [&]()
     {
-        return false;
-    }
+        FileSystemBackend& backend = FileSystemBackend::Current();
+        if (!backend.IsLocal())
+        {
+            return RemoveTree(backend, target);
+        }
+        try
+        {
+            remove_all(target);
+            return true;
+        }
+        catch (const filesystem_error&)
+        {
+            return false;
+        }
+    });
 }
 
 /*
@@ -119,7 +228,12 @@ Function: Copy
 Description: Copies a file or directory to a destination path.  Directories
              are copied recursively.  If overwrite is true and the destination
              already exists it is replaced; otherwise the call fails when the
-             destination exists.
+             destination exists.  Holds a slot on the source's and the
+             destination's device for the whole copy.  Hard links inside the
+             tree, holes in sparse files and reflink clones are kept (see
+             CopyEngine).  The copy is journaled; a failed or interrupted
+             copy keeps its journal, and running it again resumes it.  A
+             backend other than the local one does the whole copy itself.
 Parameters: src       - full source path
             dest      - full destination path
             overwrite - if true, replace an existing destination
@@ -127,27 +241,24 @@ Return: true if the copy completed successfully
 */
 bool FileOperations::Copy(const wxString& src, const wxString& dest, bool overwrite)
 {
-    try
+    std::string from = src.ToStdString();
+    std::string to   = dest.ToStdString();
+    return Scheduled({ from, to }, IoScheduler::PRIORITY_NORMAL, [&]()
     {
-        copy_options opts = copy_options::none;
-        if (overwrite)
+        FileSystemBackend& backend = FileSystemBackend::Current();
+        if (!backend.IsLocal())
         {
-            opts = copy_options::overwrite_existing | copy_options::update_existing;
+            return backend.Copy(from, to, overwrite);
         }
-
-        path srcPath(src.ToStdString());
-        if (is_directory(srcPath))
+        CopyJournal journal;
+        bool journaled = OpenJournal(journal, from, to, false, overwrite);
+        bool ok        = CopyCharged(from, to, overwrite, journaled ? &journal : nullptr);
+        if (journaled)
         {
-            opts |= copy_options::recursive;
+            CloseJournal(journal, ok);
         }
-
-        copy(srcPath, path(dest.ToStdString()), opts);
-        return true;
-    }
-    catch (const filesystem_error&)
-    {
-        return false;
-    }
+        return ok;
+    });
 }
 
 /*
@@ -155,7 +266,10 @@ Function: Move
 Description: Moves a file or directory to a destination path.  If overwrite
              is true and the destination already exists it is deleted first
              (required because std::filesystem::rename will fail on some
-             platforms when the target exists).
+             platforms when the target exists).  Between file systems, where
+             rename is impossible, the item is copied (journaled, as in
+             Copy) and the source deleted; a resumed move keeps the partial
+             destination instead of replacing it.  Other backends rename.
 Parameters: src       - full source path
             dest      - full destination path
             overwrite - if true, remove an existing destination before moving
@@ -163,20 +277,71 @@ Return: true if the move completed successfully
 */
 bool FileOperations::Move(const wxString& src, const wxString& dest, bool overwrite)
 {
-    try
+    std::string from = src.ToStdString();
+    std::string to   = dest.ToStdString();
+    return Scheduled({ from, to }, IoScheduler::PRIORITY_NORMAL, [&]()
     {
-        if (overwrite && exists(path(dest.ToStdString())))
+        FileSystemBackend& backend = FileSystemBackend::Current();
+        if (!backend.IsLocal())
         {
-            remove_all(path(dest.ToStdString()));
+            DirectoryListing::Entry existing;
+            if (overwrite && backend.LinkStat(to, existing) && !RemoveTree(backend, to))
+            {
+                return false;
+            }
+            return backend.Rename(from, to);
         }
+        try
+        {
+            std::string directory = JournalDirectory();
+            bool        resuming  = !directory.empty() && CopyJournal::Exists(directory, from, to);
+            if (overwrite && !resuming && exists(symlink_status(path(to))))
+            {
+                remove_all(path(to));
+            }
 
-        rename(path(src.ToStdString()), path(dest.ToStdString()));
-        return true;
-    }
-    catch (const filesystem_error&)
-    {
-        return false;
-    }
+            std::error_code error;
+            rename(path(from), path(to), error);
+            // A move interrupted while deleting its source may have no
+            // source left to rename.
+            if (error == std::errc::cross_device_link ||
+                (resuming && error == std::errc::no_such_file_or_directory))
+            {
+                CopyJournal journal;
+                bool journaled = OpenJournal(journal, from, to, true, overwrite);
+                if (!journaled || !journal.WasCopied())
+                {
+                    if (!CopyCharged(from, to, false, journaled ? &journal : nullptr))
+                    {
+                        if (!journaled || !journal.HasProgress())
+                        {
+                            remove_all(path(to));
+                        }
+                        if (journaled)
+                        {
+                            CloseJournal(journal, false);
+                        }
+                        return false;
+                    }
+                    if (journaled)
+                    {
+                        journal.Copied();
+                    }
+                }
+                remove_all(path(from));
+                if (journaled)
+                {
+                    CloseJournal(journal, true);
+                }
+                return true;
+            }
+            return !error;
+        }
+        catch (const filesystem_error&)
+        {
+            return false;
+        }
+    });
 }
 
 /*
@@ -188,12 +353,29 @@ Return: true if the path exists on the filesystem
 */
 bool FileOperations::Exists(const wxString& path)
 {
-    try
-    {
-        return exists(std::filesystem::path(path.ToStdString()));
-    }
-    catch (const filesystem_error&)
-    {
-        return false;
-    }
-}
\ No newline at end of file
+    DirectoryListing::Entry entry;
+    return FileSystemBackend::Current().Stat(path.ToStdString(), entry);
+}
+
+/*
+Function: SetScheduler
+Description: Installs the scheduler later operations go through.
+Parameters: scheduler - the scheduler, or nullptr for none
+Return: None
+*/
+void FileOperations::SetScheduler(IoScheduler* scheduler)
+{
+    g_scheduler = scheduler;
+}
+
+/*
+Function: SetJournalDirectory
+Description: Sets where copy and move jobs keep their journals.
+Parameters: directory - folder for journals, or "" to stop journaling
+Return: None
+*/
+void FileOperations::SetJournalDirectory(const wxString& directory)
+{
+    std::lock_guard<std::mutex> guard(g_journalLock);
+    g_journalDirectory = directory.ToStdString();
+}
@@ -2,7 +2,10 @@
 Author: Guo Jia
 Description: Declaration of FileOperations – a stateless utility class whose
              static methods wrap std::filesystem calls for open, mkdir, rename,
-             delete, copy, and move.
+             delete, copy, and move.  When a scheduler is installed, every
+             operation waits for its devices' slots and copies are charged
+             against their bandwidth limits.  Copies and cross-device moves
+             keep a journal so an interrupted one resumes when run again.
 Date: 2026-02-02
 */
 
@@ -11,6 +14,8 @@ Date: 2026-02-02
 
 #include <wx/string.h>
 
+class IoScheduler;
+
 class FileOperations
 {
 public:
@@ -46,6 +51,14 @@ public:
     // Returns true if something already exists at the given path.
     static bool Exists(const wxString& path);
 
+    // Route every operation above through 'scheduler' (nullptr: run
+    // unscheduled).  The scheduler must outlive the operations using it.
+    static void SetScheduler(IoScheduler* scheduler);
+
+    // Keep copy and move journals in 'directory' ("" turns journaling
+    // off).  See CopyJournal for finding interrupted jobs.
+    static void SetJournalDirectory(const wxString& directory);
+
 private:
 };
 
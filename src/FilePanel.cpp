@@ -6,10 +6,55 @@ Date: 2026-01-31
 
 #include "FilePanel.h"
 
-#include <wx/dir.h>
-#include <wx/filename.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <wx/bitmap.h>
 #include <wx/datetime.h>
+#include <wx/menu.h>
 #include <wx/sizer.h>
+#include <wx/stattext.h>
+#include "FileSystemBackend.h"
+
+namespace
+{
+    struct ColumnInfo
+    {
+        const char* title;
+        int         format;
+        int         width;
+    };
+
+    // Indexed by FilePanel's Columns enum.
+    const ColumnInfo COLUMN_INFO[] = {
+        { "Name",        wxLIST_FORMAT_LEFT,  300 },
+        { "Type",        wxLIST_FORMAT_LEFT,  140 },
+        { "Size",        wxLIST_FORMAT_RIGHT, 100 },
+        { "Modified",    wxLIST_FORMAT_LEFT,  160 },
+        { "Permissions", wxLIST_FORMAT_LEFT,  100 },
+        { "Owner",       wxLIST_FORMAT_LEFT,  90  },
+        { "Group",       wxLIST_FORMAT_LEFT,  90  },
+        { "Inode",       wxLIST_FORMAT_RIGHT, 100 },
+        { "Links",       wxLIST_FORMAT_RIGHT, 60  },
+        { "Allocated",   wxLIST_FORMAT_RIGHT, 100 }
+    };
+
+    // Base id of the column menu; item id = base + logical column.
+    const int COLUMN_MENU_ID = wxID_HIGHEST + 1;
+
+    // Generations are drawn from one sequence for all panels (GUI thread
+    // only), so a (panel, generation) pair is never reused, even by a new
+    // panel created where a closed one was.
+    unsigned long g_lastGeneration = 0;
+
+    template <typename T>
+    int Compare(const T& first, const T& second)
+    {
+        return (first < second) ? -1 : (second < first ? 1 : 0);
+    }
+}
 
 // ---------------------------------------------------------------------------
 // Construction / destruction
@@ -17,26 +62,88 @@ Date: 2026-01-31
 
 /*
 Function: FilePanel
-Description: Constructs the file panel and initializes UI controls.
-Parameters: parent - parent window
+Description: Constructs the file panel, initializes UI controls and
+             registers with the shared type scanner and thumbnail loader.
+Parameters: parent      - parent window
+            typeScanner - sniffs the Type column for every panel
+            thumbLoader - produces thumbnails for every panel
 Return: None
 */
-FilePanel::FilePanel(wxWindow* parent)
+FilePanel::FilePanel(wxWindow* parent, FileTypeScanner& typeScanner, ThumbnailLoader& thumbLoader)
     : wxPanel(parent),
       m_fileList(nullptr),
-      m_currentPath("")
+      m_typeChoice(nullptr),
+      m_currentPath(""),
+      m_listing(),
+      m_generation(++g_lastGeneration),
+      m_columns{ COL_NAME, COL_TYPE, COL_SIZE, COL_MODIFIED },
+      m_details(),
+      m_idNames(),
+      m_order(),
+      m_rows(),
+      m_sortColumn(COL_NAME),
+      m_sortAscending(true),
+      m_typeFilter(),
+      m_orderStale(false),
+      m_types(),
+      m_knownTypes(),
+      m_typeGeneration(0),
+      m_typeScanner(typeScanner),
+      m_typeClient(0),
+      m_thumbnailView(false),
+      m_thumbImages(THUMB_SIZE, THUMB_SIZE, false, THUMB_SLOTS + 1),
+      m_entrySlots(),
+      m_slotEntries(THUMB_SLOTS + 1, -1),
+      m_nextSlot(1),
+      m_thumbGeneration(0),
+      m_thumbLoader(thumbLoader),
+      m_thumbClient(0),
+      m_visibleTop(-1),
+      m_visibleBottom(-1),
+      m_pollTimer(this)
 {
     InitializeListControl();
+
+    // Slot 0: a fully transparent placeholder, so rows keep their layout
+    // while thumbnails are on their way.
+    wxImage placeholder(THUMB_SIZE, THUMB_SIZE);
+    placeholder.InitAlpha();
+    memset(placeholder.GetAlpha(), 0, static_cast<size_t>(THUMB_SIZE * THUMB_SIZE));
+    m_thumbImages.Add(wxBitmap(placeholder));
+
+    m_typeClient = m_typeScanner.AddClient(
+        [this](unsigned long generation, std::vector<FileTypeScanner::Result> results)
+        {
+            CallAfter([this, generation, results = std::move(results)]()
+            {
+                OnTypesReady(generation, results);
+            });
+        });
+    m_thumbClient = m_thumbLoader.AddClient(
+        [this](unsigned long generation, long entry, std::shared_ptr<const wxImage> image)
+        {
+            CallAfter([this, generation, entry, image]()
+            {
+                OnThumbnailReady(generation, entry, image);
+            });
+        });
+
+    Bind(wxEVT_TIMER, &FilePanel::OnPollTimer, this, m_pollTimer.GetId());
+    m_pollTimer.Start(POLL_MS);
 }
 
 /*
 Function: ~FilePanel
-Description: Destroys the file panel.
+Description: Destroys the file panel.  Unregistering waits for a result
+             being handed to it, so none arrives after the panel is gone.
 Parameters: None
 Return: None
 */
 FilePanel::~FilePanel()
 {
+    m_pollTimer.Stop();
+    m_typeScanner.RemoveClient(m_typeClient);
+    m_thumbLoader.RemoveClient(m_thumbClient);
 }
 
 // ---------------------------------------------------------------------------
@@ -46,28 +153,46 @@ FilePanel::~FilePanel()
 /*
 Function: InitializeListControl
 Description: Creates and configures the file list control with all four
-             columns: Name, Type, Size, and Modified.
+             columns: Name, Type, Size, and Modified.  The control is
+             virtual: it holds no rows and formats only what is on screen.
+             A type filter sits above it; column headers sort, and their
+             context menu adds or removes the optional columns.
 Parameters: None
 Return: None
 */
 void FilePanel::InitializeListControl()
 {
-    m_fileList = new wxListCtrl(
+    m_fileList = new FileListCtrl(
         this,
-        wxID_ANY,
-        wxDefaultPosition,
-        wxDefaultSize,
-        wxLC_REPORT | wxLC_SINGLE_SEL
+        [this](long item, long column) { return GetCellText(item, column); }
     );
+    m_fileList->SetImageProvider([this](long item) { return GetRowImage(item); });
+
+    static_assert(sizeof(COLUMN_INFO) / sizeof(COLUMN_INFO[0]) == COL_COUNT,
+                  "COLUMN_INFO must describe every column");
+    for (size_t display = 0; display < m_columns.size(); ++display)
+    {
+        const ColumnInfo& info = COLUMN_INFO[m_columns[display]];
+        m_fileList->InsertColumn(static_cast<long>(display), info.title, info.format, info.width);
+    }
+    m_fileList->Bind(wxEVT_LIST_COL_CLICK,       &FilePanel::OnColumnClick,      this);
+    m_fileList->Bind(wxEVT_LIST_COL_RIGHT_CLICK, &FilePanel::OnColumnRightClick, this);
+    m_fileList->Bind(wxEVT_LIST_CACHE_HINT,      &FilePanel::OnCacheHint,        this);
+
+    m_typeChoice = new wxChoice(this, wxID_ANY);
+    m_typeChoice->Append("All types");
+    m_typeChoice->SetSelection(0);
+    m_typeChoice->Bind(wxEVT_CHOICE, &FilePanel::OnTypeFilter, this);
 
-    m_fileList->InsertColumn(COL_NAME,     "Name",     wxLIST_FORMAT_LEFT,  300);
-    m_fileList->InsertColumn(COL_TYPE,     "Type",     wxLIST_FORMAT_LEFT,  80);
-    m_fileList->InsertColumn(COL_SIZE,     "Size",     wxLIST_FORMAT_RIGHT, 100);
-    m_fileList->InsertColumn(COL_MODIFIED, "Modified", wxLIST_FORMAT_LEFT,  160);
+    wxBoxSizer* filterRow = new wxBoxSizer(wxHORIZONTAL);
+    filterRow->AddStretchSpacer();
+    filterRow->Add(new wxStaticText(this, wxID_ANY, "Show:"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 4);
+    filterRow->Add(m_typeChoice, 0);
 
     // Give this panel its own sizer so the list control fills it fully
     // and resizes along with the window.
     wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(filterRow, 0, wxEXPAND | wxALL, 2);
     sizer->Add(m_fileList, 1, wxEXPAND);
     SetSizer(sizer);
 }
@@ -79,7 +204,6 @@ void FilePanel::InitializeListControl()
 /*
 Function: LoadDirectory
 Description: Loads the contents of a directory into the list control.
-             Populates Name, Type, Size, and Modified for every entry.
              Returns false and leaves the previous listing intact if the
              directory cannot be opened.
 Parameters: path - filesystem path to load
@@ -87,106 +211,1030 @@ Return: true if the directory was listed successfully, false otherwise
 */
 bool FilePanel::LoadDirectory(const wxString& path)
 {
-    wxDir directory(path);
-    if (!directory.IsOpened())
+    DirectoryListing listing;
+    if (!listing.Load(path.ToStdString()))
     {
         return false;   // leave the current listing and m_currentPath unchanged
     }
 
-    // Directory opened successfully – commit to the new path now.
-    m_currentPath = path;
-    m_fileList->DeleteAllItems();
+    ShowListing(listing);
+    return true;
+}
+
+/*
+Function: ShowListing
+Description: Makes the given listing the one on screen.  Only the row count
+             is handed to the virtual list; cell text is produced lazily by
+             GetCellText().  The sort order carries over from the previous
+             directory; the type filter does not, as its types may not exist
+             here.
+Parameters: listing - listing to display; its path becomes the current path
+Return: None
+*/
+void FilePanel::ShowListing(const DirectoryListing& listing)
+{
+    m_listing     = listing;
+    m_currentPath = wxString(listing.GetPath());
+    m_generation  = ++g_lastGeneration;
+
+    m_typeFilter.clear();
+    m_knownTypes.clear();
+    m_typeChoice->Clear();
+    m_typeChoice->Append("All types");
+    m_typeChoice->SetSelection(0);
+    ResetTypes();
+    ResetDetails();
+    ResetThumbnails();
+
+    m_fileList->SetItemState(-1, 0, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED);
+    ApplyOrder();
+    if (!m_order.empty())
+    {
+        m_fileList->EnsureVisible(0);
+    }
+    m_fileList->Refresh();
+}
+
+/*
+Function: MergeListing
+Description: Swaps in a newer listing of the directory already on screen.
+             Unlike ShowListing() the scroll position is left alone and the
+             selected entry is looked up by name in the new rows, so a
+             background revalidation does not disturb the user.
+Parameters: listing - fresh listing of CurrentPath()
+Return: Number of entries added, removed or changed
+*/
+size_t FilePanel::MergeListing(const DirectoryListing& listing)
+{
+    size_t changes = m_listing.CountChanges(listing);
+    if (changes == 0)
+    {
+        return 0;
+    }
+
+    std::string selectedName = GetSelectedName().ToStdString();
+
+    m_listing = listing;
+    ResetTypes();        // entries may have shifted; unchanged files are
+    ResetDetails();      // answered from the caches
+    ResetThumbnails();
+    m_fileList->SetItemState(-1, 0, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED);
+    ApplyOrder();
+
+    long selected = selectedName.empty() ? -1 : m_listing.Find(selectedName);
+    long row      = (selected == -1) ? -1 : m_rows[selected];
+    if (row != -1)
+    {
+        m_fileList->SetItemState(row, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED,
+                                 wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED);
+        m_fileList->EnsureVisible(row);
+    }
+    m_fileList->Refresh();
+    return changes;
+}
+
+/*
+Function: GetSelectedName
+Description: Returns the filename of the currently selected row in the list
+             control.  Used by MainFrame to know which item the user wants to
+             act on.  Returns an empty string if no row is selected.
+Parameters: None
+Return: Name-column text of the selected item, or "" if none selected
+*/
+wxString FilePanel::GetSelectedName() const
+{
+    long selected = m_fileList->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+    if (selected == wxNOT_FOUND)
+    {
+        return "";
+    }
+    return GetNameAt(selected);
+}
+
+/*
+Function: GetSelectedNames
+Description: Collects the names of every selected row, for operations
+             that act on a multiple selection.
+Parameters: None
+Return: Selected names in row order; empty if nothing is selected
+*/
+std::vector<wxString> FilePanel::GetSelectedNames() const
+{
+    std::vector<wxString> names;
+    long row = m_fileList->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+    while (row != wxNOT_FOUND)
+    {
+        names.push_back(GetNameAt(row));
+        row = m_fileList->GetNextItem(row, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+    }
+    return names;
+}
+
+/*
+Function: GetNameAt
+Description: Returns the name of the entry shown in a row.
+Parameters: index - row index
+Return: Entry name, or "" if the index is out of range
+*/
+wxString FilePanel::GetNameAt(long index) const
+{
+    long entry = EntryAt(index);
+    if (entry == -1)
+    {
+        return "";
+    }
+    return wxString(m_listing.GetEntries()[entry].name);
+}
+
+/*
+Function: IsDirectoryAt
+Description: Reports whether a row is a directory, from the listing rather
+             than the file system.
+Parameters: index - row index
+Return: true for a directory row
+*/
+bool FilePanel::IsDirectoryAt(long index) const
+{
+    long entry = EntryAt(index);
+    if (entry == -1)
+    {
+        return false;
+    }
+    return m_listing.GetEntries()[entry].isDirectory;
+}
+
+/*
+Function: GetEntryAt
+Description: Gives callers the size, type and time of a row without
+             another stat.
+Parameters: index - row index
+Return: Pointer into the current listing (valid until it changes), or
+        nullptr if the index is out of range
+*/
+const DirectoryListing::Entry* FilePanel::GetEntryAt(long index) const
+{
+    long entry = EntryAt(index);
+    if (entry == -1)
+    {
+        return nullptr;
+    }
+    return &m_listing.GetEntries()[entry];
+}
+
+/*
+Function: GetCellText
+Description: Formats one cell of the listing.  Directories show a dash in
+             the Size column, as do empty files.  A file's Type stays blank
+             until the scanner has sniffed it; metadata cells stay blank
+             until OnCacheHint() has read them.
+Parameters: item   - row index
+            column - display column
+Return: Cell text
+*/
+wxString FilePanel::GetCellText(long item, long column) const
+{
+    long index = EntryAt(item);
+    if (index == -1 || column < 0 || static_cast<size_t>(column) >= m_columns.size())
+    {
+        return "";
+    }
+    const DirectoryListing::Entry& entry = m_listing.GetEntries()[index];
+    int logical = m_columns[column];
+
+    const EntryDetails::Record* details = DetailsOf(index, FieldsFor(logical));
+    if (FieldsFor(logical) != 0 && (details == nullptr || !details->readable))
+    {
+        return (details == nullptr) ? "" : "—";
+    }
+
+    switch (logical)
+    {
+    case COL_NAME:
+        return wxString(entry.name);
+    case COL_TYPE:
+        return entry.isDirectory ? wxString("Directory") : wxString(m_types[index]);
+    case COL_SIZE:
+        if (entry.isDirectory || entry.size == 0)
+        {
+            return "—";
+        }
+        return FormatSize(static_cast<wxUIntPtr>(entry.size));
+    case COL_MODIFIED:
+        return FormatDate(entry.modified);
+    case COL_PERMISSIONS:
+        return wxString(EntryDetails::FormatMode(details->mode));
+    case COL_OWNER:
+        return wxString(m_idNames.UserName(details->uid));
+    case COL_GROUP:
+        return wxString(m_idNames.GroupName(details->gid));
+    case COL_INODE:
+        return wxString::Format("%llu", static_cast<unsigned long long>(entry.inode));
+    case COL_LINKS:
+        return wxString::Format("%llu", static_cast<unsigned long long>(details->links));
+    case COL_ALLOCATED:
+        return FormatSize(static_cast<wxUIntPtr>(details->allocated));
+    default:
+        return "";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Row order
+// ---------------------------------------------------------------------------
 
-    // Collect all filenames first so we can sort them.
-    wxArrayString filenames;
-    wxString filename;
-    bool hasFile = directory.GetFirst(&filename);
-    while (hasFile)
+/*
+Function: EntryAt
+Description: Maps a row of the list to the listing entry it shows.
+Parameters: row - row index
+Return: Entry index, or -1 if the row is out of range
+*/
+long FilePanel::EntryAt(long row) const
+{
+    if (row < 0 || static_cast<size_t>(row) >= m_order.size())
     {
-        filenames.Add(filename);
-        hasFile = directory.GetNext(&filename);
+        return -1;
     }
+    return m_order[row];
+}
 
-    // Sort alphabetically (case-insensitive).
-    filenames.Sort();
+/*
+Function: ApplyOrder
+Description: Rebuilds the rows from the listing: entries failing the type
+             filter are left out and the rest sorted by the sort column,
+             folders first either way.  The listing is already in name
+             order, so a stable sort keeps ties in name order and sorting
+             by name needs no comparisons of names at all.  Sorting by a
+             metadata column reads that field for every entry first.  The
+             selected entries stay selected if they are still shown.
+Parameters: None
+Return: None
+*/
+void FilePanel::ApplyOrder()
+{
+    std::vector<long> selected;
+    long selectedRow = m_fileList->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+    while (selectedRow != wxNOT_FOUND)
+    {
+        selected.push_back(EntryAt(selectedRow));
+        selectedRow = m_fileList->GetNextItem(selectedRow, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+    }
+    const std::vector<DirectoryListing::Entry>& entries = m_listing.GetEntries();
+    long count = static_cast<long>(entries.size());
 
-    // Now populate the list with the sorted entries.
-    for (size_t i = 0; i < filenames.GetCount(); ++i)
+    if (FieldsFor(m_sortColumn) != 0)
     {
-        filename = filenames[i];
+        std::vector<long> all(entries.size());
+        for (long entry = 0; entry < count; ++entry)
+        {
+            all[entry] = entry;
+        }
+        FetchDetails(all, FieldsFor(m_sortColumn));
+    }
 
-        // Construct the full path to this item by joining the directory
-        // path with the filename.  We can't use wxFileName(dir, file) because
-        // that assumes 'file' is a file, not a potential subdirectory.
-        wxString fullPath = path;
-        if (!fullPath.EndsWith(wxFileName::GetPathSeparator()))
+    m_order.clear();
+    for (long entry = 0; entry < count; ++entry)
+    {
+        if (PassesFilter(entry))
         {
-            fullPath += wxFileName::GetPathSeparator();
+            m_order.push_back(entry);
         }
-        fullPath += filename;
+    }
 
-        // --- Name -----------------------------------------------------------
-        long index = m_fileList->GetItemCount();
-        m_fileList->InsertItem(index, filename);
+    std::stable_sort(m_order.begin(), m_order.end(), [this, &entries](long a, long b)
+    {
+        const DirectoryListing::Entry& first  = entries[a];
+        const DirectoryListing::Entry& second = entries[b];
+        if (first.isDirectory != second.isDirectory)
+        {
+            return first.isDirectory;
+        }
 
-        // --- Type -----------------------------------------------------------
-        // CRITICAL: Use the static wxFileName::DirExists(fullPath), NOT the
-        // instance method file.DirExists() which checks if the parent directory
-        // exists, not if fullPath itself is a directory.
-        if (wxFileName::DirExists(fullPath))
+        int order = 0;
+        switch (m_sortColumn)
         {
-            m_fileList->SetItem(index, COL_TYPE, "Directory");
+        case COL_TYPE:
+            order = m_types[a].compare(m_types[b]);
+            break;
+        case COL_SIZE:
+            order = Compare(first.size, second.size);
+            break;
+        case COL_MODIFIED:
+            order = Compare(first.modified, second.modified);
+            break;
+        case COL_PERMISSIONS:
+            order = Compare(m_details[a].mode & 07777, m_details[b].mode & 07777);
+            break;
+        case COL_OWNER:
+            order = m_idNames.UserName(m_details[a].uid).compare(m_idNames.UserName(m_details[b].uid));
+            break;
+        case COL_GROUP:
+            order = m_idNames.GroupName(m_details[a].gid).compare(m_idNames.GroupName(m_details[b].gid));
+            break;
+        case COL_INODE:
+            order = Compare(first.inode, second.inode);
+            break;
+        case COL_LINKS:
+            order = Compare(m_details[a].links, m_details[b].links);
+            break;
+        case COL_ALLOCATED:
+            order = Compare(m_details[a].allocated, m_details[b].allocated);
+            break;
+        default:
+            order = Compare(a, b);
+            break;
         }
-        else
+        return m_sortAscending ? order < 0 : order > 0;
+    });
+
+    m_rows.assign(entries.size(), -1);
+    for (size_t row = 0; row < m_order.size(); ++row)
+    {
+        m_rows[m_order[row]] = static_cast<long>(row);
+    }
+
+    m_fileList->SetItemState(-1, 0, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED);
+    m_fileList->SetItemCount(static_cast<long>(m_order.size()));
+    long focus = wxLIST_STATE_FOCUSED;
+    for (long entry : selected)
+    {
+        if (entry != -1 && m_rows[entry] != -1)
+        {
+            m_fileList->SetItemState(m_rows[entry], wxLIST_STATE_SELECTED | focus,
+                                     wxLIST_STATE_SELECTED | focus);
+            focus = 0;   // the first selected row keeps the focus
+        }
+    }
+    m_visibleTop    = -1;   // the rows on screen are different ones now
+    m_visibleBottom = -1;
+    m_fileList->Refresh();
+}
+
+/*
+Function: PassesFilter
+Description: Checks an entry against the type filter.  Files whose type
+             is not known yet are hidden until it is.
+Parameters: entry - entry index
+Return: true if the entry is shown
+*/
+bool FilePanel::PassesFilter(long entry) const
+{
+    if (m_typeFilter.empty())
+    {
+        return true;
+    }
+    if (m_listing.GetEntries()[entry].isDirectory)
+    {
+        return m_typeFilter == "Directory";
+    }
+    return m_types[entry] == m_typeFilter;
+}
+
+/*
+Function: OnColumnClick
+Description: Sorts by the clicked column; clicking the sort column again
+             reverses the direction.
+Parameters: event - column-click event
+Return: None
+*/
+void FilePanel::OnColumnClick(wxListEvent& event)
+{
+    int display = event.GetColumn();
+    if (display < 0 || static_cast<size_t>(display) >= m_columns.size())
+    {
+        return;
+    }
+    int column = m_columns[display];
+    if (column == m_sortColumn)
+    {
+        m_sortAscending = !m_sortAscending;
+    }
+    else
+    {
+        m_sortColumn    = column;
+        m_sortAscending = true;
+    }
+    ApplyOrder();
+
+    long selected = m_fileList->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+    if (selected != wxNOT_FOUND)
+    {
+        m_fileList->EnsureVisible(selected);
+    }
+}
+
+/*
+Function: OnTypeFilter
+Description: Shows only the entries of the chosen type, or all of them.
+Parameters: event - choice event (unused)
+Return: None
+*/
+void FilePanel::OnTypeFilter(wxCommandEvent& /*event*/)
+{
+    int choice   = m_typeChoice->GetSelection();
+    m_typeFilter = (choice <= 0) ? std::string() : m_typeChoice->GetString(choice).ToStdString();
+    ApplyOrder();
+    if (!m_order.empty())
+    {
+        m_fileList->EnsureVisible(0);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Optional columns
+// ---------------------------------------------------------------------------
+
+/*
+Function: OnColumnRightClick
+Description: Offers every column but Name as a check item and shows or
+             hides the one picked.
+Parameters: event - column-right-click event (unused)
+Return: None
+*/
+void FilePanel::OnColumnRightClick(wxListEvent& /*event*/)
+{
+    wxMenu menu;
+    for (int column = COL_TYPE; column < COL_COUNT; ++column)
+    {
+        menu.AppendCheckItem(COLUMN_MENU_ID + column, COLUMN_INFO[column].title);
+        menu.Check(COLUMN_MENU_ID + column, IsColumnShown(column));
+    }
+
+    int column = GetPopupMenuSelectionFromUser(menu) - COLUMN_MENU_ID;
+    if (column > COL_NAME && column < COL_COUNT)
+    {
+        ShowColumn(column, !IsColumnShown(column));
+    }
+}
+
+/*
+Function: OnCacheHint
+Description: The list announces the rows it is about to paint; the fields
+             the shown columns need are read for those rows only, just
+             before they are formatted.
+Parameters: event - cache-hint event with the row range
+Return: None
+*/
+void FilePanel::OnCacheHint(wxListEvent& event)
+{
+    unsigned int fields = WantedFields();
+    if (fields == 0)
+    {
+        return;
+    }
+    std::vector<long> entries;
+    for (long row = event.GetCacheFrom(); row <= event.GetCacheTo(); ++row)
+    {
+        long entry = EntryAt(row);
+        if (entry != -1)
+        {
+            entries.push_back(entry);
+        }
+    }
+    FetchDetails(entries, fields);
+}
+
+/*
+Function: ShowColumn
+Description: Inserts or deletes a list column, keeping the display order
+             equal to the logical order.  Hiding the sort column goes back
+             to sorting by name.
+Parameters: column - logical column
+            show   - true to show it
+Return: None
+*/
+void FilePanel::ShowColumn(int column, bool show)
+{
+    auto position = std::lower_bound(m_columns.begin(), m_columns.end(), column);
+    bool shown    = position != m_columns.end() && *position == column;
+    if (show == shown)
+    {
+        return;
+    }
+    long display = static_cast<long>(position - m_columns.begin());
+
+    if (show)
+    {
+        m_columns.insert(position, column);
+        const ColumnInfo& info = COLUMN_INFO[column];
+        m_fileList->InsertColumn(display, info.title, info.format, info.width);
+        m_visibleTop    = -1;   // read the new column's rows on the next poll
+        m_visibleBottom = -1;
+    }
+    else
+    {
+        m_columns.erase(position);
+        m_fileList->DeleteColumn(static_cast<int>(display));
+        if (column == m_sortColumn)
+        {
+            m_sortColumn    = COL_NAME;
+            m_sortAscending = true;
+            ApplyOrder();
+        }
+    }
+    m_fileList->Refresh();
+}
+
+/*
+Function: IsColumnShown
+Description: Reports whether a logical column is on screen.
+Parameters: column - logical column
+Return: true if shown
+*/
+bool FilePanel::IsColumnShown(int column) const
+{
+    return std::binary_search(m_columns.begin(), m_columns.end(), column);
+}
+
+/*
+Function: WantedFields
+Description: Union of the metadata fields the shown columns need.
+Parameters: None
+Return: EntryDetails::FIELD_* bits; 0 in the default view
+*/
+unsigned int FilePanel::WantedFields() const
+{
+    unsigned int fields = 0;
+    for (int column : m_columns)
+    {
+        fields |= FieldsFor(column);
+    }
+    return fields;
+}
+
+/*
+Function: ResetDetails
+Description: Drops the metadata of the previous entries; it is read again
+             as rows are painted.
+Parameters: None
+Return: None
+*/
+void FilePanel::ResetDetails()
+{
+    m_details.clear();
+}
+
+/*
+Function: FetchDetails
+Description: Reads the given fields of the given entries where they have
+             not been read yet.  The directory is only opened when there is
+             something to read, so repainting rows costs nothing.  Entries
+             that cannot be read in place are marked unreadable.
+Parameters: entries - entry indices
+            fields  - EntryDetails::FIELD_* bits
+Return: None
+*/
+void FilePanel::FetchDetails(const std::vector<long>& entries, unsigned int fields)
+{
+    if (m_details.size() != m_listing.GetCount())
+    {
+        m_details.assign(m_listing.GetCount(), EntryDetails::Record());
+    }
+
+    std::unique_ptr<EntryDetails> reader;
+    for (long entry : entries)
+    {
+        EntryDetails::Record& record = m_details[entry];
+        unsigned int missing = fields & ~record.fields;
+        if (missing == 0)
+        {
+            continue;
+        }
+        if (!CanReadEntries())
         {
-            m_fileList->SetItem(index, COL_TYPE, "File");
+            record.fields  |= missing;
+            record.readable = false;
+            continue;
         }
+        if (!reader)
+        {
+            reader.reset(new EntryDetails(m_listing.GetPath()));
+        }
+        reader->Read(m_listing.GetEntries()[entry].name, missing, record);
+    }
+}
 
-        // --- Size -----------------------------------------------------------
-        // Directories don't have a meaningful "size" in most file managers;
-        // show a dash for them.  For regular files, stat the size via wxFileName.
-        if (wxFileName::DirExists(fullPath))
+/*
+Function: DetailsOf
+Description: The metadata of an entry, if the given fields have been read.
+Parameters: entry - entry index
+            field - EntryDetails::FIELD_* bits required
+Return: The record, or nullptr if it is not there yet
+*/
+const EntryDetails::Record* FilePanel::DetailsOf(long entry, unsigned int field) const
+{
+    if (static_cast<size_t>(entry) >= m_details.size())
+    {
+        return nullptr;
+    }
+    const EntryDetails::Record& record = m_details[entry];
+    return ((record.fields & field) == field) ? &record : nullptr;
+}
+
+/*
+Function: FieldsFor
+Description: Maps a column to the metadata it displays.  Name, Type, Size,
+             Modified and Inode come with the listing itself.
+Parameters: column - logical column
+Return: EntryDetails::FIELD_* bits, 0 if none are needed
+*/
+unsigned int FilePanel::FieldsFor(int column)
+{
+    switch (column)
+    {
+    case COL_PERMISSIONS:
+        return EntryDetails::FIELD_MODE;
+    case COL_OWNER:
+        return EntryDetails::FIELD_OWNER;
+    case COL_GROUP:
+        return EntryDetails::FIELD_GROUP;
+    case COL_LINKS:
+        return EntryDetails::FIELD_LINKS;
+    case COL_ALLOCATED:
+        return EntryDetails::FIELD_ALLOCATED;
+    default:
+        return 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Background work for the visible rows
+// ---------------------------------------------------------------------------
+
+/*
+Function: OnPollTimer
+Description: Applies type results that move rows (at most once per tick,
+             however many batches arrived), then, when the visible rows
+             have changed, puts them at the front of the type scanner's
+             queue and of the thumbnail loader's, and reads any metadata
+             the shown columns still lack for them.
+Parameters: event - timer event (unused)
+Return: None
+*/
+void FilePanel::OnPollTimer(wxTimerEvent& /*event*/)
+{
+    if (m_orderStale)
+    {
+        m_orderStale = false;
+        ApplyOrder();
+    }
+
+    long count  = static_cast<long>(m_order.size());
+    long top    = std::max(0L, m_fileList->GetTopItem());
+    long bottom = std::min(count, top + m_fileList->GetCountPerPage() + 1);
+    if (top == m_visibleTop && bottom == m_visibleBottom)
+    {
+        return;
+    }
+    m_visibleTop    = top;
+    m_visibleBottom = bottom;
+
+    std::vector<FileTypeScanner::Request> requests;
+    for (long row = top; row < bottom; ++row)
+    {
+        long entry = m_order[row];
+        if (!m_listing.GetEntries()[entry].isDirectory && m_types[entry].empty())
         {
-            m_fileList->SetItem(index, COL_SIZE, "—");
+            requests.push_back(TypeRequest(entry));
+        }
+    }
+    m_typeScanner.SetVisible(m_typeClient, m_typeGeneration, requests);
+
+    // Cache hints only come when the painted range moves; after the
+    // entries or the columns change the same rows need reading too.
+    if (WantedFields() != 0 && bottom > top)
+    {
+        FetchDetails(std::vector<long>(m_order.begin() + top, m_order.begin() + bottom), WantedFields());
+        m_fileList->RefreshItems(top, bottom - 1);
+    }
+
+    if (m_thumbnailView)
+    {
+        RequestThumbnails(top, bottom);
+    }
+}
+
+/*
+Function: CanReadEntries
+Description: The type sniffer, EntryDetails and the thumbnail loader open
+             files by path on this machine, which is only right for a
+             folder on disk browsed through the local backend.
+Parameters: None
+Return: true if the entries may be read
+*/
+bool FilePanel::CanReadEntries() const
+{
+    return !m_listing.IsVirtual() && FileSystemBackend::Current().IsLocal();
+}
+
+// ---------------------------------------------------------------------------
+// Type column
+// ---------------------------------------------------------------------------
+
+/*
+Function: ResetTypes
+Description: Forgets the types of the previous entries and queues every
+             file of the listing with the scanner.  Files it has seen
+             before (same device, inode and mtime) come back from its cache
+             without being read.  Files inside an archive cannot be read
+             in place and are simply typed "Archive member"; on a backend
+             other than the local file system they are typed "File".
+Parameters: None
+Return: None
+*/
+void FilePanel::ResetTypes()
+{
+    ++m_typeGeneration;
+    const std::vector<DirectoryListing::Entry>& entries = m_listing.GetEntries();
+    m_types.assign(entries.size(), std::string());
+    m_orderStale = false;
+
+    std::vector<FileTypeScanner::Request> requests;
+    requests.reserve(entries.size());
+    for (long entry = 0; entry < static_cast<long>(entries.size()); ++entry)
+    {
+        if (entries[entry].isDirectory)
+        {
+            AddKnownType("Directory");
+        }
+        else if (!CanReadEntries())
+        {
+            m_types[entry] = m_listing.IsVirtual() ? "Archive member" : "File";
+            AddKnownType(m_types[entry]);
         }
         else
         {
-            wxFileName file(fullPath);
-            if (file.GetSize().ToULong() != 0)
-            {
-                m_fileList->SetItem(index, COL_SIZE,
-                                    FormatSize(file.GetSize().ToULong()));
-            }
-            else
-            {
-                m_fileList->SetItem(index, COL_SIZE, "—");
-            }
+            requests.push_back(TypeRequest(entry));
+        }
+    }
+    m_typeScanner.SetListing(m_typeClient, m_typeGeneration, m_listing.GetPath(), requests);
+}
+
+/*
+Function: OnTypesReady
+Description: Stores a batch of sniffed types.  When the rows depend on
+             types (sorted by type, or filtered) they are rebuilt on the
+             next poll; otherwise a repaint shows the new cells.
+Parameters: generation - type generation the batch was requested in
+            results    - entry index and type of each file
+Return: None
+*/
+void FilePanel::OnTypesReady(unsigned long generation, const std::vector<FileTypeScanner::Result>& results)
+{
+    if (generation != m_typeGeneration)
+    {
+        return;
+    }
+    for (const FileTypeScanner::Result& result : results)
+    {
+        if (result.index >= 0 && static_cast<size_t>(result.index) < m_types.size())
+        {
+            m_types[result.index] = result.type;
+            AddKnownType(result.type);
         }
+    }
 
-        // --- Modified -------------------------------------------------------
-        wxFileName file(fullPath);
-        m_fileList->SetItem(index, COL_MODIFIED, FormatDate(file));
+    if (m_sortColumn == COL_TYPE || !m_typeFilter.empty())
+    {
+        m_orderStale = true;
+    }
+    else
+    {
+        m_fileList->Refresh();
     }
+}
 
-    return true;
+/*
+Function: AddKnownType
+Description: Adds a type to the filter choice the first time it is seen,
+             keeping the list alphabetical below "All types".
+Parameters: type - type name
+Return: None
+*/
+void FilePanel::AddKnownType(const std::string& type)
+{
+    auto inserted = m_knownTypes.insert(type);
+    if (!inserted.second)
+    {
+        return;
+    }
+    unsigned int position = static_cast<unsigned int>(std::distance(m_knownTypes.begin(), inserted.first)) + 1;
+    m_typeChoice->Insert(wxString(type), position);
+
+    // Inserting above the current choice shifts it down by one.
+    auto filter = m_knownTypes.find(m_typeFilter);
+    if (filter != m_knownTypes.end())
+    {
+        m_typeChoice->SetSelection(static_cast<int>(std::distance(m_knownTypes.begin(), filter)) + 1);
+    }
 }
 
 /*
-Function: GetSelectedName
-Description: Returns the filename of the currently selected row in the list
-             control.  Used by MainFrame to know which item the user wants to
-             act on.  Returns an empty string if no row is selected.
+Function: TypeRequest
+Description: Describes an entry to the type scanner.
+Parameters: entry - entry index
+Return: Scanner request
+*/
+FileTypeScanner::Request FilePanel::TypeRequest(long entry) const
+{
+    const DirectoryListing::Entry& source = m_listing.GetEntries()[entry];
+    return { entry, source.name, source.device, source.inode, source.modified };
+}
+
+// ---------------------------------------------------------------------------
+// Thumbnail view
+// ---------------------------------------------------------------------------
+
+/*
+Function: SetThumbnailView
+Description: Turns the thumbnail view on or off.  The loader and its disk
+             cache are shared with the other panels.
+Parameters: enable - true to show thumbnails
+Return: None
+*/
+void FilePanel::SetThumbnailView(bool enable)
+{
+    if (enable == m_thumbnailView)
+    {
+        return;
+    }
+    m_thumbnailView = enable;
+
+    if (enable)
+    {
+        m_fileList->SetImageList(&m_thumbImages, wxIMAGE_LIST_SMALL);
+        m_visibleTop    = -1;   // request the visible rows on the next poll
+        m_visibleBottom = -1;
+    }
+    else
+    {
+        m_thumbLoader.Clear(m_thumbClient);
+        m_fileList->SetImageList(nullptr, wxIMAGE_LIST_SMALL);
+    }
+    m_fileList->Refresh();
+}
+
+/*
+Function: RequestThumbnails
+Description: Asks the loader for the image entries on screen, then one
+             page below as look-ahead.  The new request list replaces the
+             old one, which cancels rows that were scrolled past before
+             their turn came.
+Parameters: top    - first visible row
+            bottom - one past the last visible row
+Return: None
+*/
+void FilePanel::RequestThumbnails(long top, long bottom)
+{
+    std::string directory = m_listing.GetPath();
+    if (directory.empty() || directory.back() != '/')
+    {
+        directory += '/';
+    }
+
+    std::vector<ThumbnailLoader::Request> requests;
+    long end = std::min(static_cast<long>(m_order.size()), bottom + (bottom - top));
+    for (long row = top; row < end; ++row)
+    {
+        long entry = m_order[row];
+        if (m_entrySlots.count(entry) != 0 || !IsImageEntry(entry))
+        {
+            continue;
+        }
+        const DirectoryListing::Entry& source = m_listing.GetEntries()[entry];
+        requests.push_back({ entry, directory + source.name, source.modified });
+    }
+    m_thumbLoader.SetRequests(m_thumbClient, m_thumbGeneration, requests);
+}
+
+/*
+Function: OnThumbnailReady
+Description: Shrinks a finished thumbnail to the list's row size, centres
+             it in a THUMB_SIZE square and stores it in the next image-list
+             slot, evicting the entry that held the slot before.
+Parameters: generation - thumbnail generation the request was made in
+            entry      - entry the thumbnail belongs to
+            image      - the thumbnail, or null if the file has none
+Return: None
+*/
+void FilePanel::OnThumbnailReady(unsigned long generation, long entry, std::shared_ptr<const wxImage> image)
+{
+    if (generation != m_thumbGeneration || !m_thumbnailView)
+    {
+        return;
+    }
+    long row = (entry >= 0 && static_cast<size_t>(entry) < m_rows.size()) ? m_rows[entry] : -1;
+    if (!image || !image->IsOk())
+    {
+        m_entrySlots[entry] = -1;
+        if (row != -1)
+        {
+            m_fileList->RefreshItem(row);
+        }
+        return;
+    }
+
+    wxImage fitted = image->Copy();
+    int longest = std::max(fitted.GetWidth(), fitted.GetHeight());
+    if (longest > THUMB_SIZE)
+    {
+        fitted.Rescale(std::max(1, fitted.GetWidth()  * THUMB_SIZE / longest),
+                       std::max(1, fitted.GetHeight() * THUMB_SIZE / longest),
+                       wxIMAGE_QUALITY_HIGH);
+    }
+    fitted = fitted.Size(wxSize(THUMB_SIZE, THUMB_SIZE),
+                         wxPoint((THUMB_SIZE - fitted.GetWidth()) / 2, (THUMB_SIZE - fitted.GetHeight()) / 2));
+
+    int slot   = m_nextSlot;
+    m_nextSlot = slot % THUMB_SLOTS + 1;
+    if (m_slotEntries[slot] != -1)
+    {
+        m_entrySlots.erase(m_slotEntries[slot]);
+    }
+    if (slot < m_thumbImages.GetImageCount())
+    {
+        m_thumbImages.Replace(slot, wxBitmap(fitted));
+    }
+    else
+    {
+        m_thumbImages.Add(wxBitmap(fitted));
+    }
+    m_slotEntries[slot] = entry;
+    m_entrySlots[entry] = slot;
+    if (row != -1)
+    {
+        m_fileList->RefreshItem(row);
+    }
+}
+
+/*
+Function: ResetThumbnails
+Description: Forgets which entries have thumbnails; called whenever the
+             entries change.  Re-sorting keeps them, as slots belong to
+             entries rather than rows.  Results still in flight are
+             recognised as stale by their generation.
 Parameters: None
-Return: Name-column text of the selected item, or "" if none selected
+Return: None
 */
-wxString FilePanel::GetSelectedName() const
+void FilePanel::ResetThumbnails()
 {
-    long selected = m_fileList->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
-    if (selected == wxNOT_FOUND)
+    ++m_thumbGeneration;
+    m_entrySlots.clear();
+    std::fill(m_slotEntries.begin(), m_slotEntries.end(), -1);
+    m_visibleTop    = -1;
+    m_visibleBottom = -1;
+    m_thumbLoader.Clear(m_thumbClient);
+}
+
+/*
+Function: GetRowImage
+Description: Image-list index for a row: its thumbnail, the placeholder
+             while one is pending, or none.
+Parameters: item - row index
+Return: Image-list index, or -1
+*/
+int FilePanel::GetRowImage(long item) const
+{
+    long entry = EntryAt(item);
+    if (!m_thumbnailView || entry == -1)
     {
-        return "";
+        return -1;
+    }
+    auto slot = m_entrySlots.find(entry);
+    if (slot != m_entrySlots.end())
+    {
+        return slot->second;
     }
-    return m_fileList->GetItemText(selected);
+    return IsImageEntry(entry) ? 0 : -1;
+}
+
+/*
+Function: IsImageEntry
+Description: An entry gets a thumbnail if it is a file that can be read in
+             place whose extension one of the registered wxImage handlers
+             claims.
+Parameters: entry - entry index
+Return: true for image files
+*/
+bool FilePanel::IsImageEntry(long entry) const
+{
+    if (entry < 0 || static_cast<size_t>(entry) >= m_listing.GetCount() || !CanReadEntries())
+    {
+        return false;
+    }
+    const DirectoryListing::Entry& source = m_listing.GetEntries()[entry];
+    if (source.isDirectory)
+    {
+        return false;
+    }
+    size_t dot = source.name.rfind('.');
+    if (dot == std::string::npos || dot + 1 == source.name.size())
+    {
+        return false;
+    }
+    std::string extension = source.name.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return wxImage::FindHandler(wxString(extension), wxBITMAP_TYPE_ANY) != nullptr;
 }
 
 // ---------------------------------------------------------------------------
@@ -223,17 +1271,16 @@ wxString FilePanel::FormatSize(wxUIntPtr bytes)
 /*
 Function: FormatDate
 Description: Returns a short, human-readable modification-date string for
-             the given file.  Falls back to "—" if the timestamp cannot be
-             retrieved.
-Parameters: fn - wxFileName to query
+             a timestamp.  Falls back to "—" if the timestamp is unknown.
+Parameters: seconds - modification time in seconds since the epoch
 Return: Formatted date string (e.g. "2026-01-31 14:05")
 */
-wxString FilePanel::FormatDate(const wxFileName& fn)
+wxString FilePanel::FormatDate(std::int64_t seconds)
 {
-    wxDateTime mod;
-    if (fn.GetTimes(nullptr, &mod, nullptr) && mod.IsValid())
+    wxDateTime mod(static_cast<time_t>(seconds));
+    if (seconds > 0 && mod.IsValid())
     {
         return mod.Format("%Y-%m-%d %H:%M");
     }
     return "—";
-}
\ No newline at end of file
+}
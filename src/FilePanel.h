@@ -1,58 +1,219 @@
 /*
 Author: Guo Jia
 Description: Declaration of FilePanel – the panel that displays a directory
-             listing with Name, Type, Size, and Modified columns.
+             listing with Name, Type, Size, and Modified columns, plus
+             optional metadata columns picked from the header's context
+             menu.  The Type column is sniffed from file contents in the
+             background; rows can be sorted by any column and filtered by
+             type.
 Date: 2026-01-31
 */
 
 #ifndef FILEPANEL_H
 #define FILEPANEL_H
 
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <wx/panel.h>
 
+#include <wx/choice.h>
 #include <wx/listctrl.h>
+#include <wx/imaglist.h>
 #include <wx/string.h>
-#include <wx/filename.h>
+#include <wx/timer.h>
+#include "DirectoryListing.h"
+#include "EntryDetails.h"
+#include "FileListCtrl.h"
+#include "FileTypeScanner.h"
+#include "IdNameCache.h"
+#include "ThumbnailLoader.h"
 
 class FilePanel : public wxPanel
 {
 public:
-    explicit FilePanel(wxWindow* parent);
+    // The type scanner and thumbnail loader are shared by all panels and
+    // must outlive this one.
+    FilePanel(wxWindow* parent, FileTypeScanner& typeScanner, ThumbnailLoader& thumbLoader);
     virtual ~FilePanel();
 
     // Reload the list from the given path.  Returns false if the directory
     // could not be opened (the previous listing is left intact).
     bool LoadDirectory(const wxString& path);
 
+    // Display a listing produced elsewhere (a snapshot, or one loaded on a
+    // worker thread).  Replaces the current rows and clears the selection.
+    void ShowListing(const DirectoryListing& listing);
+
+    // Diff a fresh listing of the *current* directory into the view,
+    // keeping the selected entry selected.  Returns the number of entries
+    // that were added, removed or changed.
+    size_t MergeListing(const DirectoryListing& listing);
+
+    // The listing currently shown, e.g. for persisting it as a snapshot.
+    const DirectoryListing& GetListing() const { return m_listing; }
+
+    // Changes every time a different listing is shown, and is unique
+    // across panels.  Background loads remember it so a result that arrives
+    // after the user navigated away can be recognised as stale and dropped.
+    unsigned long GetGeneration() const { return m_generation; }
+
     // Read-only accessor so MainFrame can keep its address bar in sync.
     const wxString& CurrentPath() const { return m_currentPath; }
 
-    // Returns the Name-column text of the currently selected row, or an
-    // empty string when nothing is selected.
+    // Returns the Name-column text of the currently selected row (the
+    // first one when several are), or an empty string when nothing is
+    // selected.
     wxString GetSelectedName() const;
 
+    // Names of all selected rows, top to bottom.
+    std::vector<wxString> GetSelectedNames() const;
+
+    // Rows are in the current sort order and only include entries that
+    // pass the type filter; the accessors below take row numbers.
+
+    // Name of the entry in the given row, or "" if out of range.
+    wxString GetNameAt(long index) const;
+
+    // True if the given row is a directory (false if out of range).
+    bool IsDirectoryAt(long index) const;
+
+    // The listing entry behind a row, or nullptr if out of range.
+    const DirectoryListing::Entry* GetEntryAt(long index) const;
+
     // Accessor for the underlying list control.  MainFrame needs this to
     // bind the double-click event directly on the control.
     wxListCtrl* GetListCtrl() const { return m_fileList; }
 
+    // Thumbnail view: image files get a preview in front of their name,
+    // produced in the background for the rows on screen.
+    void SetThumbnailView(bool enable);
+    bool IsThumbnailView() const { return m_thumbnailView; }
+
+    // Pretty-print a byte count (also used by MainFrame's operation reports).
+    static wxString FormatSize(wxUIntPtr bytes);
+
 private:
-    // Column indices – kept in sync with InitializeListControl().
+    // Edge of the thumbnails shown in the list, and how many stay loaded
+    // in the image list (slots are reused oldest first beyond that).
+    static constexpr int THUMB_SIZE    = 48;
+    static constexpr int THUMB_SLOTS   = 512;
+    // How often the visible rows are checked for background work.
+    static constexpr int POLL_MS       = 100;
+
+    // Logical columns – kept in sync with the table in FilePanel.cpp.
+    // Which are shown, and where, is in m_columns; the ones after
+    // COL_MODIFIED are off by default.
     enum Columns {
         COL_NAME = 0,
         COL_TYPE,
         COL_SIZE,
         COL_MODIFIED,
+        COL_PERMISSIONS,
+        COL_OWNER,
+        COL_GROUP,
+        COL_INODE,
+        COL_LINKS,
+        COL_ALLOCATED,
         COL_COUNT          // sentinel – not a real column
     };
 
-    wxListCtrl* m_fileList;
-    wxString    m_currentPath;   // last successfully loaded directory
+    FileListCtrl*    m_fileList;
+    wxChoice*        m_typeChoice;    // "All types" followed by the types seen
+    wxString         m_currentPath;   // last successfully loaded directory
+    DirectoryListing m_listing;       // entries behind the virtual list
+    unsigned long    m_generation;
+
+    // Shown columns in display order, which is always logical order.
+    std::vector<int>                    m_columns;
+
+    // Metadata for the optional columns, by entry.  Empty unless one of
+    // them is shown; filled in for the rows the list is about to paint.
+    std::vector<EntryDetails::Record>   m_details;
+    mutable IdNameCache                 m_idNames;           // filled while formatting
+
+    // Row order.  Entries are identified by their index in m_listing; the
+    // list shows m_order[row].
+    std::vector<long>                   m_order;             // row -> entry
+    std::vector<long>                   m_rows;              // entry -> row, -1 = filtered out
+    int                                 m_sortColumn;
+    bool                                m_sortAscending;
+    std::string                         m_typeFilter;        // "" = all types
+    bool                                m_orderStale;        // types arrived that move rows
+
+    // Sniffed types by entry ("" = not known yet) and the distinct ones
+    // offered by the filter.
+    std::vector<std::string>            m_types;
+    std::set<std::string>               m_knownTypes;
+    unsigned long                       m_typeGeneration;    // bumped when entries change
+    FileTypeScanner&                    m_typeScanner;       // shared, owned by MainFrame
+    FileTypeScanner::ClientId           m_typeClient;
+
+    // Thumbnail view state.  Image-list index 0 is the placeholder shown
+    // until an entry's thumbnail arrives; 1..THUMB_SLOTS hold thumbnails.
+    bool                                m_thumbnailView;
+    wxImageList                         m_thumbImages;
+    std::unordered_map<long, int>       m_entrySlots;        // entry -> slot, -1 = no thumbnail
+    std::vector<long>                   m_slotEntries;       // slot -> entry, -1 = free
+    int                                 m_nextSlot;          // next slot to reuse
+    unsigned long                       m_thumbGeneration;   // bumped when entries change
+    ThumbnailLoader&                    m_thumbLoader;       // shared, owned by MainFrame
+    ThumbnailLoader::ClientId           m_thumbClient;
+
+    // Visible rows last handed to the background workers.
+    long                                m_visibleTop;
+    long                                m_visibleBottom;
+    wxTimer                             m_pollTimer;
 
     void InitializeListControl();
 
+    // Row order helpers
+    long EntryAt(long row) const;
+    void ApplyOrder();
+    bool PassesFilter(long entry) const;
+    void OnColumnClick(wxListEvent& event);
+    void OnTypeFilter(wxCommandEvent& event);
+
+    // Optional column helpers
+    void OnColumnRightClick(wxListEvent& event);
+    void OnCacheHint(wxListEvent& event);
+    void ShowColumn(int column, bool show);
+    bool IsColumnShown(int column) const;
+    unsigned int WantedFields() const;
+    void ResetDetails();
+    void FetchDetails(const std::vector<long>& entries, unsigned int fields);
+    const EntryDetails::Record* DetailsOf(long entry, unsigned int field) const;
+    static unsigned int FieldsFor(int column);
+
+    // Background work for the visible rows
+    void OnPollTimer(wxTimerEvent& event);
+
+    // True if the entries can be opened where they are: not inside an
+    // archive, and the backend is this machine's file system.  Types,
+    // metadata columns and thumbnails are only read then.
+    bool CanReadEntries() const;
+
+    // Type column helpers
+    void ResetTypes();
+    void OnTypesReady(unsigned long generation, const std::vector<FileTypeScanner::Result>& results);
+    void AddKnownType(const std::string& type);
+    FileTypeScanner::Request TypeRequest(long entry) const;
+
+    // Thumbnail view helpers
+    void RequestThumbnails(long top, long bottom);
+    void OnThumbnailReady(unsigned long generation, long entry, std::shared_ptr<const wxImage> image);
+    void ResetThumbnails();
+    int  GetRowImage(long item) const;
+    bool IsImageEntry(long entry) const;
+
+    // Text of one cell; called by the virtual list for visible rows only.
+    wxString GetCellText(long item, long column) const;
+
     // Pretty-print helpers
-    static wxString FormatSize(wxUIntPtr bytes);
-    static wxString FormatDate(const wxFileName& fn);
+    static wxString FormatDate(std::int64_t seconds);
 };
 
-#endif // FILEPANEL_H
\ No newline at end of file
+#endif // FILEPANEL_H
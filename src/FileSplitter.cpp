@@ -0,0 +1,826 @@
+/*
+Author: Guo Jia
+Description: Implementation of FileSplitter.  A part task reads its range
+             in SLICE pieces to hash them and then hands the same range to
+             copy_file_range, which finds it in the page cache (or, on file
+             systems that share blocks, copies no data at all); where the
+             call is not supported between the two files the slice already
+             read is written with pwrite instead.  The manifest is plain
+             text: a header line, the file's name and size, then one line
+             per part.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "FileSplitter.h"
+#include "ContentHash.h"
+#include "JobProgress.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+namespace
+{
+    const char* MANIFEST_HEADER    = "filemanager-split 1";
+    const char* MANIFEST_EXTENSION = ".manifest";
+    const char* PARTIAL_EXTENSION  = ".partial";
+
+    // Fewest digits in part numbers: name.001 sorts right in any listing.
+    const size_t MIN_PART_DIGITS = 3;
+
+    // Whether copy_file_range works here; cleared for good on the first
+    // call the kernel or file system refuses.
+    atomic<bool> g_copyFileRange(true);
+
+    bool ReadAll(int fd, char* buffer, size_t length, uint64_t offset)
+    {
+        size_t done = 0;
+        while (done < length)
+        {
+            ssize_t n = ::pread(fd, buffer + done, length - done, static_cast<off_t>(offset + done));
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                if (n == 0)
+                {
+                    errno = EIO;   // shorter than it should be
+                }
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool WriteAll(int fd, const char* buffer, size_t length, uint64_t offset)
+    {
+        size_t done = 0;
+        while (done < length)
+        {
+            ssize_t n = ::pwrite(fd, buffer + done, length - done, static_cast<off_t>(offset + done));
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Copy one slice with copy_file_range; false with errno set, or with
+    // g_copyFileRange cleared if the call is not supported.
+    bool CopySlice(int in, uint64_t inOffset, int out, uint64_t outOffset, size_t length)
+    {
+        size_t done = 0;
+        while (done < length)
+        {
+            off_t from = static_cast<off_t>(inOffset + done);
+            off_t to   = static_cast<off_t>(outOffset + done);
+            ssize_t n  = ::copy_file_range(in, &from, out, &to, length - done, 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n < 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP) &&
+                done == 0)
+            {
+                g_copyFileRange = false;
+                return false;
+            }
+            if (n <= 0)
+            {
+                if (n == 0)
+                {
+                    errno = EIO;   // the source got shorter
+                }
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool ValidName(const string& name)
+    {
+        return !name.empty() && name != "." && name != ".." && name.find('/') == string::npos;
+    }
+
+    bool ParseNumber(const string& text, uint64_t& value)
+    {
+        char* end = nullptr;
+        errno = 0;
+        value = strtoull(text.c_str(), &end, 10);
+        return !text.empty() && *end == '\0' && errno == 0 && text[0] != '-';
+    }
+
+    string FolderOf(const string& path)
+    {
+        size_t slash = path.find_last_of('/');
+        return slash == string::npos ? string(".") : (slash == 0 ? string("/") : path.substr(0, slash));
+    }
+
+    string PathIn(const string& directory, const string& name)
+    {
+        return !directory.empty() && directory.back() == '/' ? directory + name : directory + "/" + name;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: FileSplitter
+Description: Binds the splitter to the pool its part tasks run on.
+Parameters: pool - worker pool; its size is how many parts move at once
+Return: None
+*/
+FileSplitter::FileSplitter(ThreadPool& pool)
+    : m_pool(pool),
+      m_error(),
+      m_badParts(),
+      m_mutex(),
+      m_failed(false)
+{
+}
+
+/*
+Function: ~FileSplitter
+Description: Destructor.  Split() and Join() wait for their tasks.
+Parameters: None
+Return: None
+*/
+FileSplitter::~FileSplitter()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Split / join
+// ---------------------------------------------------------------------------
+
+/*
+Function: Split
+Description: Lays out the parts, runs one task per part and writes the
+             manifest once all of them are on disk.  If any part fails, or
+             the job is cancelled, the parts written are removed again.
+Parameters: source    - file to split
+            directory - folder for the parts and the manifest
+            partSize  - bytes per part
+            overwrite - replace existing parts and manifest
+            progress  - bytes copied, and cancellation
+Return: true if every part and the manifest were written
+*/
+bool FileSplitter::Split(const string& source, const string& directory, uint64_t partSize,
+                         bool overwrite, JobProgress& progress)
+{
+    m_error.clear();
+    m_badParts.clear();
+    m_failed = false;
+
+    if (partSize == 0)
+    {
+        return Fail("The part size must be at least one byte");
+    }
+
+    int in = ::open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0)
+    {
+        return Fail("Cannot open " + source + ": " + strerror(errno));
+    }
+    struct stat info;
+    if (::fstat(in, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        ::close(in);
+        return Fail(source + " is not a regular file");
+    }
+
+    Manifest manifest;
+    manifest.name = source.substr(source.find_last_of('/') + 1);
+    manifest.size = static_cast<uint64_t>(info.st_size);
+
+    uint64_t count  = (manifest.size + partSize - 1) / partSize;
+    size_t   digits = max(MIN_PART_DIGITS, to_string(count).size());
+    for (uint64_t index = 0; index < count; ++index)
+    {
+        string number = to_string(index + 1);
+        Part   part;
+        part.file   = manifest.name + "." + string(digits - number.size(), '0') + number;
+        part.offset = index * partSize;
+        part.size   = min(partSize, manifest.size - part.offset);
+        part.hash   = 0;
+        manifest.parts.push_back(part);
+    }
+
+    string manifestPath = PathIn(directory, ManifestName(manifest.name));
+    if (!overwrite && ::access(manifestPath.c_str(), F_OK) == 0)
+    {
+        ::close(in);
+        return Fail(manifestPath + " already exists");
+    }
+
+    progress.SetTotal(manifest.size);
+    vector<char>         written(manifest.parts.size(), 0);   // one element per task
+    vector<future<void>> tasks;
+    tasks.reserve(manifest.parts.size());
+    for (size_t index = 0; index < manifest.parts.size(); ++index)
+    {
+        tasks.push_back(m_pool.Submit([this, in, &directory, &manifest, &written, index, overwrite, &progress]()
+        {
+            if (m_failed || progress.IsCancelled())
+            {
+                return;
+            }
+            progress.SetMessage("Writing " + manifest.parts[index].file);
+            if (SplitPart(in, directory, manifest.parts[index], overwrite, progress))
+            {
+                written[index] = 1;
+            }
+            else
+            {
+                m_failed = true;
+            }
+        }));
+    }
+    for (future<void>& task : tasks)
+    {
+        try
+        {
+            task.get();
+        }
+        catch (const exception&)
+        {
+            Fail("Internal error");
+            m_failed = true;
+        }
+    }
+    ::close(in);
+
+    bool ok = !m_failed && !progress.IsCancelled();
+    if (ok && !WriteManifest(manifestPath, manifest))
+    {
+        ok = Fail("Cannot write " + manifestPath + ": " + strerror(errno));
+    }
+    if (!ok)
+    {
+        for (size_t index = 0; index < manifest.parts.size(); ++index)
+        {
+            if (written[index])
+            {
+                ::unlink(PathIn(directory, manifest.parts[index].file).c_str());
+            }
+        }
+    }
+    return ok;
+}
+
+/*
+Function: Join
+Description: Opens (or continues) "<destination>.partial", runs one task
+             per part and renames the file once every part is in.  When
+             continuing, a part whose range already matches its hash is
+             not copied again.
+Parameters: manifestPath - the split's manifest
+            destination  - file to create
+            overwrite    - replace an existing destination
+            progress     - bytes joined, and cancellation
+Return: true if the whole file was joined; otherwise GetError() and
+        GetBadParts() say why
+*/
+bool FileSplitter::Join(const string& manifestPath, const string& destination, bool overwrite,
+                        JobProgress& progress)
+{
+    m_error.clear();
+    m_badParts.clear();
+    m_failed = false;
+
+    Manifest manifest;
+    string   error;
+    if (!ReadManifest(manifestPath, manifest, error))
+    {
+        return Fail(error);
+    }
+    if (!overwrite && ::access(destination.c_str(), F_OK) == 0)
+    {
+        return Fail(destination + " already exists");
+    }
+
+    string partial = destination + PARTIAL_EXTENSION;
+    int out = ::open(partial.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (out < 0)
+    {
+        return Fail("Cannot create " + partial + ": " + strerror(errno));
+    }
+    struct stat info;
+    bool resuming = ::fstat(out, &info) == 0 && info.st_size > 0 &&
+                    static_cast<uint64_t>(info.st_size) == manifest.size;
+    if (!resuming)
+    {
+        // Allocate up front so a full disk shows now, not halfway through.
+        if (::ftruncate(out, 0) != 0 ||
+            (manifest.size > 0 && ::fallocate(out, 0, 0, static_cast<off_t>(manifest.size)) != 0 &&
+             errno != EOPNOTSUPP) ||
+            ::ftruncate(out, static_cast<off_t>(manifest.size)) != 0)
+        {
+            int code = errno;
+            ::close(out);
+            ::unlink(partial.c_str());
+            return Fail("Cannot allocate " + partial + ": " + strerror(code));
+        }
+    }
+
+    string directory = FolderOf(manifestPath);
+    progress.SetTotal(manifest.size);
+    vector<future<void>> tasks;
+    tasks.reserve(manifest.parts.size());
+    for (const Part& part : manifest.parts)
+    {
+        tasks.push_back(m_pool.Submit([this, &directory, &part, out, resuming, &progress]()
+        {
+            if (m_failed || progress.IsCancelled())
+            {
+                return;
+            }
+            progress.SetMessage("Joining " + part.file);
+            if (!JoinPart(directory, part, out, resuming, progress))
+            {
+                m_failed = true;
+            }
+        }));
+    }
+    for (future<void>& task : tasks)
+    {
+        try
+        {
+            task.get();
+        }
+        catch (const exception&)
+        {
+            Fail("Internal error");
+            m_failed = true;
+        }
+    }
+
+    if (m_failed || progress.IsCancelled())
+    {
+        ::close(out);
+        return false;
+    }
+    if (!m_badParts.empty())
+    {
+        ::close(out);
+        sort(m_badParts.begin(), m_badParts.end());
+        string names;
+        for (const string& name : m_badParts)
+        {
+            names += (names.empty() ? "" : ", ") + name;
+        }
+        return Fail(to_string(m_badParts.size()) + " part(s) missing or damaged: " + names);
+    }
+
+    if (::fdatasync(out) != 0)
+    {
+        int code = errno;
+        ::close(out);
+        return Fail("Cannot write " + partial + ": " + strerror(code));
+    }
+    ::close(out);
+    if (::rename(partial.c_str(), destination.c_str()) != 0)
+    {
+        return Fail("Cannot rename " + partial + ": " + strerror(errno));
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Manifest
+// ---------------------------------------------------------------------------
+
+/*
+Function: ManifestName
+Description: "name" -> "name.manifest".
+Parameters: fileName - name of the whole file
+Return: The manifest's file name
+*/
+string FileSplitter::ManifestName(const string& fileName)
+{
+    return fileName + MANIFEST_EXTENSION;
+}
+
+/*
+Function: ReadManifest
+Description: Parses a manifest and checks that its parts cover the file
+             exactly once, in order, and that no name points outside the
+             manifest's folder.
+Parameters: path     - manifest file
+            manifest - receives the contents
+            error    - set to the reason on failure
+Return: true if it is a valid manifest
+*/
+bool FileSplitter::ReadManifest(const string& path, Manifest& manifest, string& error)
+{
+    ifstream in(path);
+    string   line;
+    if (!in || !getline(in, line) || line != MANIFEST_HEADER)
+    {
+        error = path + " is not a split manifest";
+        return false;
+    }
+
+    manifest = Manifest();
+    bool     haveName = false;
+    bool     haveSize = false;
+    uint64_t next     = 0;
+    while (getline(in, line))
+    {
+        vector<string> fields;
+        size_t start = 0;
+        for (size_t tab = line.find('\t'); tab != string::npos; tab = line.find('\t', start))
+        {
+            fields.push_back(line.substr(start, tab - start));
+            start = tab + 1;
+        }
+        fields.push_back(line.substr(start));
+
+        bool valid = false;
+        if (fields[0] == "name" && fields.size() == 2)
+        {
+            manifest.name = fields[1];
+            valid = haveName = ValidName(fields[1]);
+        }
+        else if (fields[0] == "size" && fields.size() == 2)
+        {
+            valid = haveSize = ParseNumber(fields[1], manifest.size);
+        }
+        else if (fields[0] == "part" && fields.size() == 5)
+        {
+            Part  part;
+            char* end = nullptr;
+            part.file = fields[1];
+            part.hash = strtoull(fields[4].c_str(), &end, 16);
+            valid = ValidName(part.file) && ParseNumber(fields[2], part.offset) &&
+                    ParseNumber(fields[3], part.size) && fields[4].size() == 16 && *end == '\0' &&
+                    part.offset == next && part.size > 0;
+            next += part.size;
+            manifest.parts.push_back(part);
+        }
+        else if (line.empty())
+        {
+            valid = true;
+        }
+
+        if (!valid)
+        {
+            error = path + ": bad line \"" + line + "\"";
+            return false;
+        }
+    }
+
+    if (!haveName || !haveSize || next != manifest.size)
+    {
+        error = path + " is incomplete";
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: ParseSize
+Description: A number, decimals allowed, with an optional binary unit
+             (k, M, G or T, optionally followed by "B" or "iB").
+Parameters: text  - what the user typed
+            bytes - receives the size
+Return: true for a size of at least one byte
+*/
+bool FileSplitter::ParseSize(const string& text, uint64_t& bytes)
+{
+    char*  end   = nullptr;
+    double value = strtod(text.c_str(), &end);
+    if (end == text.c_str() || value <= 0)
+    {
+        return false;
+    }
+
+    string unit(end);
+    unit.erase(remove(unit.begin(), unit.end(), ' '), unit.end());
+    if (unit.size() > 1 && (unit.substr(1) == "B" || unit.substr(1) == "iB" || unit.substr(1) == "b"))
+    {
+        unit.erase(1);
+    }
+
+    double scale = 1;
+    if (unit.empty() || unit == "B" || unit == "b")
+    {
+        scale = 1;
+    }
+    else if (unit == "k" || unit == "K")
+    {
+        scale = 1024.0;
+    }
+    else if (unit == "m" || unit == "M")
+    {
+        scale = 1024.0 * 1024;
+    }
+    else if (unit == "g" || unit == "G")
+    {
+        scale = 1024.0 * 1024 * 1024;
+    }
+    else if (unit == "t" || unit == "T")
+    {
+        scale = 1024.0 * 1024 * 1024 * 1024;
+    }
+    else
+    {
+        return false;
+    }
+
+    double result = value * scale;
+    if (result < 1 || result > 1.8e19)
+    {
+        return false;
+    }
+    bytes = static_cast<uint64_t>(result);
+    return true;
+}
+
+/*
+Function: WriteManifest
+Description: Writes the manifest to a temporary file and renames it, so a
+             manifest on disk is always complete.
+Parameters: path     - where it goes
+            manifest - what it says
+Return: true if it was written
+*/
+bool FileSplitter::WriteManifest(const string& path, const Manifest& manifest)
+{
+    string tempPath = path + ".tmp";
+    {
+        ofstream out(tempPath, ios::trunc);
+        out << MANIFEST_HEADER << '\n'
+            << "name\t" << manifest.name << '\n'
+            << "size\t" << manifest.size << '\n';
+        char hash[17];
+        for (const Part& part : manifest.parts)
+        {
+            snprintf(hash, sizeof(hash), "%016" PRIx64, part.hash);
+            out << "part\t" << part.file << '\t' << part.offset << '\t' << part.size << '\t' << hash << '\n';
+        }
+        out.flush();
+        if (!out)
+        {
+            ::unlink(tempPath.c_str());
+            return false;
+        }
+    }
+    return ::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Part tasks
+// ---------------------------------------------------------------------------
+
+/*
+Function: SplitPart
+Description: Creates one part, copies its range into it while hashing it,
+             and flushes it, since removable media are often pulled as soon
+             as the job says it is done.  A part that fails is removed.
+Parameters: in        - the source file
+            directory - folder of the parts
+            part      - the part; its hash is filled in
+            overwrite - replace an existing part file
+            progress  - bytes copied, and cancellation
+Return: true if the part is complete on disk
+*/
+bool FileSplitter::SplitPart(int in, const string& directory, Part& part, bool overwrite, JobProgress& progress)
+{
+    string path = PathIn(directory, part.file);
+    int out = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (overwrite ? O_TRUNC : O_EXCL), 0644);
+    if (out < 0)
+    {
+        return Fail("Cannot create " + path + ": " + strerror(errno));
+    }
+    ::fallocate(out, 0, 0, static_cast<off_t>(part.size));   // a hint; copying works without it
+
+    vector<char> buffer;
+    bool ok = CopyRange(in, part.offset, out, 0, part.size, &part.hash, buffer, progress);
+    if (ok && ::fdatasync(out) != 0)
+    {
+        ok = Fail("Cannot write " + path + ": " + strerror(errno));
+    }
+    if (::close(out) != 0 && ok)
+    {
+        ok = Fail("Cannot write " + path + ": " + strerror(errno));
+    }
+    if (!ok)
+    {
+        ::unlink(path.c_str());
+    }
+    return ok;
+}
+
+/*
+Function: JoinPart
+Description: Puts one part in place.  When continuing an earlier join, a
+             range that already hashes right is kept.  Otherwise the part
+             file must exist, have the right size and hash, or it is
+             recorded as bad and left out; then it is copied in.
+Parameters: directory - folder of the parts
+            part      - the part
+            out       - the file being joined
+            resuming  - 'out' holds an earlier join's data
+            progress  - bytes joined, and cancellation
+Return: false only if the join itself cannot go on (write error,
+        cancellation); bad parts are not failures
+*/
+bool FileSplitter::JoinPart(const string& directory, const Part& part, int out, bool resuming, JobProgress& progress)
+{
+    vector<char> buffer;
+    uint64_t     hash = 0;
+    if (resuming && HashRange(out, part.offset, part.size, hash, buffer, progress) && hash == part.hash)
+    {
+        progress.Advance(part.size);
+        return true;
+    }
+    if (progress.IsCancelled())
+    {
+        return false;
+    }
+
+    string path = PathIn(directory, part.file);
+    int in = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (in < 0 || ::fstat(in, &info) != 0 || static_cast<uint64_t>(info.st_size) != part.size ||
+        !HashRange(in, 0, part.size, hash, buffer, progress) || hash != part.hash)
+    {
+        if (in >= 0)
+        {
+            ::close(in);
+        }
+        if (progress.IsCancelled())
+        {
+            return false;
+        }
+        AddBadPart(part.file);
+        return true;
+    }
+
+    bool ok = CopyRange(in, 0, out, part.offset, part.size, nullptr, buffer, progress);
+    ::close(in);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: CopyRange
+Description: Copies a range one slice at a time.  With a hash wanted, the
+             slice is read and hashed first; copy_file_range then takes it
+             from the page cache, and if that call is unsupported the slice
+             read is written directly.  Without one, slices go through
+             copy_file_range, or pread/pwrite where unsupported.
+Parameters: in        - source descriptor
+            inOffset  - where the range starts in the source
+            out       - destination descriptor
+            outOffset - where it goes in the destination
+            length    - bytes to copy
+            hash      - receives the range's ContentHash, or nullptr
+            buffer    - the task's slice buffer (grown on first use)
+            progress  - advanced per slice; cancellation stops the copy
+Return: false on an error (reported) or cancellation (not reported)
+*/
+bool FileSplitter::CopyRange(int in, uint64_t inOffset, int out, uint64_t outOffset, uint64_t length,
+                             uint64_t* hash, vector<char>& buffer, JobProgress& progress)
+{
+    ContentHash content;
+    uint64_t    done = 0;
+    while (done < length)
+    {
+        if (m_failed || progress.IsCancelled())
+        {
+            return false;
+        }
+
+        size_t slice = static_cast<size_t>(min<uint64_t>(SLICE, length - done));
+        bool   read  = false;
+        buffer.resize(SLICE);
+        if (hash != nullptr || !g_copyFileRange)
+        {
+            if (!ReadAll(in, buffer.data(), slice, inOffset + done))
+            {
+                return Fail(string("Read error: ") + strerror(errno));
+            }
+            if (hash != nullptr)
+            {
+                content.Update(buffer.data(), slice);
+            }
+            read = true;
+        }
+
+        bool copied = g_copyFileRange && CopySlice(in, inOffset + done, out, outOffset + done, slice);
+        if (!copied && g_copyFileRange)
+        {
+            return Fail(string("Copy error: ") + strerror(errno));
+        }
+        if (!copied)
+        {
+            // Unsupported here (perhaps only just found out): write the slice.
+            if (!read && !ReadAll(in, buffer.data(), slice, inOffset + done))
+            {
+                return Fail(string("Read error: ") + strerror(errno));
+            }
+            if (!WriteAll(out, buffer.data(), slice, outOffset + done))
+            {
+                return Fail(string("Write error: ") + strerror(errno));
+            }
+        }
+
+        done += slice;
+        progress.Advance(slice);
+    }
+
+    if (hash != nullptr)
+    {
+        *hash = content.Digest();
+    }
+    return true;
+}
+
+/*
+Function: HashRange
+Description: Reads a range a slice at a time and hashes it.
+Parameters: fd       - file to read
+            offset   - where the range starts
+            length   - bytes to hash
+            hash     - receives the ContentHash
+            buffer   - the task's slice buffer
+            progress - checked for cancellation only
+Return: false on a read error or cancellation
+*/
+bool FileSplitter::HashRange(int fd, uint64_t offset, uint64_t length, uint64_t& hash,
+                             vector<char>& buffer, JobProgress& progress)
+{
+    ContentHash content;
+    buffer.resize(SLICE);
+    for (uint64_t done = 0; done < length; )
+    {
+        if (m_failed || progress.IsCancelled())
+        {
+            return false;
+        }
+        size_t slice = static_cast<size_t>(min<uint64_t>(SLICE, length - done));
+        if (!ReadAll(fd, buffer.data(), slice, offset + done))
+        {
+            return false;
+        }
+        content.Update(buffer.data(), slice);
+        done += slice;
+    }
+    hash = content.Digest();
+    return true;
+}
+
+/*
+Function: AddBadPart
+Description: Records a part Join() had to leave out.  Thread-safe.
+Parameters: file - the part's file name
+Return: None
+*/
+void FileSplitter::AddBadPart(const string& file)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_badParts.push_back(file);
+}
+
+/*
+Function: Fail
+Description: Records the first error of the job.  Thread-safe.
+Parameters: message - what went wrong
+Return: false, for "return Fail(...)"
+*/
+bool FileSplitter::Fail(const string& message)
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_error.empty())
+    {
+        m_error = message;
+    }
+    return false;
+}
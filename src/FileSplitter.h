@@ -0,0 +1,109 @@
+/*
+Author: Guo Jia
+Description: Declaration of FileSplitter – cuts a file into numbered parts
+             of a fixed size ("name.001", "name.002", ...) and puts them
+             back together, for file systems with a per-file size limit or
+             removable media that may lose a part on the way.  Each part is
+             its own task on the pool, copied with copy_file_range at
+             explicit offsets; its XXH64 hash goes into a manifest written
+             next to the parts ("name.manifest").  Joining checks every
+             part against the manifest before copying it in, and keeps the
+             file joined so far, so after fetching again just the parts
+             reported damaged or missing another join copies only those.
+Date: 2026-10-18
+*/
+
+#ifndef FILESPLITTER_H
+#define FILESPLITTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+class JobProgress;
+
+class FileSplitter
+{
+public:
+    struct Part
+    {
+        std::string   file;     // part file name, in the manifest's folder
+        std::uint64_t offset;   // where it goes in the whole file
+        std::uint64_t size;
+        std::uint64_t hash;     // ContentHash of its contents
+    };
+
+    struct Manifest
+    {
+        std::string       name;   // file name of the whole file
+        std::uint64_t     size;
+        std::vector<Part> parts;
+    };
+
+    explicit FileSplitter(ThreadPool& pool);
+    virtual ~FileSplitter();
+
+    FileSplitter(const FileSplitter&) = delete;
+    FileSplitter& operator=(const FileSplitter&) = delete;
+
+    // Split the regular file 'source' into parts of 'partSize' bytes (the
+    // last one shorter) in 'directory', with their manifest.  Existing
+    // parts and manifest are only replaced with 'overwrite'.  On failure
+    // or cancellation nothing is left behind.
+    bool Split(const std::string& source, const std::string& directory, std::uint64_t partSize,
+               bool overwrite, JobProgress& progress);
+
+    // Join the parts listed in the manifest at 'manifestPath' into
+    // 'destination'.  The file grows as "<destination>.partial" and is
+    // renamed when every part is in; a failed or cancelled join leaves it
+    // there for the next one to continue.  GetBadParts() lists the parts
+    // that were missing or did not match the manifest.
+    bool Join(const std::string& manifestPath, const std::string& destination, bool overwrite,
+              JobProgress& progress);
+
+    const std::string&              GetError() const { return m_error; }
+    const std::vector<std::string>& GetBadParts() const { return m_badParts; }
+
+    // Manifest file of a split of 'fileName'.
+    static std::string ManifestName(const std::string& fileName);
+
+    // Read and check a manifest.  false with 'error' set if it is not one.
+    static bool ReadManifest(const std::string& path, Manifest& manifest, std::string& error);
+
+    // "700M", "4G", "1.5G", "512k" or plain bytes; false if malformed.
+    static bool ParseSize(const std::string& text, std::uint64_t& bytes);
+
+private:
+    // Data moves, and is hashed, this much at a time.
+    static constexpr std::size_t SLICE = 8 * 1024 * 1024;
+
+    ThreadPool&              m_pool;
+    std::string              m_error;
+    std::vector<std::string> m_badParts;
+    std::mutex               m_mutex;    // guards the two above while tasks run
+    std::atomic<bool>        m_failed;   // a task failed; the others stop
+
+    // Copy 'length' bytes from 'in' at 'inOffset' to 'out' at 'outOffset',
+    // hashing them on the way if 'hash' is not null.
+    bool CopyRange(int in, std::uint64_t inOffset, int out, std::uint64_t outOffset,
+                   std::uint64_t length, std::uint64_t* hash, std::vector<char>& buffer,
+                   JobProgress& progress);
+
+    // ContentHash of 'length' bytes of 'fd' from 'offset'.
+    bool HashRange(int fd, std::uint64_t offset, std::uint64_t length, std::uint64_t& hash,
+                   std::vector<char>& buffer, JobProgress& progress);
+
+    bool SplitPart(int in, const std::string& directory, Part& part, bool overwrite, JobProgress& progress);
+    bool JoinPart(const std::string& directory, const Part& part, int out, bool resuming, JobProgress& progress);
+
+    static bool WriteManifest(const std::string& path, const Manifest& manifest);
+
+    void AddBadPart(const std::string& file);
+    bool Fail(const std::string& message);
+};
+
+#endif // FILESPLITTER_H
@@ -0,0 +1,181 @@
+/*
+Author: Guo Jia
+Description: Implementation of FileSystemBackend – the process-wide backend
+             and the factory used by the command line.
+Date: 2026-10-18
+*/
+
+#include <cstdlib>
+#include "FileSystemBackend.h"
+#include "PosixBackend.h"
+#include "SimulatedBackend.h"
+
+using namespace std;
+
+namespace
+{
+    // Set at startup and never changed while other threads run, so reads
+    // need no lock.
+    unique_ptr<FileSystemBackend> g_backend;
+
+    // Shape of the tree "simulated" starts with unless told otherwise.
+    const size_t   DEFAULT_FOLDERS = 10;
+    const size_t   DEFAULT_FILES   = 100;
+    const unsigned DEFAULT_DEPTH   = 2;
+
+    // Parse the whole of 'text' as a number no smaller than 0.
+    bool ParseValue(const string& text, double& value)
+    {
+        char* end = nullptr;
+        value = strtod(text.c_str(), &end);
+        return !text.empty() && *end == '\0' && value >= 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: ~File
+Description: Virtual destructor for open files.
+Parameters: None
+Return: None
+*/
+FileSystemBackend::File::~File()
+{
+}
+
+/*
+Function: FileSystemBackend
+Description: Base constructor.  No state.
+Parameters: None
+Return: None
+*/
+FileSystemBackend::FileSystemBackend()
+{
+}
+
+/*
+Function: ~FileSystemBackend
+Description: Virtual destructor.
+Parameters: None
+Return: None
+*/
+FileSystemBackend::~FileSystemBackend()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Selection
+// ---------------------------------------------------------------------------
+
+/*
+Function: Current
+Description: Returns the installed backend, or a PosixBackend if none was
+             set.
+Parameters: None
+Return: The backend
+*/
+FileSystemBackend& FileSystemBackend::Current()
+{
+    static PosixBackend local;
+    return g_backend ? *g_backend : local;
+}
+
+/*
+Function: SetCurrent
+Description: Replaces the backend in use.
+Parameters: backend - the new backend (nullptr: back to PosixBackend)
+Return: None
+*/
+void FileSystemBackend::SetCurrent(unique_ptr<FileSystemBackend> backend)
+{
+    g_backend = move(backend);
+}
+
+/*
+Function: Create
+Description: Builds the backend named by a command-line description; see
+             the header for the syntax.  The simulated backend gets its
+             profile for every call and a generated tree under "/".
+Parameters: description - e.g. "simulated:latency=500,jitter=100"
+            error       - set to the reason on failure
+Return: The backend, or nullptr
+*/
+unique_ptr<FileSystemBackend> FileSystemBackend::Create(const string& description, string& error)
+{
+    size_t colon = description.find(':');
+    string name  = description.substr(0, colon);
+
+    if (name == "posix" && colon == string::npos)
+    {
+        return unique_ptr<FileSystemBackend>(new PosixBackend());
+    }
+    if (name != "simulated")
+    {
+        error = "Unknown backend \"" + description + "\" (use posix or simulated[:key=value,...]).";
+        return nullptr;
+    }
+
+    SimulatedBackend::Profile profile;
+    double folders = DEFAULT_FOLDERS;
+    double files   = DEFAULT_FILES;
+    double depth   = DEFAULT_DEPTH;
+
+    size_t start = colon == string::npos ? description.size() : colon + 1;
+    while (start < description.size())
+    {
+        size_t end = description.find(',', start);
+        if (end == string::npos)
+        {
+            end = description.size();
+        }
+        string setting = description.substr(start, end - start);
+        size_t equals  = setting.find('=');
+        string key     = setting.substr(0, equals);
+        double value   = 0;
+        if (equals == string::npos || !ParseValue(setting.substr(equals + 1), value))
+        {
+            error = "Bad setting \"" + setting + "\" for the simulated backend.";
+            return nullptr;
+        }
+
+        if (key == "latency")
+        {
+            profile.latencyMillis = static_cast<unsigned int>(value);
+        }
+        else if (key == "jitter")
+        {
+            profile.jitterMillis = static_cast<unsigned int>(value);
+        }
+        else if (key == "failures" && value <= 1)
+        {
+            profile.failureRate = value;
+        }
+        else if (key == "folders")
+        {
+            folders = value;
+        }
+        else if (key == "files")
+        {
+            files = value;
+        }
+        else if (key == "depth")
+        {
+            depth = value;
+        }
+        else
+        {
+            error = "Bad setting \"" + setting + "\" for the simulated backend.";
+            return nullptr;
+        }
+        start = end + 1;
+    }
+
+    unique_ptr<SimulatedBackend> backend(new SimulatedBackend());
+    backend->Populate("/", static_cast<size_t>(folders), static_cast<size_t>(files),
+                      static_cast<unsigned int>(depth));
+    backend->SetProfile(profile);
+    return backend;
+}
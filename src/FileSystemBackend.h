@@ -0,0 +1,94 @@
+/*
+Author: Guo Jia
+Description: Declaration of FileSystemBackend – the calls the file manager
+             makes on the file system it browses: enumerate a folder, stat,
+             open, copy, rename, unlink and create folders.  PosixBackend
+             is the default; SimulatedBackend serves an in-memory tree with
+             configurable latency and failures, for benchmarks and for
+             checking that the window stays responsive on slow or failing
+             mounts.  The backend in use is chosen once at startup.
+Date: 2026-10-18
+*/
+
+#ifndef FILESYSTEMBACKEND_H
+#define FILESYSTEMBACKEND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "DirectoryListing.h"
+
+class FileSystemBackend
+{
+public:
+    // An open file: positional reads and writes, closed on destruction.
+    class File
+    {
+    public:
+        virtual ~File();
+
+        // Bytes transferred (0 at end of file), or -1 with errno set.
+        virtual long Read(void* buffer, std::size_t size, std::uint64_t offset) = 0;
+        virtual long Write(const void* buffer, std::size_t size, std::uint64_t offset) = 0;
+    };
+
+    FileSystemBackend();
+    virtual ~FileSystemBackend();
+
+    FileSystemBackend(const FileSystemBackend&) = delete;
+    FileSystemBackend& operator=(const FileSystemBackend&) = delete;
+
+    // Every call may be made from any thread.  Failures return false (or
+    // nullptr) with errno set.
+
+    // The entries of 'folder' in no particular order.  Symbolic links are
+    // described by what they point to, or by themselves if dangling.
+    virtual bool Enumerate(const std::string& folder, std::vector<DirectoryListing::Entry>& entries) = 0;
+
+    // Describe 'path' like an entry of Enumerate(); 'entry.name' is its
+    // last component.
+    virtual bool Stat(const std::string& path, DirectoryListing::Entry& entry) = 0;
+
+    // Like Stat(), but a symbolic link is described as itself – never as
+    // a folder – so walking a tree to delete it cannot leave it.
+    virtual bool LinkStat(const std::string& path, DirectoryListing::Entry& entry) = 0;
+
+    // Open a file for reading, or create / truncate it for writing.
+    virtual std::unique_ptr<File> Open(const std::string& path, bool write) = 0;
+
+    // Copy a file or a whole folder.  Without 'overwrite' an existing
+    // destination is an error.
+    virtual bool Copy(const std::string& from, const std::string& to, bool overwrite) = 0;
+
+    virtual bool Rename(const std::string& from, const std::string& to) = 0;
+
+    // Remove a file, a link or an empty folder.
+    virtual bool Unlink(const std::string& path) = 0;
+
+    virtual bool MakeDirectory(const std::string& path) = 0;
+
+    // True if paths are real paths of this machine, so code that needs
+    // the operating system itself (copy engine, memory mapping, archives,
+    // launching applications) may use them.
+    virtual bool IsLocal() const = 0;
+
+    // Where to start when there is nowhere else to go.
+    virtual std::string HomePath() const = 0;
+
+    // The backend in use; PosixBackend until SetCurrent() is called.
+    static FileSystemBackend& Current();
+
+    // Install a backend.  Only at startup, before any thread uses Current().
+    static void SetCurrent(std::unique_ptr<FileSystemBackend> backend);
+
+    // Make a backend from a command-line description: "posix", or
+    // "simulated" optionally followed by ":key=value,..." with the keys
+    // latency and jitter (milliseconds per call), failures (fraction of
+    // calls that fail), and folders, files and depth (the generated tree).
+    // Returns nullptr with 'error' set if the description is wrong.
+    static std::unique_ptr<FileSystemBackend> Create(const std::string& description, std::string& error);
+};
+
+#endif // FILESYSTEMBACKEND_H
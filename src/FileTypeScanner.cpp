@@ -0,0 +1,356 @@
+/*
+Author: Guo Jia
+Description: Implementation of FileTypeScanner.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <chrono>
+#include "FileTypeScanner.h"
+#include "FileTypeSniffer.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: FileTypeScanner
+Description: Starts the scanner thread.  One thread is enough: each file
+             costs a stat and a 512-byte read, and a second thread would
+             mostly compete with the listing and thumbnail I/O.
+Parameters: None
+Return: None
+*/
+FileTypeScanner::FileTypeScanner()
+    : m_clients(),
+      m_nextClient(0),
+      m_current(0),
+      m_stopping(false),
+      m_mutex(),
+      m_deliverMutex(),
+      m_wakeup(),
+      m_cache(),
+      m_sniffed(0),
+      m_cacheHits(0),
+      m_thread()
+{
+    m_thread = thread(&FileTypeScanner::WorkerLoop, this);
+}
+
+/*
+Function: ~FileTypeScanner
+Description: Stops the thread, abandoning the queues.  A file being read is
+             finished first.
+Parameters: None
+Return: None
+*/
+FileTypeScanner::~FileTypeScanner()
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stopping = true;
+        m_clients.clear();
+    }
+    m_wakeup.notify_all();
+    m_thread.join();
+}
+
+// ---------------------------------------------------------------------------
+// Clients
+// ---------------------------------------------------------------------------
+
+/*
+Function: AddClient
+Description: Registers an owner with no listing yet.
+Parameters: handler - receives the owner's batches of results
+Return: The owner's id
+*/
+FileTypeScanner::ClientId FileTypeScanner::AddClient(const ResultHandler& handler)
+{
+    lock_guard<mutex> lock(m_mutex);
+    ClientId client = ++m_nextClient;
+    Client& added = m_clients[client];
+    added.handler    = handler;
+    added.generation = 0;
+    return client;
+}
+
+/*
+Function: RemoveClient
+Description: Drops the owner and its queues, then waits out a delivery to
+             it that may already be running.
+Parameters: client - owner to remove
+Return: None
+*/
+void FileTypeScanner::RemoveClient(ClientId client)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_clients.erase(client);
+    }
+    lock_guard<mutex> delivering(m_deliverMutex);
+}
+
+// ---------------------------------------------------------------------------
+// Requests
+// ---------------------------------------------------------------------------
+
+/*
+Function: SetListing
+Description: Replaces both of the client's queues with the new listing's
+             files.
+Parameters: client     - owner of the listing
+            generation - identifies the listing the indices refer to
+            directory  - directory the names are in
+            requests   - every file of the listing
+Return: None
+*/
+void FileTypeScanner::SetListing(ClientId client, unsigned long generation, const string& directory,
+                                 const vector<Request>& requests)
+{
+    long highest = -1;
+    for (const Request& request : requests)
+    {
+        highest = max(highest, request.index);
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        auto found = m_clients.find(client);
+        if (found == m_clients.end())
+        {
+            return;
+        }
+        Client& owner = found->second;
+        owner.generation = generation;
+        owner.directory  = directory;
+        if (owner.directory.empty() || owner.directory.back() != '/')
+        {
+            owner.directory += '/';
+        }
+        owner.urgent.clear();
+        owner.background.assign(requests.begin(), requests.end());
+        owner.answered.assign(static_cast<size_t>(highest + 1), false);
+    }
+    m_wakeup.notify_all();
+}
+
+/*
+Function: SetVisible
+Description: Replaces the client's urgent queue.  The same files stay in
+             its background queue; whichever copy comes up second is
+             skipped.
+Parameters: client     - owner of the listing
+            generation - listing the indices refer to
+            requests   - rows on screen, top first
+Return: None
+*/
+void FileTypeScanner::SetVisible(ClientId client, unsigned long generation, const vector<Request>& requests)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        auto found = m_clients.find(client);
+        if (found == m_clients.end() || generation != found->second.generation)
+        {
+            return;
+        }
+        found->second.urgent.assign(requests.begin(), requests.end());
+    }
+    m_wakeup.notify_all();
+}
+
+/*
+Function: Clear
+Description: Drops the client's queued requests.
+Parameters: client - owner of the requests
+Return: None
+*/
+void FileTypeScanner::Clear(ClientId client)
+{
+    lock_guard<mutex> lock(m_mutex);
+    auto found = m_clients.find(client);
+    if (found != m_clients.end())
+    {
+        found->second.urgent.clear();
+        found->second.background.clear();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+/*
+Function: NextClient
+Description: Visible rows first: the client served last if it has some,
+             else the first that does.  Then background work, again
+             preferring the client served last, so batches stay long.
+Parameters: None
+Return: Client with work, or m_clients.end()
+*/
+map<FileTypeScanner::ClientId, FileTypeScanner::Client>::iterator FileTypeScanner::NextClient()
+{
+    auto current = m_clients.find(m_current);
+    if (current != m_clients.end() && !current->second.urgent.empty())
+    {
+        return current;
+    }
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it)
+    {
+        if (!it->second.urgent.empty())
+        {
+            return it;
+        }
+    }
+    if (current != m_clients.end() && !current->second.background.empty())
+    {
+        return current;
+    }
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it)
+    {
+        if (!it->second.background.empty())
+        {
+            return it;
+        }
+    }
+    return m_clients.end();
+}
+
+/*
+Function: WorkerLoop
+Description: Takes requests in NextClient() order and collects the answers
+             into a batch, which is handed over when it is full, old
+             enough, or the next request belongs to someone else.  A batch
+             belongs to one client and generation; a removed client or a
+             new listing discards it.
+Parameters: None
+Return: None
+*/
+void FileTypeScanner::WorkerLoop()
+{
+    vector<Result>                 batch;
+    ClientId                       batchClient     = 0;
+    unsigned long                  batchGeneration = 0;
+    chrono::steady_clock::time_point batchStarted;
+
+    unique_lock<mutex> lock(m_mutex);
+    while (true)
+    {
+        auto owner = m_clients.find(batchClient);
+        if (!batch.empty() && (owner == m_clients.end() || owner->second.generation != batchGeneration))
+        {
+            batch.clear();
+        }
+        auto next = NextClient();
+        if (!batch.empty() &&
+            (next != owner || batch.size() >= BATCH_SIZE ||
+             chrono::steady_clock::now() - batchStarted >= chrono::milliseconds(BATCH_MS)))
+        {
+            vector<Result> results;
+            results.swap(batch);
+            lock.unlock();
+            Deliver(batchClient, batchGeneration, move(results));
+            lock.lock();
+            continue;
+        }
+
+        m_wakeup.wait(lock, [this]()
+        {
+            return m_stopping || NextClient() != m_clients.end();
+        });
+        if (m_stopping)
+        {
+            return;
+        }
+
+        next = NextClient();
+        Client& client = next->second;
+        m_current = next->first;
+        deque<Request>& queue = client.urgent.empty() ? client.background : client.urgent;
+        Request request = move(queue.front());
+        queue.pop_front();
+        size_t slot = static_cast<size_t>(request.index);
+        if (request.index < 0 || slot >= client.answered.size() || client.answered[slot])
+        {
+            continue;
+        }
+        client.answered[slot] = true;
+        ClientId      id         = next->first;
+        string        directory  = client.directory;
+        unsigned long generation = client.generation;
+        lock.unlock();
+
+        string type = TypeOf(directory, request);
+
+        lock.lock();
+        if (batch.empty())
+        {
+            batchClient     = id;
+            batchGeneration = generation;
+            batchStarted    = chrono::steady_clock::now();
+        }
+        batch.push_back({ request.index, move(type) });
+    }
+}
+
+/*
+Function: Deliver
+Description: Runs the client's handler under m_deliverMutex, which
+             RemoveClient() waits for, so the handler never runs for an
+             owner that has gone.
+Parameters: client     - owner of the batch
+            generation - listing the batch belongs to
+            results    - the batch
+Return: None
+*/
+void FileTypeScanner::Deliver(ClientId client, unsigned long generation, vector<Result> results)
+{
+    lock_guard<mutex> delivering(m_deliverMutex);
+    ResultHandler handler;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        auto found = m_clients.find(client);
+        if (found == m_clients.end())
+        {
+            return;
+        }
+        handler = found->second.handler;
+    }
+    handler(generation, move(results));
+}
+
+/*
+Function: TypeOf
+Description: Looks the file up by identity, sniffing and remembering it on
+             a miss.  Only this thread touches the cache, so it needs no
+             lock.
+Parameters: directory - directory the file is in, ending with '/'
+            request   - the file
+Return: Type name
+*/
+string FileTypeScanner::TypeOf(const string& directory, const Request& request)
+{
+    Key key = { request.device, request.inode, request.modified };
+    auto cached = m_cache.find(key);
+    if (cached != m_cache.end())
+    {
+        ++m_cacheHits;
+        return cached->second;
+    }
+
+    string type = FileTypeSniffer::SniffFile(directory + request.name);
+    ++m_sniffed;
+
+    if (type == "Unreadable")
+    {
+        return type;   // permissions can change without touching the mtime
+    }
+    if (m_cache.size() >= MAX_CACHED)
+    {
+        m_cache.clear();
+    }
+    m_cache.emplace(key, type);
+    return type;
+}
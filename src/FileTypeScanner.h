@@ -0,0 +1,151 @@
+/*
+Author: Guo Jia
+Description: Declaration of FileTypeScanner – fills in the content-sniffed
+             type of every file in a listing on one background thread.  The
+             rows on screen are served first, then the rest of the listing
+             in order, so sorting or filtering by type soon has every row.
+             Types are remembered per (device, inode, mtime); revisiting a
+             directory, or a file that is merely renamed, reads nothing.
+             One scanner serves every file panel: each registers as a
+             client with its own listing, and shares the thread and cache.
+Date: 2026-10-18
+*/
+
+#ifndef FILETYPESCANNER_H
+#define FILETYPESCANNER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class FileTypeScanner
+{
+public:
+    struct Request
+    {
+        long          index;      // position in the owner's listing
+        std::string   name;
+        std::uint64_t device;
+        std::uint64_t inode;
+        std::int64_t  modified;
+    };
+
+    struct Result
+    {
+        long          index;
+        std::string   type;
+    };
+
+    // Receives results in batches.  Runs on the scanner thread, so it
+    // should only hand them over (e.g. with CallAfter).
+    typedef std::function<void(unsigned long generation, std::vector<Result> results)> ResultHandler;
+
+    // Identifies one owner of listings (a file panel).
+    typedef unsigned long ClientId;
+
+    FileTypeScanner();
+    virtual ~FileTypeScanner();
+
+    FileTypeScanner(const FileTypeScanner&) = delete;
+    FileTypeScanner& operator=(const FileTypeScanner&) = delete;
+
+    // Register an owner whose results go to 'handler'.  After
+    // RemoveClient() returns the handler is never called again, so the
+    // owner may be destroyed.
+    ClientId AddClient(const ResultHandler& handler);
+    void     RemoveClient(ClientId client);
+
+    // Start the client on a new listing of 'directory': every request is
+    // answered eventually, in the order given.  Drops all of the client's
+    // work for the old one.
+    void SetListing(ClientId client, unsigned long generation, const std::string& directory,
+                    const std::vector<Request>& requests);
+
+    // Answer these before the rest (the visible rows); the visible rows of
+    // any client come before the background work of all of them.
+    // Replaces the client's previous urgent set; ignored if 'generation'
+    // is not its current one.
+    void SetVisible(ClientId client, unsigned long generation, const std::vector<Request>& requests);
+
+    // Drop everything the client has queued.
+    void Clear(ClientId client);
+
+    // Files read / answered from the cache.
+    std::size_t GetSniffedCount() const { return m_sniffed; }
+    std::size_t GetCacheHitCount() const { return m_cacheHits; }
+
+private:
+    // Results are handed over once this many are ready, after BATCH_MS,
+    // or when the queue runs dry, whichever comes first – one GUI update
+    // per batch instead of one per file.
+    static constexpr std::size_t BATCH_SIZE  = 256;
+    static constexpr int         BATCH_MS    = 100;
+    // The type cache is simply emptied when it grows past this.
+    static constexpr std::size_t MAX_CACHED  = 200000;
+
+    struct Key
+    {
+        std::uint64_t device;
+        std::uint64_t inode;
+        std::int64_t  modified;
+
+        bool operator==(const Key& other) const
+        {
+            return device == other.device && inode == other.inode && modified == other.modified;
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const
+        {
+            std::uint64_t h = key.inode * 0x9E3779B97F4A7C15ULL;
+            h ^= key.device + 0x7F4A7C159E3779B9ULL + (h << 6) + (h >> 2);
+            h ^= static_cast<std::uint64_t>(key.modified) + (h << 6) + (h >> 2);
+            return static_cast<std::size_t>(h);
+        }
+    };
+
+    struct Client
+    {
+        ResultHandler       handler;
+        std::string         directory;    // ends with '/'
+        std::deque<Request> urgent;
+        std::deque<Request> background;
+        std::vector<bool>   answered;     // by listing index
+        unsigned long       generation;
+    };
+
+    std::map<ClientId, Client>                 m_clients;
+    ClientId                                   m_nextClient;
+    ClientId                                   m_current;      // served last; kept while it has work
+    bool                                       m_stopping;
+    std::mutex                                 m_mutex;
+    std::mutex                                 m_deliverMutex; // held while a handler runs
+    std::condition_variable                    m_wakeup;
+    std::unordered_map<Key, std::string, KeyHash> m_cache;    // scanner thread only
+    std::atomic<std::size_t>                   m_sniffed;
+    std::atomic<std::size_t>                   m_cacheHits;
+    std::thread                                m_thread;
+
+    void WorkerLoop();
+
+    // Client to take the next request from, or end().  Needs m_mutex.
+    std::map<ClientId, Client>::iterator NextClient();
+
+    // Hand a batch to the client's handler unless it has been removed.
+    void Deliver(ClientId client, unsigned long generation, std::vector<Result> results);
+
+    // Cached type of the request's file, sniffing it on a miss.
+    std::string TypeOf(const std::string& directory, const Request& request);
+};
+
+#endif // FILETYPESCANNER_H
@@ -0,0 +1,776 @@
+/*
+Author: Guo Jia
+Description: Implementation of FileTypeSniffer.  Signatures are checked
+             most specific first; whatever has no signature and contains no
+             control bytes is examined as text.
+Date: 2026-10-18
+*/
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "FileTypeSniffer.h"
+
+using namespace std;
+
+namespace
+{
+    struct Magic
+    {
+        size_t      offset;
+        const char* bytes;
+        size_t      length;
+        const char* name;
+    };
+
+    // Longer signatures sharing a prefix with a shorter one come first.
+    const Magic MAGICS[] = {
+        { 0,   "\x1F\x8B",                         2,  "gzip compressed data" },
+        { 0,   "BZh",                              3,  "bzip2 compressed data" },
+        { 0,   "\xFD" "7zXZ\0",                    6,  "XZ compressed data" },
+        { 0,   "\x28\xB5\x2F\xFD",                 4,  "Zstandard compressed data" },
+        { 0,   "\x04\x22\x4D\x18",                 4,  "LZ4 compressed data" },
+        { 0,   "7z\xBC\xAF\x27\x1C",               6,  "7-Zip archive" },
+        { 0,   "Rar!\x1A\x07",                     6,  "RAR archive" },
+        { 0,   "!<arch>\ndebian-binary",           21, "Debian package" },
+        { 0,   "!<arch>\n",                        8,  "ar archive" },
+        { 0,   "\xED\xAB\xEE\xDB",                 4,  "RPM package" },
+        { 0,   "MSCF\0\0\0\0",                     8,  "Cabinet archive" },
+        { 257, "ustar",                            5,  "tar archive" },
+        { 0,   "%PDF-",                            5,  "PDF document" },
+        { 0,   "\xD0\xCF\x11\xE0\xA1\xB1\x1A\xE1", 8,  "OLE2 document" },
+        { 0,   "\x89PNG\r\n\x1A\n",                8,  "PNG image" },
+        { 0,   "\xFF\xD8\xFF",                     3,  "JPEG image" },
+        { 0,   "GIF87a",                           6,  "GIF image" },
+        { 0,   "GIF89a",                           6,  "GIF image" },
+        { 0,   "II*\0",                            4,  "TIFF image" },
+        { 0,   "MM\0*",                            4,  "TIFF image" },
+        { 0,   "8BPS",                             4,  "Photoshop image" },
+        { 0,   "SQLite format 3\0",                16, "SQLite database" },
+        { 0,   "\x89HDF\r\n\x1A\n",                8,  "HDF5 data" },
+        { 0,   "\0asm",                            4,  "WebAssembly module" },
+        { 0,   "\xFE\xED\xFA\xCE",                 4,  "Mach-O binary" },
+        { 0,   "\xFE\xED\xFA\xCF",                 4,  "Mach-O binary" },
+        { 0,   "\xCE\xFA\xED\xFE",                 4,  "Mach-O binary" },
+        { 0,   "\xCF\xFA\xED\xFE",                 4,  "Mach-O binary" },
+        { 0,   "dex\n",                            4,  "Dalvik executable" },
+        { 0,   "OggS",                             4,  "Ogg media" },
+        { 0,   "fLaC",                             4,  "FLAC audio" },
+        { 0,   "ID3",                              3,  "MP3 audio" },
+        { 0,   "MThd",                             4,  "MIDI audio" },
+        { 0,   "\x1A\x45\xDF\xA3",                 4,  "Matroska media" },
+        { 0,   "wOFF",                             4,  "WOFF font" },
+        { 0,   "wOF2",                             4,  "WOFF2 font" },
+        { 0,   "OTTO",                             4,  "OpenType font" },
+        { 0,   "\0\1\0\0\0",                       5,  "TrueType font" },
+        { 0,   "LUKS\xBA\xBE",                     6,  "LUKS encrypted volume" },
+    };
+
+    bool StartsWith(const unsigned char* data, size_t length, size_t offset,
+                    const char* bytes, size_t count)
+    {
+        return offset + count <= length && memcmp(data + offset, bytes, count) == 0;
+    }
+
+    // Little- or big-endian unsigned integer of 'size' bytes at 'offset'.
+    // The caller has checked the bounds.
+    uint64_t ReadInteger(const unsigned char* data, size_t offset, size_t size, bool bigEndian)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            size_t index = bigEndian ? offset + i : offset + size - 1 - i;
+            value = (value << 8) | data[index];
+        }
+        return value;
+    }
+
+    enum TextEncoding {
+        ENCODING_ASCII,
+        ENCODING_UTF8,
+        ENCODING_OTHER
+    };
+
+    // Classifies bytes as 7-bit ASCII, well-formed UTF-8, or neither.  A
+    // sequence cut off by the end of an incomplete read is not held
+    // against the data.
+    TextEncoding DetectEncoding(const unsigned char* data, size_t length, bool complete)
+    {
+        bool ascii = true;
+        size_t i = 0;
+        while (i < length)
+        {
+            unsigned char lead = data[i];
+            if (lead < 0x80)
+            {
+                ++i;
+                continue;
+            }
+            ascii = false;
+
+            size_t   follow;
+            uint32_t minimum;
+            if (lead >= 0xC2 && lead <= 0xDF)
+            {
+                follow  = 1;
+                minimum = 0x80;
+            }
+            else if (lead >= 0xE0 && lead <= 0xEF)
+            {
+                follow  = 2;
+                minimum = 0x800;
+            }
+            else if (lead >= 0xF0 && lead <= 0xF4)
+            {
+                follow  = 3;
+                minimum = 0x10000;
+            }
+            else
+            {
+                return ENCODING_OTHER;
+            }
+
+            uint32_t code = lead & (0x3F >> follow);
+            for (size_t k = 1; k <= follow; ++k)
+            {
+                if (i + k >= length)
+                {
+                    return complete ? ENCODING_OTHER : ENCODING_UTF8;
+                }
+                if ((data[i + k] & 0xC0) != 0x80)
+                {
+                    return ENCODING_OTHER;
+                }
+                code = (code << 6) | (data[i + k] & 0x3F);
+            }
+            if (code < minimum || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF))
+            {
+                return ENCODING_OTHER;
+            }
+            i += follow + 1;
+        }
+        return ascii ? ENCODING_ASCII : ENCODING_UTF8;
+    }
+
+    // True if every byte is printable in some 8-bit character set: no NUL
+    // and no C0 controls other than the usual whitespace, backspace and
+    // escape.
+    bool IsEightBitText(const unsigned char* data, size_t length)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            unsigned char c = data[i];
+            if (c < 0x20 && c != '\t' && c != '\n' && c != '\r' && c != '\f' &&
+                c != '\v' && c != '\b' && c != 0x1B)
+            {
+                return false;
+            }
+            if (c == 0x7F)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool StartsWithIgnoreCase(const unsigned char* data, size_t length, const char* text)
+    {
+        size_t count = strlen(text);
+        if (count > length)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            unsigned char c = data[i];
+            if (c >= 'A' && c <= 'Z')
+            {
+                c = static_cast<unsigned char>(c - 'A' + 'a');
+            }
+            if (c != static_cast<unsigned char>(text[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Contains(const unsigned char* data, size_t length, const char* text)
+    {
+        return memmem(data, length, text, strlen(text)) != nullptr;
+    }
+
+    bool IsJsonSpace(unsigned char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: FileTypeSniffer
+Description: Default constructor.  All functionality is static.
+Parameters: None
+Return: None
+*/
+FileTypeSniffer::FileTypeSniffer()
+{
+}
+
+/*
+Function: ~FileTypeSniffer
+Description: Destructor.  Nothing to release.
+Parameters: None
+Return: None
+*/
+FileTypeSniffer::~FileTypeSniffer()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Sniffing
+// ---------------------------------------------------------------------------
+
+/*
+Function: SniffFile
+Description: Stats the path first so devices, FIFOs and sockets are named
+             without being opened (opening some devices has side effects),
+             then reads the head of a regular file with one pread.
+             O_NOATIME keeps the scan from dirtying every inode it touches;
+             the kernel only allows it on files we own, hence the retry.
+Parameters: path - file to examine
+Return: Type name
+*/
+string FileTypeSniffer::SniffFile(const string& path)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+    {
+        return lstat(path.c_str(), &info) == 0 && S_ISLNK(info.st_mode) ? "Broken link" : "Unreadable";
+    }
+    if (S_ISFIFO(info.st_mode))
+    {
+        return "FIFO";
+    }
+    if (S_ISSOCK(info.st_mode))
+    {
+        return "Socket";
+    }
+    if (S_ISCHR(info.st_mode) || S_ISBLK(info.st_mode))
+    {
+        return "Device";
+    }
+    if (!S_ISREG(info.st_mode))
+    {
+        return "Special file";
+    }
+    if (info.st_size == 0)
+    {
+        return "Empty";
+    }
+
+    int flags = O_RDONLY | O_CLOEXEC | O_NOCTTY;
+#ifdef O_NOATIME
+    int fd = open(path.c_str(), flags | O_NOATIME);
+    if (fd < 0 && errno == EPERM)
+    {
+        fd = open(path.c_str(), flags);
+    }
+#else
+    int fd = open(path.c_str(), flags);
+#endif
+    if (fd < 0)
+    {
+        return "Unreadable";
+    }
+
+    unsigned char buffer[SNIFF_BYTES];
+    ssize_t got = pread(fd, buffer, sizeof(buffer), 0);
+    close(fd);
+    if (got < 0)
+    {
+        return "Unreadable";
+    }
+    size_t length = static_cast<size_t>(got);
+    return Sniff(buffer, length, static_cast<uint64_t>(info.st_size) <= length);
+}
+
+/*
+Function: Sniff
+Description: Fixed signatures first, then the formats that need a closer
+             look at their header, then text.
+Parameters: data     - first bytes of the file
+            length   - number of bytes
+            complete - true if this is the whole file
+Return: Type name
+*/
+string FileTypeSniffer::Sniff(const unsigned char* data, size_t length, bool complete)
+{
+    if (length == 0)
+    {
+        return "Empty";
+    }
+
+    if (StartsWith(data, length, 0, "\x7F" "ELF", 4))
+    {
+        return SniffElf(data, length);
+    }
+    if (StartsWith(data, length, 0, "PK\x03\x04", 4))
+    {
+        return SniffZip(data, length);
+    }
+    if (StartsWith(data, length, 0, "PK\x05\x06", 4))
+    {
+        return "Zip archive";
+    }
+    if (StartsWith(data, length, 4, "ftyp", 4))
+    {
+        return SniffIsoMedia(data, length);
+    }
+    if (StartsWith(data, length, 0, "RIFF", 4) && length >= 12)
+    {
+        if (StartsWith(data, length, 8, "WEBP", 4))
+        {
+            return "WebP image";
+        }
+        if (StartsWith(data, length, 8, "WAVE", 4))
+        {
+            return "WAV audio";
+        }
+        if (StartsWith(data, length, 8, "AVI ", 4))
+        {
+            return "AVI video";
+        }
+        return "RIFF data";
+    }
+
+    const char* magic = MatchMagic(data, length);
+    if (magic != nullptr)
+    {
+        return magic;
+    }
+
+    if (StartsWith(data, length, 0, "MZ", 2))
+    {
+        // e_lfanew points at the PE header; without one it is plain DOS.
+        if (length >= 0x40)
+        {
+            uint64_t header = ReadInteger(data, 0x3C, 4, false);
+            if (header + 24 <= length && StartsWith(data, length, header, "PE\0\0", 4))
+            {
+                uint64_t characteristics = ReadInteger(data, header + 22, 2, false);
+                return (characteristics & 0x2000) != 0 ? "Windows DLL" : "Windows executable";
+            }
+        }
+        return "DOS executable";
+    }
+    if (StartsWith(data, length, 0, "\xCA\xFE\xBA\xBE", 4) && length >= 8)
+    {
+        // Shared by Java class files (version >= 45 follows) and Mach-O
+        // universal binaries (a small architecture count follows).
+        return ReadInteger(data, 4, 4, true) < 20 ? "Mach-O universal binary" : "Java class";
+    }
+    if (length >= 26 && StartsWith(data, length, 0, "BM", 2) &&
+        ReadInteger(data, 6, 4, false) == 0)
+    {
+        uint64_t infoSize = ReadInteger(data, 14, 4, false);
+        if (infoSize == 12 || infoSize == 40 || infoSize == 56 || infoSize == 108 || infoSize == 124)
+        {
+            return "BMP image";
+        }
+    }
+    if (length >= 2 && data[0] == 0xFF &&
+        (data[1] == 0xFB || data[1] == 0xFA || data[1] == 0xF3 || data[1] == 0xF2))
+    {
+        return "MP3 audio";
+    }
+
+    return SniffText(data, length, complete);
+}
+
+// ---------------------------------------------------------------------------
+// Binary formats
+// ---------------------------------------------------------------------------
+
+/*
+Function: MatchMagic
+Description: Linear scan of the signature table; it is short and most
+             entries fail on the first byte.
+Parameters: data   - first bytes of the file
+            length - number of bytes
+Return: Type name, or nullptr if no signature matches
+*/
+const char* FileTypeSniffer::MatchMagic(const unsigned char* data, size_t length)
+{
+    for (const Magic& magic : MAGICS)
+    {
+        if (StartsWith(data, length, magic.offset, magic.bytes, magic.length))
+        {
+            return magic.name;
+        }
+    }
+    return nullptr;
+}
+
+/*
+Function: SniffElf
+Description: Uses e_type, and tells position-independent executables from
+             libraries (both are ET_DYN) by looking for a PT_INTERP entry
+             among the program headers that fit in the buffer.
+Parameters: data   - first bytes of the file
+            length - number of bytes
+Return: Type name
+*/
+string FileTypeSniffer::SniffElf(const unsigned char* data, size_t length)
+{
+    if (length < 20)
+    {
+        return "ELF binary";
+    }
+    bool is64      = data[4] == 2;
+    bool bigEndian = data[5] == 2;
+    uint64_t type  = ReadInteger(data, 16, 2, bigEndian);
+
+    switch (type)
+    {
+    case 1:
+        return "ELF object";
+    case 2:
+        return "ELF executable";
+    case 4:
+        return "ELF core dump";
+    case 3:
+        break;
+    default:
+        return "ELF binary";
+    }
+
+    size_t headerEnd = is64 ? 64 : 52;
+    if (length >= headerEnd)
+    {
+        uint64_t offset    = is64 ? ReadInteger(data, 32, 8, bigEndian) : ReadInteger(data, 28, 4, bigEndian);
+        uint64_t entrySize = ReadInteger(data, is64 ? 54 : 42, 2, bigEndian);
+        uint64_t count     = ReadInteger(data, is64 ? 56 : 44, 2, bigEndian);
+        const uint64_t PT_INTERP = 3;
+        for (uint64_t i = 0; entrySize >= 4 && i < count; ++i)
+        {
+            uint64_t entry = offset + i * entrySize;
+            if (entry + 4 > length)
+            {
+                break;
+            }
+            if (ReadInteger(data, entry, 4, bigEndian) == PT_INTERP)
+            {
+                return "ELF executable";
+            }
+        }
+    }
+    return "ELF shared object";
+}
+
+/*
+Function: SniffZip
+Description: Several formats are zip files whose first member identifies
+             them: ODF and EPUB store an uncompressed "mimetype" first,
+             OOXML starts with [Content_Types].xml, and jar / apk files
+             with their manifests.
+Parameters: data   - first bytes of the file
+            length - number of bytes
+Return: Type name
+*/
+string FileTypeSniffer::SniffZip(const unsigned char* data, size_t length)
+{
+    if (length < 30)
+    {
+        return "Zip archive";
+    }
+    size_t nameLength  = static_cast<size_t>(ReadInteger(data, 26, 2, false));
+    size_t extraLength = static_cast<size_t>(ReadInteger(data, 28, 2, false));
+    if (30 + nameLength > length)
+    {
+        return "Zip archive";
+    }
+    string name(reinterpret_cast<const char*>(data + 30), nameLength);
+
+    if (name == "mimetype")
+    {
+        size_t content = 30 + nameLength + extraLength;
+        if (StartsWith(data, length, content, "application/vnd.oasis.opendocument", 34))
+        {
+            return "OpenDocument file";
+        }
+        if (StartsWith(data, length, content, "application/epub+zip", 20))
+        {
+            return "EPUB ebook";
+        }
+    }
+    if (name == "[Content_Types].xml" || name.compare(0, 6, "_rels/") == 0)
+    {
+        return "Office Open XML document";
+    }
+    if (name == "AndroidManifest.xml")
+    {
+        return "Android package";
+    }
+    if (name.compare(0, 9, "META-INF/") == 0)
+    {
+        return "Java archive";
+    }
+    return "Zip archive";
+}
+
+/*
+Function: SniffIsoMedia
+Description: ISO base media files (MP4, QuickTime, HEIF, ...) share the
+             "ftyp" box; its major brand says which one it is.
+Parameters: data   - first bytes of the file
+            length - number of bytes
+Return: Type name
+*/
+string FileTypeSniffer::SniffIsoMedia(const unsigned char* data, size_t length)
+{
+    if (length < 12)
+    {
+        return "MPEG-4 media";
+    }
+    string brand(reinterpret_cast<const char*>(data + 8), 4);
+    if (brand == "qt  ")
+    {
+        return "QuickTime video";
+    }
+    if (brand == "M4A " || brand == "M4B ")
+    {
+        return "MPEG-4 audio";
+    }
+    if (brand == "heic" || brand == "heix" || brand == "mif1" || brand == "msf1")
+    {
+        return "HEIF image";
+    }
+    if (brand == "avif")
+    {
+        return "AVIF image";
+    }
+    if (brand.compare(0, 3, "3gp") == 0)
+    {
+        return "3GP video";
+    }
+    return "MPEG-4 video";
+}
+
+// ---------------------------------------------------------------------------
+// Text
+// ---------------------------------------------------------------------------
+
+/*
+Function: SniffText
+Description: Byte-order marks decide the encoding outright; otherwise the
+             bytes are checked as ASCII, then UTF-8, then as some 8-bit
+             charset.  Text whose opening matches a known format is named
+             after the format instead of the encoding.
+Parameters: data     - first bytes of the file
+            length   - number of bytes
+            complete - true if this is the whole file
+Return: Type name
+*/
+string FileTypeSniffer::SniffText(const unsigned char* data, size_t length, bool complete)
+{
+    if (StartsWith(data, length, 0, "\xFF\xFE", 2) || StartsWith(data, length, 0, "\xFE\xFF", 2))
+    {
+        return "UTF-16 text";
+    }
+
+    string encoding;
+    if (StartsWith(data, length, 0, "\xEF\xBB\xBF", 3))
+    {
+        data   += 3;
+        length -= 3;
+        encoding = "UTF-8 text";
+    }
+    if (!IsEightBitText(data, length))
+    {
+        return "Data";   // NUL or other control bytes
+    }
+    if (encoding.empty())
+    {
+        switch (DetectEncoding(data, length, complete))
+        {
+        case ENCODING_ASCII:
+            encoding = "ASCII text";
+            break;
+        case ENCODING_UTF8:
+            encoding = "UTF-8 text";
+            break;
+        case ENCODING_OTHER:
+            encoding = "ISO-8859 text";
+            break;
+        }
+    }
+
+    if (StartsWith(data, length, 0, "#!", 2))
+    {
+        return SniffScript(data, length);
+    }
+
+    size_t start = 0;
+    while (start < length && (IsJsonSpace(data[start]) || data[start] == '\f' || data[start] == '\v'))
+    {
+        ++start;
+    }
+    const unsigned char* text = data + start;
+    size_t               rest = length - start;
+
+    if (StartsWithIgnoreCase(text, rest, "<?xml"))
+    {
+        return Contains(text, rest, "<svg") ? "SVG image" : "XML document";
+    }
+    if (StartsWithIgnoreCase(text, rest, "<svg"))
+    {
+        return "SVG image";
+    }
+    if (StartsWithIgnoreCase(text, rest, "<!doctype html") || StartsWithIgnoreCase(text, rest, "<html"))
+    {
+        return "HTML document";
+    }
+    if (StartsWith(text, rest, 0, "{\\rtf", 5))
+    {
+        return "RTF document";
+    }
+    if (StartsWith(text, rest, 0, "%!PS", 4))
+    {
+        return "PostScript document";
+    }
+    if (StartsWith(text, rest, 0, "-----BEGIN ", 11))
+    {
+        return "PEM data";
+    }
+    if (StartsWith(text, rest, 0, "diff --git ", 11) ||
+        (StartsWith(text, rest, 0, "--- ", 4) && Contains(text, rest, "\n+++ ")))
+    {
+        return "Diff";
+    }
+
+    // JSON: an object opening with a key or closing at once, or an array
+    // opening with a value.  "[section]" in INI files fails the latter.
+    if (rest > 0 && (text[0] == '{' || text[0] == '['))
+    {
+        size_t next = 1;
+        while (next < rest && IsJsonSpace(text[next]))
+        {
+            ++next;
+        }
+        if (next < rest)
+        {
+            unsigned char c = text[next];
+            bool json = (text[0] == '{') ? (c == '"' || c == '}')
+                                         : (strchr("{[\"-0123456789tfn]", c) != nullptr);
+            if (json)
+            {
+                return "JSON data";
+            }
+        }
+    }
+
+    return encoding;
+}
+
+/*
+Function: SniffScript
+Description: Names a script after the interpreter on its #! line, looking
+             through "/usr/bin/env" (and its options) to the real one.
+Parameters: data   - first bytes of the file, starting with "#!"
+            length - number of bytes
+Return: Type name
+*/
+string FileTypeSniffer::SniffScript(const unsigned char* data, size_t length)
+{
+    size_t end = 2;
+    while (end < length && data[end] != '\n')
+    {
+        ++end;
+    }
+    string line(reinterpret_cast<const char*>(data + 2), end - 2);
+
+    vector<string> words;
+    size_t position = 0;
+    while (position < line.size())
+    {
+        size_t begin = line.find_first_not_of(" \t\r", position);
+        if (begin == string::npos)
+        {
+            break;
+        }
+        size_t finish = line.find_first_of(" \t\r", begin);
+        if (finish == string::npos)
+        {
+            finish = line.size();
+        }
+        words.push_back(line.substr(begin, finish - begin));
+        position = finish;
+    }
+
+    string interpreter;
+    for (size_t i = 0; i < words.size(); ++i)
+    {
+        string name = words[i].substr(words[i].rfind('/') + 1);
+        if (i == 0 && name == "env")
+        {
+            continue;
+        }
+        if (i > 0 && !name.empty() && (name[0] == '-' || name.find('=') != string::npos))
+        {
+            continue;   // env options and variable assignments
+        }
+        interpreter = name;
+        break;
+    }
+
+    auto startsWith = [&interpreter](const char* prefix)
+    {
+        return interpreter.compare(0, strlen(prefix), prefix) == 0;
+    };
+    if (interpreter == "sh" || interpreter == "bash" || interpreter == "dash" ||
+        interpreter == "zsh" || interpreter == "ksh" || interpreter == "fish")
+    {
+        return "Shell script";
+    }
+    if (startsWith("python"))
+    {
+        return "Python script";
+    }
+    if (startsWith("perl"))
+    {
+        return "Perl script";
+    }
+    if (startsWith("ruby"))
+    {
+        return "Ruby script";
+    }
+    if (startsWith("node"))
+    {
+        return "Node.js script";
+    }
+    if (startsWith("php"))
+    {
+        return "PHP script";
+    }
+    if (startsWith("lua"))
+    {
+        return "Lua script";
+    }
+    if (interpreter == "awk" || interpreter == "gawk" || interpreter == "mawk")
+    {
+        return "Awk script";
+    }
+    if (interpreter == "tclsh" || interpreter == "wish")
+    {
+        return "Tcl script";
+    }
+    return "Script";
+}
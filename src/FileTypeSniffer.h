@@ -0,0 +1,50 @@
+/*
+Author: Guo Jia
+Description: Declaration of FileTypeSniffer – names the type of a file from
+             its first bytes (magic numbers, then a look at whether the
+             bytes are text and in which encoding) rather than from its
+             extension.  Reading a file costs one stat, one open and a
+             single pread of SNIFF_BYTES; special files are never opened.
+Date: 2026-10-18
+*/
+
+#ifndef FILETYPESNIFFER_H
+#define FILETYPESNIFFER_H
+
+#include <cstddef>
+#include <string>
+
+class FileTypeSniffer
+{
+public:
+    // Bytes read from the start of each file.  Enough for every signature
+    // recognised here, including the tar header's "ustar" at offset 257.
+    static constexpr std::size_t SNIFF_BYTES = 512;
+
+    FileTypeSniffer();
+    virtual ~FileTypeSniffer();
+
+    // Type of the file at 'path', e.g. "ELF executable", "PNG image",
+    // "UTF-8 text".  Unreadable files come back as "Unreadable".
+    static std::string SniffFile(const std::string& path);
+
+    // Type of a file starting with data[0, length).  'complete' says the
+    // data is the whole file, so a multi-byte character cut off at the end
+    // makes it binary rather than being blamed on the read size.
+    static std::string Sniff(const unsigned char* data, std::size_t length, bool complete);
+
+private:
+    // Signatures that are a fixed byte string at a fixed offset.
+    static const char* MatchMagic(const unsigned char* data, std::size_t length);
+
+    // Refinements for containers whose contents change the answer.
+    static std::string SniffElf(const unsigned char* data, std::size_t length);
+    static std::string SniffZip(const unsigned char* data, std::size_t length);
+    static std::string SniffIsoMedia(const unsigned char* data, std::size_t length);
+
+    // Text: encoding first, then a guess at the format of the contents.
+    static std::string SniffText(const unsigned char* data, std::size_t length, bool complete);
+    static std::string SniffScript(const unsigned char* data, std::size_t length);
+};
+
+#endif // FILETYPESNIFFER_H
@@ -0,0 +1,66 @@
+/*
+Author: Guo Jia
+Description: Declaration of FuzzyMatcher – ranks a fixed set of paths
+             against a typed query, fzf style: the query's characters must
+             appear in order, case-insensitively, and matches at the start
+             of a component or word, or in a run, score higher.  Spaces and
+             slashes separate query terms; the terms match in order and the
+             last one must match inside the last component, so "src main"
+             finds ".../src/.../main" but not ".../main/.../src".  The index
+             is kept as parallel arrays, and a bitmask of the characters each
+             path and last component contains rejects most candidates four
+             at a time before any string is looked at.
+Date: 2026-10-18
+*/
+
+#ifndef FUZZYMATCHER_H
+#define FUZZYMATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class FuzzyMatcher
+{
+public:
+    struct Match
+    {
+        std::size_t index;   // position in the candidates given to Build()
+        double      score;
+    };
+
+    FuzzyMatcher();
+    virtual ~FuzzyMatcher();
+
+    // Replace the candidates.  'weights' (e.g. frecency, same order, may
+    // be empty) raises a candidate's score by log2(1 + weight).
+    void Build(const std::vector<std::string>& candidates, const std::vector<double>& weights);
+
+    // Up to maxResults candidates matching 'query', best first.  An empty
+    // query matches everything, so it ranks by weight alone.
+    std::vector<Match> Find(const std::string& query, std::size_t maxResults) const;
+
+    std::size_t GetCount() const { return m_pathMasks.size(); }
+
+private:
+    // Characters of a term, one bit per letter or digit class.
+    static std::uint32_t MaskOf(const char* text, std::size_t length);
+
+    // Score of the best alignment of 'term' inside [begin, end) starting
+    // at or after 'from'; 'matchEnd' receives where it ended.  Negative if
+    // the term does not match.
+    double ScoreTerm(const char* text, std::size_t from, std::size_t begin, std::size_t end,
+                     const std::string& term, std::size_t& matchEnd) const;
+
+    // Candidates are stored heaviest first.
+    std::string                m_text;          // every candidate, lower-cased, back to back
+    std::vector<std::uint32_t> m_offsets;       // start of candidate i in m_text; one extra at the end
+    std::vector<std::uint32_t> m_nameOffsets;   // start of its last component
+    std::vector<std::uint32_t> m_pathMasks;     // MaskOf() the whole candidate
+    std::vector<std::uint32_t> m_nameMasks;     // MaskOf() its last component
+    std::vector<float>         m_weights;       // log2(1 + weight)
+    std::vector<std::size_t>   m_indices;       // position of candidate i in Build()'s input
+};
+
+#endif // FUZZYMATCHER_H
@@ -0,0 +1,667 @@
+/*
+Author: Guo Jia
+Description: Implementation of HexViewPanel.  A row is BYTES_PER_ROW bytes
+             at a fixed offset, so the row under any scroll position is a
+             division – no scanning – and a paint formats only the rows on
+             screen.  Searches open their own MappedFile on a worker thread
+             (the viewer's window is not shared across threads) and report
+             back with CallAfter().
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <wx/sizer.h>
+#include <wx/dcbuffer.h>
+#include <wx/settings.h>
+#include "HexViewPanel.h"
+#include "PatternSearch.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+namespace
+{
+    // Character columns of the row layout produced by FormatRow():
+    // "000000001A30  de ad be ef 00 11 22 33  44 55 66 77 88 99 aa bb  |..ELF...........|"
+    const int OFFSET_DIGITS = 12;
+    const int HEX_COLUMN    = OFFSET_DIGITS + 2;
+    const int ASCII_COLUMN  = HEX_COLUMN + 16 * 3 + 1 + 2;
+
+    /*
+    Function: HexColumnOf
+    Description: Character column of the hex pair for a byte in its row;
+                 the two halves of the row are separated by an extra space.
+    Parameters: index - byte index within the row
+    Return: Column number
+    */
+    int HexColumnOf(size_t index)
+    {
+        return HEX_COLUMN + static_cast<int>(index) * 3 + (index >= 8 ? 1 : 0);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: HexViewPanel
+Description: Builds the toolbar row (go-to box, find box with hex/text
+             switch and previous/next buttons, position label) above the
+             custom-drawn dump and its scroll bar.
+Parameters: parent  - parent window (the main splitter)
+            workers - pool that runs searches
+Return: None
+*/
+HexViewPanel::HexViewPanel(wxWindow* parent, ThreadPool& workers)
+    : wxPanel(parent),
+      m_gotoCtrl(nullptr),
+      m_findCtrl(nullptr),
+      m_hexBox(nullptr),
+      m_prevButton(nullptr),
+      m_nextButton(nullptr),
+      m_infoLabel(nullptr),
+      m_canvas(nullptr),
+      m_scrollBar(nullptr),
+      m_font(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL),
+      m_workers(workers),
+      m_file(),
+      m_topRow(0),
+      m_matchOffset(NO_MATCH),
+      m_matchLength(0),
+      m_searchStatus(""),
+      m_searchCancel(),
+      m_searchId(0)
+{
+    // --- Toolbar row --------------------------------------------------------
+    m_gotoCtrl = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxSize(110, -1),
+                                wxTE_PROCESS_ENTER);
+    m_gotoCtrl->SetHint("0x offset or %");
+    m_findCtrl = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxSize(160, -1),
+                                wxTE_PROCESS_ENTER);
+    m_findCtrl->SetHint("find bytes");
+    m_hexBox     = new wxCheckBox(this, wxID_ANY, "Hex");
+    m_hexBox->SetValue(true);
+    m_prevButton = new wxButton(this, wxID_ANY, "<", wxDefaultPosition, wxSize(32, -1));
+    m_nextButton = new wxButton(this, wxID_ANY, ">", wxDefaultPosition, wxSize(32, -1));
+    m_infoLabel  = new wxStaticText(this, wxID_ANY, "");
+
+    wxBoxSizer* toolbar = new wxBoxSizer(wxHORIZONTAL);
+    toolbar->Add(new wxStaticText(this, wxID_ANY, "Go to:"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 4);
+    toolbar->Add(m_gotoCtrl,   0, wxRIGHT, 8);
+    toolbar->Add(new wxStaticText(this, wxID_ANY, "Find:"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 4);
+    toolbar->Add(m_findCtrl,   0, wxRIGHT, 4);
+    toolbar->Add(m_hexBox,     0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 4);
+    toolbar->Add(m_prevButton, 0, wxRIGHT, 2);
+    toolbar->Add(m_nextButton, 0, wxRIGHT, 8);
+    toolbar->Add(m_infoLabel,  1, wxALIGN_CENTER_VERTICAL);
+
+    // --- Dump area ----------------------------------------------------------
+    m_canvas = new wxWindow(this, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                            wxWANTS_CHARS | wxFULL_REPAINT_ON_RESIZE);
+    m_canvas->SetBackgroundStyle(wxBG_STYLE_PAINT);
+    m_canvas->SetFont(m_font);
+    m_scrollBar = new wxScrollBar(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxSB_VERTICAL);
+
+    wxBoxSizer* body = new wxBoxSizer(wxHORIZONTAL);
+    body->Add(m_canvas,    1, wxEXPAND);
+    body->Add(m_scrollBar, 0, wxEXPAND);
+
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(toolbar, 0, wxEXPAND | wxALL, 4);
+    sizer->Add(body,    1, wxEXPAND);
+    SetSizer(sizer);
+
+    // --- Bind events --------------------------------------------------------
+    m_canvas->Bind(wxEVT_PAINT,      &HexViewPanel::OnPaint,      this);
+    m_canvas->Bind(wxEVT_SIZE,       &HexViewPanel::OnSize,       this);
+    m_canvas->Bind(wxEVT_MOUSEWHEEL, &HexViewPanel::OnMouseWheel, this);
+    m_canvas->Bind(wxEVT_KEY_DOWN,   &HexViewPanel::OnKeyDown,    this);
+    m_canvas->Bind(wxEVT_LEFT_DOWN,  [this](wxMouseEvent& event) { m_canvas->SetFocus(); event.Skip(); });
+
+    m_scrollBar->Bind(wxEVT_SCROLL_LINEUP,       [this](wxScrollEvent&) { ScrollRows(-1); });
+    m_scrollBar->Bind(wxEVT_SCROLL_LINEDOWN,     [this](wxScrollEvent&) { ScrollRows(1); });
+    m_scrollBar->Bind(wxEVT_SCROLL_PAGEUP,       [this](wxScrollEvent&) { ScrollRows(-VisibleRows()); });
+    m_scrollBar->Bind(wxEVT_SCROLL_PAGEDOWN,     [this](wxScrollEvent&) { ScrollRows(VisibleRows()); });
+    m_scrollBar->Bind(wxEVT_SCROLL_THUMBTRACK,   &HexViewPanel::OnScrollThumb, this);
+    m_scrollBar->Bind(wxEVT_SCROLL_THUMBRELEASE, &HexViewPanel::OnScrollThumb, this);
+
+    m_gotoCtrl->Bind(wxEVT_TEXT_ENTER, &HexViewPanel::OnGoTo, this);
+    m_findCtrl->Bind(wxEVT_TEXT_ENTER, [this](wxCommandEvent&) { StartSearch(true); });
+    m_prevButton->Bind(wxEVT_BUTTON,   [this](wxCommandEvent&) { StartSearch(false); });
+    m_nextButton->Bind(wxEVT_BUTTON,   [this](wxCommandEvent&) { StartSearch(true); });
+}
+
+/*
+Function: ~HexViewPanel
+Description: Cancels a running search; the mapping is released by
+             ~MappedFile.
+Parameters: None
+Return: None
+*/
+HexViewPanel::~HexViewPanel()
+{
+    CancelSearch();
+}
+
+// ---------------------------------------------------------------------------
+// File handling
+// ---------------------------------------------------------------------------
+
+/*
+Function: ShowFile
+Description: Opens a file and shows it from offset 0.  Nothing is read
+             until the first paint, which maps only the window it needs.
+Parameters: path - file to show
+Return: true if the file was opened
+*/
+bool HexViewPanel::ShowFile(const wxString& path)
+{
+    CloseFile();
+    if (!m_file.Open(path.ToStdString()))
+    {
+        m_infoLabel->SetLabel("Cannot open \"" + path + "\"");
+        return false;
+    }
+    ScrollToRow(0);
+    return true;
+}
+
+/*
+Function: CloseFile
+Description: Cancels any search, releases the file and clears the view.
+Parameters: None
+Return: None
+*/
+void HexViewPanel::CloseFile()
+{
+    CancelSearch();
+    m_file.Close();
+    m_topRow      = 0;
+    m_matchOffset = NO_MATCH;
+    m_matchLength = 0;
+    m_searchStatus.clear();
+    m_infoLabel->SetLabel("");
+    UpdateScrollBar();
+    m_canvas->Refresh();
+}
+
+// ---------------------------------------------------------------------------
+// Event handlers
+// ---------------------------------------------------------------------------
+
+/*
+Function: OnPaint
+Description: Formats and draws the visible rows, one Read() for all of
+             them.  The current match is underlaid with a highlight in both
+             the hex and the character column.
+Parameters: event - paint event (unused)
+Return: None
+*/
+void HexViewPanel::OnPaint(wxPaintEvent& /*event*/)
+{
+    wxAutoBufferedPaintDC dc(m_canvas);
+    dc.SetBackground(wxBrush(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOW)));
+    dc.Clear();
+
+    if (!m_file.IsOpen())
+    {
+        return;
+    }
+    m_file.UpdateSize();
+
+    dc.SetFont(m_font);
+    int rowHeight = dc.GetCharHeight();
+    int charWidth = dc.GetCharWidth();
+    int rows      = VisibleRows() + 1;   // include a partly visible last row
+
+    uint64_t first = m_topRow * BYTES_PER_ROW;
+    size_t   available = 0;
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(
+        m_file.Read(first, static_cast<size_t>(rows) * BYTES_PER_ROW, available));
+    if (data == nullptr)
+    {
+        return;
+    }
+
+    wxColour highlight = wxSystemSettings::GetColour(wxSYS_COLOUR_HIGHLIGHT);
+    dc.SetPen(wxPen(highlight));
+    dc.SetBrush(wxBrush(highlight));
+    dc.SetTextForeground(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOWTEXT));
+
+    for (int row = 0; row < rows; ++row)
+    {
+        size_t start = static_cast<size_t>(row) * BYTES_PER_ROW;
+        if (start >= available)
+        {
+            break;
+        }
+        size_t   length = min(BYTES_PER_ROW, available - start);
+        uint64_t offset = first + start;
+        int      y      = row * rowHeight;
+
+        if (m_matchOffset != NO_MATCH &&
+            m_matchOffset < offset + length && m_matchOffset + m_matchLength > offset)
+        {
+            size_t from = m_matchOffset > offset ? static_cast<size_t>(m_matchOffset - offset) : 0;
+            size_t to   = static_cast<size_t>(min<uint64_t>(m_matchOffset + m_matchLength - offset, length));
+            for (size_t i = from; i < to; ++i)
+            {
+                dc.DrawRectangle(TEXT_MARGIN + HexColumnOf(i) * charWidth, y, 2 * charWidth, rowHeight);
+                dc.DrawRectangle(TEXT_MARGIN + (ASCII_COLUMN + static_cast<int>(i)) * charWidth, y,
+                                 charWidth, rowHeight);
+            }
+        }
+        dc.DrawText(FormatRow(offset, data + start, length), TEXT_MARGIN, y);
+    }
+}
+
+/*
+Function: OnSize
+Description: A resize changes how many rows fit, which the thumb reflects.
+Parameters: event - size event (skipped)
+Return: None
+*/
+void HexViewPanel::OnSize(wxSizeEvent& event)
+{
+    event.Skip();
+    m_canvas->Refresh();
+    UpdateScrollBar();
+}
+
+/*
+Function: OnMouseWheel
+Description: Scrolls by the platform's lines-per-notch.
+Parameters: event - mouse-wheel event
+Return: None
+*/
+void HexViewPanel::OnMouseWheel(wxMouseEvent& event)
+{
+    int notches = event.GetWheelRotation() / max(1, event.GetWheelDelta());
+    ScrollRows(-static_cast<long long>(notches) * event.GetLinesPerAction());
+}
+
+/*
+Function: OnKeyDown
+Description: Arrow, page and Home/End keys move through the file; Ctrl+F
+             and Ctrl+G jump to the find and go-to boxes.
+Parameters: event - key event (skipped for other keys)
+Return: None
+*/
+void HexViewPanel::OnKeyDown(wxKeyEvent& event)
+{
+    if (event.ControlDown() && event.GetKeyCode() == 'F')
+    {
+        m_findCtrl->SetFocus();
+        return;
+    }
+    if (event.ControlDown() && event.GetKeyCode() == 'G')
+    {
+        m_gotoCtrl->SetFocus();
+        return;
+    }
+
+    switch (event.GetKeyCode())
+    {
+    case WXK_UP:       ScrollRows(-1);             break;
+    case WXK_DOWN:     ScrollRows(1);              break;
+    case WXK_PAGEUP:   ScrollRows(-VisibleRows()); break;
+    case WXK_PAGEDOWN: ScrollRows(VisibleRows());  break;
+    case WXK_HOME:     ScrollToRow(0);             break;
+    case WXK_END:      ScrollToRow(RowCount());    break;
+    default:           event.Skip();               break;
+    }
+}
+
+/*
+Function: OnScrollThumb
+Description: Maps the thumb position linearly onto the rows.  Only a
+             division and a repaint, so dragging stays smooth at any size.
+Parameters: event - scroll event carrying the thumb position
+Return: None
+*/
+void HexViewPanel::OnScrollThumb(wxScrollEvent& event)
+{
+    double fraction = static_cast<double>(event.GetPosition()) / SCROLL_RANGE;
+    ScrollToRow(static_cast<uint64_t>(fraction * static_cast<double>(RowCount())));
+}
+
+/*
+Function: OnGoTo
+Description: Jumps to the offset typed in the go-to box.
+Parameters: event - text-enter event (unused)
+Return: None
+*/
+void HexViewPanel::OnGoTo(wxCommandEvent& /*event*/)
+{
+    uint64_t offset = 0;
+    if (!m_file.IsOpen() ||
+        !ParseOffset(m_gotoCtrl->GetValue().Trim().Trim(false).ToStdString(), m_file.GetSize(), offset))
+    {
+        return;
+    }
+    ShowOffset(offset);
+    m_canvas->SetFocus();
+}
+
+// ---------------------------------------------------------------------------
+// Navigation
+// ---------------------------------------------------------------------------
+
+/*
+Function: ScrollRows
+Description: Moves the view by a number of rows.
+Parameters: count - rows to move (negative = up)
+Return: None
+*/
+void HexViewPanel::ScrollRows(long long count)
+{
+    if (count < 0 && static_cast<uint64_t>(-count) > m_topRow)
+    {
+        ScrollToRow(0);
+        return;
+    }
+    ScrollToRow(m_topRow + static_cast<uint64_t>(count));
+}
+
+/*
+Function: ScrollToRow
+Description: Makes 'row' the top row, clamped so the last page stays full.
+Parameters: row - row number
+Return: None
+*/
+void HexViewPanel::ScrollToRow(uint64_t row)
+{
+    uint64_t rows    = RowCount();
+    uint64_t visible = static_cast<uint64_t>(VisibleRows());
+    uint64_t maxTop  = rows > visible ? rows - visible : 0;
+    m_topRow = min(row, maxTop);
+    m_canvas->Refresh();
+    UpdateScrollBar();
+    UpdateInfo();
+}
+
+/*
+Function: ShowOffset
+Description: Scrolls only if the row holding 'offset' is off screen, and
+             then places it a third of the way down.
+Parameters: offset - byte offset to bring into view
+Return: None
+*/
+void HexViewPanel::ShowOffset(uint64_t offset)
+{
+    uint64_t row     = offset / BYTES_PER_ROW;
+    uint64_t visible = static_cast<uint64_t>(VisibleRows());
+    if (row >= m_topRow && row < m_topRow + visible)
+    {
+        m_canvas->Refresh();
+        UpdateInfo();
+        return;
+    }
+    ScrollToRow(row > visible / 3 ? row - visible / 3 : 0);
+}
+
+/*
+Function: RowCount
+Description: Number of rows in the open file.
+Parameters: None
+Return: Row count
+*/
+uint64_t HexViewPanel::RowCount() const
+{
+    return (m_file.GetSize() + BYTES_PER_ROW - 1) / BYTES_PER_ROW;
+}
+
+/*
+Function: VisibleRows
+Description: Number of whole rows that fit in the dump area.
+Parameters: None
+Return: Row count (at least 1)
+*/
+int HexViewPanel::VisibleRows() const
+{
+    return max(1, m_canvas->GetClientSize().GetHeight() / max(1, m_canvas->GetCharHeight()));
+}
+
+// ---------------------------------------------------------------------------
+// Search
+// ---------------------------------------------------------------------------
+
+/*
+Function: StartSearch
+Description: Parses the find box and searches from just after (forward)
+             or just before (backward) the current match, or from the top
+             row if there is none.  The search runs on the pool with its
+             own mapping; starting another cancels it.
+Parameters: forward - search direction
+Return: None
+*/
+void HexViewPanel::StartSearch(bool forward)
+{
+    if (!m_file.IsOpen())
+    {
+        return;
+    }
+
+    string pattern;
+    if (m_hexBox->GetValue())
+    {
+        if (!PatternSearch::ParseHex(m_findCtrl->GetValue().ToStdString(), pattern))
+        {
+            m_searchStatus = "Enter hex bytes, e.g. 7f 45 4c 46";
+            UpdateInfo();
+            return;
+        }
+    }
+    else
+    {
+        pattern = string(m_findCtrl->GetValue().utf8_str());
+    }
+    if (pattern.empty())
+    {
+        return;
+    }
+
+    uint64_t from = m_topRow * BYTES_PER_ROW;
+    if (m_matchOffset != NO_MATCH)
+    {
+        from = forward ? m_matchOffset + 1 : m_matchOffset;
+    }
+
+    CancelSearch();
+    shared_ptr<atomic<bool>> cancel = make_shared<atomic<bool>>(false);
+    m_searchCancel = cancel;
+    unsigned long id = ++m_searchId;
+    string path = m_file.GetPath();
+    m_searchStatus = "Searching...";
+    UpdateInfo();
+
+    m_workers.Submit([this, path, pattern, from, forward, cancel, id]()
+    {
+        MappedFile file;
+        uint64_t offset = PatternSearch::NOT_FOUND;
+        if (file.Open(path))
+        {
+            offset = PatternSearch::FindInFile(file, pattern, from, forward, *cancel);
+        }
+        if (*cancel)
+        {
+            return;
+        }
+        size_t length = pattern.size();
+        CallAfter([this, id, offset, length, forward]()
+        {
+            OnSearchDone(id, offset, length, forward);
+        });
+    });
+}
+
+/*
+Function: CancelSearch
+Description: Tells the running search, if any, to stop.
+Parameters: None
+Return: None
+*/
+void HexViewPanel::CancelSearch()
+{
+    if (m_searchCancel)
+    {
+        *m_searchCancel = true;
+        m_searchCancel.reset();
+    }
+}
+
+/*
+Function: OnSearchDone
+Description: Highlights and shows the match, or reports that there is
+             none in that direction.  Results of superseded searches are
+             dropped.
+Parameters: id      - search the result belongs to
+            offset  - match offset or PatternSearch::NOT_FOUND
+            length  - pattern length
+            forward - direction that was searched
+Return: None
+*/
+void HexViewPanel::OnSearchDone(unsigned long id, uint64_t offset, size_t length, bool forward)
+{
+    if (id != m_searchId || !m_file.IsOpen())
+    {
+        return;
+    }
+    m_searchCancel.reset();
+
+    if (offset == PatternSearch::NOT_FOUND)
+    {
+        m_searchStatus = forward ? "Not found below" : "Not found above";
+        UpdateInfo();
+        return;
+    }
+
+    m_matchOffset  = offset;
+    m_matchLength  = length;
+    m_searchStatus = wxString::Format("Match at 0x%llX", static_cast<unsigned long long>(offset));
+    ShowOffset(offset);
+}
+
+// ---------------------------------------------------------------------------
+// Display helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: UpdateScrollBar
+Description: The scroll bar covers the rows through SCROLL_RANGE steps, as
+             a file's row count does not fit in an int.
+Parameters: None
+Return: None
+*/
+void HexViewPanel::UpdateScrollBar()
+{
+    uint64_t rows = RowCount();
+    if (!m_file.IsOpen() || rows == 0)
+    {
+        m_scrollBar->SetScrollbar(0, SCROLL_RANGE, SCROLL_RANGE, SCROLL_RANGE);
+        return;
+    }
+
+    double top     = static_cast<double>(m_topRow) / static_cast<double>(rows);
+    double visible = min(1.0, static_cast<double>(VisibleRows()) / static_cast<double>(rows));
+    int thumb = max(1, static_cast<int>(visible * SCROLL_RANGE));
+    m_scrollBar->SetScrollbar(static_cast<int>(top * SCROLL_RANGE), thumb, SCROLL_RANGE + thumb, thumb);
+}
+
+/*
+Function: UpdateInfo
+Description: Shows the top row's offset, the file size and the outcome of
+             the last search.
+Parameters: None
+Return: None
+*/
+void HexViewPanel::UpdateInfo()
+{
+    if (!m_file.IsOpen())
+    {
+        return;
+    }
+    uint64_t size    = m_file.GetSize();
+    uint64_t offset  = m_topRow * BYTES_PER_ROW;
+    double   percent = size > 0 ? 100.0 * static_cast<double>(offset) / static_cast<double>(size) : 0.0;
+    wxString info = wxString::Format("0x%llX of %llu bytes, %.1f%%",
+                                     static_cast<unsigned long long>(offset),
+                                     static_cast<unsigned long long>(size), percent);
+    if (!m_searchStatus.empty())
+    {
+        info += "  -  " + m_searchStatus;
+    }
+    m_infoLabel->SetLabel(info);
+}
+
+/*
+Function: FormatRow
+Description: Formats one row as offset, hex pairs and printable characters.
+             A short last row is padded so the character column lines up.
+Parameters: offset - file offset of the row
+            data   - row bytes
+            length - number of bytes (at most BYTES_PER_ROW)
+Return: Display string
+*/
+wxString HexViewPanel::FormatRow(uint64_t offset, const unsigned char* data, size_t length)
+{
+    static const char DIGITS[] = "0123456789abcdef";
+
+    char line[ASCII_COLUMN + BYTES_PER_ROW + 2];
+    fill(line, line + sizeof(line), ' ');
+    snprintf(line, sizeof(line), "%0*llX", OFFSET_DIGITS, static_cast<unsigned long long>(offset));
+    line[OFFSET_DIGITS] = ' ';
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        int column = HexColumnOf(i);
+        line[column]     = DIGITS[data[i] >> 4];
+        line[column + 1] = DIGITS[data[i] & 0x0F];
+        line[ASCII_COLUMN + i] = (data[i] >= 0x20 && data[i] < 0x7F) ? static_cast<char>(data[i]) : '.';
+    }
+    line[ASCII_COLUMN - 1] = '|';
+    line[ASCII_COLUMN + length] = '|';
+
+    return wxString(line, ASCII_COLUMN + length + 1);
+}
+
+/*
+Function: ParseOffset
+Description: Accepts "0x1f00" (hex), "7936" (decimal) or "37.5%" (fraction
+             of the file).
+Parameters: text   - user input
+            size   - file size, for percentages and clamping
+            offset - receives the offset
+Return: false if the text is not a number
+*/
+bool HexViewPanel::ParseOffset(const string& text, uint64_t size, uint64_t& offset)
+{
+    if (text.empty())
+    {
+        return false;
+    }
+
+    char* end = nullptr;
+    if (text.back() == '%')
+    {
+        double percent = max(0.0, min(100.0, strtod(text.c_str(), &end)));
+        offset = static_cast<uint64_t>(percent / 100.0 * static_cast<double>(size));
+    }
+    else
+    {
+        bool hex = text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X');
+        offset = strtoull(text.c_str(), &end, hex ? 16 : 10);
+        if (*end != '\0')
+        {
+            return false;
+        }
+    }
+    if (size > 0)
+    {
+        offset = min(offset, size - 1);
+    }
+    return true;
+}
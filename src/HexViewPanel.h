@@ -0,0 +1,99 @@
+/*
+Author: Guo Jia
+Description: Declaration of HexViewPanel – a read-only hex/ASCII viewer for
+             binary files of any size (core dumps, database pages, ...).
+             The view is a row number into the file; each paint reads just
+             the visible rows through a MappedFile window, so opening is
+             constant-time and scrolling costs the same anywhere in a
+             multi-GB file.  Byte patterns (hex or text) are searched
+             forwards or backwards on the worker pool.
+Date: 2026-10-18
+*/
+
+#ifndef HEXVIEWPANEL_H
+#define HEXVIEWPANEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <wx/panel.h>
+#include <wx/textctrl.h>
+#include <wx/checkbox.h>
+#include <wx/button.h>
+#include <wx/stattext.h>
+#include <wx/scrolbar.h>
+#include <wx/font.h>
+#include "MappedFile.h"
+
+class ThreadPool;
+
+class HexViewPanel : public wxPanel
+{
+public:
+    HexViewPanel(wxWindow* parent, ThreadPool& workers);
+    virtual ~HexViewPanel();
+
+    // Show a file from offset 0.  Returns false if it cannot be opened.
+    bool ShowFile(const wxString& path);
+    void CloseFile();
+
+    wxString GetPath() const { return wxString(m_file.GetPath()); }
+
+private:
+    static constexpr std::size_t   BYTES_PER_ROW = 16;
+    static constexpr int           SCROLL_RANGE  = 1000000;
+    static constexpr int           TEXT_MARGIN   = 4;
+    static constexpr std::uint64_t NO_MATCH      = UINT64_MAX;
+
+    wxTextCtrl*   m_gotoCtrl;
+    wxTextCtrl*   m_findCtrl;
+    wxCheckBox*   m_hexBox;      // pattern is hex digits rather than text
+    wxButton*     m_prevButton;
+    wxButton*     m_nextButton;
+    wxStaticText* m_infoLabel;
+    wxWindow*     m_canvas;
+    wxScrollBar*  m_scrollBar;
+    wxFont        m_font;
+
+    ThreadPool&   m_workers;
+    MappedFile    m_file;
+    std::uint64_t m_topRow;
+    std::uint64_t m_matchOffset;   // highlighted match, NO_MATCH if none
+    std::size_t   m_matchLength;
+    wxString      m_searchStatus;  // outcome of the last search, shown in the info label
+
+    // The running search, if any.  Each search gets a fresh flag so an
+    // abandoned one can be cancelled without racing its successor.
+    std::shared_ptr<std::atomic<bool>> m_searchCancel;
+    unsigned long                      m_searchId;
+
+    // Event handlers
+    void OnPaint(wxPaintEvent& event);
+    void OnSize(wxSizeEvent& event);
+    void OnMouseWheel(wxMouseEvent& event);
+    void OnKeyDown(wxKeyEvent& event);
+    void OnScrollThumb(wxScrollEvent& event);
+    void OnGoTo(wxCommandEvent& event);
+
+    // Navigation
+    void ScrollRows(long long count);
+    void ScrollToRow(std::uint64_t row);
+    void ShowOffset(std::uint64_t offset);
+    std::uint64_t RowCount() const;
+    int  VisibleRows() const;
+
+    // Search
+    void StartSearch(bool forward);
+    void CancelSearch();
+    void OnSearchDone(unsigned long id, std::uint64_t offset, std::size_t length, bool forward);
+
+    void UpdateScrollBar();
+    void UpdateInfo();
+
+    static wxString FormatRow(std::uint64_t offset, const unsigned char* data, std::size_t length);
+    static bool     ParseOffset(const std::string& text, std::uint64_t size, std::uint64_t& offset);
+};
+
+#endif // HEXVIEWPANEL_H
@@ -0,0 +1,120 @@
+/*
+Author: Guo Jia
+Description: Implementation of IdNameCache.  Uses the reentrant getpwuid_r
+             / getgrgid_r, growing the buffer when an entry does not fit.
+Date: 2026-10-18
+*/
+
+#include <cerrno>
+#include <grp.h>
+#include <pwd.h>
+#include <vector>
+#include "IdNameCache.h"
+
+using namespace std;
+
+namespace
+{
+    const size_t INITIAL_BUFFER = 1024;
+    const size_t MAX_BUFFER     = 1024 * 1024;
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: IdNameCache
+Description: Starts with nothing cached.
+Parameters: None
+Return: None
+*/
+IdNameCache::IdNameCache()
+    : m_users(),
+      m_groups()
+{
+}
+
+/*
+Function: ~IdNameCache
+Description: Destructor.  Nothing to release.
+Parameters: None
+Return: None
+*/
+IdNameCache::~IdNameCache()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Lookups
+// ---------------------------------------------------------------------------
+
+/*
+Function: UserName
+Description: Looks the uid up in the password database on first use.
+Parameters: uid - user id
+Return: User name, or the uid as text
+*/
+const string& IdNameCache::UserName(uint32_t uid)
+{
+    auto cached = m_users.find(uid);
+    if (cached != m_users.end())
+    {
+        return cached->second;
+    }
+
+    string name = to_string(uid);
+    vector<char> buffer(INITIAL_BUFFER);
+    for (;;)
+    {
+        struct passwd  entry;
+        struct passwd* found = nullptr;
+        int error = getpwuid_r(static_cast<uid_t>(uid), &entry, buffer.data(), buffer.size(), &found);
+        if (error == ERANGE && buffer.size() < MAX_BUFFER)
+        {
+            buffer.resize(buffer.size() * 2);
+            continue;
+        }
+        if (error == 0 && found != nullptr)
+        {
+            name = found->pw_name;
+        }
+        break;
+    }
+    return m_users.emplace(uid, name).first->second;
+}
+
+/*
+Function: GroupName
+Description: Looks the gid up in the group database on first use.
+Parameters: gid - group id
+Return: Group name, or the gid as text
+*/
+const string& IdNameCache::GroupName(uint32_t gid)
+{
+    auto cached = m_groups.find(gid);
+    if (cached != m_groups.end())
+    {
+        return cached->second;
+    }
+
+    string name = to_string(gid);
+    vector<char> buffer(INITIAL_BUFFER);
+    for (;;)
+    {
+        struct group  entry;
+        struct group* found = nullptr;
+        int error = getgrgid_r(static_cast<gid_t>(gid), &entry, buffer.data(), buffer.size(), &found);
+        if (error == ERANGE && buffer.size() < MAX_BUFFER)
+        {
+            buffer.resize(buffer.size() * 2);
+            continue;
+        }
+        if (error == 0 && found != nullptr)
+        {
+            name = found->gr_name;
+        }
+        break;
+    }
+    return m_groups.emplace(gid, name).first->second;
+}
@@ -0,0 +1,32 @@
+/*
+Author: Guo Jia
+Description: Declaration of IdNameCache – user and group names for numeric
+             ids.  Resolving an id can mean reading /etc/passwd or asking a
+             directory service, and a listing repeats the same few ids on
+             every row, so each id is looked up once and remembered.
+Date: 2026-10-18
+*/
+
+#ifndef IDNAMECACHE_H
+#define IDNAMECACHE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+class IdNameCache
+{
+public:
+    IdNameCache();
+    virtual ~IdNameCache();
+
+    // Name of the user / group, or the id in decimal if it has none.
+    const std::string& UserName(std::uint32_t uid);
+    const std::string& GroupName(std::uint32_t gid);
+
+private:
+    std::unordered_map<std::uint32_t, std::string> m_users;
+    std::unordered_map<std::uint32_t, std::string> m_groups;
+};
+
+#endif // IDNAMECACHE_H
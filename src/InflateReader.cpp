@@ -0,0 +1,156 @@
+/*
+Author: Guo Jia
+Description: Implementation of InflateReader on top of wxZlibInputStream.
+             When a deflate stream ends, wxZlibInputStream hands the bytes
+             it read past the end back to the file stream, so the next gzip
+             member is decoded by a fresh wxZlibInputStream on the same file.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <vector>
+#include <wx/log.h>
+#include "InflateReader.h"
+
+using namespace std;
+
+namespace
+{
+    const unsigned char GZIP_MAGIC = 0x1F;
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: InflateReader
+Description: Opens the file and seeks to the start of the compressed data.
+Parameters: path    - file holding the data
+            offset  - where the compressed data starts
+            framing - gzip members or raw deflate
+Return: None
+*/
+InflateReader::InflateReader(const string& path, uint64_t offset, Framing framing)
+    : m_file(wxString::FromUTF8(path.c_str())),
+      m_zlib(),
+      m_framing(framing),
+      m_position(0),
+      m_failed(false)
+{
+    if (!m_file.IsOk() || m_file.SeekI(static_cast<wxFileOffset>(offset)) == wxInvalidOffset)
+    {
+        m_failed = true;
+        return;
+    }
+    if (m_framing == FRAMING_RAW)
+    {
+        m_zlib.reset(new wxZlibInputStream(m_file, wxZLIB_NO_HEADER));
+    }
+    else if (!NextMember())
+    {
+        m_failed = true;   // not even one gzip member
+    }
+}
+
+/*
+Function: ~InflateReader
+Description: Destructor.  The streams close the file.
+Parameters: None
+Return: None
+*/
+InflateReader::~InflateReader()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Reading
+// ---------------------------------------------------------------------------
+
+/*
+Function: Read
+Description: Reads from the current member, moving on to the next one when
+             it ends.  wx would report a corrupt stream through wxLogError,
+             i.e. a message box; errors are returned instead.
+Parameters: buffer - receives the data
+            length - capacity of 'buffer'
+Return: Bytes produced; 0 at the end or on error
+*/
+size_t InflateReader::Read(void* buffer, size_t length)
+{
+    wxLogNull quiet;
+    while (m_zlib && !m_failed && length > 0)
+    {
+        m_zlib->Read(buffer, length);
+        size_t produced = m_zlib->LastRead();
+        if (produced > 0)
+        {
+            m_position += produced;
+            return produced;
+        }
+        if (m_zlib->GetLastError() != wxSTREAM_EOF)
+        {
+            m_failed = true;
+        }
+        else if (m_framing == FRAMING_RAW || !NextMember())
+        {
+            m_zlib.reset();
+        }
+    }
+    return 0;
+}
+
+/*
+Function: Skip
+Description: Skipping compressed data still means inflating it; it is
+             decoded into a scratch buffer.
+Parameters: length - bytes to skip
+Return: true if that many bytes were skipped
+*/
+bool InflateReader::Skip(uint64_t length)
+{
+    vector<char> scratch(static_cast<size_t>(min<uint64_t>(length, SKIP_BUFFER)));
+    while (length > 0)
+    {
+        size_t produced = Read(scratch.data(), static_cast<size_t>(min<uint64_t>(length, scratch.size())));
+        if (produced == 0)
+        {
+            return false;
+        }
+        length -= produced;
+    }
+    return true;
+}
+
+/*
+Function: GetCompressedPosition
+Description: Position of the file stream, which lags the real consumption
+             by at most the zlib stream's input buffer.
+Parameters: None
+Return: Offset into the file
+*/
+uint64_t InflateReader::GetCompressedPosition() const
+{
+    wxFileOffset position = m_file.TellI();
+    return position == wxInvalidOffset ? 0 : static_cast<uint64_t>(position);
+}
+
+/*
+Function: NextMember
+Description: A new member must start with the gzip magic byte; anything
+             else (end of file, or the zero padding some tools append) ends
+             the data without an error.
+Parameters: None
+Return: true if another member was found
+*/
+bool InflateReader::NextMember()
+{
+    m_zlib.reset();
+    unsigned char next = static_cast<unsigned char>(m_file.Peek());
+    if (m_file.GetLastError() != wxSTREAM_NO_ERROR || next != GZIP_MAGIC)
+    {
+        return false;
+    }
+    m_zlib.reset(new wxZlibInputStream(m_file, wxZLIB_GZIP));
+    return true;
+}
@@ -0,0 +1,65 @@
+/*
+Author: Guo Jia
+Description: Declaration of InflateReader – sequential reader of deflated
+             data in a file: a gzip file (all of its members, as gzip -d
+             would concatenate them) or a raw deflate stream starting at an
+             offset, as zip stores its members.  Only forward reads and
+             skips; there is no random access into compressed data.
+Date: 2026-10-18
+*/
+
+#ifndef INFLATEREADER_H
+#define INFLATEREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <wx/wfstream.h>
+#include <wx/zstream.h>
+
+class InflateReader
+{
+public:
+    enum Framing {
+        FRAMING_GZIP,   // one or more gzip members
+        FRAMING_RAW     // a single raw deflate stream (zip method 8)
+    };
+
+    // Opens 'path' and positions it at 'offset'; see IsOk().
+    InflateReader(const std::string& path, std::uint64_t offset, Framing framing);
+    virtual ~InflateReader();
+
+    InflateReader(const InflateReader&) = delete;
+    InflateReader& operator=(const InflateReader&) = delete;
+
+    bool IsOk() const { return !m_failed; }
+
+    // Decompress up to 'length' bytes into 'buffer'.  Returns the number
+    // of bytes produced; 0 at the end of the data or on a corrupt stream
+    // (IsOk() tells them apart).
+    std::size_t Read(void* buffer, std::size_t length);
+
+    // Decompress and discard 'length' bytes.  Returns false if the data
+    // ends first.
+    bool Skip(std::uint64_t length);
+
+    // Uncompressed bytes produced so far, and how far into the file the
+    // compressed data has been consumed.
+    std::uint64_t GetPosition() const { return m_position; }
+    std::uint64_t GetCompressedPosition() const;
+
+private:
+    static constexpr std::size_t SKIP_BUFFER = 64 * 1024;
+
+    wxFileInputStream                  m_file;
+    std::unique_ptr<wxZlibInputStream> m_zlib;       // current member; null at the end
+    Framing                            m_framing;
+    std::uint64_t                      m_position;
+    bool                               m_failed;
+
+    // Start decoding the next gzip member, if another one follows.
+    bool NextMember();
+};
+
+#endif // INFLATEREADER_H
@@ -0,0 +1,412 @@
+/*
+Author: Guo Jia
+Description: Implementation of IoScheduler – per-device slot counting under
+             one mutex, a token bucket per throttled device, and the sysfs
+             lookup that tells spinning disks from SSDs.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include "IoScheduler.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: IoScheduler
+Description: Starts with no devices known; each is classified the first
+             time a job touches it.
+Parameters: None
+Return: None
+*/
+IoScheduler::IoScheduler()
+    : m_devices(),
+      m_waiting(),
+      m_nextSequence(0),
+      m_mutex(),
+      m_released()
+{
+}
+
+/*
+Function: ~IoScheduler
+Description: Nothing to release.  Jobs must have finished: they hold
+             references to the scheduler while they run.
+Parameters: None
+Return: None
+*/
+IoScheduler::~IoScheduler()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Scheduling
+// ---------------------------------------------------------------------------
+
+/*
+Function: Run
+Description: Registers the job as waiting, blocks until CanStart() admits
+             it, takes one slot on each of its devices and runs it.  The
+             slots are returned even if work() throws, and every waiter is
+             woken to re-check.
+Parameters: paths    - files or folders the job reads or writes
+            priority - rank among jobs waiting for the same devices
+            work     - the job
+Return: work()'s result
+*/
+bool IoScheduler::Run(const vector<string>& paths, Priority priority, const function<bool()>& work)
+{
+    Waiter waiter;
+    waiter.priority = priority;
+    waiter.sequence = 0;
+    for (const string& path : paths)
+    {
+        dev_t device;
+        if (DeviceOf(path, device))
+        {
+            waiter.devices.push_back(device);
+        }
+    }
+    sort(waiter.devices.begin(), waiter.devices.end());
+    waiter.devices.erase(unique(waiter.devices.begin(), waiter.devices.end()), waiter.devices.end());
+
+    {
+        unique_lock<mutex> lock(m_mutex);
+        waiter.sequence = m_nextSequence++;
+        m_waiting.push_back(&waiter);
+        m_released.wait(lock, [&] { return CanStart(waiter); });
+
+        m_waiting.erase(find(m_waiting.begin(), m_waiting.end(), &waiter));
+        for (dev_t device : waiter.devices)
+        {
+            ++DeviceEntry(device).active;
+        }
+    }
+
+    auto release = [&]()
+    {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            for (dev_t device : waiter.devices)
+            {
+                --DeviceEntry(device).active;
+            }
+        }
+        m_released.notify_all();
+    };
+
+    bool result = false;
+    try
+    {
+        result = work();
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+    release();
+    return result;
+}
+
+/*
+Function: Transfer
+Description: Token bucket: the device earns 'rate' bytes per second (up to
+             a short burst) and each transfer spends its size.  When the
+             balance is negative the caller sleeps until it is paid back,
+             which spreads the device's bandwidth over all jobs using it.
+Parameters: device - device the bytes went to or came from
+            bytes  - amount transferred
+Return: None
+*/
+void IoScheduler::Transfer(dev_t device, uint64_t bytes)
+{
+    double wait = 0.0;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        Device& entry = DeviceEntry(device);
+        if (entry.rate == 0)
+        {
+            return;
+        }
+
+        Clock::time_point now = Clock::now();
+        double elapsed = chrono::duration<double>(now - entry.refilled).count();
+        double burst   = static_cast<double>(entry.rate) * BURST_SECONDS;
+        entry.tokens   = min(burst, entry.tokens + elapsed * static_cast<double>(entry.rate));
+        entry.refilled = now;
+
+        entry.tokens -= static_cast<double>(bytes);
+        if (entry.tokens < 0.0)
+        {
+            wait = -entry.tokens / static_cast<double>(entry.rate);
+        }
+    }
+
+    if (wait > 0.0)
+    {
+        this_thread::sleep_for(chrono::duration<double>(wait));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Limits
+// ---------------------------------------------------------------------------
+
+/*
+Function: SetLimits
+Description: Replaces the slot count and/or bandwidth of one device.  Jobs
+             waiting for it are woken in case the limit went up.
+Parameters: path           - any path on the device
+            concurrency    - jobs at once, 0 for the automatic value
+            bytesPerSecond - bandwidth limit, 0 for none
+Return: false if the path's device cannot be found
+*/
+bool IoScheduler::SetLimits(const string& path, unsigned int concurrency, uint64_t bytesPerSecond)
+{
+    dev_t device;
+    if (!DeviceOf(path, device))
+    {
+        return false;
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        Device& entry = DeviceEntry(device);
+        entry.limit    = concurrency > 0 ? concurrency : DefaultLimit(Classify(device));
+        entry.rate     = bytesPerSecond;
+        entry.tokens   = static_cast<double>(bytesPerSecond) * BURST_SECONDS;
+        entry.refilled = Clock::now();
+    }
+    m_released.notify_all();
+    return true;
+}
+
+/*
+Function: LoadLimits
+Description: Parses the limits file.  The path comes first and may contain
+             spaces, so the two numbers are taken from the end of the line.
+             Lines that do not parse, or name missing paths, are skipped.
+Parameters: file - path of the limits file
+Return: number of devices whose limits were set
+*/
+size_t IoScheduler::LoadLimits(const string& file)
+{
+    ifstream in(file);
+    size_t applied = 0;
+    string line;
+    while (getline(in, line))
+    {
+        size_t hash = line.find('#');
+        if (hash != string::npos)
+        {
+            line.erase(hash);
+        }
+        while (!line.empty() && isspace(static_cast<unsigned char>(line.back())))
+        {
+            line.pop_back();
+        }
+
+        size_t rateStart = line.find_last_of(" \t");
+        if (rateStart == string::npos)
+        {
+            continue;
+        }
+        size_t jobsEnd   = line.find_last_not_of(" \t", rateStart);
+        size_t jobsStart = jobsEnd == string::npos ? string::npos : line.find_last_of(" \t", jobsEnd);
+        if (jobsStart == string::npos)
+        {
+            continue;
+        }
+        size_t pathEnd = line.find_last_not_of(" \t", jobsStart);
+        if (pathEnd == string::npos)
+        {
+            continue;
+        }
+
+        string path = line.substr(0, pathEnd + 1);
+        string jobs = line.substr(jobsStart + 1, jobsEnd - jobsStart);
+        string rate = line.substr(rateStart + 1);
+        char* jobsRest = nullptr;
+        char* rateRest = nullptr;
+        unsigned long concurrency = strtoul(jobs.c_str(), &jobsRest, 10);
+        double megabytes = strtod(rate.c_str(), &rateRest);
+        if (*jobsRest != '\0' || *rateRest != '\0' || megabytes < 0.0 || concurrency > UINT_MAX)
+        {
+            continue;
+        }
+
+        if (SetLimits(path, static_cast<unsigned int>(concurrency),
+                      static_cast<uint64_t>(megabytes * 1024.0 * 1024.0)))
+        {
+            ++applied;
+        }
+    }
+    return applied;
+}
+
+// ---------------------------------------------------------------------------
+// Devices
+// ---------------------------------------------------------------------------
+
+/*
+Function: DeviceOf
+Description: stat() the path, walking up to the parent until something
+             exists, so a copy's destination counts before it is created.
+Parameters: path   - file or folder
+            device - receives its st_dev
+Return: false if no part of the path exists
+*/
+bool IoScheduler::DeviceOf(const string& path, dev_t& device)
+{
+    string current = path;
+    for (;;)
+    {
+        struct stat info;
+        if (::stat(current.c_str(), &info) == 0)
+        {
+            device = info.st_dev;
+            return true;
+        }
+        if (current == "/" || current == ".")
+        {
+            return false;
+        }
+
+        size_t slash = current.find_last_of('/');
+        current = slash == string::npos ? string(".") : slash == 0 ? string("/") : current.substr(0, slash);
+    }
+}
+
+/*
+Function: Classify
+Description: /sys/dev/block/<major>:<minor> links to the block device's
+             sysfs folder.  A partition has no queue of its own, so its
+             disk's (the parent folder's) queue/rotational is read instead.
+             File systems without a block device (major 0: tmpfs, NFS, FUSE,
+             btrfs subvolumes) are "other".
+Parameters: device - st_dev of a file
+Return: the kind of storage
+*/
+IoScheduler::DeviceKind IoScheduler::Classify(dev_t device)
+{
+    if (major(device) == 0)
+    {
+        return DEVICE_OTHER;
+    }
+
+    string link = "/sys/dev/block/" + to_string(major(device)) + ":" + to_string(minor(device));
+    char* resolved = ::realpath(link.c_str(), nullptr);
+    if (resolved == nullptr)
+    {
+        return DEVICE_OTHER;
+    }
+    string folder = resolved;
+    free(resolved);
+
+    for (int level = 0; level < 2; ++level)
+    {
+        ifstream rotational(folder + "/queue/rotational");
+        int value = 0;
+        if (rotational >> value)
+        {
+            if (value != 0)
+            {
+                return DEVICE_ROTATIONAL;
+            }
+            string name = folder.substr(folder.find_last_of('/') + 1);
+            return name.compare(0, 4, "nvme") == 0 ? DEVICE_NVME : DEVICE_SOLID_STATE;
+        }
+        folder = folder.substr(0, folder.find_last_of('/'));
+    }
+    return DEVICE_OTHER;
+}
+
+// ---------------------------------------------------------------------------
+// Internals
+// ---------------------------------------------------------------------------
+
+/*
+Function: DeviceEntry
+Description: Finds the device's entry, classifying a device seen for the
+             first time.  Classify() reads two small sysfs files once per
+             device.
+Parameters: device - st_dev
+Return: the entry
+*/
+IoScheduler::Device& IoScheduler::DeviceEntry(dev_t device)
+{
+    auto found = m_devices.find(device);
+    if (found != m_devices.end())
+    {
+        return found->second;
+    }
+
+    Device& entry = m_devices[device];
+    entry.limit    = DefaultLimit(Classify(device));
+    entry.refilled = Clock::now();
+    return entry;
+}
+
+/*
+Function: CanStart
+Description: A device's free slots go to its waiters in rank order
+             (priority, then arrival), so the waiter may start only if each
+             of its devices has more free slots than better-ranked waiters
+             want.  High-priority jobs (quick interactive ones) get one slot
+             beyond the limit, so a rename does not wait for a long copy.
+Parameters: waiter - the job asking
+Return: true if it may start now
+*/
+bool IoScheduler::CanStart(const Waiter& waiter)
+{
+    for (dev_t device : waiter.devices)
+    {
+        Device& entry = DeviceEntry(device);
+        unsigned int ahead = 0;
+        for (const Waiter* other : m_waiting)
+        {
+            bool better = other->priority < waiter.priority ||
+                          (other->priority == waiter.priority && other->sequence < waiter.sequence);
+            if (better && binary_search(other->devices.begin(), other->devices.end(), device))
+            {
+                ++ahead;
+            }
+        }
+        unsigned int limit = entry.limit + (waiter.priority == PRIORITY_HIGH ? 1 : 0);
+        if (entry.active + ahead >= limit)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+Function: DefaultLimit
+Description: Jobs at once for a kind of disk.  A spinning disk does best
+             with one stream; flash devices need several requests in flight
+             to reach their throughput.
+Parameters: kind - kind of disk
+Return: slot count
+*/
+unsigned int IoScheduler::DefaultLimit(DeviceKind kind)
+{
+    switch (kind)
+    {
+        case DEVICE_ROTATIONAL:  return ROTATIONAL_JOBS;
+        case DEVICE_SOLID_STATE: return SOLID_STATE_JOBS;
+        case DEVICE_NVME:        return NVME_JOBS;
+        default:                 return OTHER_JOBS;
+    }
+}
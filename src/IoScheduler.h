@@ -0,0 +1,122 @@
+/*
+Author: Guo Jia
+Description: Declaration of IoScheduler – admits file operations per
+             storage device.  Every job names the paths it touches; the
+             devices (st_dev) of those paths each allow a limited number of
+             jobs at once, chosen from the kind of disk behind them (one for
+             a spinning disk, where parallel jobs only add seeks, more for
+             SSD and NVMe).  Waiting jobs are admitted by priority, then in
+             arrival order.  A device may also be throttled to a number of
+             bytes per second, charged by the jobs as they transfer data.
+Date: 2026-10-18
+*/
+
+#ifndef IOSCHEDULER_H
+#define IOSCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+class IoScheduler
+{
+public:
+    enum Priority {
+        PRIORITY_HIGH,      // short interactive work (rename, new folder);
+                            // may use one slot beyond the device's limit
+        PRIORITY_NORMAL,    // copies, moves and deletes
+        PRIORITY_LOW        // background scans
+    };
+
+    enum DeviceKind {
+        DEVICE_ROTATIONAL,
+        DEVICE_SOLID_STATE,
+        DEVICE_NVME,
+        DEVICE_OTHER        // network, virtual or unknown file systems
+    };
+
+    IoScheduler();
+    virtual ~IoScheduler();
+
+    IoScheduler(const IoScheduler&) = delete;
+    IoScheduler& operator=(const IoScheduler&) = delete;
+
+    // Run 'work' on the calling thread once every device holding one of
+    // 'paths' has a free slot, and release the slots afterwards.  Paths
+    // that do not exist yet count for the device of their nearest existing
+    // parent.  Returns work()'s result.
+    bool Run(const std::vector<std::string>& paths, Priority priority,
+             const std::function<bool()>& work);
+
+    // Account for 'bytes' read from or written to 'device'; sleeps as long
+    // as the device's bandwidth limit requires.  Free when unthrottled.
+    void Transfer(dev_t device, std::uint64_t bytes);
+
+    // Override the automatic limits of the device holding 'path'.
+    // 'concurrency' 0 keeps the automatic value; 'bytesPerSecond' 0 means
+    // unthrottled.  Returns false if 'path' cannot be resolved.
+    bool SetLimits(const std::string& path, unsigned int concurrency, std::uint64_t bytesPerSecond);
+
+    // Read "<path> <jobs> <MB/s>" lines ('#' starts a comment) and apply
+    // them with SetLimits().  A missing file is not an error.  Returns the
+    // number of lines applied.
+    std::size_t LoadLimits(const std::string& file);
+
+    // Device of 'path' (or of its nearest existing parent); false if none.
+    static bool DeviceOf(const std::string& path, dev_t& device);
+
+    // Kind of disk behind 'device', from /sys/dev/block/<major>:<minor>.
+    static DeviceKind Classify(dev_t device);
+
+private:
+    static constexpr unsigned int ROTATIONAL_JOBS  = 1;
+    static constexpr unsigned int SOLID_STATE_JOBS = 4;
+    static constexpr unsigned int NVME_JOBS        = 16;
+    static constexpr unsigned int OTHER_JOBS       = 4;
+
+    // Up to this much transfer may happen in a burst before throttling.
+    static constexpr double BURST_SECONDS = 0.25;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Device
+    {
+        unsigned int      limit      = 0;
+        unsigned int      active     = 0;
+        std::uint64_t     rate       = 0;     // bytes per second, 0 = unlimited
+        double            tokens     = 0.0;   // may go negative: bytes owed
+        Clock::time_point refilled;
+    };
+
+    struct Waiter
+    {
+        Priority            priority;
+        std::uint64_t       sequence;
+        std::vector<dev_t>  devices;
+    };
+
+    std::map<dev_t, Device>  m_devices;
+    std::vector<Waiter*>     m_waiting;
+    std::uint64_t            m_nextSequence;
+    std::mutex               m_mutex;
+    std::condition_variable  m_released;
+
+    // Look up (creating with automatic limits) the entry of 'device'.
+    // Caller holds m_mutex.
+    Device& DeviceEntry(dev_t device);
+
+    // Whether 'waiter' may start: every one of its devices has a free slot
+    // that no better-ranked waiter for the same device is waiting for.
+    // Caller holds m_mutex.
+    bool CanStart(const Waiter& waiter);
+
+    static unsigned int DefaultLimit(DeviceKind kind);
+};
+
+#endif // IOSCHEDULER_H
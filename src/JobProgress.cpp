@@ -0,0 +1,184 @@
+/*
+Author: Guo Jia
+Description: Implementation of JobProgress – atomics for the counters and a
+             mutex only for the status message string.
+Date: 2026-10-18
+*/
+
+#include "JobProgress.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: JobProgress
+Description: Creates an empty, not-yet-started progress record.
+Parameters: None
+Return: None
+*/
+JobProgress::JobProgress()
+    : m_total(0),
+      m_done(0),
+      m_cancelled(false),
+      m_finished(false),
+      m_messageMutex(),
+      m_message("")
+{
+}
+
+/*
+Function: ~JobProgress
+Description: Destructor.  No resources to release.
+Parameters: None
+Return: None
+*/
+JobProgress::~JobProgress()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Counters
+// ---------------------------------------------------------------------------
+
+/*
+Function: SetTotal
+Description: Sets the total amount of work the job expects to do.
+Parameters: total - total work units (usually bytes)
+Return: None
+*/
+void JobProgress::SetTotal(uint64_t total)
+{
+    m_total = total;
+}
+
+/*
+Function: GetTotal
+Description: Returns the total amount of work.
+Parameters: None
+Return: Total work units
+*/
+uint64_t JobProgress::GetTotal() const
+{
+    return m_total;
+}
+
+/*
+Function: Advance
+Description: Records that more work has been completed.  Safe to call from
+             several worker threads at once.
+Parameters: amount - work units just completed
+Return: None
+*/
+void JobProgress::Advance(uint64_t amount)
+{
+    m_done += amount;
+}
+
+/*
+Function: GetDone
+Description: Returns the amount of work completed so far.
+Parameters: None
+Return: Completed work units
+*/
+uint64_t JobProgress::GetDone() const
+{
+    return m_done;
+}
+
+/*
+Function: GetFraction
+Description: Returns done/total clamped to [0, 1].  Returns 0 while the
+             total is unknown so the dialog does not jump to 100 %.
+Parameters: None
+Return: Completed fraction
+*/
+double JobProgress::GetFraction() const
+{
+    uint64_t total = m_total;
+    if (total == 0)
+    {
+        return 0.0;
+    }
+
+    double fraction = static_cast<double>(m_done) / static_cast<double>(total);
+    return fraction > 1.0 ? 1.0 : fraction;
+}
+
+// ---------------------------------------------------------------------------
+// Status message
+// ---------------------------------------------------------------------------
+
+/*
+Function: SetMessage
+Description: Replaces the human-readable status line.
+Parameters: message - new status text
+Return: None
+*/
+void JobProgress::SetMessage(const string& message)
+{
+    lock_guard<mutex> lock(m_messageMutex);
+    m_message = message;
+}
+
+/*
+Function: GetMessage
+Description: Returns a copy of the current status line.
+Parameters: None
+Return: Status text
+*/
+string JobProgress::GetMessage() const
+{
+    lock_guard<mutex> lock(m_messageMutex);
+    return m_message;
+}
+
+// ---------------------------------------------------------------------------
+// Cancellation / completion
+// ---------------------------------------------------------------------------
+
+/*
+Function: Cancel
+Description: Asks the job to stop at its next check.
+Parameters: None
+Return: None
+*/
+void JobProgress::Cancel()
+{
+    m_cancelled = true;
+}
+
+/*
+Function: IsCancelled
+Description: Returns true once Cancel() has been called.
+Parameters: None
+Return: Cancellation flag
+*/
+bool JobProgress::IsCancelled() const
+{
+    return m_cancelled;
+}
+
+/*
+Function: Finish
+Description: Marks the job as returned so the GUI can stop polling.
+Parameters: None
+Return: None
+*/
+void JobProgress::Finish()
+{
+    m_finished = true;
+}
+
+/*
+Function: IsFinished
+Description: Returns true once the worker has called Finish().
+Parameters: None
+Return: Completion flag
+*/
+bool JobProgress::IsFinished() const
+{
+    return m_finished;
+}
@@ -0,0 +1,57 @@
+/*
+Author: Guo Jia
+Description: Declaration of JobProgress – thread-safe progress/cancel state
+             shared between a background job and the GUI thread that shows
+             its progress dialog.
+Date: 2026-10-18
+*/
+
+#ifndef JOBPROGRESS_H
+#define JOBPROGRESS_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+class JobProgress
+{
+public:
+    JobProgress();
+    virtual ~JobProgress();
+
+    // Holds a mutex and atomics, so it is shared by reference only.
+    JobProgress(const JobProgress&) = delete;
+    JobProgress& operator=(const JobProgress&) = delete;
+
+    // Total amount of work (usually bytes) and the amount completed so far.
+    void          SetTotal(std::uint64_t total);
+    std::uint64_t GetTotal() const;
+    void          Advance(std::uint64_t amount);
+    std::uint64_t GetDone() const;
+
+    // Completed fraction in [0, 1]; 0 while the total is still unknown.
+    double GetFraction() const;
+
+    // Short description of what the job is doing right now.
+    void        SetMessage(const std::string& message);
+    std::string GetMessage() const;
+
+    // Cooperative cancellation – the job polls IsCancelled().
+    void Cancel();
+    bool IsCancelled() const;
+
+    // Set by the worker once it has returned.
+    void Finish();
+    bool IsFinished() const;
+
+private:
+    std::atomic<std::uint64_t> m_total;
+    std::atomic<std::uint64_t> m_done;
+    std::atomic<bool>          m_cancelled;
+    std::atomic<bool>          m_finished;
+    mutable std::mutex         m_messageMutex;
+    std::string                m_message;
+};
+
+#endif // JOBPROGRESS_H
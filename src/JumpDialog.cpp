@@ -0,0 +1,178 @@
+/*
+Author: Guo Jia
+Description: Implementation of JumpDialog.  The matcher is built once, with
+             each folder's frecency as its weight, and queried on the GUI
+             thread: a query over the whole history takes well under a
+             millisecond, less than redrawing the list.
+Date: 2026-10-18
+*/
+
+#include <chrono>
+#include <ctime>
+#include <wx/sizer.h>
+#include "JumpDialog.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: JumpDialog
+Description: Indexes the history, lays out the query field, result list
+             and status line, and shows the most frecent folders.
+Parameters: parent  - parent window
+            history - folders to choose from
+Return: None
+*/
+JumpDialog::JumpDialog(wxWindow* parent, const DirectoryHistory& history)
+    : wxDialog(parent, wxID_ANY, "Jump to Folder", wxDefaultPosition, wxSize(640, 420),
+               wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER),
+      m_paths(),
+      m_matcher(),
+      m_matches(),
+      m_chosen(),
+      m_query(nullptr),
+      m_results(nullptr),
+      m_status(nullptr)
+{
+    int64_t now = static_cast<int64_t>(time(nullptr));
+    vector<double> weights;
+    m_paths.reserve(history.GetEntries().size());
+    weights.reserve(history.GetEntries().size());
+    for (const DirectoryHistory::Entry& entry : history.GetEntries())
+    {
+        m_paths.push_back(entry.path);
+        weights.push_back(DirectoryHistory::Frecency(entry, now));
+    }
+    m_matcher.Build(m_paths, weights);
+
+    m_query   = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxDefaultSize, wxTE_PROCESS_ENTER);
+    m_results = new wxListBox(this, wxID_ANY);
+    m_status  = new wxStaticText(this, wxID_ANY, "");
+
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(m_query,   0, wxEXPAND | wxALL, 8);
+    sizer->Add(m_results, 1, wxEXPAND | wxLEFT | wxRIGHT, 8);
+    sizer->Add(m_status,  0, wxEXPAND | wxALL, 8);
+    sizer->Add(CreateButtonSizer(wxOK | wxCANCEL), 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 8);
+    SetSizer(sizer);
+
+    m_query->Bind(wxEVT_TEXT, &JumpDialog::OnQueryChanged, this);
+    m_query->Bind(wxEVT_TEXT_ENTER, &JumpDialog::OnAccept, this);
+    m_query->Bind(wxEVT_KEY_DOWN, &JumpDialog::OnQueryKey, this);
+    m_results->Bind(wxEVT_LISTBOX_DCLICK, &JumpDialog::OnAccept, this);
+    Bind(wxEVT_BUTTON, &JumpDialog::OnAccept, this, wxID_OK);
+
+    UpdateResults();
+    m_query->SetFocus();
+}
+
+/*
+Function: ~JumpDialog
+Description: Destructor.  Child controls are destroyed by wxWidgets.
+Parameters: None
+Return: None
+*/
+JumpDialog::~JumpDialog()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Event handlers
+// ---------------------------------------------------------------------------
+
+/*
+Function: OnQueryChanged
+Description: Re-ranks on every edit of the query.
+Parameters: event - the text event (unused)
+Return: None
+*/
+void JumpDialog::OnQueryChanged(wxCommandEvent& /*event*/)
+{
+    UpdateResults();
+}
+
+/*
+Function: OnQueryKey
+Description: Up / Down / Page Up / Page Down move the selection in the
+             result list while the caret stays in the query.  Other keys
+             go to the text control.
+Parameters: event - the key event
+Return: None
+*/
+void JumpDialog::OnQueryKey(wxKeyEvent& event)
+{
+    int count = static_cast<int>(m_results->GetCount());
+    int step  = 0;
+    switch (event.GetKeyCode())
+    {
+    case WXK_DOWN:     step = 1;   break;
+    case WXK_UP:       step = -1;  break;
+    case WXK_PAGEDOWN: step = 10;  break;
+    case WXK_PAGEUP:   step = -10; break;
+    default:
+        event.Skip();
+        return;
+    }
+    if (count == 0)
+    {
+        return;
+    }
+
+    int selection = m_results->GetSelection() + step;
+    m_results->SetSelection(selection < 0 ? 0 : (selection >= count ? count - 1 : selection));
+}
+
+/*
+Function: OnAccept
+Description: Enter, a double-click or OK: closes with the selected folder.
+             Does nothing while there is no match.
+Parameters: event - the command event (unused)
+Return: None
+*/
+void JumpDialog::OnAccept(wxCommandEvent& /*event*/)
+{
+    int selection = m_results->GetSelection();
+    if (selection < 0 || static_cast<size_t>(selection) >= m_matches.size())
+    {
+        return;
+    }
+    m_chosen = wxString(m_paths[m_matches[selection].index]);
+    EndModal(wxID_OK);
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: UpdateResults
+Description: Queries the matcher, fills the list and reports the match
+             time in the status line.
+Parameters: None
+Return: None
+*/
+void JumpDialog::UpdateResults()
+{
+    auto start = chrono::steady_clock::now();
+    m_matches  = m_matcher.Find(m_query->GetValue().ToStdString(), MAX_SHOWN);
+    long micros = static_cast<long>(chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now() - start).count());
+
+    wxArrayString rows;
+    for (const FuzzyMatcher::Match& match : m_matches)
+    {
+        rows.Add(wxString(m_paths[match.index]));
+    }
+    m_results->Set(rows);
+    if (!m_matches.empty())
+    {
+        m_results->SetSelection(0);
+    }
+
+    m_status->SetLabel(wxString::Format("%lu of %lu folders shown (%ld us)",
+                                        static_cast<unsigned long>(m_matches.size()),
+                                        static_cast<unsigned long>(m_paths.size()), micros));
+}
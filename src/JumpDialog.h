@@ -0,0 +1,52 @@
+/*
+Author: Guo Jia
+Description: Declaration of JumpDialog – the quick-jump popup.  Every
+             keystroke re-ranks the DirectoryHistory with a FuzzyMatcher and
+             lists the best folders; Up and Down move through them without
+             leaving the query, and Enter or a double-click picks one.
+Date: 2026-10-18
+*/
+
+#ifndef JUMPDIALOG_H
+#define JUMPDIALOG_H
+
+#include <string>
+#include <vector>
+#include <wx/dialog.h>
+#include <wx/listbox.h>
+#include <wx/stattext.h>
+#include <wx/textctrl.h>
+#include "DirectoryHistory.h"
+#include "FuzzyMatcher.h"
+
+class JumpDialog : public wxDialog
+{
+public:
+    // The index is built from the history as it is now.
+    JumpDialog(wxWindow* parent, const DirectoryHistory& history);
+    virtual ~JumpDialog();
+
+    // The folder picked, once the dialog returned wxID_OK.
+    wxString GetPath() const { return m_chosen; }
+
+private:
+    static constexpr std::size_t MAX_SHOWN = 50;
+
+    std::vector<std::string>         m_paths;     // history order
+    FuzzyMatcher                     m_matcher;
+    std::vector<FuzzyMatcher::Match> m_matches;   // rows of m_results
+    wxString                         m_chosen;
+
+    wxTextCtrl*   m_query;
+    wxListBox*    m_results;
+    wxStaticText* m_status;
+
+    void OnQueryChanged(wxCommandEvent& event);
+    void OnQueryKey(wxKeyEvent& event);
+    void OnAccept(wxCommandEvent& event);
+
+    // Re-run the query and refill the list, best match selected.
+    void UpdateResults();
+};
+
+#endif // JUMPDIALOG_H
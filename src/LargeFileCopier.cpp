@@ -0,0 +1,452 @@
+/*
+Author: Guo Jia
+Description: Implementation of LargeFileCopier – statvfs/fallocate set-up,
+             an O_DIRECT attempt with a buffered fallback, and a reader
+             thread handing chunks to the writing thread through two
+             aligned buffers.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#include "LargeFileCopier.h"
+
+using namespace std;
+
+namespace
+{
+    // One of the two buffers passed between the reader and the writer.
+    struct Slot
+    {
+        char*   data   = nullptr;
+        ssize_t length = 0;       // bytes read; 0 at the end, -1 on error
+        bool    full   = false;
+        int     error  = 0;
+        bool    cold   = false;   // none of the source pages were cached before
+    };
+
+    // True if no page of [offset, offset + length) of 'fd' is in the page
+    // cache, asked of mincore() through a mapping that is never touched.
+    // 'offset' must be page aligned.  Any failure answers false, so pages
+    // are only ever dropped when they are known to be the copy's own.
+    bool NoneResident(int fd, uint64_t offset, size_t length)
+    {
+        void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(offset));
+        if (mapping == MAP_FAILED)
+        {
+            return false;
+        }
+        size_t                page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        vector<unsigned char> resident((length + page - 1) / page);
+        bool none = ::mincore(mapping, length, resident.data()) == 0 &&
+                    none_of(resident.begin(), resident.end(), [](unsigned char flags) { return (flags & 1) != 0; });
+        ::munmap(mapping, length);
+        return none;
+    }
+
+    string ParentOf(const string& path)
+    {
+        size_t slash = path.find_last_of('/');
+        if (slash == string::npos)
+        {
+            return ".";
+        }
+        return slash == 0 ? string("/") : path.substr(0, slash);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: LargeFileCopier
+Description: Stores the progress callback.
+Parameters: progress - called after each chunk; returns false to cancel
+Return: None
+*/
+LargeFileCopier::LargeFileCopier(const Progress& progress)
+    : m_progress(progress),
+      m_error(),
+      m_directIo(false),
+      m_keepPartial(false)
+{
+}
+
+/*
+Function: ~LargeFileCopier
+Description: Nothing to release; Copy() cleans up after itself.
+Parameters: None
+Return: None
+*/
+LargeFileCopier::~LargeFileCopier()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Copying
+// ---------------------------------------------------------------------------
+
+/*
+Function: Copy
+Description: Opens both files, checks free space, switches both to
+             O_DIRECT where the file systems allow it, and preallocates the
+             destination in one request so it is not fragmented by other
+             writers, then runs the copy loop.
+             O_DIRECT writes whole aligned blocks, so the file is truncated
+             to its real size at the end.  A resumed copy opens the
+             destination as it is and allocates only what is left.
+Parameters: src       - regular file to copy
+            dest      - file to create
+            overwrite - replace an existing destination
+            start     - bytes an earlier copy already wrote, or 0
+Return: true if the file was copied
+*/
+bool LargeFileCopier::Copy(const string& src, const string& dest, bool overwrite, uint64_t start)
+{
+    m_error.clear();
+    m_directIo = false;
+
+    // Chunk boundaries keep O_DIRECT offsets aligned.
+    start -= start % CHUNK;
+
+    int in = ::open(src.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0)
+    {
+        return Fail("Cannot open " + src + ": " + strerror(errno));
+    }
+
+    struct stat info;
+    if (::fstat(in, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        ::close(in);
+        return Fail(src + " is not a regular file");
+    }
+    uint64_t size = static_cast<uint64_t>(info.st_size);
+    if (start > size)
+    {
+        start = 0;
+    }
+
+    uint64_t reclaimed = 0;
+    struct stat existing;
+    if ((overwrite || start > 0) && ::stat(dest.c_str(), &existing) == 0)
+    {
+        reclaimed = static_cast<uint64_t>(existing.st_blocks) * 512;
+    }
+    if (!CheckFreeSpace(dest, size, reclaimed))
+    {
+        ::close(in);
+        return false;
+    }
+
+    int flags = start > 0 ? 0 : (overwrite ? O_TRUNC : O_EXCL);
+    int out   = ::open(dest.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | flags, info.st_mode & 07777);
+    if (out < 0)
+    {
+        int error = errno;
+        ::close(in);
+        return Fail("Cannot create " + dest + ": " + strerror(error));
+    }
+
+    // O_DIRECT is switched on after opening, since file systems without it
+    // refuse it only then; both sides use it or neither does.
+    m_directIo = SetDirectIo(in, true);
+    if (m_directIo && !SetDirectIo(out, true))
+    {
+        SetDirectIo(in, false);
+        m_directIo = false;
+    }
+
+    // Preallocation is only an optimisation; file systems without it
+    // (EOPNOTSUPP) are copied all the same.
+    if (size > start && ::fallocate(out, 0, static_cast<off_t>(start), static_cast<off_t>(size - start)) != 0 &&
+        errno != EOPNOTSUPP && errno != ENOSYS)
+    {
+        int error = errno;
+        ::close(in);
+        ::close(out);
+        if (!m_keepPartial)
+        {
+            ::unlink(dest.c_str());
+        }
+        return Fail("Cannot allocate " + dest + ": " + strerror(error));
+    }
+    if (!m_directIo)
+    {
+        ::posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    bool ok = CopyData(in, out, start, size);
+    if (ok && ::ftruncate(out, static_cast<off_t>(size)) != 0)
+    {
+        ok = Fail("Cannot set the size of " + dest + ": " + strerror(errno));
+    }
+    ::close(in);
+    if (::close(out) != 0 && ok)
+    {
+        ok = Fail("Cannot write " + dest + ": " + strerror(errno));
+    }
+    if (!ok && !m_keepPartial)
+    {
+        ::unlink(dest.c_str());
+    }
+    return ok;
+}
+
+/*
+Function: CheckFreeSpace
+Description: Compares the size with the blocks available to unprivileged
+             users on the destination's file system, so a copy that cannot
+             fit fails at once instead of after hours.
+Parameters: dest      - destination path (need not exist)
+            size      - bytes to be written
+            reclaimed - bytes an overwritten destination gives back
+Return: true if the file fits (or the space cannot be determined)
+*/
+bool LargeFileCopier::CheckFreeSpace(const string& dest, uint64_t size, uint64_t reclaimed)
+{
+    struct statvfs volume;
+    if (::statvfs(ParentOf(dest).c_str(), &volume) != 0)
+    {
+        return true;
+    }
+
+    uint64_t available = static_cast<uint64_t>(volume.f_bavail) * static_cast<uint64_t>(volume.f_frsize);
+    if (size > available + reclaimed)
+    {
+        return Fail("Not enough space for " + dest + ": " + to_string(size) + " bytes needed, " +
+                    to_string(available + reclaimed) + " available");
+    }
+    return true;
+}
+
+/*
+Function: CopyData
+Description: The reader thread reads chunk n+1 into one buffer while this
+             thread writes chunk n from the other.  Without O_DIRECT each
+             written chunk is queued for write-back at once, and the chunk
+             before it is waited for and dropped from the cache, so the
+             copy never holds more than a few chunks of cache.  Source
+             pages are dropped too, but only for chunks of which nothing
+             was cached before the reader got to them: pages someone else
+             was using stay where they were.
+Parameters: in    - source descriptor
+            out   - destination descriptor
+            start - offset to begin at, a multiple of CHUNK
+            size  - source size
+Return: true if all of it was copied
+*/
+bool LargeFileCopier::CopyData(int in, int out, uint64_t start, uint64_t size)
+{
+    Slot slots[2];
+    for (Slot& slot : slots)
+    {
+        void* memory = nullptr;
+        if (::posix_memalign(&memory, ALIGNMENT, CHUNK) != 0)
+        {
+            free(slots[0].data);
+            return Fail("Out of memory");
+        }
+        slot.data = static_cast<char*>(memory);
+    }
+
+    mutex              lock;
+    condition_variable changed;
+    bool               stop = false;
+
+    thread reader([&]()
+    {
+        for (uint64_t offset = start, index = 0;; offset += CHUNK, ++index)
+        {
+            Slot& slot = slots[index % 2];
+            {
+                unique_lock<mutex> guard(lock);
+                changed.wait(guard, [&] { return !slot.full || stop; });
+                if (stop)
+                {
+                    return;
+                }
+            }
+
+            bool cold = !m_directIo && offset < size &&
+                        NoneResident(in, offset, static_cast<size_t>(min<uint64_t>(CHUNK, size - offset)));
+            ssize_t got = 0;
+            int     error = 0;
+            while (static_cast<uint64_t>(got) < CHUNK && offset + static_cast<uint64_t>(got) < size)
+            {
+                ssize_t part = ::pread(in, slot.data + got, CHUNK - static_cast<size_t>(got),
+                                       static_cast<off_t>(offset + static_cast<uint64_t>(got)));
+                if (part < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (part <= 0)
+                {
+                    error = part < 0 ? errno : 0;
+                    break;
+                }
+                got += part;
+            }
+
+            {
+                lock_guard<mutex> guard(lock);
+                slot.length = error != 0 ? -1 : got;
+                slot.error  = error;
+                slot.cold   = cold;
+                slot.full   = true;
+            }
+            changed.notify_all();
+            if (got == 0 || error != 0)
+            {
+                return;
+            }
+        }
+    });
+
+    bool     ok       = true;
+    uint64_t previous = 0;   // offset of the chunk written before this one
+    uint64_t written  = start;
+    for (uint64_t index = 0; ok; ++index)
+    {
+        Slot& slot = slots[index % 2];
+        {
+            unique_lock<mutex> guard(lock);
+            changed.wait(guard, [&] { return slot.full; });
+        }
+        if (slot.length < 0)
+        {
+            ok = Fail(string("Read error: ") + strerror(slot.error));
+            break;
+        }
+        if (slot.length == 0)
+        {
+            break;
+        }
+
+        // O_DIRECT writes whole blocks; the tail is zero-padded and cut off
+        // again by the final ftruncate().
+        size_t length = static_cast<size_t>(slot.length);
+        size_t toWrite = length;
+        if (m_directIo && toWrite % ALIGNMENT != 0)
+        {
+            size_t padded = (toWrite + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+            memset(slot.data + toWrite, 0, padded - toWrite);
+            toWrite = padded;
+        }
+
+        size_t done = 0;
+        while (done < toWrite)
+        {
+            ssize_t part = ::pwrite(out, slot.data + done, toWrite - done,
+                                    static_cast<off_t>(written + done));
+            if (part < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (part <= 0)
+            {
+                ok = Fail(string("Write error: ") + strerror(part < 0 ? errno : EIO));
+                break;
+            }
+            done += static_cast<size_t>(part);
+        }
+
+        if (ok && !m_directIo)
+        {
+            ::sync_file_range(out, static_cast<off_t>(written), static_cast<off_t>(length),
+                              SYNC_FILE_RANGE_WRITE);
+            if (index > 0)
+            {
+                ::sync_file_range(out, static_cast<off_t>(previous), CHUNK,
+                                  SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+                                  SYNC_FILE_RANGE_WAIT_AFTER);
+                ::posix_fadvise(out, static_cast<off_t>(previous), CHUNK, POSIX_FADV_DONTNEED);
+            }
+            if (slot.cold)
+            {
+                ::posix_fadvise(in, static_cast<off_t>(written), static_cast<off_t>(length),
+                                POSIX_FADV_DONTNEED);
+            }
+        }
+        previous = written;
+        written += length;
+
+        {
+            lock_guard<mutex> guard(lock);
+            slot.full = false;
+        }
+        changed.notify_all();
+
+        if (ok && m_progress && !m_progress(length))
+        {
+            ok = Fail("Cancelled");
+        }
+        if (length < CHUNK)
+        {
+            break;
+        }
+    }
+
+    {
+        lock_guard<mutex> guard(lock);
+        stop = true;
+    }
+    changed.notify_all();
+    reader.join();
+
+    if (ok && !m_directIo && written > start)
+    {
+        ::fdatasync(out);
+        ::posix_fadvise(out, 0, 0, POSIX_FADV_DONTNEED);
+    }
+    if (ok && written != size)
+    {
+        ok = Fail("The source changed size during the copy");
+    }
+
+    free(slots[0].data);
+    free(slots[1].data);
+    return ok;
+}
+
+/*
+Function: SetDirectIo
+Description: Turns O_DIRECT on or off for an open descriptor.
+Parameters: fd     - descriptor
+            enable - whether to bypass the page cache
+Return: true if the flag was changed (false: unsupported here)
+*/
+bool LargeFileCopier::SetDirectIo(int fd, bool enable)
+{
+    int flags = ::fcntl(fd, F_GETFL);
+    if (flags < 0)
+    {
+        return false;
+    }
+    flags = enable ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+    return ::fcntl(fd, F_SETFL, flags) == 0;
+}
+
+/*
+Function: Fail
+Description: Records why the copy failed.
+Parameters: message - description of the failure
+Return: false, so callers can return Fail(...)
+*/
+bool LargeFileCopier::Fail(const string& message)
+{
+    m_error = message;
+    return false;
+}
@@ -0,0 +1,78 @@
+/*
+Author: Guo Jia
+Description: Declaration of LargeFileCopier – copies one big regular file
+             without flushing everyone else's data out of the page cache.
+             Free space is checked and the destination preallocated before
+             any data moves; the data then goes through O_DIRECT with
+             aligned buffers, or, where the file system refuses O_DIRECT,
+             through the cache with each chunk written back and dropped
+             right away (source pages only where the copy itself brought
+             them in).  A reader thread fills one buffer while the other
+             is being written.
+Date: 2026-10-18
+*/
+
+#ifndef LARGEFILECOPIER_H
+#define LARGEFILECOPIER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+class LargeFileCopier
+{
+public:
+    // Told about every chunk copied (bytes); returns false to cancel.
+    using Progress = std::function<bool(std::uint64_t bytes)>;
+
+    // Data moves in chunks of this size; a resumed copy starts on a chunk
+    // boundary.
+    static constexpr std::size_t CHUNK = 8 * 1024 * 1024;
+
+    explicit LargeFileCopier(const Progress& progress);
+    virtual ~LargeFileCopier();
+
+    LargeFileCopier(const LargeFileCopier&) = delete;
+    LargeFileCopier& operator=(const LargeFileCopier&) = delete;
+
+    // Copy the regular file 'src' to 'dest' (created with the source's
+    // permission bits; truncated first if 'overwrite', else it must not
+    // exist).  A partly written destination is removed on failure unless
+    // SetKeepPartial().  A non-zero 'start' continues an earlier copy: the
+    // destination is kept and only the data from there on (rounded down
+    // to a chunk) is copied.  Returns false with GetError() saying why.
+    bool Copy(const std::string& src, const std::string& dest, bool overwrite, std::uint64_t start = 0);
+
+    // Leave a partly written destination in place on failure, for a
+    // resumable job to continue later with 'start'.
+    void SetKeepPartial(bool keep) { m_keepPartial = keep; }
+
+    const std::string& GetError() const { return m_error; }
+
+    // Whether the last Copy() bypassed the page cache with O_DIRECT.
+    bool UsedDirectIo() const { return m_directIo; }
+
+private:
+    static constexpr std::size_t ALIGNMENT = 4096;   // O_DIRECT offset/size/address unit
+
+    Progress    m_progress;
+    std::string m_error;
+    bool        m_directIo;
+    bool        m_keepPartial;
+
+    // Enough room on the destination's file system for 'size' bytes, given
+    // 'reclaimed' bytes freed by truncating an existing destination.
+    bool CheckFreeSpace(const std::string& dest, std::uint64_t size, std::uint64_t reclaimed);
+
+    // The double-buffered copy loop over already opened descriptors,
+    // from 'start' to 'size'.
+    bool CopyData(int in, int out, std::uint64_t start, std::uint64_t size);
+
+    // Switch O_DIRECT on or off; false if the file system does not allow it.
+    static bool SetDirectIo(int fd, bool enable);
+
+    bool Fail(const std::string& message);
+};
+
+#endif // LARGEFILECOPIER_H
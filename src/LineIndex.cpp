@@ -0,0 +1,226 @@
+/*
+Author: Guo Jia
+Description: Implementation of LineIndex.  The indexer reads with pread
+             into a fixed buffer rather than through the viewer's mapping,
+             so it neither disturbs the viewer's window nor grows memory.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include "LineIndex.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: LineIndex
+Description: Creates an empty index.
+Parameters: None
+Return: None
+*/
+LineIndex::LineIndex()
+    : m_path(""),
+      m_checkpoints(),
+      m_mutex(),
+      m_newlines(0),
+      m_indexedBytes(0),
+      m_complete(false),
+      m_running(false),
+      m_stop(false),
+      m_thread()
+{
+}
+
+/*
+Function: ~LineIndex
+Description: Stops the background pass.
+Parameters: None
+Return: None
+*/
+LineIndex::~LineIndex()
+{
+    Stop();
+}
+
+// ---------------------------------------------------------------------------
+// Control
+// ---------------------------------------------------------------------------
+
+/*
+Function: Build
+Description: Resets the index for a new file and starts the first pass.
+Parameters: path - file to index
+Return: None
+*/
+void LineIndex::Build(const string& path)
+{
+    Stop();
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_checkpoints.assign(1, 0);   // line 0 starts at offset 0
+    }
+    m_path         = path;
+    m_newlines     = 0;
+    m_indexedBytes = 0;
+    m_complete     = false;
+    Start();
+}
+
+/*
+Function: Extend
+Description: Starts another pass from the end of the previous one.
+Parameters: None
+Return: None
+*/
+void LineIndex::Extend()
+{
+    if (m_path.empty() || m_running)
+    {
+        return;
+    }
+    Stop();   // joins the finished thread
+    m_complete = false;
+    Start();
+}
+
+/*
+Function: Stop
+Description: Asks the pass to stop and waits for it.
+Parameters: None
+Return: None
+*/
+void LineIndex::Stop()
+{
+    m_stop = true;
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+    m_stop = false;
+}
+
+/*
+Function: Start
+Description: Launches Run() on a new thread.
+Parameters: None
+Return: None
+*/
+void LineIndex::Start()
+{
+    m_running = true;
+    m_thread  = thread(&LineIndex::Run, this);
+}
+
+// ---------------------------------------------------------------------------
+// Queries
+// ---------------------------------------------------------------------------
+
+/*
+Function: FindLine
+Description: Maps a line number to the closest checkpoint at or before it.
+Parameters: line             - 0-based line number
+            checkpointOffset - receives the checkpoint's byte offset
+            linesToSkip      - receives line minus the checkpoint's line
+Return: false if the line lies beyond the checkpoints found so far
+*/
+bool LineIndex::FindLine(uint64_t line, uint64_t& checkpointOffset, uint64_t& linesToSkip) const
+{
+    uint64_t checkpoint = line / STRIDE;
+    lock_guard<mutex> lock(m_mutex);
+    if (checkpoint >= m_checkpoints.size())
+    {
+        return false;
+    }
+    checkpointOffset = m_checkpoints[checkpoint];
+    linesToSkip      = line - checkpoint * STRIDE;
+    return true;
+}
+
+/*
+Function: FindOffset
+Description: Maps a byte offset to the closest checkpoint at or before it.
+Parameters: offset           - byte offset
+            checkpointLine   - receives the checkpoint's line number
+            checkpointOffset - receives the checkpoint's byte offset
+Return: false if the offset lies beyond the indexed part of the file
+*/
+bool LineIndex::FindOffset(uint64_t offset, uint64_t& checkpointLine, uint64_t& checkpointOffset) const
+{
+    if (offset > m_indexedBytes)
+    {
+        return false;
+    }
+    lock_guard<mutex> lock(m_mutex);
+    if (m_checkpoints.empty())
+    {
+        return false;
+    }
+    auto after = upper_bound(m_checkpoints.begin(), m_checkpoints.end(), offset);
+    size_t checkpoint = static_cast<size_t>(after - m_checkpoints.begin()) - 1;
+    checkpointLine   = checkpoint * STRIDE;
+    checkpointOffset = m_checkpoints[checkpoint];
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+/*
+Function: Run
+Description: Reads the file sequentially from m_indexedBytes in CHUNK_SIZE
+             pieces, counting newlines with memchr and recording every
+             STRIDE-th line start.  Reaching end of file marks the index
+             complete; a later Extend() picks up any growth.
+Parameters: None
+Return: None
+*/
+void LineIndex::Run()
+{
+    int fd = open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        m_running = false;
+        return;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    vector<char> buffer(CHUNK_SIZE);
+    uint64_t offset   = m_indexedBytes;
+    uint64_t newlines = m_newlines;
+
+    while (!m_stop)
+    {
+        ssize_t got = pread(fd, buffer.data(), buffer.size(), static_cast<off_t>(offset));
+        if (got <= 0)
+        {
+            m_complete = (got == 0);
+            break;
+        }
+
+        const char* begin = buffer.data();
+        const char* end   = begin + got;
+        for (const char* p = begin; (p = static_cast<const char*>(memchr(p, '\n', end - p))) != nullptr; ++p)
+        {
+            ++newlines;
+            if (newlines % STRIDE == 0)
+            {
+                lock_guard<mutex> lock(m_mutex);
+                m_checkpoints.push_back(offset + static_cast<uint64_t>(p - begin) + 1);
+            }
+        }
+
+        offset        += static_cast<uint64_t>(got);
+        m_newlines     = newlines;
+        m_indexedBytes = offset;
+    }
+
+    close(fd);
+    m_running = false;
+}
@@ -0,0 +1,286 @@
+/*
+Author: Guo Jia
+Description: Implementation of ListingCache.  A list holds the slots in
+             recency order and a hash map indexes them by path, so every
+             operation is O(1) under a single mutex.  Reads in progress are
+             kept in a second map; the mutex is never held while reading.
+Date: 2026-10-18
+*/
+
+#include <cerrno>
+#include "ListingCache.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: ListingCache
+Description: Creates an empty cache.
+Parameters: None
+Return: None
+*/
+ListingCache::ListingCache()
+    : m_mutex(),
+      m_slots(),
+      m_index(),
+      m_flights(),
+      m_totalEntries(0),
+      m_stats()
+{
+}
+
+/*
+Function: ~ListingCache
+Description: Destructor.  Listings still referenced elsewhere stay alive
+             through their shared_ptrs.
+Parameters: None
+Return: None
+*/
+ListingCache::~ListingCache()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Access
+// ---------------------------------------------------------------------------
+
+/*
+Function: Get
+Description: Looks a path up, moving a hit to the front of the LRU list.
+Parameters: path - directory path
+Return: The cached listing, or nullptr on a miss
+*/
+shared_ptr<const DirectoryListing> ListingCache::Get(const string& path)
+{
+    lock_guard<mutex> lock(m_mutex);
+    ++m_stats.lookups;
+
+    auto found = m_index.find(Key(path));
+    if (found == m_index.end())
+    {
+        return nullptr;
+    }
+
+    ++m_stats.hits;
+    if (found->second->prefetched)
+    {
+        ++m_stats.prefetchHits;
+        found->second->prefetched = false;   // count each prefetch once
+    }
+    m_slots.splice(m_slots.begin(), m_slots, found->second);
+    return found->second->listing;
+}
+
+/*
+Function: Contains
+Description: Checks for a path without affecting recency or stats.
+Parameters: path - directory path
+Return: true if the path is cached
+*/
+bool ListingCache::Contains(const string& path) const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_index.find(Key(path)) != m_index.end();
+}
+
+/*
+Function: Put
+Description: Stores a listing produced elsewhere (see PutLocked()).
+Parameters: listing    - listing to store (keyed by its own path)
+            prefetched - true when stored by the prefetcher
+Return: None
+*/
+void ListingCache::Put(shared_ptr<const DirectoryListing> listing, bool prefetched)
+{
+    if (!listing || listing->GetPath().empty())
+    {
+        return;
+    }
+    lock_guard<mutex> lock(m_mutex);
+    PutLocked(move(listing), prefetched);
+}
+
+/*
+Function: Load
+Description: The first caller for a folder becomes its reader: it registers
+             a flight, reads without the lock, stores the listing (unless
+             Remove() or a fresh Load() detached the flight meanwhile, in
+             which case the result may predate a change) and wakes the
+             callers that joined.  Those only wait and share the result.
+             A foreground call does not join the prefetcher's flight: that
+             thread reads at idle I/O priority and could keep the user
+             waiting indefinitely under disk load, so it starts its own
+             read, which later callers join instead.
+Parameters: path       - directory path
+            prefetched - true when called by the prefetcher
+            fresh      - do not join a read that is already running
+            error      - receives errno if the folder cannot be read
+Return: The listing, or nullptr on failure
+*/
+shared_ptr<const DirectoryListing> ListingCache::Load(const string& path, bool prefetched, bool fresh, int& error)
+{
+    string             key = Key(path);
+    shared_ptr<Flight> flight;
+    bool               reader = false;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        auto found = m_flights.find(key);
+        if (found != m_flights.end() && !fresh && (prefetched || !found->second->prefetched))
+        {
+            flight = found->second;
+            ++m_stats.sharedLoads;
+        }
+        else
+        {
+            flight             = make_shared<Flight>();
+            flight->result     = flight->done.get_future().share();
+            flight->prefetched = prefetched;
+            m_flights[key]     = flight;   // replaces a detached, older or prefetch flight
+            reader             = true;
+        }
+    }
+
+    if (reader)
+    {
+        shared_ptr<DirectoryListing> listing = make_shared<DirectoryListing>();
+        bool loaded = false;
+        try
+        {
+            loaded = listing->Load(path);
+        }
+        catch (const exception&)
+        {
+            errno = ENOMEM;
+        }
+        flight->error = loaded ? 0 : errno;
+        if (loaded)
+        {
+            flight->listing = listing;
+        }
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            auto found = m_flights.find(key);
+            if (found != m_flights.end() && found->second == flight)
+            {
+                m_flights.erase(found);
+                if (loaded)
+                {
+                    PutLocked(listing, prefetched);
+                }
+            }
+        }
+        flight->done.set_value();
+    }
+
+    flight->result.wait();
+    error = flight->error;
+    return flight->listing;
+}
+
+/*
+Function: Remove
+Description: Drops a path, e.g. after the directory was changed by an
+             operation of ours.  A read of it still running may have seen
+             the folder before the change, so it is detached too.
+Parameters: path - directory path
+Return: None
+*/
+void ListingCache::Remove(const string& path)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_flights.erase(Key(path));
+    auto found = m_index.find(Key(path));
+    if (found != m_index.end())
+    {
+        m_totalEntries -= found->second->listing->GetCount();
+        m_slots.erase(found->second);
+        m_index.erase(found);
+    }
+}
+
+/*
+Function: GetStats
+Description: Returns a copy of the hit/miss counters.
+Parameters: None
+Return: Current statistics
+*/
+ListingCache::Stats ListingCache::GetStats() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_stats;
+}
+
+// ---------------------------------------------------------------------------
+// Internal helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: PutLocked
+Description: Inserts a listing at the front, replacing an older one for the
+             same path, then evicts from the back until within bounds.
+             Caller holds m_mutex.
+Parameters: listing    - listing to store (keyed by its own path)
+            prefetched - true when stored by the prefetcher
+Return: None
+*/
+void ListingCache::PutLocked(shared_ptr<const DirectoryListing> listing, bool prefetched)
+{
+    string key = Key(listing->GetPath());
+    auto found = m_index.find(key);
+    if (found != m_index.end())
+    {
+        m_totalEntries -= found->second->listing->GetCount();
+        m_slots.erase(found->second);
+        m_index.erase(found);
+    }
+
+    m_totalEntries += listing->GetCount();
+    m_slots.push_front(Slot{ key, move(listing), prefetched });
+    m_index[key] = m_slots.begin();
+    if (prefetched)
+    {
+        ++m_stats.prefetched;
+    }
+    EvictLocked();
+}
+
+/*
+Function: EvictLocked
+Description: Removes least recently used slots while either bound is
+             exceeded.  The newest slot is always kept, however large.
+             Caller holds m_mutex.
+Parameters: None
+Return: None
+*/
+void ListingCache::EvictLocked()
+{
+    while (m_slots.size() > 1 &&
+           (m_slots.size() > MAX_FOLDERS || m_totalEntries > MAX_TOTAL_ENTRIES))
+    {
+        Slot& oldest = m_slots.back();
+        m_totalEntries -= oldest.listing->GetCount();
+        m_index.erase(oldest.path);
+        m_slots.pop_back();
+    }
+}
+
+/*
+Function: Key
+Description: Normalises a path by dropping trailing separators (but not
+             the root's).
+Parameters: path - directory path
+Return: Cache key
+*/
+string ListingCache::Key(const string& path)
+{
+    string key = path;
+    while (key.size() > 1 && key.back() == '/')
+    {
+        key.pop_back();
+    }
+    return key;
+}
@@ -0,0 +1,101 @@
+/*
+Author: Guo Jia
+Description: Declaration of ListingCache – a small, thread-safe LRU cache of
+             parsed DirectoryListings keyed by path.  Filled by navigation
+             and by the background prefetcher so opening a folder can render
+             from memory; bounded both in folders and in total entries.
+             Reads go through Load(), which shares a read already running
+             for the same folder, so tabs and panes asking for one folder at
+             once cost a single enumeration.  Foreground reads never wait on
+             the prefetcher's idle-priority ones.
+Date: 2026-10-18
+*/
+
+#ifndef LISTINGCACHE_H
+#define LISTINGCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "DirectoryListing.h"
+
+class ListingCache
+{
+public:
+    struct Stats
+    {
+        std::uint64_t lookups      = 0;
+        std::uint64_t hits         = 0;
+        std::uint64_t prefetched   = 0;   // listings stored by the prefetcher
+        std::uint64_t prefetchHits = 0;   // hits on one of those
+        std::uint64_t sharedLoads  = 0;   // Load() calls served by a read already running
+    };
+
+    ListingCache();
+    virtual ~ListingCache();
+
+    // Cached listing of 'path' (counted as a lookup), or nullptr.
+    std::shared_ptr<const DirectoryListing> Get(const std::string& path);
+
+    // Presence check that does not touch the LRU order or the stats.
+    bool Contains(const std::string& path) const;
+
+    // Store (or replace) the listing for its own path.  'prefetched'
+    // marks entries produced speculatively, for the stats.
+    void Put(std::shared_ptr<const DirectoryListing> listing, bool prefetched);
+
+    // Read 'path' from disk and store the listing; nullptr with 'error'
+    // set to the errno of the failure.  If a read of the same folder is
+    // running, wait for it and share its result instead, unless 'fresh'
+    // asks for a read that starts now (e.g. after the folder was changed)
+    // or the running read is the prefetcher's and this one is not.
+    // Blocks; call from a worker thread.
+    std::shared_ptr<const DirectoryListing> Load(const std::string& path, bool prefetched, bool fresh,
+                                                 int& error);
+
+    // Drop a path, and detach a read of it that is running so its result
+    // is neither stored nor shared with later calls.
+    void  Remove(const std::string& path);
+    Stats GetStats() const;
+
+private:
+    static constexpr std::size_t MAX_FOLDERS       = 64;
+    static constexpr std::size_t MAX_TOTAL_ENTRIES = 500000;
+
+    struct Slot
+    {
+        std::string                             path;
+        std::shared_ptr<const DirectoryListing> listing;
+        bool                                    prefetched;
+    };
+
+    // A read in progress; every Load() of its folder waits on 'result'.
+    struct Flight
+    {
+        std::shared_ptr<const DirectoryListing> listing;   // set by the reader
+        int                                     error = 0;
+        bool                                    prefetched = false;   // read at idle I/O priority
+        std::promise<void>                      done;
+        std::shared_future<void>                result;
+    };
+
+    mutable std::mutex                                          m_mutex;
+    std::list<Slot>                                             m_slots;     // front = most recent
+    std::unordered_map<std::string, std::list<Slot>::iterator> m_index;
+    std::unordered_map<std::string, std::shared_ptr<Flight>>   m_flights;   // reads running, by key
+    std::size_t                                                 m_totalEntries;
+    Stats                                                       m_stats;
+
+    void PutLocked(std::shared_ptr<const DirectoryListing> listing, bool prefetched);
+    void EvictLocked();
+
+    // "/a/b/" and "/a/b" share a slot.
+    static std::string Key(const std::string& path);
+};
+
+#endif // LISTINGCACHE_H
@@ -6,15 +6,120 @@ Description: Defines the main application window.  Wires up the menu bar,
 Date: 2026-01-31
 */
 
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+#include <filesystem>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
 #include <wx/sizer.h>
 #include <wx/msgdlg.h>
 #include <wx/textdlg.h>
 #include <wx/filename.h>
+#include <wx/dirdlg.h>
+#include <wx/filedlg.h>
+#include <wx/choicdlg.h>
+#include <wx/progdlg.h>
+#include <wx/stdpaths.h>
 #include "MainFrame.h"
 #include "FileOperations.h"
+#include "ThreadPool.h"
+#include "JobProgress.h"
+#include "DirectorySync.h"
+#include "DirectoryCompare.h"
+#include "TreeHashCache.h"
+#include "CompareDialog.h"
+#include "DirectoryListing.h"
+#include "PathCompleter.h"
+#include "ListingCache.h"
+#include "DirectoryPrefetcher.h"
+#include "TextPreviewPanel.h"
+#include "HexViewPanel.h"
+#include "ArchiveIndex.h"
+#include "ArchiveRegistry.h"
+#include "TarWriter.h"
+#include "ParallelCompressor.h"
+#include "IoScheduler.h"
+#include "CopyJournal.h"
+#include "BatchRenamer.h"
+#include "BatchRenameDialog.h"
+#include "AttributeChanger.h"
+#include "AttributesDialog.h"
+#include "FileSystemBackend.h"
+#include "DirectoryHistory.h"
+#include "JumpDialog.h"
+#include "FileSplitter.h"
+#include "ThumbnailCache.h"
 #include <wx/app.h>
 #include "FileManagerApp.h"
 
+namespace
+{
+    // Resolution of the progress dialogs and how often RunJob polls the job.
+    const int PROGRESS_RANGE   = 1000;
+    const int PROGRESS_POLL_MS = 50;
+
+    // Last listing shown, restored at the next launch.  Very large folders
+    // are truncated; the background revalidation fills in the rest.
+    const char*        SNAPSHOT_FILE        = "last-listing.snapshot";
+    const std::size_t  SNAPSHOT_MAX_ENTRIES = 20000;
+
+    // The window should be interactive within this long after launch.
+    const long STARTUP_TARGET_MS = 100;
+
+    // Double-clicking a file at least this large opens it in the preview
+    // pane instead of the default application, which would load all of it.
+    const std::uint64_t LARGE_FILE_BYTES = 64ULL * 1024 * 1024;
+
+    // Per-device job and bandwidth limits ("<path> <jobs> <MB/s>" lines),
+    // and how many pastes and deletes may be queued or running at once.
+    const char*        IO_LIMITS_FILE   = "io-limits.conf";
+    const unsigned int FILE_JOB_THREADS = 8;
+
+    // Folder (in the user data directory) where copies and moves keep the
+    // journals they resume from after a crash.
+    const char* JOURNAL_FOLDER = "journals";
+
+    // Folders visited, with their frecency, for Jump to Folder.
+    const char* HISTORY_FILE = "folder-history.txt";
+
+    // Threads for Change Attributes.  Each entry costs a round trip of
+    // metadata calls rather than bandwidth, so more threads than cores
+    // still help, most of all on network file systems.
+    const unsigned int ATTRIBUTE_THREADS = 16;
+
+    // Compression levels used by Compress...: gzip's and zstd's defaults.
+    const int GZIP_LEVEL = 6;
+    const int ZSTD_LEVEL = 3;
+
+    // Whether one of two folders is, or lies inside, the other once links
+    // and "." / ".." are resolved.  Syncing such a pair would copy a tree
+    // into itself or, with deletion on, delete the source's own entries.
+    bool Overlaps(const wxString& first, const wxString& second)
+    {
+        std::error_code ec;
+        std::string a = std::filesystem::weakly_canonical(first.ToStdString(), ec).string();
+        std::string b = std::filesystem::weakly_canonical(second.ToStdString(), ec).string();
+        if (ec || a.empty() || b.empty())
+        {
+            return true;   // cannot tell; assume the worst
+        }
+        auto contains = [](const std::string& outer, const std::string& inner)
+        {
+            return inner == outer ||
+                   (inner.compare(0, outer.size(), outer) == 0 &&
+                    (outer.back() == '/' || inner[outer.size()] == '/'));
+        };
+        return contains(a, b) || contains(b, a);
+    }
+
+    // Parts written or joined at once by Split... and Join..., and the
+    // part size offered: under the 4 GiB file limit of FAT32.
+    const unsigned int SPLIT_THREADS      = 4;
+    const char*        SPLIT_DEFAULT_SIZE = "4095M";
+}
+
 // ---------------------------------------------------------------------------
 // Construction / destruction
 // ---------------------------------------------------------------------------
@@ -23,18 +128,51 @@ Date: 2026-01-31
 Function: MainFrame
 Description: Constructs the main application frame.  Creates the menu bar,
              address bar, file-listing panel, and status bar; binds all
-             events; and loads the user's home directory.
-Parameters: title - title of the window
+             events; and shows the last session's directory from its
+             snapshot.  No directory is read on the GUI thread here.
+Parameters: title        - title of the window
+            launchMillis - time already spent since the application started
 Return: None
 */
-MainFrame::MainFrame(const wxString& title)
+MainFrame::MainFrame(const wxString& title, long launchMillis)
     : wxFrame(nullptr, wxID_ANY, title, wxDefaultPosition, wxSize(800, 600)),
       m_filePanel(nullptr),
       m_addressBar(nullptr),
       m_statusBar(nullptr),
+      m_splitter(nullptr),
+      m_panes(nullptr),
+      m_notebooks{ nullptr, nullptr },
+      m_previewPanel(nullptr),
+      m_hexPanel(nullptr),
+      m_workers(new ThreadPool()),
+      m_treeHashCache(new TreeHashCache(UserDataPath("treehash.cache").ToStdString())),
+      m_pathCompleter(),
+      m_listingCache(new ListingCache()),
+      m_prefetcher(),
+      m_archives(new ArchiveRegistry()),
+      m_ioScheduler(new IoScheduler()),
+      m_fileJobs(new ThreadPool(FILE_JOB_THREADS)),
+      m_history(new DirectoryHistory(UserDataPath(HISTORY_FILE).ToStdString())),
+      m_typeScanner(new FileTypeScanner()),
+      m_thumbCache(new ThumbnailCache()),
+      m_thumbLoader(),
+      m_fileJobsRunning(0),
+      m_hoverRow(-1),
+      m_navigation(0),
+      m_lastNavigation(),
       m_clipboardPath(""),
-      m_clipboardIsCut(false)
+      m_clipboardIsCut(false),
+      m_startupClock(),
+      m_startupMillis(-1)
 {
+    m_startupClock.Start(launchMillis);
+    m_prefetcher.reset(new DirectoryPrefetcher(*m_listingCache));
+    m_thumbLoader.reset(new ThumbnailLoader(*m_thumbCache));
+    m_ioScheduler->LoadLimits(UserDataPath(IO_LIMITS_FILE).ToStdString());
+    FileOperations::SetScheduler(m_ioScheduler.get());
+    FileOperations::SetJournalDirectory(UserDataPath(JOURNAL_FOLDER));
+    m_history->Load();
+
     // --- Menu bar -----------------------------------------------------------
     InitializeMenuBar();
 
@@ -45,11 +183,32 @@ MainFrame::MainFrame(const wxString& title)
         "",
         wxDefaultPosition,
         wxSize(-1, 28),
-        wxTE_PROCESS_ENTER
+        wxTE_PROCESS_ENTER | wxTE_PROCESS_TAB
     );
+    m_pathCompleter.reset(new PathCompleter(m_addressBar, *m_workers));
 
-    // --- File listing panel -------------------------------------------------
-    m_filePanel = new FilePanel(this);
+    // --- Panes of tabbed file panels, and the preview pane ------------------
+    m_splitter = new wxSplitterWindow(this, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                                      wxSP_3D | wxSP_LIVE_UPDATE);
+    m_splitter->SetMinimumPaneSize(120);
+    m_splitter->SetSashGravity(0.5);
+    m_panes = new wxSplitterWindow(m_splitter, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                                   wxSP_3D | wxSP_LIVE_UPDATE);
+    m_panes->SetMinimumPaneSize(120);
+    m_panes->SetSashGravity(0.5);
+    for (int pane = 0; pane < 2; ++pane)
+    {
+        m_notebooks[pane] = new wxNotebook(m_panes, wxID_ANY);
+        m_notebooks[pane]->Bind(wxEVT_NOTEBOOK_PAGE_CHANGED, &MainFrame::OnTabChanged, this);
+    }
+    m_notebooks[1]->Hide();
+    m_panes->Initialize(m_notebooks[0]);
+    m_filePanel    = AddTab(0, "");
+    m_previewPanel = new TextPreviewPanel(m_splitter);
+    m_previewPanel->Hide();
+    m_hexPanel     = new HexViewPanel(m_splitter, *m_workers);
+    m_hexPanel->Hide();
+    m_splitter->Initialize(m_panes);
 
     // --- Status bar ---------------------------------------------------------
     InitializeStatusBar();
@@ -57,12 +216,11 @@ MainFrame::MainFrame(const wxString& title)
     // --- Layout -------------------------------------------------------------
     wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
     sizer->Add(m_addressBar, 0, wxEXPAND | wxALL, 4);
-    sizer->Add(m_filePanel,  1, wxEXPAND | wxALL, 0);
+    sizer->Add(m_splitter,   1, wxEXPAND | wxALL, 0);
     SetSizer(sizer);
 
     // --- Bind events --------------------------------------------------------
     Bind(wxEVT_TEXT_ENTER,          &MainFrame::OnAddressBarEnter, this, m_addressBar->GetId());
-    Bind(wxEVT_LIST_ITEM_ACTIVATED, &MainFrame::OnListDoubleClick, this, m_filePanel->GetListCtrl()->GetId());
 
     Bind(wxEVT_MENU, &MainFrame::OnNewFolder, this, ID_NEW_FOLDER);
     Bind(wxEVT_MENU, &MainFrame::OnRename,    this, ID_RENAME);
@@ -70,7 +228,26 @@ MainFrame::MainFrame(const wxString& title)
     Bind(wxEVT_MENU, &MainFrame::OnCopy,      this, ID_COPY);
     Bind(wxEVT_MENU, &MainFrame::OnCut,       this, ID_CUT);
     Bind(wxEVT_MENU, &MainFrame::OnPaste,     this, ID_PASTE);
+    Bind(wxEVT_MENU, &MainFrame::OnCopyToOtherPane, this, ID_COPY_TO_PANE);
+    Bind(wxEVT_MENU, &MainFrame::OnMoveToOtherPane, this, ID_MOVE_TO_PANE);
     Bind(wxEVT_MENU, &MainFrame::OnRefresh,   this, ID_REFRESH);
+    Bind(wxEVT_MENU, &MainFrame::OnJumpToFolder, this, ID_JUMP);
+    Bind(wxEVT_MENU, &MainFrame::OnSyncTo,    this, ID_SYNC_TO);
+    Bind(wxEVT_MENU, &MainFrame::OnCompareWith, this, ID_COMPARE);
+    Bind(wxEVT_MENU, &MainFrame::OnCompress,  this, ID_COMPRESS);
+    Bind(wxEVT_MENU, &MainFrame::OnSplit,     this, ID_SPLIT);
+    Bind(wxEVT_MENU, &MainFrame::OnJoin,      this, ID_JOIN);
+    Bind(wxEVT_MENU, &MainFrame::OnBatchRename, this, ID_BATCH_RENAME);
+    Bind(wxEVT_MENU, &MainFrame::OnChangeAttributes, this, ID_ATTRIBUTES);
+    Bind(wxEVT_MENU, &MainFrame::OnTogglePreview, this, ID_PREVIEW);
+    Bind(wxEVT_MENU, &MainFrame::OnToggleHexView, this, ID_HEX_VIEW);
+    Bind(wxEVT_MENU, &MainFrame::OnToggleThumbnails, this, ID_THUMBNAILS);
+    Bind(wxEVT_MENU, &MainFrame::OnNewTab,    this, ID_NEW_TAB);
+    Bind(wxEVT_MENU, &MainFrame::OnCloseTab,  this, ID_CLOSE_TAB);
+    Bind(wxEVT_MENU, &MainFrame::OnToggleDualPane, this, ID_DUAL_PANE);
+    Bind(wxEVT_MENU, &MainFrame::OnSwitchPane, this, ID_SWITCH_PANE);
+    Bind(wxEVT_IDLE,         &MainFrame::OnFirstIdle, this);
+    Bind(wxEVT_CLOSE_WINDOW, &MainFrame::OnClose,     this);
     // wxID_EXIT is handled automatically by wxWidgets on macOS (Cmd+Q) and
     // falls back to the Exit menu item on other platforms.
     wxDECLARE_APP(FileManagerApp);
@@ -78,19 +255,28 @@ MainFrame::MainFrame(const wxString& title)
     Bind(wxEVT_MENU, [](wxCommandEvent& /*event*/) { wxGetApp().GetTopWindow()->Close(); }, wxID_EXIT);
 
     // --- Initial directory --------------------------------------------------
-    wxString homeDir = wxGetHomeDir();
-    m_filePanel->LoadDirectory(homeDir);
-    m_addressBar->SetValue(homeDir);
+    RestoreLastListing();
 }
 
 /*
 Function: ~MainFrame
-Description: Destroys the main application frame.
+Description: Destroys the main application frame.  The worker pool is
+             drained first: queued background loads still reference the
+             completer and the frame's controls.  File jobs are allowed to
+             finish before the scheduler they run under goes away.  The
+             controls go before the type scanner and thumbnail loader,
+             which the file panels are registered with.
 Parameters: None
 Return: None
 */
 MainFrame::~MainFrame()
 {
+    m_hexPanel->CloseFile();   // cancel a search so the pool drains quickly
+    m_fileJobs.reset();
+    FileOperations::SetScheduler(nullptr);
+    FileOperations::SetJournalDirectory("");
+    m_workers.reset();
+    DestroyChildren();   // the file panels unregister from the scanner and loader
 }
 
 // ---------------------------------------------------------------------------
@@ -100,7 +286,7 @@ MainFrame::~MainFrame()
 /*
 Function: InitializeMenuBar
 Description: Builds the File menu with all operations and their keyboard
-             shortcuts, then attaches it to the frame.
+             shortcuts, plus the View menu, then attaches them to the frame.
 Parameters: None
 Return: None
 */
@@ -111,18 +297,41 @@ void MainFrame::InitializeMenuBar()
     fileMenu->Append(ID_NEW_FOLDER, "New Folder\tCtrl+Shift+N");
     fileMenu->AppendSeparator();
     fileMenu->Append(ID_RENAME,     "Rename\tF2");
+    fileMenu->Append(ID_BATCH_RENAME, "Batch Rename...\tCtrl+Shift+R");
     fileMenu->Append(ID_DELETE,     "Delete\tDelete");
+    fileMenu->Append(ID_ATTRIBUTES, "Change Attributes...\tCtrl+Shift+M");
     fileMenu->AppendSeparator();
     fileMenu->Append(ID_COPY,       "Copy\tCtrl+C");
     fileMenu->Append(ID_CUT,        "Cut\tCtrl+X");
     fileMenu->Append(ID_PASTE,      "Paste\tCtrl+V");
+    fileMenu->Append(ID_COPY_TO_PANE, "Copy to Other Pane\tShift+F5");
+    fileMenu->Append(ID_MOVE_TO_PANE, "Move to Other Pane\tShift+F6");
     fileMenu->AppendSeparator();
     fileMenu->Append(ID_REFRESH,    "Refresh\tF5");
+    fileMenu->Append(ID_JUMP,       "Jump to Folder...\tCtrl+J");
+    fileMenu->AppendSeparator();
+    fileMenu->Append(ID_SYNC_TO,    "Sync To...\tCtrl+Shift+S");
+    fileMenu->Append(ID_COMPARE,    "Compare With...\tCtrl+Shift+D");
+    fileMenu->Append(ID_COMPRESS,   "Compress...\tCtrl+Shift+A");
+    fileMenu->Append(ID_SPLIT,      "Split...");
+    fileMenu->Append(ID_JOIN,       "Join...");
     fileMenu->AppendSeparator();
     fileMenu->Append(wxID_EXIT,     "Exit\tCtrl+Q");
 
+    wxMenu* viewMenu = new wxMenu();
+    viewMenu->AppendCheckItem(ID_PREVIEW,  "Preview Pane\tF3");
+    viewMenu->AppendCheckItem(ID_HEX_VIEW, "Hex View\tCtrl+H");
+    viewMenu->AppendSeparator();
+    viewMenu->AppendCheckItem(ID_THUMBNAILS, "Thumbnails\tCtrl+T");
+    viewMenu->AppendSeparator();
+    viewMenu->Append(ID_NEW_TAB,             "New Tab\tCtrl+Shift+T");
+    viewMenu->Append(ID_CLOSE_TAB,           "Close Tab\tCtrl+W");
+    viewMenu->AppendCheckItem(ID_DUAL_PANE,  "Dual Pane\tF9");
+    viewMenu->Append(ID_SWITCH_PANE,         "Switch Pane\tF6");
+
     wxMenuBar* menuBar = new wxMenuBar();
     menuBar->Append(fileMenu, "File");
+    menuBar->Append(viewMenu, "View");
     SetMenuBar(menuBar);
 }
 
@@ -161,13 +370,17 @@ void MainFrame::OnAddressBarEnter(wxCommandEvent& /*event*/)
 /*
 Function: OnListDoubleClick
 Description: Called when the user double-clicks a row in the file listing.
-             Directories are navigated into; files are opened with the system
-             default application.
+             Directories and archives are navigated into; files are opened
+             with the system default application, except very large ones,
+             which go to the built-in preview pane.  Files inside an archive
+             are copied out first.
 Parameters: event - the list-item-activated event (unused beyond triggering)
 Return: None
 */
 void MainFrame::OnListDoubleClick(wxListEvent& event)
 {
+    SetActivePanel(PanelOf(event.GetEventObject()));
+
     // Get the index of the row that was double-clicked from the event itself.
     // Don't rely on the selection state, as the item may not be selected yet
     // when the activation event fires.
@@ -178,7 +391,7 @@ void MainFrame::OnListDoubleClick(wxListEvent& event)
     }
 
     // Get the name from that specific row.
-    wxString name = m_filePanel->GetListCtrl()->GetItemText(index);
+    wxString name = m_filePanel->GetNameAt(index);
     if (name.IsEmpty())
     {
         return;
@@ -186,17 +399,95 @@ void MainFrame::OnListDoubleClick(wxListEvent& event)
 
     wxString fullPath = FullPath(name);
     wxFileName fn(fullPath);
+    const DirectoryListing::Entry* entry = m_filePanel->GetEntryAt(index);
+    bool inArchive = m_filePanel->GetListing().IsVirtual();
 
-    if (wxFileName::DirExists(fullPath))
+    if (entry != nullptr && entry->isDirectory)
     {
         NavigateTo(fullPath);
     }
+    else if (inArchive)
+    {
+        OpenArchiveMember(fullPath);
+    }
+    else if (ArchiveIndex::DetectFormat(fullPath.ToStdString()) != ArchiveIndex::FORMAT_NONE)
+    {
+        NavigateTo(fullPath);
+    }
+    else if (entry != nullptr && entry->size >= LARGE_FILE_BYTES)
+    {
+        if (RefuseNonLocal("Preview"))
+        {
+            return;
+        }
+        ShowPreviewPane(true);
+        PreviewFile(fullPath);
+        m_statusBar->SetStatusText("Previewing \"" + name + "\" (" +
+                                   FilePanel::FormatSize(static_cast<wxUIntPtr>(entry->size)) + ")");
+    }
     else
     {
         OpenFile(fullPath);
     }
 }
 
+/*
+Function: OnListSelect
+Description: Selecting a folder row is a strong hint it will be opened
+             next, so it is handed to the prefetcher.  Selecting a file
+             shows it in the preview pane when that is open.  Neither
+             applies inside an archive, or to panels other than the active
+             one (their selection also changes when a listing is merged).
+Parameters: event - the list-item-selected event
+Return: None
+*/
+void MainFrame::OnListSelect(wxListEvent& event)
+{
+    event.Skip();
+    long index = event.GetIndex();
+    if (PanelOf(event.GetEventObject()) != m_filePanel || m_filePanel->GetListing().IsVirtual())
+    {
+        return;
+    }
+    if (m_filePanel->IsDirectoryAt(index))
+    {
+        m_prefetcher->Request(FullPath(m_filePanel->GetNameAt(index)).ToStdString());
+    }
+    else if (m_splitter->IsSplit())
+    {
+        PreviewFile(FullPath(m_filePanel->GetNameAt(index)));
+    }
+}
+
+/*
+Function: OnListHover
+Description: Hovering over a folder row is a weaker hint; it is requested
+             once per row entered, and the prefetcher's debounce ignores
+             rows the pointer only passes over.  Only the active panel's
+             rows count.
+Parameters: event - mouse-motion event on the list control (skipped)
+Return: None
+*/
+void MainFrame::OnListHover(wxMouseEvent& event)
+{
+    event.Skip();
+    if (PanelOf(event.GetEventObject()) != m_filePanel)
+    {
+        return;
+    }
+    int flags = 0;
+    long row = m_filePanel->GetListCtrl()->HitTest(event.GetPosition(), flags);
+    if (row == m_hoverRow)
+    {
+        return;
+    }
+    m_hoverRow = row;
+    if (m_filePanel->IsDirectoryAt(row) && !m_filePanel->GetListing().IsVirtual())
+    {
+        m_prefetcher->Request(FullPath(m_filePanel->GetNameAt(row)).ToStdString());
+    }
+}
+
 /*
 Function: OnNewFolder
 Description: Prompts the user for a directory name, then creates it inside
@@ -207,6 +498,11 @@ Return: None
 */
 void MainFrame::OnNewFolder(wxCommandEvent& /*event*/)
 {
+    if (RefuseInArchive("New Folder"))
+    {
+        return;
+    }
+
     wxString name = wxGetTextFromUser(
         "Enter the name for the new folder:",
         "New Folder",
@@ -230,7 +526,7 @@ void MainFrame::OnNewFolder(wxCommandEvent& /*event*/)
     }
 
     m_statusBar->SetStatusText("Created folder \"" + name + "\"");
-    m_filePanel->LoadDirectory(m_filePanel->CurrentPath());
+    RevalidateAsync(m_filePanel->CurrentPath());
 }
 
 /*
@@ -243,6 +539,11 @@ Return: None
 */
 void MainFrame::OnRename(wxCommandEvent& /*event*/)
 {
+    if (RefuseInArchive("Rename") || RefuseMultipleSelection("Rename"))
+    {
+        return;
+    }
+
     wxString name = m_filePanel->GetSelectedName();
     if (name.IsEmpty())
     {
@@ -274,28 +575,37 @@ void MainFrame::OnRename(wxCommandEvent& /*event*/)
     }
 
     m_statusBar->SetStatusText("Renamed \"" + name + "\" to \"" + newName + "\"");
-    m_filePanel->LoadDirectory(m_filePanel->CurrentPath());
+    RevalidateAsync(m_filePanel->CurrentPath());
 }
 
 /*
 Function: OnDelete
-Description: Asks the user to confirm deletion of the selected item, then
-             deletes it.  Works for both files and directories (recursive).
+Description: Asks the user to confirm deletion of the selected items, then
+             deletes them in the background.  Works for both files and
+             directories (recursive).
 Parameters: event - the menu command event (unused)
 Return: None
 */
 void MainFrame::OnDelete(wxCommandEvent& /*event*/)
 {
-    wxString name = m_filePanel->GetSelectedName();
-    if (name.IsEmpty())
+    if (RefuseInArchive("Delete"))
+    {
+        return;
+    }
+
+    std::vector<wxString> names = m_filePanel->GetSelectedNames();
+    if (names.empty())
     {
         wxMessageBox("Please select a file or folder to delete.",
                      "Nothing Selected", wxOK | wxICON_WARNING, this);
         return;
     }
 
+    wxString what = names.size() == 1 ? "\"" + names.front() + "\""
+                                      : wxString::Format("the %lu selected items",
+                                                         static_cast<unsigned long>(names.size()));
     int answer = wxMessageBox(
-        "Are you sure you want to delete \"" + name + "\"?\n"
+        "Are you sure you want to delete " + what + "?\n"
         "This cannot be undone.",
         "Confirm Delete",
         wxYES_NO | wxNO_DEFAULT | wxICON_WARNING,
@@ -307,17 +617,47 @@ void MainFrame::OnDelete(wxCommandEvent& /*event*/)
         return;
     }
 
-    wxString fullPath = FullPath(name);
-
-    if (!FileOperations::Delete(fullPath))
+    std::vector<wxString> paths;
+    for (const wxString& name : names)
     {
-        wxMessageBox("Failed to delete \"" + name + "\".",
-                     "Error", wxOK | wxICON_ERROR, this);
-        return;
+        paths.push_back(FullPath(name));
     }
+    wxString directory = m_filePanel->CurrentPath();
 
-    m_statusBar->SetStatusText("Deleted \"" + name + "\"");
-    m_filePanel->LoadDirectory(m_filePanel->CurrentPath());
+    std::shared_ptr<std::vector<wxString>> failed = std::make_shared<std::vector<wxString>>();
+    RunFileJob("Deleting " + what,
+               [paths, failed]()
+               {
+                   for (const wxString& path : paths)
+                   {
+                       if (!FileOperations::Delete(path))
+                       {
+                           failed->push_back(wxFileName(path).GetFullName());
+                       }
+                   }
+                   return failed->empty();
+               },
+               [this, what, paths, failed, directory](bool success)
+    {
+        for (const wxString& path : paths)
+        {
+            m_listingCache->Remove(path.ToStdString());
+        }
+        if (!success)
+        {
+            wxString list;
+            for (const wxString& name : *failed)
+            {
+                list += "\n" + name;
+            }
+            wxMessageBox("Failed to delete:" + list, "Error", wxOK | wxICON_ERROR, this);
+        }
+        else
+        {
+            m_statusBar->SetStatusText("Deleted " + what);
+        }
+        RevalidateAsync(directory);
+    });
 }
 
 /*
@@ -329,6 +669,11 @@ Return: None
 */
 void MainFrame::OnCopy(wxCommandEvent& /*event*/)
 {
+    if (RefuseMultipleSelection("Copy"))
+    {
+        return;
+    }
+
     wxString name = m_filePanel->GetSelectedName();
     if (name.IsEmpty())
     {
@@ -351,6 +696,11 @@ Return: None
 */
 void MainFrame::OnCut(wxCommandEvent& /*event*/)
 {
+    if (RefuseInArchive("Cut") || RefuseMultipleSelection("Cut"))
+    {
+        return;
+    }
+
     wxString name = m_filePanel->GetSelectedName();
     if (name.IsEmpty())
     {
@@ -368,8 +718,10 @@ void MainFrame::OnCut(wxCommandEvent& /*event*/)
 Function: OnPaste
 Description: Completes a pending copy or cut by placing the clipboard item
              into the current directory.  If a name collision exists the user
-             is asked whether to overwrite.  Clears the clipboard and updates
-             the status bar when done.
+             is asked whether to overwrite.  A clipboard item inside an
+             archive is copied out of it; other items are copied or moved in
+             the background, so several pastes can run at once.  Clears the
+             clipboard and updates the status bar.
 Parameters: event - the menu command event (unused)
 Return: None
 */
@@ -381,6 +733,10 @@ void MainFrame::OnPaste(wxCommandEvent& /*event*/)
                      "Empty Clipboard", wxOK | wxICON_WARNING, this);
         return;
     }
+    if (RefuseInArchive("Paste"))
+    {
+        return;
+    }
 
     // Derive the destination name from the source path's filename component.
     wxFileName srcFn(m_clipboardPath);
@@ -405,98 +761,1955 @@ void MainFrame::OnPaste(wxCommandEvent& /*event*/)
         overwrite = true;
     }
 
-    bool success = false;
-    if (m_clipboardIsCut)
-    {
-        success = FileOperations::Move(m_clipboardPath, destPath, overwrite);
-    }
-    else
-    {
-        success = FileOperations::Copy(m_clipboardPath, destPath, overwrite);
-    }
+    // A path that does not exist may be a member of an archive.
+    std::string archive;
+    std::string inner;
+    bool fromArchive = !FileOperations::Exists(m_clipboardPath) &&
+                       ArchiveRegistry::SplitPath(m_clipboardPath.ToStdString(), archive, inner);
 
-    if (!success)
+    if (fromArchive)
     {
-        wxMessageBox("Paste failed.",
-                     "Error", wxOK | wxICON_ERROR, this);
+        if (!ExtractFromArchive(m_clipboardPath, destPath))
+        {
+            wxMessageBox("Paste failed.",
+                         "Error", wxOK | wxICON_ERROR, this);
+            return;
+        }
+        m_clipboardPath.Clear();
+        m_statusBar->SetStatusText("Clipboard is now empty");
+        RevalidateAsync(m_filePanel->CurrentPath());
         return;
     }
 
-    // Clear the clipboard and update the UI.
+    // The clipboard is emptied as the job starts, so the same item cannot
+    // be pasted twice while it is still being copied or moved.
+    wxString source    = m_clipboardPath;
+    bool     move      = m_clipboardIsCut;
+    wxString directory = m_filePanel->CurrentPath();
     m_clipboardPath.Clear();
-    m_statusBar->SetStatusText("Clipboard is now empty");
-    m_filePanel->LoadDirectory(m_filePanel->CurrentPath());
+
+    RunFileJob((move ? "Moving \"" : "Copying \"") + destName + "\"",
+               [source, destPath, move, overwrite]()
+               {
+                   return move ? FileOperations::Move(source, destPath, overwrite)
+                               : FileOperations::Copy(source, destPath, overwrite);
+               },
+               [this, source, destName, directory, move](bool success)
+    {
+        m_listingCache->Remove(wxFileName(source).GetPath().ToStdString());
+        if (!success)
+        {
+            wxMessageBox("Paste of \"" + destName + "\" failed.",
+                         "Error", wxOK | wxICON_ERROR, this);
+            return;
+        }
+        m_statusBar->SetStatusText("Pasted \"" + destName + "\"; clipboard is now empty");
+        RevalidateAsync(directory);
+        if (move)
+        {
+            RevalidateAsync(wxFileName(source).GetPath());
+        }
+    });
+}
+
+/*
+Function: OnCopyToOtherPane
+Description: Copies the selection into the other pane's folder.
+Parameters: event - the menu command event (unused)
+Return: None
+*/
+void MainFrame::OnCopyToOtherPane(wxCommandEvent& /*event*/)
+{
+    TransferToOtherPane(false);
+}
+
+/*
+Function: OnMoveToOtherPane
+Description: Moves the selection into the other pane's folder.
+Parameters: event - the menu command event (unused)
+Return: None
+*/
+void MainFrame::OnMoveToOtherPane(wxCommandEvent& /*event*/)
+{
+    TransferToOtherPane(true);
 }
 
 /*
 Function: OnRefresh
 Description: Reloads the current directory listing from disk.  This picks up
-             any changes made outside the application.
+             any changes made outside the application.  Inside an archive the
+             index is rebuilt if the archive file has changed.
 Parameters: event - the menu command event (unused)
 Return: None
 */
 void MainFrame::OnRefresh(wxCommandEvent& /*event*/)
 {
-    m_filePanel->LoadDirectory(m_filePanel->CurrentPath());
+    if (m_filePanel->GetListing().IsVirtual())
+    {
+        NavigateTo(m_filePanel->CurrentPath());
+    }
+    else
+    {
+        RevalidateAsync(m_filePanel->CurrentPath());
+    }
     m_statusBar->SetStatusText("Refreshed");
 }
 
-// ---------------------------------------------------------------------------
-// Private helpers
-// ---------------------------------------------------------------------------
+/*
+Function: OnJumpToFolder
+Description: Opens the quick-jump popup over the folders visited so far and
+             goes to the one picked.
+Parameters: event - the menu command event (unused)
+Return: None
+*/
+void MainFrame::OnJumpToFolder(wxCommandEvent& /*event*/)
+{
+    if (m_history->GetEntries().empty())
+    {
+        m_statusBar->SetStatusText("No folders visited yet");
+        return;
+    }
+
+    JumpDialog dialog(this, *m_history);
+    if (dialog.ShowModal() == wxID_OK)
+    {
+        NavigateTo(dialog.GetPath());
+    }
+}
 
 /*
-Function: NavigateTo
-Description: Attempts to load the given directory into the file panel and
-             sync the address bar.  If the directory cannot be opened an error
-             dialog is shown and the address bar is reverted.
-Parameters: path - the directory path to navigate to
+Function: OnSyncTo
+Description: Mirrors a directory onto another one.  The source is the
+             selected folder, or the current directory when no folder is
+             selected; the destination may neither be it nor contain it or
+             lie inside it.  After the user picks a destination and options, a
+             dry run compares both trees and reports what would be copied,
+             updated and deleted (with byte totals); nothing is changed until
+             the user confirms that report.
+Parameters: event - the menu command event (unused)
 Return: None
 */
-void MainFrame::NavigateTo(const wxString& path)
+void MainFrame::OnSyncTo(wxCommandEvent& /*event*/)
 {
-    if (!m_filePanel->LoadDirectory(path))
+    if (RefuseInArchive("Sync To") || RefuseNonLocal("Sync To") || RefuseMultipleSelection("Sync To"))
+    {
+        return;
+    }
+
+    wxString source   = m_filePanel->CurrentPath();
+    wxString selected = m_filePanel->GetSelectedName();
+    if (!selected.IsEmpty() && wxFileName::DirExists(FullPath(selected)))
+    {
+        source = FullPath(selected);
+    }
+
+    // Not the source's parent: accepting that default would sync into a
+    // folder that contains the source.
+    FilePanel* other = OtherPanel();
+    wxDirDialog dirDialog(this, "Sync \"" + source + "\" to:",
+                          other != nullptr ? other->CurrentPath()
+                                           : wxString(FileSystemBackend::Current().HomePath()));
+    if (dirDialog.ShowModal() != wxID_OK)
+    {
+        return;
+    }
+    wxString destination = dirDialog.GetPath();
+    if (Overlaps(source, destination))
+    {
+        wxMessageBox("The source and the destination must be separate folders;\n"
+                     "neither may be the other or lie inside it.",
+                     "Error", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    wxArrayString choices;
+    choices.Add("Delete files in the destination that are not in the source");
+    choices.Add("Compare file contents by hash (slower, ignores timestamps)");
+    wxArrayInt selections;
+    if (wxGetSelectedChoices(selections, "Sync options:", "Sync To", choices, this) == -1)
+    {
+        return;   // cancelled
+    }
+
+    DirectorySync::Options options;
+    for (size_t i = 0; i < selections.GetCount(); ++i)
+    {
+        if (selections[i] == 0)
+        {
+            options.deleteExtras = true;
+        }
+        else if (selections[i] == 1)
+        {
+            options.compareByHash = true;
+        }
+    }
+
+    DirectorySync sync(source.ToStdString(), destination.ToStdString(), options, *m_workers);
+
+    // --- Dry run ------------------------------------------------------------
+    DirectorySync::Plan plan;
+    JobProgress planProgress;
+    if (!RunJob("Sync - Comparing", planProgress,
+                [&]() { return sync.BuildPlan(plan, planProgress); }))
+    {
+        if (!planProgress.IsCancelled())
+        {
+            wxMessageBox("Could not compare \"" + source + "\" with \"" + destination + "\".",
+                         "Error", wxOK | wxICON_ERROR, this);
+        }
+        return;
+    }
+
+    if (plan.items.empty())
+    {
+        m_statusBar->SetStatusText("\"" + destination + "\" is already in sync");
+        return;
+    }
+
+    wxString report = wxString::Format(
+        "Dry run: \"%s\" -> \"%s\"\n\n"
+        "New files:\t\t%lu (%s)\n"
+        "Changed files:\t%lu (%s, %lu by delta transfer)\n"
+        "New folders:\t\t%lu\n"
+        "To delete:\t\t%lu (%s)\n"
+        "Unchanged files:\t%lu\n\n"
+        "Proceed with the sync?",
+        source, destination,
+        static_cast<unsigned long>(plan.newFiles),
+        FilePanel::FormatSize(static_cast<wxUIntPtr>(plan.newBytes)),
+        static_cast<unsigned long>(plan.changedFiles),
+        FilePanel::FormatSize(static_cast<wxUIntPtr>(plan.changedBytes)),
+        static_cast<unsigned long>(plan.deltaFiles),
+        static_cast<unsigned long>(plan.createdDirectories),
+        static_cast<unsigned long>(plan.deletedEntries),
+        FilePanel::FormatSize(static_cast<wxUIntPtr>(plan.deletedBytes)),
+        static_cast<unsigned long>(plan.unchangedFiles));
+
+    if (wxMessageBox(report, "Sync To", wxYES_NO | wxNO_DEFAULT | wxICON_QUESTION, this) != wxYES)
+    {
+        return;
+    }
+
+    // --- Real run -----------------------------------------------------------
+    JobProgress runProgress;
+    std::string error;
+    bool success = RunJob("Sync - Copying", runProgress,
+                          [&]() { return sync.Execute(plan, runProgress, error); });
+
+    if (!success)
     {
-        wxMessageBox("Could not open directory:\n" + path,
+        wxMessageBox("Sync did not complete:\n" + wxString(error.empty() ? "Cancelled" : error),
                      "Error", wxOK | wxICON_ERROR, this);
     }
-    m_addressBar->SetValue(m_filePanel->CurrentPath());
+    else
+    {
+        wxString status = "Synced to \"" + destination + "\" (" +
+                          FilePanel::FormatSize(static_cast<wxUIntPtr>(sync.GetBytesCopied())) + " copied";
+        if (sync.GetBytesReused() > 0)
+        {
+            status += ", " + FilePanel::FormatSize(static_cast<wxUIntPtr>(sync.GetBytesReused())) +
+                      " reused from existing files";
+        }
+        m_statusBar->SetStatusText(status + ")");
+    }
+    RevalidateAsync(m_filePanel->CurrentPath());
 }
 
 /*
-Function: OpenFile
-Description: Opens a file using the operating system's default application
-             for its type.  Shows an error dialog on failure.
-Parameters: path - full path of the file to open
+Function: OnCompareWith
+Description: Compares the selected folder (or the current directory) with
+             another folder and shows the added, removed and changed entries
+             in a side-by-side dialog.  Content hashes are cached across
+             sessions, so re-comparing large, mostly-unchanged trees only
+             reads the files that changed.
+Parameters: event - the menu command event (unused)
 Return: None
 */
-void MainFrame::OpenFile(const wxString& path)
+void MainFrame::OnCompareWith(wxCommandEvent& /*event*/)
 {
-    if (!FileOperations::Open(path))
+    if (RefuseInArchive("Compare With") || RefuseNonLocal("Compare With") ||
+        RefuseMultipleSelection("Compare With"))
     {
-        wxMessageBox("Could not open file:\n" + path,
-                     "Error", wxOK | wxICON_ERROR, this);
+        return;
     }
-    m_statusBar->SetStatusText("Opened \"" + wxFileName(path).GetFullName() + "\"");
+
+    wxString left     = m_filePanel->CurrentPath();
+    wxString selected = m_filePanel->GetSelectedName();
+    if (!selected.IsEmpty() && wxFileName::DirExists(FullPath(selected)))
+    {
+        left = FullPath(selected);
+    }
+
+    wxDirDialog dirDialog(this, "Compare \"" + left + "\" with:", m_filePanel->CurrentPath());
+    if (dirDialog.ShowModal() != wxID_OK)
+    {
+        return;
+    }
+    wxString right = dirDialog.GetPath();
+
+    DirectoryCompare compare(left.ToStdString(), right.ToStdString(), *m_treeHashCache, *m_workers);
+    JobProgress progress;
+    if (!RunJob("Compare Folders", progress, [&]() { return compare.Run(progress); }))
+    {
+        if (!progress.IsCancelled())
+        {
+            wxMessageBox("Could not compare \"" + left + "\" with \"" + right + "\".",
+                         "Error", wxOK | wxICON_ERROR, this);
+        }
+        return;
+    }
+
+    const std::vector<DirectoryCompare::Difference>& differences = compare.GetDifferences();
+    size_t added   = 0;
+    size_t removed = 0;
+    for (const DirectoryCompare::Difference& difference : differences)
+    {
+        if (difference.change == DirectoryCompare::Change::Added)
+        {
+            ++added;
+        }
+        else if (difference.change == DirectoryCompare::Change::Removed)
+        {
+            ++removed;
+        }
+    }
+
+    wxString summary = wxString::Format(
+        "%lu added, %lu removed, %lu changed.  Read %lu file(s) (%s); %lu hash(es) reused from cache.",
+        static_cast<unsigned long>(added),
+        static_cast<unsigned long>(removed),
+        static_cast<unsigned long>(differences.size() - added - removed),
+        static_cast<unsigned long>(compare.GetFilesHashed()),
+        FilePanel::FormatSize(static_cast<wxUIntPtr>(compare.GetBytesHashed())),
+        static_cast<unsigned long>(compare.GetHashesReused()));
+
+    if (differences.empty())
+    {
+        m_statusBar->SetStatusText("Folders are identical.  " + summary);
+        return;
+    }
+
+    CompareDialog dialog(this, left, right, differences, summary);
+    dialog.ShowModal();
 }
 
 /*
-Function: FullPath
-Description: Joins the current directory path with a filename to produce a
-             complete filesystem path.
-Parameters: name - filename or folder name to append
-Return: Full path string
+Function: OnCompress
+Description: Writes the selected entries (folders with everything under
+             them) into a new .tar.gz or .tar.zst archive.  The tar stream is
+             produced on the job thread and cut into blocks that the thread
+             pool compresses in parallel, so the job runs at the speed of
+             the disk or of all cores together, not of one core.
+Parameters: event - the menu command event (unused)
+Return: None
 */
-wxString MainFrame::FullPath(const wxString& name) const
+void MainFrame::OnCompress(wxCommandEvent& /*event*/)
 {
-    wxString currentPath = m_filePanel->CurrentPath();
-    
-    // Manually join the current directory with the name.
-    // Ensure there's exactly one separator between them.
-    if (!currentPath.EndsWith(wxFileName::GetPathSeparator()))
+    std::vector<wxString> names = m_filePanel->GetSelectedNames();
+    if (names.empty())
+    {
+        wxMessageBox("Select the files and folders to compress first.",
+                     "Nothing Selected", wxOK | wxICON_WARNING, this);
+        return;
+    }
+    if (RefuseInArchive("Compress") || RefuseNonLocal("Compress"))
+    {
+        return;
+    }
+
+    bool     haveZstd = ParallelCompressor::IsAvailable(ParallelCompressor::METHOD_ZSTD);
+    wxString wildcard = "gzip-compressed tar (*.tar.gz)|*.tar.gz";
+    if (haveZstd)
     {
-        currentPath += wxFileName::GetPathSeparator();
+        wildcard += "|zstd-compressed tar (*.tar.zst)|*.tar.zst";
     }
-    
-    return currentPath + name;
-}
\ No newline at end of file
+    wxString baseName = names.size() == 1 ? names.front()
+                                          : wxFileName(m_filePanel->CurrentPath()).GetFullName();
+    if (baseName.IsEmpty())
+    {
+        baseName = "archive";
+    }
+
+    wxFileDialog fileDialog(this, "Compress to:", m_filePanel->CurrentPath(), baseName + ".tar.gz",
+                            wildcard, wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (fileDialog.ShowModal() != wxID_OK)
+    {
+        return;
+    }
+    wxString target = fileDialog.GetPath();
+
+    // The extension typed wins over the filter picked.
+    ParallelCompressor::Method method = ParallelCompressor::METHOD_GZIP;
+    if (haveZstd && (target.EndsWith(".zst") || (fileDialog.GetFilterIndex() == 1 &&
+                                                 !target.EndsWith(".gz") && !target.EndsWith(".tgz"))))
+    {
+        method = ParallelCompressor::METHOD_ZSTD;
+    }
+
+    for (const wxString& name : names)
+    {
+        if (target == FullPath(name) || target.StartsWith(FullPath(name) + wxFileName::GetPathSeparator()))
+        {
+            wxMessageBox("The archive cannot be written inside what is being compressed.",
+                         "Error", wxOK | wxICON_ERROR, this);
+            return;
+        }
+    }
+
+    std::string targetPath = target.ToStdString();
+    int out = ::open(targetPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0)
+    {
+        wxMessageBox("Could not create \"" + target + "\".", "Error", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    ParallelCompressor compressor(out, method,
+                                  method == ParallelCompressor::METHOD_ZSTD ? ZSTD_LEVEL : GZIP_LEVEL,
+                                  *m_workers);
+    TarWriter writer([&compressor](const char* data, std::size_t length)
+                     { return compressor.Write(data, length); });
+
+    JobProgress progress;
+    wxStopWatch watch;
+    bool success = RunJob("Compressing", progress, [&]()
+    {
+        progress.SetMessage("Counting...");
+        std::uint64_t total = 0;
+        for (const wxString& name : names)
+        {
+            total += TarWriter::TotalSize(FullPath(name).ToStdString());
+        }
+        progress.SetTotal(total);
+
+        for (const wxString& name : names)
+        {
+            if (!writer.Add(FullPath(name).ToStdString(), name.ToStdString(), progress))
+            {
+                return false;
+            }
+        }
+        return writer.Finish() && compressor.Finish();
+    });
+    long millis = watch.Time();
+
+    bool closed = ::close(out) == 0;
+    if (!success || !closed)
+    {
+        ::unlink(targetPath.c_str());
+        if (!progress.IsCancelled())
+        {
+            wxString reason = writer.GetError().empty() ? wxString("Could not write the archive.")
+                                                        : wxString::FromUTF8(writer.GetError());
+            wxMessageBox("Compressing failed:\n" + reason, "Error", wxOK | wxICON_ERROR, this);
+        }
+        else
+        {
+            m_statusBar->SetStatusText("Compressing cancelled");
+        }
+        return;
+    }
+
+    double seconds = std::max(millis, 1L) / 1000.0;
+    m_statusBar->SetStatusText(wxString::Format(
+        "Compressed %s into %s (%.0f%%) in %.1f s, %s/s on %u thread(s)",
+        FilePanel::FormatSize(static_cast<wxUIntPtr>(compressor.GetBytesIn())),
+        FilePanel::FormatSize(static_cast<wxUIntPtr>(compressor.GetBytesOut())),
+        compressor.GetBytesIn() == 0 ? 100.0
+                                     : 100.0 * compressor.GetBytesOut() / compressor.GetBytesIn(),
+        seconds,
+        FilePanel::FormatSize(static_cast<wxUIntPtr>(compressor.GetBytesIn() / seconds)),
+        m_workers->GetThreadCount()));
+
+    RevalidateAsync(wxFileName(target).GetPath());
+}
+
+/*
+Function: OnSplit
+Description: Cuts the selected file into parts of a size the user picks,
+             with a manifest of their hashes, in a folder the user picks.
+             The parts are written in parallel by a dedicated pool, under
+             the I/O slots of both the file and the target folder.
+Parameters: event - the menu command event (unused)
+Return: None
+*/
+void MainFrame::OnSplit(wxCommandEvent& /*event*/)
+{
+    if (RefuseInArchive("Split") || RefuseNonLocal("Split") || RefuseMultipleSelection("Split"))
+    {
+        return;
+    }
+
+    wxString name = m_filePanel->GetSelectedName();
+    if (name.IsEmpty() || wxFileName::DirExists(FullPath(name)))
+    {
+        wxMessageBox("Please select the file to split.", "Nothing Selected", wxOK | wxICON_WARNING, this);
+        return;
+    }
+
+    wxString sizeText = wxGetTextFromUser("Size of each part (e.g. 700M, 4095M, 1.5G):", "Split",
+                                          SPLIT_DEFAULT_SIZE, this);
+    if (sizeText.IsEmpty())
+    {
+        return;
+    }
+    std::uint64_t partSize = 0;
+    if (!FileSplitter::ParseSize(sizeText.ToStdString(), partSize))
+    {
+        wxMessageBox("\"" + sizeText + "\" is not a size.", "Error", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    wxDirDialog dirDialog(this, "Write the parts of \"" + name + "\" to:", m_filePanel->CurrentPath());
+    if (dirDialog.ShowModal() != wxID_OK)
+    {
+        return;
+    }
+    wxString directory = dirDialog.GetPath();
+    wxString manifest  = directory + wxFileName::GetPathSeparator() +
+                         wxString(FileSplitter::ManifestName(name.ToStdString()));
+    bool overwrite = wxFileName::FileExists(manifest);
+    if (overwrite && wxMessageBox("\"" + manifest + "\" already exists.  Replace it and its parts?",
+                                  "Split", wxYES_NO | wxICON_QUESTION, this) != wxYES)
+    {
+        return;
+    }
+
+    std::string  source = FullPath(name).ToStdString();
+    std::string  folder = directory.ToStdString();
+    ThreadPool   pool(SPLIT_THREADS);
+    FileSplitter splitter(pool);
+    JobProgress  progress;
+    wxStopWatch  watch;
+    bool success = RunJob("Splitting", progress, [&]()
+    {
+        return m_ioScheduler->Run({ source, folder }, IoScheduler::PRIORITY_NORMAL, [&]()
+        {
+            return splitter.Split(source, folder, partSize, overwrite, progress);
+        });
+    });
+
+    if (!success)
+    {
+        if (progress.IsCancelled())
+        {
+            m_statusBar->SetStatusText("Splitting cancelled");
+        }
+        else
+        {
+            wxMessageBox("Splitting failed:\n" + wxString::FromUTF8(splitter.GetError()),
+                         "Error", wxOK | wxICON_ERROR, this);
+        }
+        return;
+    }
+
+    std::uint64_t total = progress.GetTotal();
+    m_statusBar->SetStatusText(wxString::Format("Split %s into %lu part(s) in %.1f s",
+        FilePanel::FormatSize(static_cast<wxUIntPtr>(total)),
+        static_cast<unsigned long>(total == 0 ? 0 : (total + partSize - 1) / partSize),
+        watch.Time() / 1000.0));
+    RevalidateAsync(directory);
+}
+
+/*
+Function: OnJoin
+Description: Puts the file described by the selected manifest back
+             together in a folder the user picks.  Every part is checked
+             against its hash first; damaged or missing parts are listed,
+             and once they are fetched again, joining once more copies only
+             those.
+Parameters: event - the menu command event (unused)
+Return: None
+*/
+void MainFrame::OnJoin(wxCommandEvent& /*event*/)
+{
+    if (RefuseInArchive("Join") || RefuseNonLocal("Join") || RefuseMultipleSelection("Join"))
+    {
+        return;
+    }
+
+    wxString name = m_filePanel->GetSelectedName();
+    FileSplitter::Manifest manifest;
+    std::string error;
+    if (name.IsEmpty() || !FileSplitter::ReadManifest(FullPath(name).ToStdString(), manifest, error))
+    {
+        wxMessageBox("Please select the .manifest file written by Split.",
+                     "Nothing Selected", wxOK | wxICON_WARNING, this);
+        return;
+    }
+
+    wxDirDialog dirDialog(this, "Join \"" + wxString(manifest.name) + "\" in:", m_filePanel->CurrentPath());
+    if (dirDialog.ShowModal() != wxID_OK)
+    {
+        return;
+    }
+    wxString directory   = dirDialog.GetPath();
+    wxString destination = directory + wxFileName::GetPathSeparator() + wxString(manifest.name);
+    bool overwrite = wxFileName::Exists(destination);
+    if (overwrite && wxMessageBox("\"" + destination + "\" already exists.  Replace it?",
+                                  "Join", wxYES_NO | wxICON_QUESTION, this) != wxYES)
+    {
+        return;
+    }
+
+    std::string  manifestPath = FullPath(name).ToStdString();
+    std::string  target       = destination.ToStdString();
+    ThreadPool   pool(SPLIT_THREADS);
+    FileSplitter splitter(pool);
+    JobProgress  progress;
+    wxStopWatch  watch;
+    bool success = RunJob("Joining", progress, [&]()
+    {
+        return m_ioScheduler->Run({ manifestPath, target }, IoScheduler::PRIORITY_NORMAL, [&]()
+        {
+            return splitter.Join(manifestPath, target, overwrite, progress);
+        });
+    });
+
+    if (!success)
+    {
+        if (progress.IsCancelled())
+        {
+            m_statusBar->SetStatusText("Joining cancelled; joining again continues where it stopped");
+        }
+        else if (!splitter.GetBadParts().empty())
+        {
+            wxString parts;
+            for (const std::string& part : splitter.GetBadParts())
+            {
+                parts += wxString(part) + "\n";
+            }
+            wxMessageBox("These parts are missing or do not match the manifest:\n" + parts +
+                         "\nFetch them again and join once more; the parts already joined are kept.",
+                         "Join", wxOK | wxICON_WARNING, this);
+        }
+        else
+        {
+            wxMessageBox("Joining failed:\n" + wxString::FromUTF8(splitter.GetError()),
+                         "Error", wxOK | wxICON_ERROR, this);
+        }
+    }
+    else
+    {
+        m_statusBar->SetStatusText(wxString::Format("Joined %s from %lu part(s) in %.1f s",
+            FilePanel::FormatSize(static_cast<wxUIntPtr>(manifest.size)),
+            static_cast<unsigned long>(manifest.parts.size()),
+            watch.Time() / 1000.0));
+    }
+    RevalidateAsync(directory);
+}
+
+/*
+Function: OnBatchRename
+Description: Renames the selection by rules set up in BatchRenameDialog.
+             The renames run as one job under the folder's I/O slot; if one
+             fails or the job is cancelled, the names changed so far are
+             restored.
+Parameters: event - the menu command event (unused)
+Return: None
+*/
+void MainFrame::OnBatchRename(wxCommandEvent& /*event*/)
+{
+    if (RefuseInArchive("Batch Rename") || RefuseNonLocal("Batch Rename"))
+    {
+        return;
+    }
+
+    std::vector<wxString> names = m_filePanel->GetSelectedNames();
+    if (names.empty())
+    {
+        wxMessageBox("Please select the files and folders to rename.",
+                     "Nothing Selected", wxOK | wxICON_WARNING, this);
+        return;
+    }
+
+    wxString directory = m_filePanel->CurrentPath();
+    BatchRenameDialog dialog(this, directory, names);
+    if (dialog.ShowModal() != wxID_OK)
+    {
+        return;
+    }
+
+    const BatchRenamer::Plan& plan = dialog.GetPlan();
+    std::string folder = directory.ToStdString();
+    JobProgress progress;
+    std::string error;
+    bool success = RunJob("Batch Rename", progress, [&]()
+    {
+        return m_ioScheduler->Run({ folder }, IoScheduler::PRIORITY_HIGH, [&]()
+        {
+            return BatchRenamer::Execute(folder, plan, progress, error);
+        });
+    });
+
+    if (!success)
+    {
+        wxMessageBox("Batch rename did not complete; the original names were restored.\n" +
+                     wxString::FromUTF8(error),
+                     "Error", wxOK | wxICON_ERROR, this);
+    }
+    else
+    {
+        m_statusBar->SetStatusText(wxString::Format("Renamed %lu item(s)",
+                                                    static_cast<unsigned long>(plan.renamed)));
+    }
+    RevalidateAsync(directory);
+}
+
+/*
+Function: OnChangeAttributes
+Description: Sets the mode, owner, group or times of the selection (and,
+             if asked, of everything in the selected folders) as entered in
+             AttributesDialog.  The trees are walked by a dedicated pool and
+             the job runs under the folder's I/O slot; entries that cannot
+             be changed are reported at the end.
+Parameters: event - the menu command event (unused)
+Return: None
+*/
+void MainFrame::OnChangeAttributes(wxCommandEvent& /*event*/)
+{
+    if (RefuseInArchive("Change Attributes") || RefuseNonLocal("Change Attributes"))
+    {
+        return;
+    }
+
+    std::vector<wxString> names = m_filePanel->GetSelectedNames();
+    if (names.empty())
+    {
+        wxMessageBox("Please select the files and folders to change.",
+                     "Nothing Selected", wxOK | wxICON_WARNING, this);
+        return;
+    }
+
+    AttributesDialog dialog(this, names.size());
+    if (dialog.ShowModal() != wxID_OK)
+    {
+        return;
+    }
+
+    std::vector<std::string> paths;
+    paths.reserve(names.size());
+    for (const wxString& name : names)
+    {
+        paths.push_back(FullPath(name).ToStdString());
+    }
+
+    const AttributeChanger& changer = dialog.GetChanger();
+    AttributeChanger::Result result;
+    JobProgress progress;
+    bool finished = RunJob("Change Attributes", progress, [&]()
+    {
+        return m_ioScheduler->Run(paths, IoScheduler::PRIORITY_NORMAL, [&]()
+        {
+            ThreadPool pool(ATTRIBUTE_THREADS);
+            return changer.Apply(pool, paths, progress, result);
+        });
+    });
+
+    wxString summary = wxString::Format("Changed %lu item(s), %lu already as asked",
+                                        static_cast<unsigned long>(result.changed),
+                                        static_cast<unsigned long>(result.unchanged));
+    if (result.failed > 0)
+    {
+        wxString details;
+        for (const std::string& error : result.errors)
+        {
+            details += wxString::FromUTF8(error) + "\n";
+        }
+        wxMessageBox(wxString::Format("%lu item(s) could not be changed:\n",
+                                      static_cast<unsigned long>(result.failed)) + details,
+                     "Change Attributes", wxOK | wxICON_ERROR, this);
+    }
+    m_statusBar->SetStatusText(finished ? summary : summary + " (cancelled)");
+    RevalidateAsync(m_filePanel->CurrentPath());
+}
+
+/*
+Function: OnTogglePreview
+Description: View > Preview Pane.  Opening the pane previews the selected
+             file, if any.
+Parameters: event - the menu command event (carries the check state)
+Return: None
+*/
+void MainFrame::OnTogglePreview(wxCommandEvent& event)
+{
+    ShowPreviewPane(event.IsChecked());
+    wxString selected = m_filePanel->GetSelectedName();
+    if (event.IsChecked() && !selected.IsEmpty() && !wxFileName::DirExists(FullPath(selected)) &&
+        !m_filePanel->GetListing().IsVirtual())
+    {
+        PreviewFile(FullPath(selected));
+    }
+}
+
+/*
+Function: OnToggleHexView
+Description: View > Hex View.  Switches the preview pane between the text
+             and the hex viewer; if the pane is open the other viewer takes
+             its place and shows the same file.
+Parameters: event - the menu command event (carries the check state)
+Return: None
+*/
+void MainFrame::OnToggleHexView(wxCommandEvent& event)
+{
+    bool      hex      = event.IsChecked();
+    wxWindow* previous = hex ? static_cast<wxWindow*>(m_previewPanel) : static_cast<wxWindow*>(m_hexPanel);
+    wxString  path     = hex ? m_previewPanel->GetPath() : m_hexPanel->GetPath();
+    if (!m_splitter->IsSplit())
+    {
+        return;
+    }
+
+    m_previewPanel->CloseFile();
+    m_hexPanel->CloseFile();
+    PreviewWindow()->Show();
+    m_splitter->ReplaceWindow(previous, PreviewWindow());
+    previous->Hide();
+    if (!path.IsEmpty())
+    {
+        PreviewFile(path);
+    }
+}
+
+/*
+Function: OnToggleThumbnails
+Description: View > Thumbnails.  Shows image previews in the file list.
+Parameters: event - the menu command event (carries the check state)
+Return: None
+*/
+void MainFrame::OnToggleThumbnails(wxCommandEvent& event)
+{
+    m_filePanel->SetThumbnailView(event.IsChecked());
+}
+
+/*
+Function: OnNewTab
+Description: View > New Tab.  Opens the active panel's folder in a new tab
+             of the same pane.
+Parameters: event - the menu command event (unused)
+Return: None
+*/
+void MainFrame::OnNewTab(wxCommandEvent& /*event*/)
+{
+    int pane = m_filePanel->GetParent() == m_notebooks[1] ? 1 : 0;
+    SetActivePanel(AddTab(pane, m_filePanel->CurrentPath()));
+}
+
+/*
+Function: OnCloseTab
+Description: View > Close Tab.  Closes the active tab; the tab next to it
+             becomes active.  The last tab of a pane stays open.
+Parameters: event - the menu command event (unused)
+Return: None
+*/
+void MainFrame::OnCloseTab(wxCommandEvent& /*event*/)
+{
+    wxNotebook* notebook = static_cast<wxNotebook*>(m_filePanel->GetParent());
+    if (notebook->GetPageCount() < 2)
+    {
+        m_statusBar->SetStatusText("The last tab of a pane cannot be closed");
+        return;
+    }
+
+    FilePanel* closing = m_filePanel;
+    m_lastNavigation.erase(closing);
+    m_filePanel = nullptr;   // SetActivePanel() below must not skip the survivor
+    notebook->DeletePage(notebook->FindPage(closing));
+    SetActivePanel(static_cast<FilePanel*>(notebook->GetCurrentPage()));
+}
+
+/*
+Function: OnToggleDualPane
+Description: View > Dual Pane.  Shows the right pane beside the left one,
+             opening the active folder in it the first time, or hides it
+             again (its tabs are kept for next time).
+Parameters: event - the menu command event (carries the check state)
+Return: None
+*/
+void MainFrame::OnToggleDualPane(wxCommandEvent& event)
+{
+    if (event.IsChecked() && !m_panes->IsSplit())
+    {
+        m_notebooks[1]->Show();
+        m_panes->SplitVertically(m_notebooks[0], m_notebooks[1]);
+        if (m_notebooks[1]->GetPageCount() == 0)
+        {
+            AddTab(1, m_filePanel->CurrentPath());
+        }
+    }
+    else if (!event.IsChecked() && m_panes->IsSplit())
+    {
+        m_panes->Unsplit(m_notebooks[1]);
+        SetActivePanel(static_cast<FilePanel*>(m_notebooks[0]->GetCurrentPage()));
+    }
+}
+
+/*
+Function: OnSwitchPane
+Description: View > Switch Pane.  Moves the focus to the other pane.
+Parameters: event - the menu command event (unused)
+Return: None
+*/
+void MainFrame::OnSwitchPane(wxCommandEvent& /*event*/)
+{
+    FilePanel* other = OtherPanel();
+    if (other != nullptr)
+    {
+        SetActivePanel(other);
+        other->GetListCtrl()->SetFocus();
+    }
+}
+
+/*
+Function: OnTabChanged
+Description: A tab picked in either pane becomes the active panel.
+Parameters: event - the notebook page-changed event (skipped)
+Return: None
+*/
+void MainFrame::OnTabChanged(wxBookCtrlEvent& event)
+{
+    event.Skip();
+    wxNotebook* notebook = static_cast<wxNotebook*>(event.GetEventObject());
+    if (event.GetSelection() >= 0)
+    {
+        SetActivePanel(static_cast<FilePanel*>(notebook->GetPage(event.GetSelection())));
+    }
+}
+
+/*
+Function: OnPanelFocus
+Description: Clicking into a panel's list makes that panel active.
+Parameters: event - the focus event on a list control (skipped)
+Return: None
+*/
+void MainFrame::OnPanelFocus(wxFocusEvent& event)
+{
+    event.Skip();
+    SetActivePanel(PanelOf(event.GetEventObject()));
+}
+
+/*
+Function: OnFirstIdle
+Description: The first idle event after the window is shown marks the point
+             where it is interactive.  Records and reports the startup time,
+             unbinds itself, then offers to resume interrupted copies.
+Parameters: event - the idle event (skipped so others still see it)
+Return: None
+*/
+void MainFrame::OnFirstIdle(wxIdleEvent& event)
+{
+    event.Skip();
+    Unbind(wxEVT_IDLE, &MainFrame::OnFirstIdle, this);
+
+    m_startupMillis = m_startupClock.Time();
+    wxString message = wxString::Format("Ready in %ld ms", m_startupMillis);
+    if (m_startupMillis > STARTUP_TARGET_MS)
+    {
+        message += wxString::Format(" (target %ld ms)", STARTUP_TARGET_MS);
+    }
+    m_statusBar->SetStatusText(message);
+
+    ResumeInterruptedJobs();
+}
+
+/*
+Function: ResumeInterruptedJobs
+Description: Asks about each copy or move whose journal was left behind by
+             a crash or a failure.  A resumed job runs again as a file job
+             and skips what its journal says is done; a declined one has its
+             journal deleted, leaving the partly copied files in place.
+Parameters: None
+Return: None
+*/
+void MainFrame::ResumeInterruptedJobs()
+{
+    for (const CopyJournal::Job& job : CopyJournal::FindInterrupted(UserDataPath(JOURNAL_FOLDER).ToStdString()))
+    {
+        wxString source      = wxString::FromUTF8(job.source);
+        wxString destination = wxString::FromUTF8(job.destination);
+        int answer = wxMessageBox(
+            wxString(job.move ? "Moving" : "Copying") + " \"" + source + "\"\nto \"" + destination +
+            "\"\ndid not finish.  Resume it?",
+            "Resume?",
+            wxYES_NO | wxICON_QUESTION,
+            this
+        );
+        if (answer != wxYES)
+        {
+            CopyJournal::Discard(job.journal);
+            continue;
+        }
+
+        wxString name      = wxFileName(destination).GetFullName();
+        bool     move      = job.move;
+        bool     overwrite = job.overwrite;
+        RunFileJob((move ? "Resuming move of \"" : "Resuming copy of \"") + name + "\"",
+                   [source, destination, move, overwrite]()
+                   {
+                       return move ? FileOperations::Move(source, destination, overwrite)
+                                   : FileOperations::Copy(source, destination, overwrite);
+                   },
+                   [this, name, destination](bool success)
+        {
+            if (!success)
+            {
+                wxMessageBox("Resuming \"" + name + "\" failed.",
+                             "Error", wxOK | wxICON_ERROR, this);
+                return;
+            }
+            m_statusBar->SetStatusText("Finished \"" + name + "\"");
+            wxString directory = wxFileName(destination).GetPath();
+            RevalidateAsync(directory);
+        });
+    }
+}
+
+/*
+Function: OnClose
+Description: Saves the listing on screen as the snapshot for the next
+             launch, and the folder history, then lets the window close
+             normally.  A folder inside
+             an archive is not saved; it could not be revalidated.  While
+             pastes or deletes are running the user is asked first, since
+             closing waits for them.
+Parameters: event - the close event (skipped)
+Return: None
+*/
+void MainFrame::OnClose(wxCloseEvent& event)
+{
+    if (m_fileJobsRunning > 0 && event.CanVeto())
+    {
+        int answer = wxMessageBox(
+            wxString::Format("%d file operation(s) are still running.\n"
+                             "Quit when they have finished?", m_fileJobsRunning),
+            "Operations Running", wxYES_NO | wxNO_DEFAULT | wxICON_QUESTION, this);
+        if (answer != wxYES)
+        {
+            event.Veto();
+            return;
+        }
+    }
+
+    const DirectoryListing& listing = m_filePanel->GetListing();
+    if (!listing.GetPath().empty() && !listing.IsVirtual())
+    {
+        listing.SaveSnapshot(UserDataPath(SNAPSHOT_FILE).ToStdString(), SNAPSHOT_MAX_ENTRIES);
+    }
+    m_history->Save();
+    event.Skip();
+}
+
+// ---------------------------------------------------------------------------
+// Private helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: NavigateTo
+Description: Navigates the active panel; see the overload below.
+Parameters: path - the directory path to navigate to
+Return: None
+*/
+void MainFrame::NavigateTo(const wxString& path)
+{
+    NavigateTo(m_filePanel, path);
+}
+
+/*
+Function: NavigateTo
+Description: Attempts to load the given directory into a file panel and,
+             for the active panel, sync the address bar.  A listing already
+             in the cache (visited recently, prefetched, or open in another
+             tab) is shown at once and revalidated in the background;
+             otherwise the directory is read on the worker pool through the
+             cache, so a slow or hung file system never blocks the window
+             and a read of it already running for another panel is shared.
+             The result is shown when it arrives unless the panel has been
+             navigated again, or closed, meanwhile.  If the directory cannot
+             be opened an error dialog is shown and the address bar is
+             reverted.  Paths into an archive show the archive's folder
+             instead.  Folders opened on the local file system count as a
+             visit in the folder history, under the path the panel shows
+             (normalised by the history); one that no longer exists is
+             dropped from it.
+Parameters: panel - the panel to show the directory in
+            path  - the directory path to navigate to
+Return: None
+*/
+void MainFrame::NavigateTo(FilePanel* panel, const wxString& path)
+{
+    std::string   target     = path.ToStdString();
+    unsigned long request    = ++m_navigation;
+    unsigned long generation = panel->GetGeneration();
+    m_lastNavigation[panel]  = request;
+
+    std::shared_ptr<const DirectoryListing> cached = m_listingCache->Get(target);
+    if (cached)
+    {
+        ShowListingIn(panel, *cached);
+        RevalidateAsync(path);
+        if (!cached->IsVirtual() && FileSystemBackend::Current().IsLocal())
+        {
+            m_history->Record(panel->CurrentPath().ToStdString(), static_cast<std::int64_t>(time(nullptr)));
+        }
+        m_pathCompleter->AddListing(*cached);
+        if (panel != m_filePanel)
+        {
+            return;
+        }
+
+        ListingCache::Stats stats = m_listingCache->GetStats();
+        m_statusBar->SetStatusText(wxString::Format(
+            "Opened from cache (hit rate %.0f%%, %lu of %lu prefetches used)",
+            100.0 * static_cast<double>(stats.hits) / static_cast<double>(stats.lookups),
+            static_cast<unsigned long>(stats.prefetchHits),
+            static_cast<unsigned long>(stats.prefetched)));
+        m_addressBar->ChangeValue(panel->CurrentPath());
+        return;
+    }
+
+    if (panel == m_filePanel)
+    {
+        m_statusBar->SetStatusText("Opening \"" + path + "\"...");
+    }
+    bool local = FileSystemBackend::Current().IsLocal();
+    m_workers->Submit([this, panel, request, generation, target, local]()
+    {
+        int error = 0;
+        std::shared_ptr<const DirectoryListing> listing = m_listingCache->Load(target, false, false, error);
+        std::string archive;
+        std::string inner;
+        bool loaded    = listing != nullptr;
+        bool inArchive = !loaded && local && ArchiveRegistry::SplitPath(target, archive, inner);
+
+        CallAfter([this, panel, request, generation, target, listing, loaded, error, local, inArchive,
+                   archive, inner]()
+        {
+            if (!loaded && !inArchive && local && (error == ENOENT || error == ENOTDIR))
+            {
+                m_history->Remove(target);
+            }
+            if (loaded)
+            {
+                m_pathCompleter->AddListing(*listing);
+            }
+
+            // A closed panel has no entry; its pointer is not touched.
+            auto latest = m_lastNavigation.find(panel);
+            if (latest == m_lastNavigation.end() || latest->second != request ||
+                panel->GetGeneration() != generation)
+            {
+                return;   // the user has gone elsewhere since
+            }
+
+            bool active = panel == m_filePanel;
+            if (inArchive)
+            {
+                ShowArchiveFolder(panel, archive, inner);
+            }
+            else if (!loaded)
+            {
+                wxMessageBox("Could not open directory:\n" + wxString(target),
+                             "Error", wxOK | wxICON_ERROR, this);
+                if (active)
+                {
+                    m_statusBar->SetStatusText("");
+                }
+            }
+            else
+            {
+                ShowListingIn(panel, *listing);
+                if (local)
+                {
+                    m_history->Record(panel->CurrentPath().ToStdString(), static_cast<std::int64_t>(time(nullptr)));
+                }
+                if (active)
+                {
+                    m_statusBar->SetStatusText(wxString::Format("%lu item(s)",
+                                                                static_cast<unsigned long>(listing->GetCount())));
+                }
+            }
+            if (active)
+            {
+                m_addressBar->ChangeValue(panel->CurrentPath());
+            }
+        });
+    });
+}
+
+/*
+Function: RestoreLastListing
+Description: Startup path.  The snapshot is one small sequential read, so
+             the window appears with the previous session's rows already in
+             place; the real directory is then read on a worker thread and
+             diffed in by RevalidateAsync().  Without a snapshot the list
+             starts empty and the home directory is loaded in the
+             background.
+Parameters: None
+Return: None
+*/
+void MainFrame::RestoreLastListing()
+{
+    DirectoryListing snapshot;
+    if (!snapshot.LoadSnapshot(UserDataPath(SNAPSHOT_FILE).ToStdString()))
+    {
+        NavigateTo(FileSystemBackend::Current().HomePath());
+        return;
+    }
+
+    ShowListingIn(m_filePanel, snapshot);
+    m_pathCompleter->AddListing(snapshot);
+    m_addressBar->ChangeValue(m_filePanel->CurrentPath());
+    RevalidateAsync(m_filePanel->CurrentPath());
+}
+
+/*
+Function: RevalidateAsync
+Description: Notes every panel showing 'path' (on disk, not inside an
+             archive) with its generation, loads the directory once on the
+             worker pool and hands the result back to the GUI thread with
+             CallAfter().  The read starts fresh rather than joining one
+             already running, which may predate the change being picked
+             up.  Each panel still showing the same generation gets the
+             result merged in; if the directory no longer exists, those
+             panels fall back to the home directory.
+Parameters: path - directory to load
+Return: None
+*/
+void MainFrame::RevalidateAsync(const wxString& path)
+{
+    std::vector<std::pair<FilePanel*, unsigned long>> panels;
+    for (FilePanel* panel : GetPanels())
+    {
+        if (panel->CurrentPath() == path && !panel->GetListing().IsVirtual())
+        {
+            panels.push_back(std::make_pair(panel, panel->GetGeneration()));
+        }
+    }
+    if (panels.empty())
+    {
+        return;
+    }
+    std::string target = path.ToStdString();
+
+    m_workers->Submit([this, panels, target]()
+    {
+        int error = 0;
+        std::shared_ptr<const DirectoryListing> listing = m_listingCache->Load(target, false, true, error);
+
+        CallAfter([this, panels, target, listing]()
+        {
+            if (listing)
+            {
+                m_pathCompleter->AddListing(*listing);
+            }
+
+            wxString homeDir = FileSystemBackend::Current().HomePath();
+            for (const std::pair<FilePanel*, unsigned long>& shown : panels)
+            {
+                FilePanel* panel = shown.first;
+                if (!HasPanel(panel) || panel->GetGeneration() != shown.second)
+                {
+                    continue;   // closed, or navigated since; this result is stale for it
+                }
+
+                if (!listing)
+                {
+                    if (target != homeDir.ToStdString())
+                    {
+                        NavigateTo(panel, homeDir);
+                    }
+                    continue;
+                }
+
+                size_t changes = panel->MergeListing(*listing);
+                if (panel == m_filePanel && changes > 0 && m_startupMillis >= 0)
+                {
+                    m_statusBar->SetStatusText(wxString::Format(
+                        "Ready in %ld ms; %lu change(s) since last session",
+                        m_startupMillis, static_cast<unsigned long>(changes)));
+                }
+            }
+        });
+    });
+}
+
+// ---------------------------------------------------------------------------
+// Tabs and panes
+// ---------------------------------------------------------------------------
+
+/*
+Function: AddTab
+Description: Creates a file panel as a new, selected tab of a pane, routes
+             its list events to the frame (bound on the control, so they
+             go away with it), and opens 'path' in it.  Most
+             new tabs open a folder another panel shows, which the shared
+             listing cache serves without reading the disk.
+Parameters: pane - 0 for the left pane, 1 for the right one
+            path - folder to open, or "" to leave the panel empty
+Return: The new panel
+*/
+FilePanel* MainFrame::AddTab(int pane, const wxString& path)
+{
+    FilePanel* panel = new FilePanel(m_notebooks[pane], *m_typeScanner, *m_thumbLoader);
+    wxWindow*  list  = panel->GetListCtrl();
+    list->Bind(wxEVT_LIST_ITEM_ACTIVATED, &MainFrame::OnListDoubleClick, this);
+    list->Bind(wxEVT_LIST_ITEM_SELECTED,  &MainFrame::OnListSelect,      this);
+    list->Bind(wxEVT_MOTION,    &MainFrame::OnListHover,  this);
+    list->Bind(wxEVT_SET_FOCUS, &MainFrame::OnPanelFocus, this);
+
+    m_notebooks[pane]->AddPage(panel, path.IsEmpty() ? wxString("New Tab") : path.AfterLast('/'), true);
+    if (!path.IsEmpty())
+    {
+        NavigateTo(panel, path);
+    }
+    return panel;
+}
+
+/*
+Function: GetPanels
+Description: Every file panel, left pane first, in tab order.  Panels of a
+             hidden right pane are included; they stay open.
+Parameters: None
+Return: The panels
+*/
+std::vector<FilePanel*> MainFrame::GetPanels() const
+{
+    std::vector<FilePanel*> panels;
+    for (wxNotebook* notebook : m_notebooks)
+    {
+        for (size_t page = 0; page < notebook->GetPageCount(); ++page)
+        {
+            panels.push_back(static_cast<FilePanel*>(notebook->GetPage(page)));
+        }
+    }
+    return panels;
+}
+
+/*
+Function: HasPanel
+Description: Whether 'panel' is still open.  Results of background work
+             check this before touching a panel they captured.
+Parameters: panel - the panel, possibly closed
+Return: true if it is a tab of either pane
+*/
+bool MainFrame::HasPanel(const FilePanel* panel) const
+{
+    std::vector<FilePanel*> panels = GetPanels();
+    return std::find(panels.begin(), panels.end(), panel) != panels.end();
+}
+
+/*
+Function: PanelOf
+Description: The panel owning a list control, e.g. an event's source.
+Parameters: listCtrl - the list control
+Return: The panel, or nullptr
+*/
+FilePanel* MainFrame::PanelOf(const wxObject* listCtrl) const
+{
+    for (FilePanel* panel : GetPanels())
+    {
+        if (panel->GetListCtrl() == listCtrl)
+        {
+            return panel;
+        }
+    }
+    return nullptr;
+}
+
+/*
+Function: OtherPanel
+Description: The current tab of the pane the active panel is not in.
+Parameters: None
+Return: That panel, or nullptr in single-pane mode
+*/
+FilePanel* MainFrame::OtherPanel() const
+{
+    if (!m_panes->IsSplit())
+    {
+        return nullptr;
+    }
+    wxNotebook* other = m_filePanel->GetParent() == m_notebooks[0] ? m_notebooks[1] : m_notebooks[0];
+    return static_cast<FilePanel*>(other->GetCurrentPage());
+}
+
+/*
+Function: SetActivePanel
+Description: Makes 'panel' the one commands act on: the address bar and the
+             Thumbnails check follow it.
+Parameters: panel - the panel (ignored if nullptr or already active)
+Return: None
+*/
+void MainFrame::SetActivePanel(FilePanel* panel)
+{
+    if (panel == nullptr || panel == m_filePanel)
+    {
+        return;
+    }
+    m_filePanel = panel;
+    m_hoverRow  = -1;
+    m_addressBar->ChangeValue(panel->CurrentPath());
+    GetMenuBar()->Check(ID_THUMBNAILS, panel->IsThumbnailView());
+}
+
+/*
+Function: ShowListingIn
+Description: Shows a listing in a panel and names its tab after the folder.
+Parameters: panel   - the panel
+            listing - what to show
+Return: None
+*/
+void MainFrame::ShowListingIn(FilePanel* panel, const DirectoryListing& listing)
+{
+    panel->ShowListing(listing);
+
+    wxString path  = panel->CurrentPath();
+    wxString label = path.AfterLast('/');
+    wxNotebook* notebook = static_cast<wxNotebook*>(panel->GetParent());
+    notebook->SetPageText(notebook->FindPage(panel), label.IsEmpty() ? path : label);
+}
+
+/*
+Function: TransferToOtherPane
+Description: Copies or moves the selected entries into the folder the
+             other pane shows.  Existing names are overwritten or skipped,
+             as the user chooses once for all of them.  The entries go
+             through FileOperations as a single file job, like a paste, so
+             the I/O scheduler and the copy journal apply; when it finishes
+             every panel showing either folder is revalidated.
+Parameters: move - move instead of copy
+Return: None
+*/
+void MainFrame::TransferToOtherPane(bool move)
+{
+    wxString action = move ? "Move to Other Pane" : "Copy to Other Pane";
+    FilePanel* other = OtherPanel();
+    if (other == nullptr)
+    {
+        wxMessageBox("Turn on View > Dual Pane to open a second pane first.",
+                     action, wxOK | wxICON_WARNING, this);
+        return;
+    }
+    if (RefuseInArchive(action))
+    {
+        return;
+    }
+    if (other->GetListing().IsVirtual() || other->CurrentPath().IsEmpty())
+    {
+        wxMessageBox("The other pane does not show a folder that can be written to.",
+                     action, wxOK | wxICON_WARNING, this);
+        return;
+    }
+
+    std::vector<wxString> names = m_filePanel->GetSelectedNames();
+    if (names.empty())
+    {
+        wxMessageBox("Please select the files and folders to " + wxString(move ? "move." : "copy."),
+                     "Nothing Selected", wxOK | wxICON_WARNING, this);
+        return;
+    }
+
+    wxString sourceDir = m_filePanel->CurrentPath();
+    wxString targetDir = other->CurrentPath();
+    if (targetDir == sourceDir)
+    {
+        wxMessageBox("Both panes show the same folder.", "Error", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    std::vector<std::pair<wxString, wxString>> items;   // source, destination
+    size_t existing = 0;
+    for (const wxString& name : names)
+    {
+        wxString source      = FullPath(name);
+        wxString destination = JoinPath(targetDir, name);
+        if (targetDir == source || targetDir.StartsWith(source + wxFileName::GetPathSeparator()))
+        {
+            wxMessageBox("\"" + name + "\" cannot be put inside itself.", "Error", wxOK | wxICON_ERROR, this);
+            return;
+        }
+        existing += FileOperations::Exists(destination) ? 1 : 0;
+        items.push_back(std::make_pair(source, destination));
+    }
+
+    bool overwrite = false;
+    if (existing > 0)
+    {
+        int answer = wxMessageBox(
+            wxString::Format("%lu of the selected item(s) already exist in \"%s\".\n"
+                             "Overwrite them?  (No skips them.)",
+                             static_cast<unsigned long>(existing), targetDir),
+            "Overwrite?",
+            wxYES_NO | wxCANCEL | wxNO_DEFAULT | wxICON_WARNING,
+            this
+        );
+        if (answer == wxCANCEL)
+        {
+            return;
+        }
+        overwrite = answer == wxYES;
+    }
+
+    std::shared_ptr<std::vector<wxString>> failed = std::make_shared<std::vector<wxString>>();
+    std::shared_ptr<size_t>                done   = std::make_shared<size_t>(0);
+    RunFileJob(wxString::Format("%s %lu item(s) to \"%s\"", move ? "Moving" : "Copying",
+                                static_cast<unsigned long>(items.size()), targetDir),
+               [items, move, overwrite, failed, done]()
+               {
+                   for (const std::pair<wxString, wxString>& item : items)
+                   {
+                       if (!overwrite && FileOperations::Exists(item.second))
+                       {
+                           continue;
+                       }
+                       bool ok = move ? FileOperations::Move(item.first, item.second, overwrite)
+                                      : FileOperations::Copy(item.first, item.second, overwrite);
+                       if (ok)
+                       {
+                           ++*done;
+                       }
+                       else
+                       {
+                           failed->push_back(wxFileName(item.first).GetFullName());
+                       }
+                   }
+                   return failed->empty();
+               },
+               [this, sourceDir, targetDir, move, failed, done](bool success)
+    {
+        if (move)
+        {
+            m_listingCache->Remove(sourceDir.ToStdString());
+        }
+        m_listingCache->Remove(targetDir.ToStdString());
+        if (!success)
+        {
+            wxString names;
+            for (const wxString& name : *failed)
+            {
+                names += "\n" + name;
+            }
+            wxMessageBox(wxString(move ? "Could not move:" : "Could not copy:") + names,
+                         "Error", wxOK | wxICON_ERROR, this);
+        }
+        m_statusBar->SetStatusText(wxString::Format("%s %lu item(s) to \"%s\"", move ? "Moved" : "Copied",
+                                                    static_cast<unsigned long>(*done), targetDir));
+        RevalidateAsync(targetDir);
+        if (move)
+        {
+            RevalidateAsync(sourceDir);
+        }
+    });
+}
+
+/*
+Function: OpenFile
+Description: Opens a file using the operating system's default application
+             for its type.  Shows an error dialog on failure.
+Parameters: path - full path of the file to open
+Return: None
+*/
+void MainFrame::OpenFile(const wxString& path)
+{
+    if (!FileOperations::Open(path))
+    {
+        wxMessageBox("Could not open file:\n" + path,
+                     "Error", wxOK | wxICON_ERROR, this);
+    }
+    m_statusBar->SetStatusText("Opened \"" + wxFileName(path).GetFullName() + "\"");
+}
+
+/*
+Function: IndexArchive
+Description: Indexes are kept per archive for as long as its mtime and
+             size are unchanged, so going back into an archive, or up and
+             down its folders, reads nothing.
+Parameters: archive - archive file
+Return: The index, or nullptr
+*/
+std::shared_ptr<const ArchiveIndex> MainFrame::IndexArchive(const std::string& archive)
+{
+    std::shared_ptr<const ArchiveIndex> cached = m_archives->Get(archive);
+    if (cached)
+    {
+        return cached;
+    }
+
+    std::shared_ptr<ArchiveIndex> index = std::make_shared<ArchiveIndex>();
+    JobProgress progress;
+    if (!RunJob("Reading Archive", progress, [&]() { return index->Build(archive, progress); }))
+    {
+        if (!progress.IsCancelled())
+        {
+            wxMessageBox("Could not read archive:\n" + wxString(archive),
+                         "Error", wxOK | wxICON_ERROR, this);
+        }
+        return nullptr;
+    }
+    m_archives->Put(index);
+    return index;
+}
+
+/*
+Function: ShowArchiveFolder
+Description: Lists a folder of an archive in a file panel.  The listing
+             is virtual: it has no directory on disk behind it, so it is
+             neither cached nor revalidated like real ones.
+Parameters: panel   - the panel to show it in
+            archive - archive file
+            inner   - folder inside it, "" for the top level
+Return: None
+*/
+void MainFrame::ShowArchiveFolder(FilePanel* panel, const std::string& archive, const std::string& inner)
+{
+    std::shared_ptr<const ArchiveIndex> index = IndexArchive(archive);
+    if (!index)
+    {
+        return;
+    }
+
+    DirectoryListing listing;
+    if (!index->List(inner, listing))
+    {
+        wxMessageBox("There is no folder \"" + wxString(inner) + "\" in\n" + wxString(archive),
+                     "Error", wxOK | wxICON_ERROR, this);
+        return;
+    }
+    ShowListingIn(panel, listing);
+    m_statusBar->SetStatusText(wxString::Format(
+        "Archive \"%s\": %lu member(s), read-only",
+        wxFileName(wxString(archive)).GetFullName(),
+        static_cast<unsigned long>(index->GetMemberCount())));
+}
+
+/*
+Function: ExtractFromArchive
+Description: Copies one member (with everything under it, for a folder)
+             out of its archive behind a progress dialog.  Only that
+             member's data is read.
+Parameters: source      - virtual path of the member
+            destination - path to create
+Return: true if the member was copied
+*/
+bool MainFrame::ExtractFromArchive(const wxString& source, const wxString& destination)
+{
+    std::string archive;
+    std::string inner;
+    if (!ArchiveRegistry::SplitPath(source.ToStdString(), archive, inner))
+    {
+        return false;
+    }
+    std::shared_ptr<const ArchiveIndex> index = IndexArchive(archive);
+    if (!index)
+    {
+        return false;
+    }
+
+    JobProgress progress;
+    std::string target = destination.ToStdString();
+    return RunJob("Copying from Archive", progress,
+                  [&]() { return index->Extract(inner, target, progress); });
+}
+
+/*
+Function: OpenArchiveMember
+Description: The default application needs a real file, so the member is
+             copied to a folder under the system temporary directory first.
+Parameters: path - virtual path of the member
+Return: None
+*/
+void MainFrame::OpenArchiveMember(const wxString& path)
+{
+    wxString directory = wxStandardPaths::Get().GetTempDir() + wxFileName::GetPathSeparator() +
+                         "filemanager-archive";
+    if (!wxFileName::DirExists(directory))
+    {
+        wxFileName::Mkdir(directory, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    }
+    wxString target = directory + wxFileName::GetPathSeparator() + wxFileName(path).GetFullName();
+
+    if (!ExtractFromArchive(path, target))
+    {
+        wxMessageBox("Could not copy \"" + wxFileName(path).GetFullName() + "\" out of the archive.",
+                     "Error", wxOK | wxICON_ERROR, this);
+        return;
+    }
+    OpenFile(target);
+}
+
+/*
+Function: RefuseInArchive
+Description: Archives are opened read-only; operations that would change
+             the folder shown, or need it on disk, are turned down with a
+             message.
+Parameters: action - name of the refused command
+Return: true if the command must not go ahead
+*/
+bool MainFrame::RefuseInArchive(const wxString& action)
+{
+    if (!m_filePanel->GetListing().IsVirtual())
+    {
+        return false;
+    }
+    wxMessageBox("\"" + action + "\" is not available inside an archive.\n"
+                 "Archives are opened read-only; use Copy and Paste to copy members out.",
+                 "Read-Only Archive", wxOK | wxICON_WARNING, this);
+    return true;
+}
+
+/*
+Function: RefuseMultipleSelection
+Description: Commands that take one item (the clipboard holds one path)
+             are turned down when several rows are selected, rather than
+             silently acting on the first of them.
+Parameters: action - name of the refused command
+Return: true if the command must not go ahead
+*/
+bool MainFrame::RefuseMultipleSelection(const wxString& action)
+{
+    size_t selected = m_filePanel->GetSelectedNames().size();
+    if (selected <= 1)
+    {
+        return false;
+    }
+    wxMessageBox(wxString::Format("\"%s\" works on one item, but %lu are selected.\n"
+                                  "Select a single file or folder, or use Copy / Move to Other Pane "
+                                  "for several.", action, static_cast<unsigned long>(selected)),
+                 "Several Items Selected", wxOK | wxICON_WARNING, this);
+    return true;
+}
+
+/*
+Function: RefuseNonLocal
+Description: Commands that open files through the operating system (the
+             copy engine, memory mapping, archive writers, attribute
+             calls) would reach the local disk instead of the backend
+             being browsed, so they are turned down with a status message.
+Parameters: action - name of the refused command
+Return: true if the command must not go ahead
+*/
+bool MainFrame::RefuseNonLocal(const wxString& action)
+{
+    if (FileSystemBackend::Current().IsLocal())
+    {
+        return false;
+    }
+    m_statusBar->SetStatusText("\"" + action + "\" is not available: the file system browsed is not local");
+    return true;
+}
+
+/*
+Function: ShowPreviewPane
+Description: Splits the main area to show the preview pane, or unsplits it
+             and releases the previewed file.
+Parameters: show - true to show the pane
+Return: None
+*/
+void MainFrame::ShowPreviewPane(bool show)
+{
+    GetMenuBar()->Check(ID_PREVIEW, show);
+    if (show && !m_splitter->IsSplit())
+    {
+        PreviewWindow()->Show();
+        m_splitter->SplitVertically(m_panes, PreviewWindow());
+    }
+    else if (!show && m_splitter->IsSplit())
+    {
+        m_splitter->Unsplit(PreviewWindow());
+        m_previewPanel->CloseFile();
+        m_hexPanel->CloseFile();
+    }
+}
+
+/*
+Function: PreviewWindow
+Description: The viewer selected by View > Hex View.
+Parameters: None
+Return: The hex or the text preview panel
+*/
+wxWindow* MainFrame::PreviewWindow() const
+{
+    if (GetMenuBar()->IsChecked(ID_HEX_VIEW))
+    {
+        return m_hexPanel;
+    }
+    return m_previewPanel;
+}
+
+/*
+Function: PreviewFile
+Description: Shows a file in whichever viewer the preview pane holds.  The
+             viewers map the file, so nothing is shown from a backend
+             other than the local file system.
+Parameters: path - file to show
+Return: None
+*/
+void MainFrame::PreviewFile(const wxString& path)
+{
+    if (RefuseNonLocal("Preview"))
+    {
+        return;
+    }
+    if (GetMenuBar()->IsChecked(ID_HEX_VIEW))
+    {
+        m_hexPanel->ShowFile(path);
+    }
+    else
+    {
+        m_previewPanel->ShowFile(path);
+    }
+}
+
+/*
+Function: FullPath
+Description: Joins the current directory path with a filename to produce a
+             complete filesystem path.
+Parameters: name - filename or folder name to append
+Return: Full path string
+*/
+wxString MainFrame::FullPath(const wxString& name) const
+{
+    return JoinPath(m_filePanel->CurrentPath(), name);
+}
+
+/*
+Function: JoinPath
+Description: Joins a directory path with a filename.
+Parameters: directory - the directory
+            name      - filename or folder name to append
+Return: Full path string
+*/
+wxString MainFrame::JoinPath(const wxString& directory, const wxString& name)
+{
+    wxString path = directory;
+
+    // Manually join the directory with the name.
+    // Ensure there's exactly one separator between them.
+    if (!path.EndsWith(wxFileName::GetPathSeparator()))
+    {
+        path += wxFileName::GetPathSeparator();
+    }
+
+    return path + name;
+}
+
+/*
+Function: UserDataPath
+Description: Builds a path inside the platform's per-user application data
+             directory, creating the directory the first time.
+Parameters: fileName - name of the file inside the data directory
+Return: Full path to the file
+*/
+wxString MainFrame::UserDataPath(const wxString& fileName)
+{
+    wxString directory = wxStandardPaths::Get().GetUserDataDir();
+    if (!wxFileName::DirExists(directory))
+    {
+        wxFileName::Mkdir(directory, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    }
+    return directory + wxFileName::GetPathSeparator() + fileName;
+}
+
+/*
+Function: RunFileJob
+Description: Queues the operation on the file-job pool.  The status bar
+             shows what is running; the prefetcher stays paused until the
+             last job has finished, as it does for modal jobs.
+Parameters: description - what the job does, for the status bar
+            work        - the operation, run on a background thread
+            done        - called on the GUI thread with work()'s result
+Return: None
+*/
+void MainFrame::RunFileJob(const wxString& description, const std::function<bool()>& work,
+                           const std::function<void(bool)>& done)
+{
+    ++m_fileJobsRunning;
+    m_prefetcher->Suspend();
+    m_statusBar->SetStatusText(wxString::Format("%s... (%d operation(s) running)",
+                                                description, m_fileJobsRunning));
+
+    m_fileJobs->Submit([this, work, done]()
+    {
+        bool success = false;
+        try
+        {
+            success = work();
+        }
+        catch (const std::exception&)
+        {
+            success = false;
+        }
+
+        CallAfter([this, done, success]()
+        {
+            --m_fileJobsRunning;
+            m_prefetcher->Resume();
+            done(success);
+        });
+    });
+}
+
+/*
+Function: RunJob
+Description: Runs a long operation on its own thread and keeps the GUI alive
+             with a modal progress dialog that polls the shared JobProgress.
+             While the total is unknown (e.g. during a tree walk) the dialog
+             pulses instead of showing a percentage.  Pressing Cancel only
+             raises the flag; the dialog stays up until the job has actually
+             stopped, so the job never outlives the objects it references.
+Parameters: title    - dialog title
+            progress - progress/cancel state shared with the job
+            work     - the job; its return value is the job's success
+Return: true if work() succeeded and was not cancelled
+*/
+bool MainFrame::RunJob(const wxString& title, JobProgress& progress,
+                       const std::function<bool()>& work)
+{
+    // Foreground jobs get the disks to themselves.
+    m_prefetcher->Suspend();
+
+    bool succeeded = false;
+    std::thread worker([&]()
+    {
+        try
+        {
+            succeeded = work();
+        }
+        catch (const std::exception&)
+        {
+            succeeded = false;
+        }
+        progress.Finish();
+    });
+
+    {
+        wxProgressDialog dialog(title, "Starting...", PROGRESS_RANGE, this,
+                                wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME |
+                                wxPD_REMAINING_TIME | wxPD_SMOOTH);
+
+        while (!progress.IsFinished())
+        {
+            wxString message = wxString::FromUTF8(progress.GetMessage());
+            bool keepGoing;
+            if (progress.GetTotal() == 0)
+            {
+                keepGoing = dialog.Pulse(message);
+            }
+            else
+            {
+                // Stay below the range so the dialog does not close itself.
+                int value = static_cast<int>(progress.GetFraction() * (PROGRESS_RANGE - 1));
+                keepGoing = dialog.Update(value, message);
+            }
+
+            if (!keepGoing)
+            {
+                progress.Cancel();
+            }
+            wxMilliSleep(PROGRESS_POLL_MS);
+        }
+    }
+
+    worker.join();
+    m_prefetcher->Resume();
+    return succeeded && !progress.IsCancelled();
+}
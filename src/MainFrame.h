@@ -1,36 +1,87 @@
 /*
 Author: Guo Jia
 Description: Declaration of MainFrame – the top-level application window
-             containing the menu bar, address bar, file-listing panel, and
-             status bar.  Also owns the virtual clipboard state and declares
-             every file-operation event handler.
+             containing the menu bar, address bar, file-listing panels, and
+             status bar.  Panels are tabs of one or two panes; every panel
+             shares the frame's listing cache and worker pool, and commands
+             act on the active one.  Also owns the virtual clipboard state
+             and declares every file-operation event handler.
 Date: 2026-01-31
 */
 
 #ifndef MAINFRAME_H
 #define MAINFRAME_H
 
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <wx/frame.h>
 #include <wx/textctrl.h>
 #include <wx/statusbr.h>
 #include <wx/menu.h>
 #include <wx/listctrl.h>
+#include <wx/stopwatch.h>
+#include <wx/splitter.h>
+#include <wx/notebook.h>
 #include "FilePanel.h"
 
+class ThreadPool;
+class JobProgress;
+class TreeHashCache;
+class PathCompleter;
+class ListingCache;
+class DirectoryPrefetcher;
+class TextPreviewPanel;
+class HexViewPanel;
+class ArchiveIndex;
+class ArchiveRegistry;
+class IoScheduler;
+class DirectoryHistory;
+class ThumbnailCache;
+
 
 class MainFrame : public wxFrame
 {
 public:
-    explicit MainFrame(const wxString& title);
+    // launchMillis is how long the application took before creating the
+    // frame; it seeds the startup measurement reported in the status bar.
+    MainFrame(const wxString& title, long launchMillis);
     virtual ~MainFrame();
 
 private:
     // -----------------------------------------------------------------------
     // UI controls
     // -----------------------------------------------------------------------
-    FilePanel*    m_filePanel;
-    wxTextCtrl*   m_addressBar;
-    wxStatusBar*  m_statusBar;
+    FilePanel*        m_filePanel;      // the active panel: current tab of the focused pane
+    wxTextCtrl*       m_addressBar;     // shows and edits the active panel's path
+    wxStatusBar*      m_statusBar;
+    wxSplitterWindow* m_splitter;       // panes | preview
+    wxSplitterWindow* m_panes;          // left pane | right pane (unsplit in single-pane mode)
+    wxNotebook*       m_notebooks[2];   // the tabs of each pane
+    TextPreviewPanel* m_previewPanel;   // hidden until the pane is opened
+    HexViewPanel*     m_hexPanel;       // takes the preview's place in hex mode
+
+    // -----------------------------------------------------------------------
+    // Background work – shared by every long-running operation.
+    // -----------------------------------------------------------------------
+    std::unique_ptr<ThreadPool>    m_workers;
+    std::unique_ptr<TreeHashCache> m_treeHashCache;   // persisted folder-compare hashes
+    std::unique_ptr<PathCompleter> m_pathCompleter;   // address bar completion
+    std::unique_ptr<ListingCache>        m_listingCache;   // recent + prefetched listings
+    std::unique_ptr<DirectoryPrefetcher> m_prefetcher;     // declared after the cache it fills
+    std::unique_ptr<ArchiveRegistry>     m_archives;       // indexes of archives browsed recently
+    std::unique_ptr<IoScheduler>         m_ioScheduler;    // per-device limits for FileOperations
+    std::unique_ptr<ThreadPool>          m_fileJobs;       // pastes and deletes running in the background
+    std::unique_ptr<DirectoryHistory>    m_history;        // folders visited, for Jump to Folder
+    std::unique_ptr<FileTypeScanner>     m_typeScanner;    // Type column of every panel
+    std::unique_ptr<ThumbnailCache>      m_thumbCache;     // shared by the loader's workers
+    std::unique_ptr<ThumbnailLoader>     m_thumbLoader;    // thumbnails of every panel; after its cache
+    int                                  m_fileJobsRunning;
+    long                                 m_hoverRow;       // last row hovered, -1 if none
+    unsigned long                        m_navigation;     // NavigateTo() calls so far
+    std::unordered_map<const FilePanel*, unsigned long> m_lastNavigation;   // newest per panel; older loads are dropped
 
     // -----------------------------------------------------------------------
     // Virtual clipboard – just a path and a flag; no real OS clipboard used.
@@ -38,17 +89,40 @@ private:
     wxString  m_clipboardPath;   // full path of the file/dir marked for copy/cut
     bool      m_clipboardIsCut;  // true = cut (move), false = copy
 
+    // -----------------------------------------------------------------------
+    // Startup – time until the window first goes idle (i.e. is interactive).
+    // -----------------------------------------------------------------------
+    wxStopWatch m_startupClock;
+    long        m_startupMillis;   // -1 until measured
+
     // -----------------------------------------------------------------------
     // Menu IDs – unique values for every action so Bind() can distinguish them.
     // -----------------------------------------------------------------------
     enum MenuId {
         ID_NEW_FOLDER = wxID_HIGHEST + 1,
         ID_RENAME,
+        ID_BATCH_RENAME,
+        ID_ATTRIBUTES,
         ID_DELETE,
         ID_COPY,
         ID_CUT,
         ID_PASTE,
-        ID_REFRESH
+        ID_COPY_TO_PANE,
+        ID_MOVE_TO_PANE,
+        ID_REFRESH,
+        ID_JUMP,
+        ID_SYNC_TO,
+        ID_COMPARE,
+        ID_COMPRESS,
+        ID_SPLIT,
+        ID_JOIN,
+        ID_PREVIEW,
+        ID_HEX_VIEW,
+        ID_THUMBNAILS,
+        ID_NEW_TAB,
+        ID_CLOSE_TAB,
+        ID_DUAL_PANE,
+        ID_SWITCH_PANE
     };
 
     // -----------------------------------------------------------------------
@@ -62,27 +136,126 @@ private:
     // -----------------------------------------------------------------------
     void OnAddressBarEnter(wxCommandEvent& event);
     void OnListDoubleClick(wxListEvent& event);
+    void OnListSelect(wxListEvent& event);
+    void OnListHover(wxMouseEvent& event);
     void OnNewFolder(wxCommandEvent& event);
     void OnRename(wxCommandEvent& event);
     void OnDelete(wxCommandEvent& event);
     void OnCopy(wxCommandEvent& event);
     void OnCut(wxCommandEvent& event);
     void OnPaste(wxCommandEvent& event);
+    void OnCopyToOtherPane(wxCommandEvent& event);
+    void OnMoveToOtherPane(wxCommandEvent& event);
     void OnRefresh(wxCommandEvent& event);
+    void OnJumpToFolder(wxCommandEvent& event);
+    void OnSyncTo(wxCommandEvent& event);
+    void OnCompareWith(wxCommandEvent& event);
+    void OnCompress(wxCommandEvent& event);
+    void OnSplit(wxCommandEvent& event);
+    void OnJoin(wxCommandEvent& event);
+    void OnBatchRename(wxCommandEvent& event);
+    void OnChangeAttributes(wxCommandEvent& event);
+    void OnTogglePreview(wxCommandEvent& event);
+    void OnToggleHexView(wxCommandEvent& event);
+    void OnToggleThumbnails(wxCommandEvent& event);
+    void OnNewTab(wxCommandEvent& event);
+    void OnCloseTab(wxCommandEvent& event);
+    void OnToggleDualPane(wxCommandEvent& event);
+    void OnSwitchPane(wxCommandEvent& event);
+    void OnTabChanged(wxBookCtrlEvent& event);
+    void OnPanelFocus(wxFocusEvent& event);
+    void OnFirstIdle(wxIdleEvent& event);
+    void OnClose(wxCloseEvent& event);
 
     // -----------------------------------------------------------------------
     // Private helpers
     // -----------------------------------------------------------------------
-    // Navigate to a directory and sync the address bar.  Shows an error dialog
-    // on failure.
+    // Navigate the active panel (or 'panel') to a directory and sync the
+    // address bar.  The directory is read on the worker pool unless
+    // cached; shows an error dialog on failure.
     void NavigateTo(const wxString& path);
+    void NavigateTo(FilePanel* panel, const wxString& path);
+
+    // Show the listing saved at the end of the last session (if any) and
+    // start revalidating it in the background.  Falls back to the home
+    // directory when there is no snapshot or its directory is gone.
+    void RestoreLastListing();
+
+    // Re-read 'path' on a worker thread and diff the result into every
+    // panel showing it, except those that have moved on by the time it
+    // arrives.  Does nothing if no panel shows 'path'.
+    void RevalidateAsync(const wxString& path);
+
+    // Tabs and panes.  AddTab opens a panel in a pane (0 = left) at
+    // 'path'; the panel receives focus-tracking and list events.
+    // ShowListingIn shows a listing and relabels the panel's tab.
+    FilePanel*             AddTab(int pane, const wxString& path);
+    std::vector<FilePanel*> GetPanels() const;
+    bool                   HasPanel(const FilePanel* panel) const;
+    FilePanel*             PanelOf(const wxObject* listCtrl) const;
+    FilePanel*             OtherPanel() const;   // nullptr in single-pane mode
+    void                   SetActivePanel(FilePanel* panel);
+    void                   ShowListingIn(FilePanel* panel, const DirectoryListing& listing);
+
+    // Copy or move the selection into the other pane's folder as one
+    // background file job.
+    void TransferToOtherPane(bool move);
 
     // Open a file with the system default application.
     void OpenFile(const wxString& path);
 
+    // Archives are browsed as read-only folders under virtual paths
+    // ("/dir/a.tar.gz/inner").  IndexArchive returns the cached index or
+    // builds one behind a progress dialog (nullptr if that fails or is
+    // cancelled); the others show a folder of an archive, copy a member
+    // out, and open a member by copying it to a temporary folder.
+    std::shared_ptr<const ArchiveIndex> IndexArchive(const std::string& archive);
+    void ShowArchiveFolder(FilePanel* panel, const std::string& archive, const std::string& inner);
+    bool ExtractFromArchive(const wxString& source, const wxString& destination);
+    void OpenArchiveMember(const wxString& path);
+
+    // True, after telling the user, when the panel shows the inside of an
+    // archive, where 'action' cannot be done.
+    bool RefuseInArchive(const wxString& action);
+
+    // True, after saying so in the status bar, when the backend is not the
+    // local file system, which 'action' reads or writes directly.
+    bool RefuseNonLocal(const wxString& action);
+
+    // True, after telling the user, when more than one row is selected for
+    // 'action', which works on a single item.
+    bool RefuseMultipleSelection(const wxString& action);
+
+    // Show or hide the preview pane (keeps the View menu check in sync).
+    void ShowPreviewPane(bool show);
+
+    // The panel the preview pane currently shows (text or hex), and
+    // showing a file in it.
+    wxWindow* PreviewWindow() const;
+    void      PreviewFile(const wxString& path);
+
     // Returns the full path that results from joining m_filePanel->CurrentPath()
-    // with the given filename.
-    wxString FullPath(const wxString& name) const;
+    // (or 'directory') with the given filename.
+    wxString        FullPath(const wxString& name) const;
+    static wxString JoinPath(const wxString& directory, const wxString& name);
+
+    // Full path of a file in the per-user data directory (created on demand).
+    static wxString UserDataPath(const wxString& fileName);
+
+    // Offer to resume copies and moves that were interrupted.
+    void ResumeInterruptedJobs();
+
+    // Run a file operation in the background and call 'done' with its
+    // result on the GUI thread.  Several may run at once; the I/O
+    // scheduler decides which of them touch a disk at the same time.
+    void RunFileJob(const wxString& description, const std::function<bool()>& work,
+                    const std::function<void(bool)>& done);
+
+    // Run 'work' on a background thread while a modal progress dialog polls
+    // 'progress'.  The dialog's Cancel button sets progress.Cancel().
+    // Returns work()'s result, or false if the job was cancelled.
+    bool RunJob(const wxString& title, JobProgress& progress,
+                const std::function<bool()>& work);
 };
 
 #endif // MAINFRAME_H
\ No newline at end of file
@@ -0,0 +1,354 @@
+/*
+Author: Guo Jia
+Description: Implementation of MappedFile.  Every window is registered
+             with a process-wide SIGBUS handler: touching a mapped page past
+             the end of a file that shrank (a followed log rotated with
+             copytruncate) makes the handler map a zero page over it, so the
+             access reads zeros and the next UpdateSize() drops the window.
+             Faults outside the registered windows go to the previous
+             handler.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MappedFile.h"
+
+using namespace std;
+
+namespace
+{
+    // Windows mapped at once across all MappedFile objects that the
+    // SIGBUS handler protects; further windows still work, unguarded.
+    const int MAX_GUARDED = 64;
+
+    // A registered window.  Written by the owning thread, read by the
+    // handler on whichever thread faults, hence atomics and no locks.
+    struct GuardedWindow
+    {
+        atomic<uintptr_t> start;
+        atomic<size_t>    length;
+    };
+
+    GuardedWindow    g_guarded[MAX_GUARDED];
+    uintptr_t        g_pageSize = 0;
+    struct sigaction g_previous;
+    once_flag        g_installed;
+
+    // mmap() is not on the async-signal-safe list, but on Linux it is a
+    // plain system call with no library state, which is all this needs.
+    void OnBusError(int signal, siginfo_t* info, void* context)
+    {
+        uintptr_t address = reinterpret_cast<uintptr_t>(info->si_addr);
+        for (GuardedWindow& window : g_guarded)
+        {
+            uintptr_t start  = window.start.load(memory_order_acquire);
+            size_t    length = window.length.load(memory_order_acquire);
+            if (start != 0 && address >= start && address - start < length)
+            {
+                void* page = reinterpret_cast<void*>(address & ~(g_pageSize - 1));
+                if (mmap(page, g_pageSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) != MAP_FAILED)
+                {
+                    return;   // the access is retried and reads zeros
+                }
+                break;
+            }
+        }
+
+        if ((g_previous.sa_flags & SA_SIGINFO) != 0 && g_previous.sa_sigaction != nullptr)
+        {
+            g_previous.sa_sigaction(signal, info, context);
+        }
+        else if (g_previous.sa_handler != SIG_DFL && g_previous.sa_handler != SIG_IGN)
+        {
+            g_previous.sa_handler(signal);
+        }
+        else
+        {
+            // Returning re-runs the access, which now takes the default
+            // action and ends the process as it would have without us.
+            ::signal(SIGBUS, SIG_DFL);
+        }
+    }
+
+    void InstallHandler()
+    {
+        g_pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+
+        struct sigaction action;
+        action.sa_sigaction = OnBusError;
+        action.sa_flags     = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGBUS, &action, &g_previous);
+    }
+
+    // Claim a slot for [start, start + length); -1 if all are taken.
+    int Guard(const char* start, size_t length)
+    {
+        call_once(g_installed, InstallHandler);
+        uintptr_t address = reinterpret_cast<uintptr_t>(start);
+        for (int slot = 0; slot < MAX_GUARDED; ++slot)
+        {
+            uintptr_t expected = 0;
+            if (g_guarded[slot].start.compare_exchange_strong(expected, address, memory_order_acq_rel))
+            {
+                g_guarded[slot].length.store(length, memory_order_release);
+                return slot;
+            }
+        }
+        return -1;
+    }
+
+    void Unguard(int slot)
+    {
+        if (slot >= 0)
+        {
+            g_guarded[slot].length.store(0, memory_order_release);
+            g_guarded[slot].start.store(0, memory_order_release);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: MappedFile
+Description: Creates a closed file object.
+Parameters: None
+Return: None
+*/
+MappedFile::MappedFile()
+    : m_fd(-1),
+      m_size(0),
+      m_path(""),
+      m_window(nullptr),
+      m_windowOffset(0),
+      m_windowLength(0),
+      m_slot(-1)
+{
+}
+
+/*
+Function: ~MappedFile
+Description: Unmaps the window and closes the file.
+Parameters: None
+Return: None
+*/
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+// ---------------------------------------------------------------------------
+// Open / close
+// ---------------------------------------------------------------------------
+
+/*
+Function: Open
+Description: Opens a regular file read-only, closing any previous one.
+Parameters: path - file to open
+Return: true if the file is open
+*/
+bool MappedFile::Open(const string& path)
+{
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        close(fd);
+        return false;
+    }
+
+    m_fd   = fd;
+    m_size = static_cast<uint64_t>(info.st_size);
+    m_path = path;
+    return true;
+}
+
+/*
+Function: Close
+Description: Releases the window and the descriptor.  Safe to call twice.
+Parameters: None
+Return: None
+*/
+void MappedFile::Close()
+{
+    UnmapWindow();
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+    }
+    m_fd   = -1;
+    m_size = 0;
+    m_path.clear();
+}
+
+/*
+Function: UpdateSize
+Description: Picks up a change in file size.  If the file shrank below the
+             mapped window the window is dropped: touching mapped pages
+             past the end of a file raises SIGBUS.
+Parameters: None
+Return: true if the size changed
+*/
+bool MappedFile::UpdateSize()
+{
+    struct stat info;
+    if (m_fd < 0 || fstat(m_fd, &info) != 0)
+    {
+        return false;
+    }
+
+    uint64_t size = static_cast<uint64_t>(info.st_size);
+    if (size == m_size)
+    {
+        return false;
+    }
+    if (size < m_windowOffset + m_windowLength)
+    {
+        UnmapWindow();
+    }
+    m_size = size;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Access
+// ---------------------------------------------------------------------------
+
+/*
+Function: Read
+Description: Serves the request from the current window when it fits,
+             otherwise maps a new window starting at the page containing
+             'offset'.  The file is re-stat'ed first: a followed file may
+             have been truncated since UpdateSize(), and touching a mapped
+             page past its end raises SIGBUS.  Nothing past the size just
+             checked is ever handed out.
+Parameters: offset    - file offset
+            length    - bytes wanted
+            available - receives the number of readable bytes at the result
+Return: Pointer to the data, or nullptr
+*/
+const char* MappedFile::Read(uint64_t offset, size_t length, size_t& available)
+{
+    available = 0;
+    uint64_t size = 0;
+    if (m_fd < 0 || !CurrentSize(size))
+    {
+        return nullptr;
+    }
+
+    // Growth is only picked up by UpdateSize(); shrinking applies at once.
+    size = min(size, m_size);
+    if (m_windowOffset + m_windowLength > size)
+    {
+        UnmapWindow();
+    }
+    if (offset >= size)
+    {
+        return nullptr;
+    }
+    length = static_cast<size_t>(min<uint64_t>(length, size - offset));
+
+    if (m_window == nullptr || offset < m_windowOffset ||
+        offset + length > m_windowOffset + m_windowLength)
+    {
+        if (!MapWindow(offset, length, size))
+        {
+            return nullptr;
+        }
+    }
+
+    available = static_cast<size_t>(m_windowOffset + m_windowLength - offset);
+    return m_window + (offset - m_windowOffset);
+}
+
+// ---------------------------------------------------------------------------
+// Internal helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: CurrentSize
+Description: Reads the file's size as it is now, without updating m_size.
+Parameters: size - receives the size
+Return: true on success
+*/
+bool MappedFile::CurrentSize(uint64_t& size) const
+{
+    struct stat info;
+    if (fstat(m_fd, &info) != 0)
+    {
+        return false;
+    }
+    size = static_cast<uint64_t>(info.st_size);
+    return true;
+}
+
+/*
+Function: MapWindow
+Description: Replaces the window with one covering [offset, offset+length),
+             page-aligned and at least WINDOW_SIZE long where the file
+             allows.  Never maps past 'size'.
+Parameters: offset - first byte that must be mapped
+            length - number of bytes that must be mapped
+            size   - file size just checked
+Return: true on success
+*/
+bool MappedFile::MapWindow(uint64_t offset, size_t length, uint64_t size)
+{
+    UnmapWindow();
+
+    uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t start    = offset - offset % pageSize;
+    uint64_t wanted   = max<uint64_t>(WINDOW_SIZE, (offset - start) + length);
+    size_t   mapped   = static_cast<size_t>(min<uint64_t>(wanted, size - start));
+
+    void* window = mmap(nullptr, mapped, PROT_READ, MAP_SHARED, m_fd, static_cast<off_t>(start));
+    if (window == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_window       = static_cast<char*>(window);
+    m_windowOffset = start;
+    m_windowLength = mapped;
+    m_slot         = Guard(m_window, m_windowLength);
+    return true;
+}
+
+/*
+Function: UnmapWindow
+Description: Unmaps the current window, if any, after taking it off the
+             SIGBUS handler's list, so the address range is never guarded
+             once something else may be mapped there.
+Parameters: None
+Return: None
+*/
+void MappedFile::UnmapWindow()
+{
+    Unguard(m_slot);
+    if (m_window != nullptr)
+    {
+        munmap(m_window, m_windowLength);
+    }
+    m_slot         = -1;
+    m_window       = nullptr;
+    m_windowOffset = 0;
+    m_windowLength = 0;
+}
@@ -0,0 +1,66 @@
+/*
+Author: Guo Jia
+Description: Declaration of MappedFile – read-only access to a file of any
+             size through a single sliding mmap window.  Only the window is
+             mapped, so address space and memory use stay constant whether
+             the file is 1 KB or 20 GB; moving elsewhere remaps in O(1).
+             A file truncated under a window reads as zeros there instead
+             of raising SIGBUS.
+Date: 2026-10-18
+*/
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class MappedFile
+{
+public:
+    MappedFile();
+    virtual ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Open a regular file.  Nothing is mapped until the first Read().
+    bool Open(const std::string& path);
+    void Close();
+
+    bool               IsOpen() const { return m_fd >= 0; }
+    std::uint64_t      GetSize() const { return m_size; }
+    const std::string& GetPath() const { return m_path; }
+
+    // Re-stat the file (it may be growing, e.g. a log being followed).
+    // Returns true if the size changed; the window is dropped if it now
+    // reaches past the end.
+    bool UpdateSize();
+
+    // Pointer to the bytes at 'offset'.  'available' receives how many
+    // bytes may be read there: at least min(length, size - offset) unless
+    // mapping failed or the file has been truncated since.  Returns nullptr
+    // at or past the end of the file.  The pointer is valid until the next
+    // Read(), UpdateSize() or Close(); bytes cut off by a truncation after
+    // this call read as zeros.
+    const char* Read(std::uint64_t offset, std::size_t length, std::size_t& available);
+
+private:
+    // Default window; requests larger than this get a larger window.
+    static constexpr std::size_t WINDOW_SIZE = 16 * 1024 * 1024;
+
+    int           m_fd;
+    std::uint64_t m_size;
+    std::string   m_path;
+    char*         m_window;
+    std::uint64_t m_windowOffset;
+    std::size_t   m_windowLength;
+    int           m_slot;           // guarded-window slot, or -1
+
+    bool CurrentSize(std::uint64_t& size) const;
+    bool MapWindow(std::uint64_t offset, std::size_t length, std::uint64_t size);
+    void UnmapWindow();
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,220 @@
+/*
+Author: Guo Jia
+Description: Implementation of Md5 following RFC 1321.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cstring>
+#include "Md5.h"
+
+using namespace std;
+
+namespace
+{
+    // Per-round shift amounts and the sine-derived constants of RFC 1321.
+    const uint32_t SHIFTS[64] = {
+        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+        5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+    };
+
+    const uint32_t CONSTANTS[64] = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+    };
+
+    inline uint32_t RotateLeft(uint32_t value, uint32_t bits)
+    {
+        return (value << bits) | (value >> (32 - bits));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: Md5
+Description: Starts a digest with the RFC 1321 initial state.
+Parameters: None
+Return: None
+*/
+Md5::Md5()
+    : m_state{ 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 },
+      m_totalLength(0),
+      m_pending(),
+      m_pendingLength(0)
+{
+}
+
+/*
+Function: ~Md5
+Description: Destructor.  No resources to release.
+Parameters: None
+Return: None
+*/
+Md5::~Md5()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Digest
+// ---------------------------------------------------------------------------
+
+/*
+Function: Update
+Description: Buffers input until a whole 64-byte block is available.
+Parameters: data   - bytes to add
+            length - number of bytes
+Return: None
+*/
+void Md5::Update(const void* data, size_t length)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    m_totalLength += length;
+
+    if (m_pendingLength > 0)
+    {
+        size_t take = min(length, BLOCK_SIZE - m_pendingLength);
+        memcpy(m_pending + m_pendingLength, bytes, take);
+        m_pendingLength += take;
+        bytes  += take;
+        length -= take;
+        if (m_pendingLength < BLOCK_SIZE)
+        {
+            return;
+        }
+        ProcessBlock(m_pending);
+        m_pendingLength = 0;
+    }
+
+    for (; length >= BLOCK_SIZE; bytes += BLOCK_SIZE, length -= BLOCK_SIZE)
+    {
+        ProcessBlock(bytes);
+    }
+
+    memcpy(m_pending, bytes, length);
+    m_pendingLength = length;
+}
+
+/*
+Function: HexDigest
+Description: Appends the padding and the bit length, then formats the
+             state little-endian as hex.
+Parameters: None
+Return: 32-character lowercase hex digest
+*/
+string Md5::HexDigest()
+{
+    uint64_t bitLength = m_totalLength * 8;
+
+    unsigned char padding[BLOCK_SIZE] = { 0x80 };
+    size_t padLength = (m_pendingLength < 56) ? 56 - m_pendingLength : 120 - m_pendingLength;
+    Update(padding, padLength);
+
+    unsigned char lengthBytes[8];
+    for (int i = 0; i < 8; ++i)
+    {
+        lengthBytes[i] = static_cast<unsigned char>(bitLength >> (8 * i));
+    }
+    Update(lengthBytes, sizeof(lengthBytes));
+
+    static const char DIGITS[] = "0123456789abcdef";
+    string hex;
+    hex.reserve(32);
+    for (uint32_t word : m_state)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            unsigned char byte = static_cast<unsigned char>(word >> (8 * i));
+            hex += DIGITS[byte >> 4];
+            hex += DIGITS[byte & 0x0F];
+        }
+    }
+    return hex;
+}
+
+/*
+Function: Hex
+Description: One-shot digest of a string.
+Parameters: text - input bytes
+Return: 32-character lowercase hex digest
+*/
+string Md5::Hex(const string& text)
+{
+    Md5 digest;
+    digest.Update(text.data(), text.size());
+    return digest.HexDigest();
+}
+
+// ---------------------------------------------------------------------------
+// Internal helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: ProcessBlock
+Description: The four 16-step rounds of RFC 1321 over one block.
+Parameters: block - 64 input bytes
+Return: None
+*/
+void Md5::ProcessBlock(const unsigned char* block)
+{
+    uint32_t words[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        words[i] = static_cast<uint32_t>(block[i * 4]) |
+                   static_cast<uint32_t>(block[i * 4 + 1]) << 8 |
+                   static_cast<uint32_t>(block[i * 4 + 2]) << 16 |
+                   static_cast<uint32_t>(block[i * 4 + 3]) << 24;
+    }
+
+    uint32_t a = m_state[0];
+    uint32_t b = m_state[1];
+    uint32_t c = m_state[2];
+    uint32_t d = m_state[3];
+
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        uint32_t f;
+        uint32_t g;
+        if (i < 16)
+        {
+            f = (b & c) | (~b & d);
+            g = i;
+        }
+        else if (i < 32)
+        {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) % 16;
+        }
+        else if (i < 48)
+        {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) % 16;
+        }
+        else
+        {
+            f = c ^ (b | ~d);
+            g = (7 * i) % 16;
+        }
+
+        uint32_t rotated = d;
+        d = c;
+        c = b;
+        b = b + RotateLeft(a + f + CONSTANTS[i] + words[g], SHIFTS[i]);
+        a = rotated;
+    }
+
+    m_state[0] += a;
+    m_state[1] += b;
+    m_state[2] += c;
+    m_state[3] += d;
+}
@@ -0,0 +1,44 @@
+/*
+Author: Guo Jia
+Description: Declaration of Md5 – the MD5 message digest.  Only used where
+             an external format prescribes it (freedesktop thumbnail file
+             names are the MD5 of the file's URI); ContentHash is the choice
+             for anything internal.
+Date: 2026-10-18
+*/
+
+#ifndef MD5_H
+#define MD5_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class Md5
+{
+public:
+    Md5();
+    virtual ~Md5();
+
+    // Feed more bytes into the running digest.
+    void Update(const void* data, std::size_t length);
+
+    // Finish and return the digest as 32 lowercase hex digits.  The object
+    // must not be updated afterwards.
+    std::string HexDigest();
+
+    // One-shot digest of a string.
+    static std::string Hex(const std::string& text);
+
+private:
+    static const std::size_t BLOCK_SIZE = 64;
+
+    std::uint32_t m_state[4];
+    std::uint64_t m_totalLength;
+    unsigned char m_pending[BLOCK_SIZE];   // partial block not yet processed
+    std::size_t   m_pendingLength;
+
+    void ProcessBlock(const unsigned char* block);
+};
+
+#endif // MD5_H
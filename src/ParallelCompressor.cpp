@@ -0,0 +1,283 @@
+/*
+Author: Guo Jia
+Description: Implementation of ParallelCompressor – blocks of input are
+             handed to the thread pool as they fill up; the caller's thread
+             writes the compressed blocks out strictly in order, and only
+             waits for the pool when the in-flight limit is reached.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+#include <wx/mstream.h>
+#include <wx/zstream.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#include "ParallelCompressor.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: ParallelCompressor
+Description: Sets up an empty stream.  Twice as many blocks as pool threads
+             may be in flight, so the workers stay busy while the caller
+             writes, and memory stays near 2 * threads * BLOCK_SIZE times two
+             (input and output).
+Parameters: out    - descriptor the compressed stream is written to
+            method - gzip members or zstd frames
+            level  - compression level of the method
+            pool   - workers that compress the blocks
+Return: None
+*/
+ParallelCompressor::ParallelCompressor(int out, Method method, int level, ThreadPool& pool)
+    : m_out(out),
+      m_method(method),
+      m_level(level),
+      m_pool(pool),
+      m_maxInFlight(max<size_t>(2, 2 * static_cast<size_t>(pool.GetThreadCount()))),
+      m_current(),
+      m_pending(),
+      m_mutex(),
+      m_blockDone(),
+      m_bytesIn(0),
+      m_bytesOut(0),
+      m_failed(false)
+{
+    m_current.reserve(BLOCK_SIZE);
+}
+
+/*
+Function: ~ParallelCompressor
+Description: Waits for blocks still being compressed, since their tasks
+             refer to this object.  Unwritten data is dropped.
+Parameters: None
+Return: None
+*/
+ParallelCompressor::~ParallelCompressor()
+{
+    unique_lock<mutex> lock(m_mutex);
+    m_blockDone.wait(lock, [this] {
+        return all_of(m_pending.begin(), m_pending.end(),
+                      [](const shared_ptr<Block>& block) { return block->done; });
+    });
+}
+
+// ---------------------------------------------------------------------------
+// Public interface
+// ---------------------------------------------------------------------------
+
+/*
+Function: IsAvailable
+Description: gzip comes with wxWidgets' zlib; zstd needs the build flag.
+Parameters: method - format asked about
+Return: true if Compress() can produce it
+*/
+bool ParallelCompressor::IsAvailable(Method method)
+{
+#ifdef HAVE_ZSTD
+    (void)method;
+    return true;
+#else
+    return method == METHOD_GZIP;
+#endif
+}
+
+/*
+Function: Write
+Description: Copies the data into the current block, submitting each block
+             that fills up and writing out whatever blocks have finished.
+Parameters: data   - bytes to append
+            length - number of bytes
+Return: false once an earlier block failed to compress or write
+*/
+bool ParallelCompressor::Write(const char* data, size_t length)
+{
+    m_bytesIn += length;
+    while (length > 0 && !m_failed)
+    {
+        size_t part = min(length, BLOCK_SIZE - m_current.size());
+        m_current.append(data, part);
+        data += part;
+        length -= part;
+
+        if (m_current.size() == BLOCK_SIZE)
+        {
+            SubmitCurrent();
+            if (!WriteFinished(m_maxInFlight - 1))
+            {
+                m_failed = true;
+            }
+        }
+    }
+    return !m_failed;
+}
+
+/*
+Function: Finish
+Description: Submits the partly filled last block and writes every pending
+             block.  An empty stream still gets one (empty) member so the
+             result is a valid compressed file.
+Parameters: None
+Return: true if everything was compressed and written
+*/
+bool ParallelCompressor::Finish()
+{
+    if (m_failed)
+    {
+        return false;
+    }
+    if (!m_current.empty() || m_bytesIn == 0)
+    {
+        SubmitCurrent();
+    }
+    if (!WriteFinished(0))
+    {
+        m_failed = true;
+    }
+    return !m_failed;
+}
+
+// ---------------------------------------------------------------------------
+// Internals
+// ---------------------------------------------------------------------------
+
+/*
+Function: SubmitCurrent
+Description: Moves the current block into the queue and has a worker
+             compress it.
+Parameters: None
+Return: None
+*/
+void ParallelCompressor::SubmitCurrent()
+{
+    auto block = make_shared<Block>();
+    block->input.swap(m_current);
+    m_current.reserve(BLOCK_SIZE);
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_pending.push_back(block);
+    }
+
+    Method method = m_method;
+    int level = m_level;
+    m_pool.Submit([this, block, method, level] {
+        string output;
+        bool ok = Compress(method, level, block->input, output);
+
+        lock_guard<mutex> lock(m_mutex);
+        block->output.swap(output);
+        block->failed = !ok;
+        block->done = true;
+        string().swap(block->input);
+        m_blockDone.notify_all();
+    });
+}
+
+/*
+Function: WriteFinished
+Description: Writes the blocks at the front of the queue in order.  Blocks
+             that are done are written without waiting; the caller only
+             blocks while more than 'keep' are still pending.
+Parameters: keep - number of pending blocks that may be left behind
+Return: false if a block failed to compress or could not be written
+*/
+bool ParallelCompressor::WriteFinished(size_t keep)
+{
+    for (;;)
+    {
+        shared_ptr<Block> block;
+        {
+            unique_lock<mutex> lock(m_mutex);
+            if (m_pending.empty())
+            {
+                return true;
+            }
+            if (!m_pending.front()->done)
+            {
+                if (m_pending.size() <= keep)
+                {
+                    return true;
+                }
+                m_blockDone.wait(lock, [this] { return m_pending.front()->done; });
+            }
+            block = m_pending.front();
+            m_pending.pop_front();
+        }
+
+        if (block->failed)
+        {
+            return false;
+        }
+
+        const char* data = block->output.data();
+        size_t remaining = block->output.size();
+        while (remaining > 0)
+        {
+            ssize_t written = ::write(m_out, data, remaining);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            remaining -= static_cast<size_t>(written);
+        }
+        m_bytesOut += block->output.size();
+    }
+}
+
+/*
+Function: Compress
+Description: Compresses one block on its own: a complete gzip member
+             (header, deflate data, CRC and length) or a complete zstd
+             frame, so the blocks can simply be concatenated.
+Parameters: method - format to produce
+            level  - compression level
+            input  - uncompressed block
+            output - receives the compressed block
+Return: true on success
+*/
+bool ParallelCompressor::Compress(Method method, int level, const string& input, string& output)
+{
+    if (method == METHOD_ZSTD)
+    {
+#ifdef HAVE_ZSTD
+        output.resize(ZSTD_compressBound(input.size()));
+        size_t length = ZSTD_compress(&output[0], output.size(), input.data(), input.size(), level);
+        if (ZSTD_isError(length))
+        {
+            return false;
+        }
+        output.resize(length);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    wxMemoryOutputStream compressedStream;
+    {
+        wxZlibOutputStream zlib(compressedStream, level, wxZLIB_GZIP);
+        zlib.Write(input.data(), input.size());
+        if (!zlib.Close())
+        {
+            return false;
+        }
+    }
+    output.assign(compressedStream.GetLength(), '\0');
+    if (!output.empty())
+    {
+        compressedStream.CopyTo(&output[0], output.size());
+    }
+    return true;
+}
@@ -0,0 +1,89 @@
+/*
+Author: Guo Jia
+Description: Declaration of ParallelCompressor – compresses a byte stream
+             on all cores, pigz-style: the input is cut into fixed blocks,
+             each block becomes an independent gzip member (or zstd frame)
+             compressed on the thread pool, and the results are written to
+             the output in order.  Concatenated members are a valid .gz (or
+             .zst) file for any decompressor.  At most a fixed number of
+             blocks are in flight, which bounds the memory used.
+Date: 2026-10-18
+*/
+
+#ifndef PARALLELCOMPRESSOR_H
+#define PARALLELCOMPRESSOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class ThreadPool;
+
+class ParallelCompressor
+{
+public:
+    enum Method {
+        METHOD_GZIP,
+        METHOD_ZSTD    // only when built with HAVE_ZSTD
+    };
+
+    // Compressed data is written to the open descriptor 'out'.  'level'
+    // is the method's own compression level.
+    ParallelCompressor(int out, Method method, int level, ThreadPool& pool);
+    virtual ~ParallelCompressor();
+
+    ParallelCompressor(const ParallelCompressor&) = delete;
+    ParallelCompressor& operator=(const ParallelCompressor&) = delete;
+
+    // Whether this build can produce the method's format.
+    static bool IsAvailable(Method method);
+
+    // Append data to the stream.  Waits for the oldest block when too
+    // many are in flight.  Returns false once compressing or writing has
+    // failed.
+    bool Write(const char* data, std::size_t length);
+
+    // Compress what is buffered and wait until everything is written.
+    bool Finish();
+
+    std::uint64_t GetBytesIn() const { return m_bytesIn; }
+    std::uint64_t GetBytesOut() const { return m_bytesOut; }
+
+private:
+    static constexpr std::size_t BLOCK_SIZE = 1024 * 1024;
+
+    struct Block
+    {
+        std::string input;
+        std::string output;
+        bool        done   = false;
+        bool        failed = false;
+    };
+
+    int                                m_out;
+    Method                             m_method;
+    int                                m_level;
+    ThreadPool&                        m_pool;
+    std::size_t                        m_maxInFlight;   // twice the pool's threads
+    std::string                        m_current;       // block being filled
+    std::deque<std::shared_ptr<Block>> m_pending;       // submitted, in stream order
+    std::mutex                         m_mutex;
+    std::condition_variable            m_blockDone;
+    std::uint64_t                      m_bytesIn;
+    std::uint64_t                      m_bytesOut;
+    bool                               m_failed;
+
+    void SubmitCurrent();
+
+    // Write out finished blocks from the front of the queue, waiting for
+    // them while more than 'keep' are pending.
+    bool WriteFinished(std::size_t keep);
+
+    static bool Compress(Method method, int level, const std::string& input, std::string& output);
+};
+
+#endif // PARALLELCOMPRESSOR_H
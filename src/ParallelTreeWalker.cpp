@@ -0,0 +1,289 @@
+/*
+Author: Guo Jia
+Description: Implementation of ParallelTreeWalker.  Each task owns one
+             folder descriptor: it lists the folder with fdopendir(), stats
+             entries with fstatat(), and opens subfolders with openat() and
+             O_NOFOLLOW before handing them to new tasks.
+Date: 2026-10-18
+*/
+
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ParallelTreeWalker.h"
+#include "ThreadPool.h"
+#include "JobProgress.h"
+
+using namespace std;
+
+namespace
+{
+    // Progress messages are set once per this many entries.
+    const size_t MESSAGE_INTERVAL = 1024;
+
+    string ParentOf(const string& path)
+    {
+        size_t slash = path.find_last_of('/');
+        if (slash == string::npos)
+        {
+            return ".";
+        }
+        return slash == 0 ? string("/") : path.substr(0, slash);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: ParallelTreeWalker
+Description: Stores the pool the folder tasks run on.
+Parameters: pool - worker pool
+Return: None
+*/
+ParallelTreeWalker::ParallelTreeWalker(ThreadPool& pool)
+    : m_pool(pool),
+      m_visitor(nullptr),
+      m_mutex(),
+      m_idle(),
+      m_pendingTasks(0),
+      m_queuedFolders(0),
+      m_visited(0),
+      m_unreadable(0),
+      m_firstError()
+{
+}
+
+/*
+Function: ~ParallelTreeWalker
+Description: Nothing to release; Walk() waits for its tasks.
+Parameters: None
+Return: None
+*/
+ParallelTreeWalker::~ParallelTreeWalker()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Walking
+// ---------------------------------------------------------------------------
+
+/*
+Function: Walk
+Description: Stats and visits each root relative to its parent folder, then
+             queues the roots that are folders and waits until every task
+             has finished.  Trailing slashes on roots are ignored.
+Parameters: roots     - full paths of the entries to start from
+            recursive - whether to go below folders
+            visitor   - called for every entry
+            progress  - counts entries; polled for cancellation
+Return: false if the job was cancelled
+*/
+bool ParallelTreeWalker::Walk(const vector<string>& roots, bool recursive, const Visitor& visitor,
+                              JobProgress& progress)
+{
+    m_visitor    = &visitor;
+    m_visited    = 0;
+    m_unreadable = 0;
+    m_firstError.clear();
+
+    for (string root : roots)
+    {
+        while (root.size() > 1 && root.back() == '/')
+        {
+            root.pop_back();
+        }
+        string parentPath = ParentOf(root);
+        string name       = root.substr(root.find_last_of('/') == string::npos ? 0 : root.find_last_of('/') + 1);
+
+        int parent = ::open(parentPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        struct stat info;
+        if (parent < 0 || ::fstatat(parent, name.c_str(), &info, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+            Failed(root);
+            if (parent >= 0)
+            {
+                ::close(parent);
+            }
+            continue;
+        }
+
+        // Opened before the visitor can change its permissions.
+        int folder = -1;
+        if (recursive && S_ISDIR(info.st_mode))
+        {
+            folder = ::openat(parent, name.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (folder < 0)
+            {
+                Failed(root);
+            }
+        }
+        ++m_visited;
+        progress.Advance(1);
+        bool descend = visitor(parent, name.c_str(), root, info);
+        ::close(parent);
+
+        if (folder >= 0)
+        {
+            if (descend && !progress.IsCancelled())
+            {
+                Enqueue(folder, root, progress);
+            }
+            else
+            {
+                ::close(folder);
+            }
+        }
+    }
+
+    WaitForTasks();
+    m_visitor = nullptr;
+    return !progress.IsCancelled();
+}
+
+/*
+Function: Enqueue
+Description: Counts a pending task and queues the folder's walk, unless
+             MAX_QUEUED_FOLDERS descriptors are already waiting in the
+             queue, in which case the calling task walks it right away.
+Parameters: folder   - open folder descriptor (ownership passes on)
+            path     - its full path
+            progress - status/cancel sink
+Return: None
+*/
+void ParallelTreeWalker::Enqueue(int folder, const string& path, JobProgress& progress)
+{
+    if (++m_queuedFolders > MAX_QUEUED_FOLDERS)
+    {
+        --m_queuedFolders;
+        WalkFolder(folder, path, progress);
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        ++m_pendingTasks;
+    }
+    m_pool.Submit([this, folder, path, &progress]()
+    {
+        --m_queuedFolders;
+        WalkFolder(folder, path, progress);
+
+        lock_guard<mutex> lock(m_mutex);
+        if (--m_pendingTasks == 0)
+        {
+            m_idle.notify_all();
+        }
+    });
+}
+
+/*
+Function: WalkFolder
+Description: Lists one folder and visits its entries.  Subfolders are
+             opened before their visit and then queued.  A cancelled job
+             stops listing, closing what it holds.
+Parameters: folder   - open folder descriptor (closed here)
+            path     - its full path
+            progress - status/cancel sink
+Return: None
+*/
+void ParallelTreeWalker::WalkFolder(int folder, const string& path, JobProgress& progress)
+{
+    DIR* listing = ::fdopendir(folder);
+    if (listing == nullptr)
+    {
+        ::close(folder);
+        Failed(path);
+        return;
+    }
+
+    while (!progress.IsCancelled())
+    {
+        errno = 0;
+        struct dirent* entry = ::readdir(listing);
+        if (entry == nullptr)
+        {
+            if (errno != 0)
+            {
+                Failed(path);
+            }
+            break;
+        }
+        const char* name = entry->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+        {
+            continue;
+        }
+
+        struct stat info;
+        if (::fstatat(folder, name, &info, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+            continue;   // vanished between readdir and stat
+        }
+        string child = path == "/" ? "/" + string(name) : path + "/" + name;
+
+        if (m_visited++ % MESSAGE_INTERVAL == 0)
+        {
+            progress.SetMessage(child);
+        }
+        progress.Advance(1);
+
+        if (!S_ISDIR(info.st_mode))
+        {
+            (*m_visitor)(folder, name, child, info);
+            continue;
+        }
+
+        int subfolder = ::openat(folder, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (subfolder < 0)
+        {
+            Failed(child);
+        }
+        bool descend = (*m_visitor)(folder, name, child, info);
+        if (subfolder >= 0)
+        {
+            if (descend)
+            {
+                Enqueue(subfolder, child, progress);
+            }
+            else
+            {
+                ::close(subfolder);
+            }
+        }
+    }
+    ::closedir(listing);
+}
+
+/*
+Function: Failed
+Description: Counts a folder that could not be read and remembers the
+             first one for the report.
+Parameters: path - the folder
+Return: None
+*/
+void ParallelTreeWalker::Failed(const string& path)
+{
+    int error = errno;
+    ++m_unreadable;
+    lock_guard<mutex> lock(m_mutex);
+    if (m_firstError.empty())
+    {
+        m_firstError = "Cannot read " + path + ": " + strerror(error);
+    }
+}
+
+/*
+Function: WaitForTasks
+Description: Blocks until every queued folder task has finished.
+Parameters: None
+Return: None
+*/
+void ParallelTreeWalker::WaitForTasks()
+{
+    unique_lock<mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_pendingTasks == 0; });
+}
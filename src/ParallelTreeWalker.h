@@ -0,0 +1,82 @@
+/*
+Author: Guo Jia
+Description: Declaration of ParallelTreeWalker – visits every entry of one
+             or more trees from a thread pool.  Folders are opened relative
+             to their parent's descriptor (never following symbolic links)
+             and entries are handed to the visitor as (folder descriptor,
+             name), so per-entry calls such as fchmodat() never resolve a
+             path again.  Each folder is a separate task, so wide trees keep
+             every thread busy.
+Date: 2026-10-18
+*/
+
+#ifndef PARALLELTREEWALKER_H
+#define PARALLELTREEWALKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+class ThreadPool;
+class JobProgress;
+
+class ParallelTreeWalker
+{
+public:
+    // Called once per entry, concurrently from pool threads.  'folder' is
+    // the open parent folder, 'name' the entry in it, 'path' its full
+    // path, 'info' its lstat.  For a folder, returning false skips what is
+    // below it.
+    using Visitor = std::function<bool(int folder, const char* name, const std::string& path,
+                                       const struct stat& info)>;
+
+    explicit ParallelTreeWalker(ThreadPool& pool);
+    virtual ~ParallelTreeWalker();
+
+    ParallelTreeWalker(const ParallelTreeWalker&) = delete;
+    ParallelTreeWalker& operator=(const ParallelTreeWalker&) = delete;
+
+    // Visit each root and, if 'recursive', everything below it.  A folder
+    // is visited before its contents but opened before it is visited, so
+    // a visitor taking away its read permission does not stop the walk.
+    // Must not be called from a pool thread.  Returns false if cancelled;
+    // folders that could not be read are counted and the walk goes on.
+    bool Walk(const std::vector<std::string>& roots, bool recursive, const Visitor& visitor,
+              JobProgress& progress);
+
+    std::size_t        GetEntriesVisited() const { return m_visited; }
+    std::size_t        GetUnreadableFolders() const { return m_unreadable; }
+    const std::string& GetFirstError() const { return m_firstError; }
+
+private:
+    // Folders queued as tasks hold their descriptor open until they run;
+    // beyond this many, a folder is walked inline by the task that found it
+    // instead, which keeps descriptors bounded on very wide trees.
+    static constexpr int MAX_QUEUED_FOLDERS = 256;
+
+    ThreadPool&              m_pool;
+    const Visitor*           m_visitor;
+
+    std::mutex               m_mutex;
+    std::condition_variable  m_idle;
+    std::size_t              m_pendingTasks;
+    std::atomic<int>         m_queuedFolders;
+    std::atomic<std::size_t> m_visited;
+    std::atomic<std::size_t> m_unreadable;
+    std::string              m_firstError;
+
+    // Queue the walk of an opened folder, or do it inline if too many
+    // folders are queued.  Takes ownership of 'folder'.
+    void Enqueue(int folder, const std::string& path, JobProgress& progress);
+    void WalkFolder(int folder, const std::string& path, JobProgress& progress);
+
+    void Failed(const std::string& path);
+    void WaitForTasks();
+};
+
+#endif // PARALLELTREEWALKER_H
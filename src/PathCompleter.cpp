@@ -0,0 +1,274 @@
+/*
+Author: Guo Jia
+Description: Implementation of PathCompleter.  All trie access happens on
+             the GUI thread; worker threads only produce DirectoryListings,
+             which are handed back with CallAfter().
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <wx/log.h>
+#include "PathCompleter.h"
+#include "DirectoryListing.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+namespace
+{
+    // Enable with WXTRACE=completion to see per-keystroke timings.
+    const char* TRACE_MASK = "completion";
+
+    // Per-keystroke budget; slower completions are traced as such.
+    const long LATENCY_BUDGET_MICROS = 5000;
+
+    vector<string> DirectoryNames(const DirectoryListing& listing)
+    {
+        vector<string> names;
+        for (const DirectoryListing::Entry& entry : listing.GetEntries())
+        {
+            if (entry.isDirectory)
+            {
+                names.push_back(entry.name);
+            }
+        }
+        return names;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: PathCompleter
+Description: Attaches the completer to a text control.
+Parameters: textCtrl - the address bar
+            workers  - pool used for directory prefetching
+Return: None
+*/
+PathCompleter::PathCompleter(wxTextCtrl* textCtrl, ThreadPool& workers)
+    : m_textCtrl(textCtrl),
+      m_workers(workers),
+      m_trie(),
+      m_pending(),
+      m_suppressInline(false),
+      m_lastLatencyMicros(0),
+      m_worstLatencyMicros(0)
+{
+    m_textCtrl->Bind(wxEVT_KEY_DOWN, &PathCompleter::OnKeyDown, this);
+    m_textCtrl->Bind(wxEVT_TEXT,     &PathCompleter::OnText,    this);
+}
+
+/*
+Function: ~PathCompleter
+Description: Detaches from the text control.
+Parameters: None
+Return: None
+*/
+PathCompleter::~PathCompleter()
+{
+    m_textCtrl->Unbind(wxEVT_KEY_DOWN, &PathCompleter::OnKeyDown, this);
+    m_textCtrl->Unbind(wxEVT_TEXT,     &PathCompleter::OnText,    this);
+}
+
+/*
+Function: AddListing
+Description: Records the subdirectories of a listing in the trie.
+Parameters: listing - a directory listing the user has just seen
+Return: None
+*/
+void PathCompleter::AddListing(const DirectoryListing& listing)
+{
+    if (!listing.GetPath().empty())
+    {
+        m_trie.SetChildren(listing.GetPath(), DirectoryNames(listing));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Event handlers
+// ---------------------------------------------------------------------------
+
+/*
+Function: OnKeyDown
+Description: Tab accepts the current completion.  Backspace and Delete turn
+             inline completion off until the next ordinary key, otherwise
+             deleting the suggested part would immediately bring it back.
+Parameters: event - key event (skipped for everything but Tab)
+Return: None
+*/
+void PathCompleter::OnKeyDown(wxKeyEvent& event)
+{
+    int keyCode = event.GetKeyCode();
+    if (keyCode == WXK_TAB && event.GetModifiers() == wxMOD_NONE)
+    {
+        AcceptCompletion();
+        return;   // consumed: no focus change, no tab character
+    }
+
+    m_suppressInline = (keyCode == WXK_BACK || keyCode == WXK_DELETE);
+    event.Skip();
+}
+
+/*
+Function: OnText
+Description: Runs inline completion after each edit, but only while the
+             caret is at the end of the text.
+Parameters: event - text-changed event (skipped)
+Return: None
+*/
+void PathCompleter::OnText(wxCommandEvent& event)
+{
+    event.Skip();
+    if (m_suppressInline || m_textCtrl->GetInsertionPoint() != m_textCtrl->GetLastPosition())
+    {
+        return;
+    }
+    CompleteInline();
+}
+
+// ---------------------------------------------------------------------------
+// Completion
+// ---------------------------------------------------------------------------
+
+/*
+Function: CompleteInline
+Description: Looks the typed text up in the trie and, if the matches share
+             more than what was typed, appends the rest as a selection.
+             Uses ChangeValue() so the edit does not re-enter OnText().
+             Starts a prefetch when the directory is not yet known.  The
+             time taken is recorded and traced.
+Parameters: None
+Return: None
+*/
+void PathCompleter::CompleteInline()
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    wxString typed = m_textCtrl->GetValue();
+    string directory;
+    string prefix;
+    if (!SplitPath(typed.ToStdString(), directory, prefix))
+    {
+        return;
+    }
+
+    if (!m_trie.IsListed(directory))
+    {
+        Prefetch(directory);
+    }
+
+    vector<string> matches = m_trie.Complete(directory, prefix, MAX_CANDIDATES);
+    string common = PathTrie::CommonPrefix(matches);
+    if (common.size() > prefix.size())
+    {
+        wxString completed = typed + wxString(common.substr(prefix.size()));
+        m_textCtrl->ChangeValue(completed);
+        m_textCtrl->SetSelection(static_cast<long>(typed.length()), static_cast<long>(completed.length()));
+    }
+
+    m_lastLatencyMicros = static_cast<long>(
+        chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count());
+    m_worstLatencyMicros = max(m_worstLatencyMicros, m_lastLatencyMicros);
+    wxLogTrace(TRACE_MASK, "completion of \"%s\": %lu match(es) in %ld us%s",
+               typed, static_cast<unsigned long>(matches.size()), m_lastLatencyMicros,
+               m_lastLatencyMicros > LATENCY_BUDGET_MICROS ? " (over budget)" : "");
+}
+
+/*
+Function: AcceptCompletion
+Description: Moves the caret past any inline suggestion.  If the text then
+             names exactly one known subdirectory, a separator is appended
+             and completion continues one level down, shell-style.
+Parameters: None
+Return: None
+*/
+void PathCompleter::AcceptCompletion()
+{
+    m_textCtrl->SetInsertionPointEnd();
+
+    wxString typed = m_textCtrl->GetValue();
+    string directory;
+    string prefix;
+    if (!SplitPath(typed.ToStdString(), directory, prefix) || prefix.empty())
+    {
+        return;
+    }
+
+    vector<string> matches = m_trie.Complete(directory, prefix, 2);
+    if (matches.size() == 1 && matches.front() == prefix)
+    {
+        m_textCtrl->ChangeValue(typed + "/");
+        m_textCtrl->SetInsertionPointEnd();
+        CompleteInline();
+    }
+}
+
+/*
+Function: Prefetch
+Description: Lists a directory on the worker pool, at most once at a time
+             per directory.  When the result arrives the trie is updated
+             and, if the user is still typing inside that directory with the
+             caret at the end, completion is re-run.  Directories that
+             cannot be read are recorded as empty so they are not retried on
+             every keystroke.
+Parameters: directory - absolute directory path
+Return: None
+*/
+void PathCompleter::Prefetch(const string& directory)
+{
+    if (!m_pending.insert(directory).second)
+    {
+        return;   // already in flight
+    }
+
+    m_workers.Submit([this, directory]()
+    {
+        shared_ptr<DirectoryListing> listing = make_shared<DirectoryListing>();
+        listing->Load(directory);
+
+        m_textCtrl->CallAfter([this, directory, listing]()
+        {
+            m_pending.erase(directory);
+            m_trie.SetChildren(directory, DirectoryNames(*listing));
+
+            string typedDirectory;
+            string prefix;
+            long from = 0;
+            long to   = 0;
+            m_textCtrl->GetSelection(&from, &to);
+            if (SplitPath(m_textCtrl->GetValue().ToStdString(), typedDirectory, prefix) &&
+                typedDirectory == directory && from == to &&
+                m_textCtrl->GetInsertionPoint() == m_textCtrl->GetLastPosition() &&
+                !m_suppressInline)
+            {
+                CompleteInline();
+            }
+        });
+    });
+}
+
+/*
+Function: SplitPath
+Description: Splits typed text at its last separator into the directory to
+             complete in and the partial name.
+Parameters: text      - typed text
+            directory - receives everything up to and including the last '/'
+            prefix    - receives the rest
+Return: false if the text contains no separator
+*/
+bool PathCompleter::SplitPath(const string& text, string& directory, string& prefix)
+{
+    size_t separator = text.rfind('/');
+    if (separator == string::npos)
+    {
+        return false;
+    }
+    directory = text.substr(0, separator + 1);
+    prefix    = text.substr(separator + 1);
+    return true;
+}
@@ -0,0 +1,66 @@
+/*
+Author: Guo Jia
+Description: Declaration of PathCompleter – inline and Tab completion for a
+             path text control.  Suggestions come only from a PathTrie held
+             in memory; when the directory being typed is not known yet it
+             is listed on the worker pool and the suggestion appears once
+             the result arrives, so a keystroke never waits on the disk.
+Date: 2026-10-18
+*/
+
+#ifndef PATHCOMPLETER_H
+#define PATHCOMPLETER_H
+
+#include <set>
+#include <string>
+#include <wx/textctrl.h>
+#include "PathTrie.h"
+
+class ThreadPool;
+class DirectoryListing;
+
+class PathCompleter
+{
+public:
+    // Binds to textCtrl's key and text events.  The control should have
+    // the wxTE_PROCESS_TAB style so Tab reaches it.
+    PathCompleter(wxTextCtrl* textCtrl, ThreadPool& workers);
+    virtual ~PathCompleter();
+
+    // Feed a listing the user has seen (e.g. after navigating) into the
+    // trie, so completing below that directory needs no prefetch.
+    void AddListing(const DirectoryListing& listing);
+
+    // Time spent in the last / slowest completion, in microseconds.
+    long GetLastLatencyMicros() const { return m_lastLatencyMicros; }
+    long GetWorstLatencyMicros() const { return m_worstLatencyMicros; }
+
+private:
+    static constexpr std::size_t MAX_CANDIDATES = 256;
+
+    wxTextCtrl*           m_textCtrl;
+    ThreadPool&           m_workers;
+    PathTrie              m_trie;
+    std::set<std::string> m_pending;          // directories being listed
+    bool                  m_suppressInline;   // set while the user is deleting
+    long                  m_lastLatencyMicros;
+    long                  m_worstLatencyMicros;
+
+    void OnKeyDown(wxKeyEvent& event);
+    void OnText(wxCommandEvent& event);
+
+    // Extend the typed text with the common prefix of the matches and
+    // select the added part, so typing on simply replaces it.
+    void CompleteInline();
+
+    // Tab: accept the inline suggestion; a unique directory match also
+    // gets its trailing separator.
+    void AcceptCompletion();
+
+    void Prefetch(const std::string& directory);
+
+    // "/usr/lo" -> ("/usr/", "lo").  false for text without a separator.
+    static bool SplitPath(const std::string& text, std::string& directory, std::string& prefix);
+};
+
+#endif // PATHCOMPLETER_H
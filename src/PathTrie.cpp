@@ -0,0 +1,282 @@
+/*
+Author: Guo Jia
+Description: Implementation of PathTrie.  Children are kept in an ordered
+             map so a prefix query is one lower_bound plus a forward scan.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include "PathTrie.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: PathTrie
+Description: Creates an empty trie.
+Parameters: None
+Return: None
+*/
+PathTrie::PathTrie()
+    : m_root(),
+      m_nodeCount(0)
+{
+}
+
+/*
+Function: ~PathTrie
+Description: Destructor.  Nodes are released by their unique_ptrs.
+Parameters: None
+Return: None
+*/
+PathTrie::~PathTrie()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Updates
+// ---------------------------------------------------------------------------
+
+/*
+Function: SetChildren
+Description: Replaces the children of a directory with the given names,
+             moving over the subtrees of names that were already known.
+Parameters: directory - absolute directory path
+            names     - names of its subdirectories
+Return: None
+*/
+void PathTrie::SetChildren(const string& directory, const vector<string>& names)
+{
+    if (m_nodeCount + names.size() > MAX_NODES)
+    {
+        Clear();
+    }
+
+    Node* node = FindOrCreate(directory);
+    map<string, unique_ptr<Node>> children;
+    for (const string& name : names)
+    {
+        auto existing = node->children.find(name);
+        if (existing != node->children.end())
+        {
+            children[name] = move(existing->second);
+        }
+        else
+        {
+            children[name].reset(new Node());
+        }
+    }
+
+    // Whatever is left in the old map is being dropped.
+    for (const auto& child : node->children)
+    {
+        if (child.second)
+        {
+            m_nodeCount -= CountNodes(*child.second);
+        }
+    }
+    for (const auto& child : children)
+    {
+        if (node->children.find(child.first) == node->children.end())
+        {
+            ++m_nodeCount;
+        }
+    }
+
+    node->children.swap(children);
+    node->listed = true;
+}
+
+/*
+Function: Clear
+Description: Forgets everything.
+Parameters: None
+Return: None
+*/
+void PathTrie::Clear()
+{
+    m_root.children.clear();
+    m_root.listed = false;
+    m_nodeCount   = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Queries
+// ---------------------------------------------------------------------------
+
+/*
+Function: IsListed
+Description: Reports whether a directory's children are known.
+Parameters: directory - absolute directory path
+Return: true if SetChildren() has been called for it
+*/
+bool PathTrie::IsListed(const string& directory) const
+{
+    const Node* node = Find(directory);
+    return node != nullptr && node->listed;
+}
+
+/*
+Function: Complete
+Description: Collects the children of a directory that begin with a prefix.
+Parameters: directory  - absolute directory path
+            prefix     - typed start of the name
+            maxResults - cap on the number of names returned
+Return: Matching names, sorted
+*/
+vector<string> PathTrie::Complete(const string& directory, const string& prefix,
+                                  size_t maxResults) const
+{
+    vector<string> matches;
+    const Node* node = Find(directory);
+    if (node == nullptr)
+    {
+        return matches;
+    }
+
+    for (auto it = node->children.lower_bound(prefix);
+         it != node->children.end() && matches.size() < maxResults; ++it)
+    {
+        if (it->first.compare(0, prefix.size(), prefix) != 0)
+        {
+            break;
+        }
+        matches.push_back(it->first);
+    }
+    return matches;
+}
+
+/*
+Function: CommonPrefix
+Description: Longest prefix shared by all names.  The cut is moved back so it
+             never splits a multi-byte UTF-8 character.
+Parameters: names - candidate names
+Return: Common prefix ("" for an empty list)
+*/
+string PathTrie::CommonPrefix(const vector<string>& names)
+{
+    if (names.empty())
+    {
+        return "";
+    }
+
+    size_t length = names.front().size();
+    for (const string& name : names)
+    {
+        size_t i = 0;
+        size_t limit = min(length, name.size());
+        while (i < limit && name[i] == names.front()[i])
+        {
+            ++i;
+        }
+        length = i;
+    }
+
+    while (length > 0 && length < names.front().size() &&
+           (static_cast<unsigned char>(names.front()[length]) & 0xC0) == 0x80)
+    {
+        --length;
+    }
+    return names.front().substr(0, length);
+}
+
+// ---------------------------------------------------------------------------
+// Internal helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: Find
+Description: Walks the trie along a path's components.
+Parameters: directory - absolute directory path
+Return: The node, or nullptr if some component is unknown
+*/
+const PathTrie::Node* PathTrie::Find(const string& directory) const
+{
+    const Node* node = &m_root;
+    for (const string& component : SplitComponents(directory))
+    {
+        auto it = node->children.find(component);
+        if (it == node->children.end())
+        {
+            return nullptr;
+        }
+        node = it->second.get();
+    }
+    return node;
+}
+
+/*
+Function: FindOrCreate
+Description: Walks the trie along a path, creating missing nodes.
+Parameters: directory - absolute directory path
+Return: The node for the directory
+*/
+PathTrie::Node* PathTrie::FindOrCreate(const string& directory)
+{
+    Node* node = &m_root;
+    for (const string& component : SplitComponents(directory))
+    {
+        unique_ptr<Node>& child = node->children[component];
+        if (!child)
+        {
+            child.reset(new Node());
+            ++m_nodeCount;
+        }
+        node = child.get();
+    }
+    return node;
+}
+
+/*
+Function: CountNodes
+Description: Size of a subtree, used to keep m_nodeCount right on removal.
+Parameters: node - subtree root
+Return: Number of nodes including 'node'
+*/
+size_t PathTrie::CountNodes(const Node& node)
+{
+    size_t count = 1;
+    for (const auto& child : node.children)
+    {
+        if (child.second)
+        {
+            count += CountNodes(*child.second);
+        }
+    }
+    return count;
+}
+
+/*
+Function: SplitComponents
+Description: Splits a path on '/', dropping empty components, so "/a//b/"
+             and "/a/b" address the same node.  A leading '/' is kept as a
+             component of its own, so "a/b" never lands on "/a/b".
+Parameters: directory - directory path
+Return: Path components
+*/
+vector<string> PathTrie::SplitComponents(const string& directory)
+{
+    vector<string> components;
+    if (!directory.empty() && directory[0] == '/')
+    {
+        components.push_back("/");
+    }
+    size_t start = 0;
+    while (start <= directory.size())
+    {
+        size_t end = directory.find('/', start);
+        if (end == string::npos)
+        {
+            end = directory.size();
+        }
+        if (end > start)
+        {
+            components.push_back(directory.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return components;
+}
@@ -0,0 +1,68 @@
+/*
+Author: Guo Jia
+Description: Declaration of PathTrie – an in-memory tree of directory names
+             keyed by path component ("/home/user" is "/" → home → user;
+             a relative "home/user" is a different branch, home → user).
+             Answers "which subdirectories of X start with Y" without any
+             file-system access, so the address bar can complete paths on
+             every keystroke.  Not thread-safe; used on the GUI thread only.
+Date: 2026-10-18
+*/
+
+#ifndef PATHTRIE_H
+#define PATHTRIE_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class PathTrie
+{
+public:
+    PathTrie();
+    virtual ~PathTrie();
+
+    // Record the complete set of subdirectory names of 'directory'.
+    // Children not in 'names' are dropped; known grandchildren of the ones
+    // that remain are kept.
+    void SetChildren(const std::string& directory, const std::vector<std::string>& names);
+
+    // True once SetChildren() has been called for 'directory'.
+    bool IsListed(const std::string& directory) const;
+
+    // Up to maxResults subdirectory names of 'directory' starting with
+    // 'prefix', in sorted order.
+    std::vector<std::string> Complete(const std::string& directory, const std::string& prefix,
+                                      std::size_t maxResults) const;
+
+    std::size_t GetNodeCount() const { return m_nodeCount; }
+    void Clear();
+
+    // Longest common prefix of all strings, never ending inside a UTF-8
+    // sequence.
+    static std::string CommonPrefix(const std::vector<std::string>& names);
+
+private:
+    // Past this many names the trie is rebuilt from scratch; directories
+    // being typed are re-listed on demand anyway.
+    static constexpr std::size_t MAX_NODES = 200000;
+
+    struct Node
+    {
+        std::map<std::string, std::unique_ptr<Node>> children;
+        bool listed = false;
+    };
+
+    Node        m_root;
+    std::size_t m_nodeCount;
+
+    const Node* Find(const std::string& directory) const;
+    Node*       FindOrCreate(const std::string& directory);
+
+    static std::size_t CountNodes(const Node& node);
+    static std::vector<std::string> SplitComponents(const std::string& directory);
+};
+
+#endif // PATHTRIE_H
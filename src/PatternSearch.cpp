@@ -0,0 +1,273 @@
+/*
+Author: Guo Jia
+Description: Implementation of PatternSearch.  The SSE2 loop follows the
+             usual "first and last byte" filter: for 16 candidate starts at
+             once it compares the first pattern byte at each start and the
+             last pattern byte at each start + length - 1, and only starts
+             that pass both are compared in full.  Builds without SSE2 fall
+             back to memmem / memrchr.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "PatternSearch.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: PatternSearch
+Description: Default constructor.  All functionality is static.
+Parameters: None
+Return: None
+*/
+PatternSearch::PatternSearch()
+{
+}
+
+/*
+Function: ~PatternSearch
+Description: Destructor.  Nothing to release.
+Parameters: None
+Return: None
+*/
+PatternSearch::~PatternSearch()
+{
+}
+
+// ---------------------------------------------------------------------------
+// In-memory search
+// ---------------------------------------------------------------------------
+
+/*
+Function: FindForward
+Description: Scans the candidate starts from the front, 16 at a time where
+             SSE2 is available, then finishes the tail with memmem.
+Parameters: data          - buffer to search
+            length        - buffer length
+            pattern       - bytes to find
+            patternLength - pattern length
+Return: Pointer to the first match, or nullptr
+*/
+const char* PatternSearch::FindForward(const char* data, size_t length,
+                                       const char* pattern, size_t patternLength)
+{
+    if (patternLength == 0 || patternLength > length)
+    {
+        return nullptr;
+    }
+    if (patternLength == 1)
+    {
+        return static_cast<const char*>(memchr(data, pattern[0], length));
+    }
+
+    size_t starts = length - patternLength + 1;   // number of candidate starts
+    size_t i      = 0;
+
+#if defined(__SSE2__)
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last  = _mm_set1_epi8(pattern[patternLength - 1]);
+    for (; i + 16 <= starts; i += 16)
+    {
+        __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + patternLength - 1));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(tail, last))));
+        while (mask != 0)
+        {
+            size_t bit = static_cast<size_t>(__builtin_ctz(mask));
+            if (memcmp(data + i + bit + 1, pattern + 1, patternLength - 2) == 0)
+            {
+                return data + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    return static_cast<const char*>(memmem(data + i, length - i, pattern, patternLength));
+}
+
+/*
+Function: FindBackward
+Description: Mirror image of FindForward: blocks of 16 starts are taken
+             from the back and their candidates checked highest first; the
+             remaining head is searched with memrchr on the first byte.
+Parameters: data          - buffer to search
+            length        - buffer length
+            pattern       - bytes to find
+            patternLength - pattern length
+Return: Pointer to the last match, or nullptr
+*/
+const char* PatternSearch::FindBackward(const char* data, size_t length,
+                                        const char* pattern, size_t patternLength)
+{
+    if (patternLength == 0 || patternLength > length)
+    {
+        return nullptr;
+    }
+    if (patternLength == 1)
+    {
+        return static_cast<const char*>(memrchr(data, pattern[0], length));
+    }
+
+    size_t end = length - patternLength + 1;   // candidate starts are [0, end)
+
+#if defined(__SSE2__)
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last  = _mm_set1_epi8(pattern[patternLength - 1]);
+    while (end >= 16)
+    {
+        end -= 16;
+        __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + end));
+        __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + end + patternLength - 1));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(tail, last))));
+        while (mask != 0)
+        {
+            size_t bit = static_cast<size_t>(31 - __builtin_clz(mask));
+            if (memcmp(data + end + bit + 1, pattern + 1, patternLength - 2) == 0)
+            {
+                return data + end + bit;
+            }
+            mask &= ~(1u << bit);
+        }
+    }
+#endif
+
+    while (end > 0)
+    {
+        const char* hit = static_cast<const char*>(memrchr(data, pattern[0], end));
+        if (hit == nullptr)
+        {
+            return nullptr;
+        }
+        if (memcmp(hit, pattern, patternLength) == 0)
+        {
+            return hit;
+        }
+        end = static_cast<size_t>(hit - data);
+    }
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// File search
+// ---------------------------------------------------------------------------
+
+/*
+Function: FindInFile
+Description: Walks the file in CHUNK_SIZE steps of candidate starts, each
+             read through the MappedFile window together with the
+             patternLength - 1 bytes a match starting near its end needs.
+Parameters: file    - open file to search
+            pattern - bytes to find
+            from    - forward: first start considered;
+                      backward: starts before this are considered
+            forward - search direction
+            cancel  - checked between steps
+Return: Offset of the match, or NOT_FOUND
+*/
+uint64_t PatternSearch::FindInFile(MappedFile& file, const string& pattern,
+                                   uint64_t from, bool forward,
+                                   const atomic<bool>& cancel)
+{
+    uint64_t size          = file.GetSize();
+    size_t   patternLength = pattern.size();
+    if (patternLength == 0 || size < patternLength)
+    {
+        return NOT_FOUND;
+    }
+    uint64_t lastStart = size - patternLength;
+
+    if (forward)
+    {
+        for (uint64_t begin = from; begin <= lastStart && !cancel; )
+        {
+            size_t starts = static_cast<size_t>(min<uint64_t>(CHUNK_SIZE, lastStart - begin + 1));
+            size_t wanted = starts + patternLength - 1;
+            size_t available = 0;
+            const char* data = file.Read(begin, wanted, available);
+            if (data == nullptr || available < wanted)
+            {
+                return NOT_FOUND;
+            }
+            const char* hit = FindForward(data, wanted, pattern.data(), patternLength);
+            if (hit != nullptr)
+            {
+                return begin + static_cast<uint64_t>(hit - data);
+            }
+            begin += starts;
+        }
+        return NOT_FOUND;
+    }
+
+    for (uint64_t end = min(from, lastStart + 1); end > 0 && !cancel; )
+    {
+        size_t   starts = static_cast<size_t>(min<uint64_t>(CHUNK_SIZE, end));
+        uint64_t begin  = end - starts;
+        size_t   wanted = starts + patternLength - 1;
+        size_t   available = 0;
+        const char* data = file.Read(begin, wanted, available);
+        if (data == nullptr || available < wanted)
+        {
+            return NOT_FOUND;
+        }
+        const char* hit = FindBackward(data, wanted, pattern.data(), patternLength);
+        if (hit != nullptr)
+        {
+            return begin + static_cast<uint64_t>(hit - data);
+        }
+        end = begin;
+    }
+    return NOT_FOUND;
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: ParseHex
+Description: Converts hex digit pairs to bytes, ignoring spaces.
+Parameters: text  - user input
+            bytes - receives the bytes
+Return: true if the whole text was valid
+*/
+bool PatternSearch::ParseHex(const string& text, string& bytes)
+{
+    bytes.clear();
+    int high = -1;
+    for (char c : text)
+    {
+        if (c == ' ')
+        {
+            continue;
+        }
+        if (!isxdigit(static_cast<unsigned char>(c)))
+        {
+            return false;
+        }
+        int digit = isdigit(static_cast<unsigned char>(c)) ? c - '0'
+                                                           : tolower(static_cast<unsigned char>(c)) - 'a' + 10;
+        if (high < 0)
+        {
+            high = digit;
+        }
+        else
+        {
+            bytes += static_cast<char>((high << 4) | digit);
+            high = -1;
+        }
+    }
+    return high < 0 && !bytes.empty();
+}
@@ -0,0 +1,56 @@
+/*
+Author: Guo Jia
+Description: Declaration of PatternSearch – byte-pattern search in memory
+             buffers and in files of any size.  In-memory search compares
+             the pattern's first and last bytes against 16 positions at a
+             time with SSE2 and only verifies the candidates that match
+             both, which skips most of the input without a byte loop.
+             File search walks a MappedFile window by window in either
+             direction, so it needs no more memory than the window.
+Date: 2026-10-18
+*/
+
+#ifndef PATTERNSEARCH_H
+#define PATTERNSEARCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class MappedFile;
+
+class PatternSearch
+{
+public:
+    static constexpr std::uint64_t NOT_FOUND = UINT64_MAX;
+
+    PatternSearch();
+    virtual ~PatternSearch();
+
+    // First occurrence of the pattern in data[0, length), or nullptr.
+    static const char* FindForward(const char* data, std::size_t length,
+                                   const char* pattern, std::size_t patternLength);
+
+    // Last occurrence of the pattern in data[0, length), or nullptr.
+    static const char* FindBackward(const char* data, std::size_t length,
+                                    const char* pattern, std::size_t patternLength);
+
+    // Search an open file.  Forward finds the first match starting at or
+    // after 'from'; backward finds the last match starting before 'from'.
+    // Stops early (returning NOT_FOUND) once 'cancel' becomes true.
+    static std::uint64_t FindInFile(MappedFile& file, const std::string& pattern,
+                                    std::uint64_t from, bool forward,
+                                    const std::atomic<bool>& cancel);
+
+    // "de ad BE EF" / "deadbeef" -> the four bytes.  false if the text is
+    // empty, has an odd number of digits or anything but hex and spaces.
+    static bool ParseHex(const std::string& text, std::string& bytes);
+
+private:
+    // Bytes of the file searched per step; a match may straddle two steps,
+    // so each step reads patternLength - 1 bytes past its end.
+    static constexpr std::size_t CHUNK_SIZE = 4 * 1024 * 1024;
+};
+
+#endif // PATTERNSEARCH_H
@@ -0,0 +1,256 @@
+/*
+Author: Guo Jia
+Description: Implementation of PosixBackend.
+Date: 2026-10-18
+*/
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <pwd.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "PosixBackend.h"
+#include "CopyEngine.h"
+
+using namespace std;
+
+namespace
+{
+    // A file descriptor as a FileSystemBackend::File.
+    class PosixFile : public FileSystemBackend::File
+    {
+    public:
+        explicit PosixFile(int fd) : m_fd(fd) {}
+        ~PosixFile() override { ::close(m_fd); }
+
+        long Read(void* buffer, size_t size, uint64_t offset) override
+        {
+            return static_cast<long>(::pread(m_fd, buffer, size, static_cast<off_t>(offset)));
+        }
+
+        long Write(const void* buffer, size_t size, uint64_t offset) override
+        {
+            return static_cast<long>(::pwrite(m_fd, buffer, size, static_cast<off_t>(offset)));
+        }
+
+    private:
+        int m_fd;
+    };
+
+    void FillEntry(const char* name, const struct stat& info, DirectoryListing::Entry& entry)
+    {
+        entry.name        = name;
+        entry.isDirectory = S_ISDIR(info.st_mode);
+        entry.size        = entry.isDirectory ? 0 : static_cast<uint64_t>(info.st_size);
+        entry.modified    = static_cast<int64_t>(info.st_mtime);
+        entry.device      = static_cast<uint64_t>(info.st_dev);
+        entry.inode       = static_cast<uint64_t>(info.st_ino);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: PosixBackend
+Description: No state; every call goes straight to the system.
+Parameters: None
+Return: None
+*/
+PosixBackend::PosixBackend()
+{
+}
+
+/*
+Function: ~PosixBackend
+Description: Destructor.  No resources to release.
+Parameters: None
+Return: None
+*/
+PosixBackend::~PosixBackend()
+{
+}
+
+// ---------------------------------------------------------------------------
+// FileSystemBackend
+// ---------------------------------------------------------------------------
+
+/*
+Function: Enumerate
+Description: Reads every entry of a folder ('.' and '..' excluded) with one
+             fstatat per entry relative to the open folder.  Symlinks are
+             followed, so a link to a folder lists as a folder; a dangling
+             link falls back to the link itself.
+Parameters: folder  - folder to read
+            entries - receives the entries
+Return: true if the folder was read
+*/
+bool PosixBackend::Enumerate(const string& folder, vector<DirectoryListing::Entry>& entries)
+{
+    DIR* directory = opendir(folder.c_str());
+    if (directory == nullptr)
+    {
+        return false;
+    }
+    int directoryFd = dirfd(directory);
+
+    entries.clear();
+    while (struct dirent* item = readdir(directory))
+    {
+        if (strcmp(item->d_name, ".") == 0 || strcmp(item->d_name, "..") == 0)
+        {
+            continue;
+        }
+
+        struct stat info;
+        if (fstatat(directoryFd, item->d_name, &info, 0) != 0 &&
+            fstatat(directoryFd, item->d_name, &info, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+            continue;   // vanished between readdir and stat
+        }
+
+        DirectoryListing::Entry entry;
+        FillEntry(item->d_name, info, entry);
+        entries.push_back(move(entry));
+    }
+    closedir(directory);
+    return true;
+}
+
+/*
+Function: Stat
+Description: stat(2), or lstat(2) for a dangling link.
+Parameters: path  - entry to describe
+            entry - receives the description
+Return: true if the entry exists
+*/
+bool PosixBackend::Stat(const string& path, DirectoryListing::Entry& entry)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0 && lstat(path.c_str(), &info) != 0)
+    {
+        return false;
+    }
+    size_t slash = path.find_last_of('/');
+    FillEntry(slash == string::npos ? path.c_str() : path.c_str() + slash + 1, info, entry);
+    return true;
+}
+
+/*
+Function: LinkStat
+Description: lstat(2): a link is a non-folder entry of its own.
+Parameters: path  - entry to describe
+            entry - receives the description
+Return: true if the entry exists
+*/
+bool PosixBackend::LinkStat(const string& path, DirectoryListing::Entry& entry)
+{
+    struct stat info;
+    if (lstat(path.c_str(), &info) != 0)
+    {
+        return false;
+    }
+    size_t slash = path.find_last_of('/');
+    FillEntry(slash == string::npos ? path.c_str() : path.c_str() + slash + 1, info, entry);
+    return true;
+}
+
+/*
+Function: Open
+Description: Opens a file for reading, or creates / truncates it for
+             writing.
+Parameters: path  - the file
+            write - open for writing
+Return: The open file, or nullptr
+*/
+unique_ptr<FileSystemBackend::File> PosixBackend::Open(const string& path, bool write)
+{
+    int flags = write ? (O_WRONLY | O_CREAT | O_TRUNC) : O_RDONLY;
+    int fd    = ::open(path.c_str(), flags | O_CLOEXEC, 0666);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    return unique_ptr<File>(new PosixFile(fd));
+}
+
+/*
+Function: Copy
+Description: Copies with CopyEngine, without progress reporting.
+Parameters: from      - file or folder to copy
+            to        - destination
+            overwrite - replace existing files
+Return: true if everything was copied
+*/
+bool PosixBackend::Copy(const string& from, const string& to, bool overwrite)
+{
+    CopyEngine engine([](uint64_t /*bytes*/) { return true; });
+    return engine.Copy(from, to, overwrite);
+}
+
+/*
+Function: Rename
+Description: rename(2).
+Parameters: from - current path
+            to   - new path
+Return: true on success
+*/
+bool PosixBackend::Rename(const string& from, const string& to)
+{
+    return ::rename(from.c_str(), to.c_str()) == 0;
+}
+
+/*
+Function: Unlink
+Description: unlink(2) for files and links, rmdir(2) for folders.
+Parameters: path - entry to remove
+Return: true on success
+*/
+bool PosixBackend::Unlink(const string& path)
+{
+    struct stat info;
+    if (lstat(path.c_str(), &info) != 0)
+    {
+        return false;
+    }
+    return (S_ISDIR(info.st_mode) ? ::rmdir(path.c_str()) : ::unlink(path.c_str())) == 0;
+}
+
+/*
+Function: MakeDirectory
+Description: mkdir(2) with the default permissions (less the umask).
+Parameters: path - folder to create
+Return: true on success
+*/
+bool PosixBackend::MakeDirectory(const string& path)
+{
+    return ::mkdir(path.c_str(), 0777) == 0;
+}
+
+/*
+Function: HomePath
+Description: $HOME, else the password database's home folder, else "/".
+Parameters: None
+Return: The user's home folder
+*/
+string PosixBackend::HomePath() const
+{
+    const char* home = getenv("HOME");
+    if (home != nullptr && home[0] != '\0')
+    {
+        return home;
+    }
+
+    struct passwd  entry;
+    struct passwd* found = nullptr;
+    char buffer[4096];
+    if (getpwuid_r(getuid(), &entry, buffer, sizeof(buffer), &found) == 0 && found != nullptr)
+    {
+        return found->pw_dir;
+    }
+    return "/";
+}
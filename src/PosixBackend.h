@@ -0,0 +1,33 @@
+/*
+Author: Guo Jia
+Description: Declaration of PosixBackend – FileSystemBackend on the local
+             file systems: readdir plus fstatat relative to the open folder,
+             pread/pwrite, rename(2), unlink/rmdir, and CopyEngine for
+             copies.
+Date: 2026-10-18
+*/
+
+#ifndef POSIXBACKEND_H
+#define POSIXBACKEND_H
+
+#include "FileSystemBackend.h"
+
+class PosixBackend : public FileSystemBackend
+{
+public:
+    PosixBackend();
+    virtual ~PosixBackend();
+
+    bool Enumerate(const std::string& folder, std::vector<DirectoryListing::Entry>& entries) override;
+    bool Stat(const std::string& path, DirectoryListing::Entry& entry) override;
+    bool LinkStat(const std::string& path, DirectoryListing::Entry& entry) override;
+    std::unique_ptr<File> Open(const std::string& path, bool write) override;
+    bool Copy(const std::string& from, const std::string& to, bool overwrite) override;
+    bool Rename(const std::string& from, const std::string& to) override;
+    bool Unlink(const std::string& path) override;
+    bool MakeDirectory(const std::string& path) override;
+    bool IsLocal() const override { return true; }
+    std::string HomePath() const override;
+};
+
+#endif // POSIXBACKEND_H
@@ -0,0 +1,131 @@
+/*
+Author: Guo Jia
+Description: Implementation of ResponsivenessProbe.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include "ResponsivenessProbe.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: ResponsivenessProbe
+Description: Creates a stopped probe with no measurements.
+Parameters: None
+Return: None
+*/
+ResponsivenessProbe::ResponsivenessProbe()
+    : wxTimer(),
+      m_started(),
+      m_lastTick(),
+      m_ticked(false),
+      m_ticks(0),
+      m_stalls(0),
+      m_worst(0),
+      m_histogram(BUCKET_COUNT, 0)
+{
+}
+
+/*
+Function: ~ResponsivenessProbe
+Description: Stops the timer.
+Parameters: None
+Return: None
+*/
+ResponsivenessProbe::~ResponsivenessProbe()
+{
+    Stop();
+}
+
+// ---------------------------------------------------------------------------
+// Measuring
+// ---------------------------------------------------------------------------
+
+/*
+Function: Begin
+Description: Starts the periodic timer.
+Parameters: None
+Return: None
+*/
+void ResponsivenessProbe::Begin()
+{
+    m_started = Clock::now();
+    m_ticked  = false;
+    Start(TICK_MS);
+}
+
+/*
+Function: Notify
+Description: Called by the event loop on every tick.  The time since the
+             previous tick beyond TICK_MS is the delay the loop added.
+Parameters: None
+Return: None
+*/
+void ResponsivenessProbe::Notify()
+{
+    Clock::time_point now = Clock::now();
+    if (m_ticked)
+    {
+        long elapsed = static_cast<long>(chrono::duration_cast<chrono::milliseconds>(now - m_lastTick).count());
+        long delay   = max(0L, elapsed - TICK_MS);
+
+        ++m_ticks;
+        ++m_histogram[min<long>(delay / BUCKET_MS, BUCKET_COUNT - 1)];
+        m_worst = max(m_worst, delay);
+        if (delay >= STALL_MS)
+        {
+            ++m_stalls;
+        }
+    }
+    m_ticked   = true;
+    m_lastTick = now;
+}
+
+/*
+Function: GetReport
+Description: Summarises the measurements so far.
+Parameters: None
+Return: The summary
+*/
+string ResponsivenessProbe::GetReport() const
+{
+    double seconds = chrono::duration<double>(Clock::now() - m_started).count();
+    char report[256];
+    snprintf(report, sizeof(report),
+             "Responsiveness: %lu ticks in %.1f s; event delay median %ld ms, 99%% %ld ms, worst %ld ms; "
+             "%lu stall(s) of %d ms or more",
+             m_ticks, seconds, Percentile(0.5), Percentile(0.99), m_worst, m_stalls, STALL_MS);
+    return report;
+}
+
+/*
+Function: Percentile
+Description: Walks the histogram up to the bucket holding the given share
+             of the ticks and returns that bucket's upper end.
+Parameters: fraction - 0.5 for the median, 0.99 for the 99th percentile
+Return: Milliseconds (0 before any tick)
+*/
+long ResponsivenessProbe::Percentile(double fraction) const
+{
+    if (m_ticks == 0)
+    {
+        return 0;
+    }
+    unsigned long wanted = static_cast<unsigned long>(fraction * static_cast<double>(m_ticks));
+    unsigned long seen   = 0;
+    for (int bucket = 0; bucket < BUCKET_COUNT; ++bucket)
+    {
+        seen += m_histogram[bucket];
+        if (seen > wanted || bucket == BUCKET_COUNT - 1)
+        {
+            return bucket == BUCKET_COUNT - 1 ? m_worst : static_cast<long>(bucket + 1) * BUCKET_MS;
+        }
+    }
+    return m_worst;
+}
@@ -0,0 +1,63 @@
+/*
+Author: Guo Jia
+Description: Declaration of ResponsivenessProbe – measures how promptly the
+             GUI thread handles events.  A timer asks to be woken every few
+             milliseconds; how late each wake-up comes is how long the event
+             loop was busy, i.e. how long a click or keystroke would have
+             waited.  Started with --probe, it reports when the application
+             exits, so a run against a slow backend shows whether the window
+             stayed responsive.
+Date: 2026-10-18
+*/
+
+#ifndef RESPONSIVENESSPROBE_H
+#define RESPONSIVENESSPROBE_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <wx/timer.h>
+
+class ResponsivenessProbe : public wxTimer
+{
+public:
+    ResponsivenessProbe();
+    virtual ~ResponsivenessProbe();
+
+    // Start measuring; the first tick sets the baseline.
+    void Begin();
+
+    // One line: ticks, median / 99th percentile / worst delay, stalls.
+    std::string GetReport() const;
+
+    long GetWorstMillis() const { return m_worst; }
+
+protected:
+    void Notify() override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // How often the timer fires, and how late a tick must be to count as
+    // a stall the user would notice.
+    static constexpr int TICK_MS  = 20;
+    static constexpr int STALL_MS = 100;
+
+    // Delays are counted in buckets of this many milliseconds; the last
+    // bucket takes everything longer.
+    static constexpr int BUCKET_MS    = 5;
+    static constexpr int BUCKET_COUNT = 401;
+
+    Clock::time_point          m_started;
+    Clock::time_point          m_lastTick;
+    bool                       m_ticked;
+    unsigned long              m_ticks;
+    unsigned long              m_stalls;
+    long                       m_worst;       // milliseconds
+    std::vector<unsigned long> m_histogram;   // BUCKET_COUNT buckets
+
+    // Smallest delay at least 'fraction' of the ticks stayed within.
+    long Percentile(double fraction) const;
+};
+
+#endif // RESPONSIVENESSPROBE_H
@@ -0,0 +1,91 @@
+/*
+Author: Guo Jia
+Description: Implementation of RollingChecksum.  Both halves are kept modulo
+             2^16 by masking in Digest(); unsigned wrap-around in between is
+             harmless because only the low 16 bits are ever observed.
+Date: 2026-10-18
+*/
+
+#include "RollingChecksum.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: RollingChecksum
+Description: Creates a checksum over an empty window.
+Parameters: None
+Return: None
+*/
+RollingChecksum::RollingChecksum()
+    : m_a(0),
+      m_b(0),
+      m_length(0)
+{
+}
+
+/*
+Function: ~RollingChecksum
+Description: Destructor.  No resources to release.
+Parameters: None
+Return: None
+*/
+RollingChecksum::~RollingChecksum()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Window handling
+// ---------------------------------------------------------------------------
+
+/*
+Function: Reset
+Description: Computes a = sum(x[i]) and b = sum((length - i) * x[i]) over a
+             fresh window.
+Parameters: data   - first byte of the window
+            length - window length in bytes
+Return: None
+*/
+void RollingChecksum::Reset(const unsigned char* data, size_t length)
+{
+    m_a = 0;
+    m_b = 0;
+    m_length = length;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        m_a += data[i];
+        m_b += static_cast<uint32_t>(length - i) * data[i];
+    }
+}
+
+/*
+Function: Roll
+Description: Removes the outgoing byte's contribution from both sums and
+             adds the incoming byte, moving the window one byte forward.
+Parameters: outgoing - byte leaving the window
+            incoming - byte entering the window
+Return: None
+*/
+void RollingChecksum::Roll(unsigned char outgoing, unsigned char incoming)
+{
+    m_a = m_a - outgoing + incoming;
+    m_b = m_b - static_cast<uint32_t>(m_length) * outgoing + m_a;
+}
+
+/*
+Function: Compute
+Description: One-shot checksum of a block.
+Parameters: data   - block start
+            length - block length
+Return: 32-bit weak checksum
+*/
+uint32_t RollingChecksum::Compute(const unsigned char* data, size_t length)
+{
+    RollingChecksum checksum;
+    checksum.Reset(data, length);
+    return checksum.Digest();
+}
@@ -0,0 +1,41 @@
+/*
+Author: Guo Jia
+Description: Declaration of RollingChecksum – the rsync weak checksum, which
+             can slide its window forward by one byte in O(1).  Used by
+             DeltaCopier to find blocks of the old file inside the new one
+             at any byte offset.
+Date: 2026-10-18
+*/
+
+#ifndef ROLLINGCHECKSUM_H
+#define ROLLINGCHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+
+class RollingChecksum
+{
+public:
+    RollingChecksum();
+    virtual ~RollingChecksum();
+
+    // Start a new window covering data[0, length).
+    void Reset(const unsigned char* data, std::size_t length);
+
+    // Slide the window one byte: 'outgoing' leaves at the front and
+    // 'incoming' joins at the back.  The window length is unchanged.
+    void Roll(unsigned char outgoing, unsigned char incoming);
+
+    // 32-bit checksum of the current window.
+    std::uint32_t Digest() const { return (m_a & 0xFFFF) | (m_b << 16); }
+
+    // One-shot checksum of a block.
+    static std::uint32_t Compute(const unsigned char* data, std::size_t length);
+
+private:
+    std::uint32_t m_a;        // sum of the bytes
+    std::uint32_t m_b;        // sum of the running a values
+    std::size_t   m_length;   // window length
+};
+
+#endif // ROLLINGCHECKSUM_H
@@ -0,0 +1,752 @@
+/*
+Author: Guo Jia
+Description: Implementation of SimulatedBackend.  Nodes are kept in one map
+             by full path, each folder also listing its children's names.
+             Latency is slept outside the lock, so concurrent calls overlap
+             the way they do on a real mount.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include "SimulatedBackend.h"
+
+using namespace std;
+
+namespace
+{
+    // Extensions Populate() gives its files in turn, so type filters and
+    // icons have something to work with.
+    const char* const EXTENSIONS[] = { ".txt", ".jpg", ".pdf", ".cpp", ".dat" };
+
+    // Times of populated entries count back from here, one hour apart.
+    const int64_t POPULATE_EPOCH = 1760000000;
+
+    int64_t Now()
+    {
+        return static_cast<int64_t>(time(nullptr));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Nested types
+// ---------------------------------------------------------------------------
+
+// A path in the tree opened as a file.  Reads and writes look the node up
+// again each time, so a file removed while open reads as ENOENT.
+class SimulatedBackend::SimulatedFile : public FileSystemBackend::File
+{
+public:
+    SimulatedFile(SimulatedBackend& backend, const string& path) : m_backend(backend), m_path(path) {}
+
+    long Read(void* buffer, size_t size, uint64_t offset) override
+    {
+        if (!m_backend.Delay(CALL_READ))
+        {
+            return -1;
+        }
+        lock_guard<mutex> lock(m_backend.m_mutex);
+        Node* node = m_backend.Find(m_path);
+        if (node == nullptr)
+        {
+            errno = ENOENT;
+            return -1;
+        }
+        if (offset >= node->size)
+        {
+            return 0;
+        }
+        size_t count = static_cast<size_t>(min<uint64_t>(size, node->size - offset));
+        // Bytes past the stored data are zeros, as in a sparse file.
+        memset(buffer, 0, count);
+        if (offset < node->data.size())
+        {
+            memcpy(buffer, node->data.data() + offset,
+                   min<size_t>(count, node->data.size() - static_cast<size_t>(offset)));
+        }
+        return static_cast<long>(count);
+    }
+
+    long Write(const void* buffer, size_t size, uint64_t offset) override
+    {
+        if (!m_backend.Delay(CALL_WRITE))
+        {
+            return -1;
+        }
+        lock_guard<mutex> lock(m_backend.m_mutex);
+        Node* node = m_backend.Find(m_path);
+        if (node == nullptr)
+        {
+            errno = ENOENT;
+            return -1;
+        }
+        size_t end = static_cast<size_t>(offset) + size;
+        if (node->data.size() < end)
+        {
+            node->data.resize(end, '\0');
+        }
+        memcpy(&node->data[static_cast<size_t>(offset)], buffer, size);
+        node->size     = max<uint64_t>(node->size, end);
+        node->modified = Now();
+        return static_cast<long>(size);
+    }
+
+private:
+    SimulatedBackend& m_backend;
+    string            m_path;
+};
+
+/*
+Function: Profile::Profile
+Description: Default profile: instant and never failing.
+Parameters: None
+Return: None
+*/
+SimulatedBackend::Profile::Profile()
+    : latencyMillis(0),
+      jitterMillis(0),
+      failureRate(0)
+{
+}
+
+/*
+Function: Node::Node
+Description: An empty file.
+Parameters: None
+Return: None
+*/
+SimulatedBackend::Node::Node()
+    : isDirectory(false),
+      size(0),
+      data(),
+      modified(0),
+      inode(0),
+      children()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: SimulatedBackend
+Description: Starts with an empty root folder and instant calls.
+Parameters: None
+Return: None
+*/
+SimulatedBackend::SimulatedBackend()
+    : m_profiles(),
+      m_calls(),
+      m_random(),
+      m_nextInode(2),
+      m_mutex(),
+      m_nodes()
+{
+    for (atomic<uint64_t>& calls : m_calls)
+    {
+        calls = 0;
+    }
+    Node root;
+    root.isDirectory = true;
+    root.modified    = Now();
+    root.inode       = 1;
+    m_nodes["/"]     = root;
+}
+
+/*
+Function: ~SimulatedBackend
+Description: Destructor.  Open files must not outlive the backend.
+Parameters: None
+Return: None
+*/
+SimulatedBackend::~SimulatedBackend()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Configuration
+// ---------------------------------------------------------------------------
+
+/*
+Function: SetProfile
+Description: Uses one profile for every kind of call.
+Parameters: profile - latency, jitter and failure rate
+Return: None
+*/
+void SimulatedBackend::SetProfile(const Profile& profile)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_profiles.fill(profile);
+}
+
+/*
+Function: SetProfile
+Description: Sets the profile of one kind of call.
+Parameters: call    - which call
+            profile - latency, jitter and failure rate
+Return: None
+*/
+void SimulatedBackend::SetProfile(Call call, const Profile& profile)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_profiles[call] = profile;
+}
+
+/*
+Function: Populate
+Description: Generates a tree; see the header.  Existing entries with the
+             generated names are left alone.
+Parameters: root    - folder to fill (must exist)
+            folders - folders per level
+            files   - files per folder
+            depth   - levels of folders
+Return: None
+*/
+void SimulatedBackend::Populate(const string& root, size_t folders, size_t files, unsigned int depth)
+{
+    lock_guard<mutex> lock(m_mutex);
+    PopulateFolder(Normalise(root), folders, files, depth);
+}
+
+// ---------------------------------------------------------------------------
+// FileSystemBackend
+// ---------------------------------------------------------------------------
+
+/*
+Function: Enumerate
+Description: One enumerate delay for the listing, then one stat delay per
+             entry; entries whose stat fails are left out, as Posix does
+             with entries that vanish.
+Parameters: folder  - folder to read
+            entries - receives the entries
+Return: true if the folder was read
+*/
+bool SimulatedBackend::Enumerate(const string& folder, vector<DirectoryListing::Entry>& entries)
+{
+    if (!Delay(CALL_ENUMERATE))
+    {
+        return false;
+    }
+
+    vector<DirectoryListing::Entry> found;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        string path = Normalise(folder);
+        Node*  node = Find(path);
+        if (node == nullptr || !node->isDirectory)
+        {
+            errno = node == nullptr ? ENOENT : ENOTDIR;
+            return false;
+        }
+        found.reserve(node->children.size());
+        for (const string& name : node->children)
+        {
+            found.push_back(Describe(name, m_nodes[Join(path, name)]));
+        }
+    }
+
+    entries.clear();
+    entries.reserve(found.size());
+    for (DirectoryListing::Entry& entry : found)
+    {
+        if (Delay(CALL_STAT))
+        {
+            entries.push_back(move(entry));
+        }
+    }
+    return true;
+}
+
+/*
+Function: Stat
+Description: Describes one entry.
+Parameters: path  - entry to describe
+            entry - receives the description
+Return: true if the entry exists
+*/
+bool SimulatedBackend::Stat(const string& path, DirectoryListing::Entry& entry)
+{
+    if (!Delay(CALL_STAT))
+    {
+        return false;
+    }
+    lock_guard<mutex> lock(m_mutex);
+    string normalised = Normalise(path);
+    Node*  node       = Find(normalised);
+    if (node == nullptr)
+    {
+        errno = ENOENT;
+        return false;
+    }
+    entry = Describe(NameOf(normalised), *node);
+    return true;
+}
+
+/*
+Function: LinkStat
+Description: Same as Stat(): the simulated tree holds no links.  Costs a
+             stat call.
+Parameters: path  - entry to describe
+            entry - receives the description
+Return: true if the entry exists
+*/
+bool SimulatedBackend::LinkStat(const string& path, DirectoryListing::Entry& entry)
+{
+    return Stat(path, entry);
+}
+
+/*
+Function: Open
+Description: Opens a file for reading, or creates / truncates it for
+             writing.
+Parameters: path  - the file
+            write - open for writing
+Return: The open file, or nullptr
+*/
+unique_ptr<FileSystemBackend::File> SimulatedBackend::Open(const string& path, bool write)
+{
+    if (!Delay(CALL_OPEN))
+    {
+        return nullptr;
+    }
+    lock_guard<mutex> lock(m_mutex);
+    string normalised = Normalise(path);
+    Node*  node       = Find(normalised);
+    if (node == nullptr)
+    {
+        if (!write || !AddNode(normalised, false, 0, Now()))
+        {
+            if (!write)
+            {
+                errno = ENOENT;
+            }
+            return nullptr;
+        }
+        node = Find(normalised);
+    }
+    if (node->isDirectory)
+    {
+        errno = EISDIR;
+        return nullptr;
+    }
+    if (write)
+    {
+        node->data.clear();
+        node->size     = 0;
+        node->modified = Now();
+    }
+    return unique_ptr<File>(new SimulatedFile(*this, normalised));
+}
+
+/*
+Function: Copy
+Description: Copies a file or folder tree as one call.  With 'overwrite'
+             an existing destination is replaced as a whole.
+Parameters: from      - entry to copy
+            to        - destination
+            overwrite - replace an existing destination
+Return: true on success
+*/
+bool SimulatedBackend::Copy(const string& from, const string& to, bool overwrite)
+{
+    if (!Delay(CALL_COPY))
+    {
+        return false;
+    }
+    lock_guard<mutex> lock(m_mutex);
+    string source      = Normalise(from);
+    string destination = Normalise(to);
+    if (Find(source) == nullptr)
+    {
+        errno = ENOENT;
+        return false;
+    }
+    if (destination == source || destination.compare(0, source.size() + 1, source + "/") == 0)
+    {
+        errno = EINVAL;
+        return false;
+    }
+    if (Find(destination) != nullptr)
+    {
+        if (!overwrite || destination == "/")
+        {
+            errno = EEXIST;
+            return false;
+        }
+        RemoveTree(destination);
+    }
+    return CopyTree(source, destination);
+}
+
+/*
+Function: Rename
+Description: Moves an entry and everything under it.  An existing
+             destination is replaced if it is a file, or an empty folder
+             replaced by a folder, as rename(2) does.
+Parameters: from - current path
+            to   - new path
+Return: true on success
+*/
+bool SimulatedBackend::Rename(const string& from, const string& to)
+{
+    if (!Delay(CALL_RENAME))
+    {
+        return false;
+    }
+    lock_guard<mutex> lock(m_mutex);
+    string source      = Normalise(from);
+    string destination = Normalise(to);
+    Node*  node        = Find(source);
+    if (node == nullptr || source == "/")
+    {
+        errno = node == nullptr ? ENOENT : EBUSY;
+        return false;
+    }
+    if (destination == source)
+    {
+        return true;
+    }
+    if (destination.compare(0, source.size() + 1, source + "/") == 0)
+    {
+        errno = EINVAL;
+        return false;
+    }
+    Node* parent = Find(ParentOf(destination));
+    if (parent == nullptr || !parent->isDirectory)
+    {
+        errno = parent == nullptr ? ENOENT : ENOTDIR;
+        return false;
+    }
+    if (Node* existing = Find(destination))
+    {
+        if (existing->isDirectory != node->isDirectory)
+        {
+            errno = existing->isDirectory ? EISDIR : ENOTDIR;
+            return false;
+        }
+        if (!existing->children.empty())
+        {
+            errno = ENOTEMPTY;
+            return false;
+        }
+        RemoveTree(destination);
+    }
+
+    // Re-key the entry and everything below it.
+    string prefix = source + "/";
+    vector<string> moved { source };
+    for (auto it = m_nodes.lower_bound(prefix); it != m_nodes.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+    {
+        moved.push_back(it->first);
+    }
+    for (const string& path : moved)
+    {
+        auto it = m_nodes.find(path);
+        Node moving = move(it->second);
+        m_nodes.erase(it);
+        m_nodes[destination + path.substr(source.size())] = move(moving);
+    }
+    m_nodes[ParentOf(source)].children.erase(NameOf(source));
+    m_nodes[ParentOf(destination)].children.insert(NameOf(destination));
+    return true;
+}
+
+/*
+Function: Unlink
+Description: Removes a file or an empty folder.
+Parameters: path - entry to remove
+Return: true on success
+*/
+bool SimulatedBackend::Unlink(const string& path)
+{
+    if (!Delay(CALL_UNLINK))
+    {
+        return false;
+    }
+    lock_guard<mutex> lock(m_mutex);
+    string normalised = Normalise(path);
+    Node*  node       = Find(normalised);
+    if (node == nullptr || normalised == "/")
+    {
+        errno = node == nullptr ? ENOENT : EBUSY;
+        return false;
+    }
+    if (!node->children.empty())
+    {
+        errno = ENOTEMPTY;
+        return false;
+    }
+    RemoveTree(normalised);
+    return true;
+}
+
+/*
+Function: MakeDirectory
+Description: Creates an empty folder in an existing one.
+Parameters: path - folder to create
+Return: true on success
+*/
+bool SimulatedBackend::MakeDirectory(const string& path)
+{
+    if (!Delay(CALL_MAKE_DIRECTORY))
+    {
+        return false;
+    }
+    lock_guard<mutex> lock(m_mutex);
+    return AddNode(Normalise(path), true, 0, Now());
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: Delay
+Description: Counts the call, draws its latency and whether it fails under
+             the lock, then sleeps without it.
+Parameters: call - kind of call
+Return: false with errno = EIO if the call is to fail
+*/
+bool SimulatedBackend::Delay(Call call)
+{
+    ++m_calls[call];
+
+    unsigned int millis = 0;
+    bool         fail   = false;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        const Profile& profile = m_profiles[call];
+        millis = profile.latencyMillis;
+        if (profile.jitterMillis > 0)
+        {
+            millis += uniform_int_distribution<unsigned int>(0, profile.jitterMillis)(m_random);
+        }
+        fail = profile.failureRate > 0 && uniform_real_distribution<double>(0, 1)(m_random) < profile.failureRate;
+    }
+
+    if (millis > 0)
+    {
+        this_thread::sleep_for(chrono::milliseconds(millis));
+    }
+    if (fail)
+    {
+        errno = EIO;
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: Find
+Description: Looks up a normalised path.
+Parameters: path - the path
+Return: The node, or nullptr
+*/
+SimulatedBackend::Node* SimulatedBackend::Find(const string& path)
+{
+    auto it = m_nodes.find(path);
+    return it == m_nodes.end() ? nullptr : &it->second;
+}
+
+/*
+Function: AddNode
+Description: Adds a file (of 'size' zero bytes) or an empty folder to an
+             existing folder.
+Parameters: path        - normalised path of the new entry
+            isDirectory - folder or file
+            size        - file size
+            modified    - modification time
+Return: false with errno set if it exists or its parent does not
+*/
+bool SimulatedBackend::AddNode(const string& path, bool isDirectory, uint64_t size, int64_t modified)
+{
+    if (Find(path) != nullptr)
+    {
+        errno = EEXIST;
+        return false;
+    }
+    Node* parent = Find(ParentOf(path));
+    if (parent == nullptr || !parent->isDirectory)
+    {
+        errno = parent == nullptr ? ENOENT : ENOTDIR;
+        return false;
+    }
+    parent->children.insert(NameOf(path));
+
+    Node node;
+    node.isDirectory = isDirectory;
+    node.size        = isDirectory ? 0 : size;
+    node.modified    = modified;
+    node.inode       = m_nextInode++;
+    m_nodes[path]    = move(node);
+    return true;
+}
+
+/*
+Function: PopulateFolder
+Description: Fills one folder for Populate() and recurses into the folders
+             it adds.
+Parameters: folder  - normalised path of the folder
+            folders - folders per level
+            files   - files per folder
+            depth   - levels of folders still to add
+Return: None
+*/
+void SimulatedBackend::PopulateFolder(const string& folder, size_t folders, size_t files, unsigned int depth)
+{
+    for (size_t index = 0; index < files; ++index)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "file-%04zu%s", index + 1,
+                 EXTENSIONS[index % (sizeof(EXTENSIONS) / sizeof(EXTENSIONS[0]))]);
+        uint64_t size = (index * 7919 % 1000) * 1024 + index;
+        AddNode(Join(folder, name), false, size, POPULATE_EPOCH - static_cast<int64_t>(index) * 3600);
+    }
+    if (depth == 0)
+    {
+        return;
+    }
+
+    for (size_t index = 0; index < folders; ++index)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "folder-%02zu", index + 1);
+        string path = Join(folder, name);
+        if (AddNode(path, true, 0, POPULATE_EPOCH - static_cast<int64_t>(index) * 3600))
+        {
+            PopulateFolder(path, folders, files, depth - 1);
+        }
+    }
+}
+
+/*
+Function: RemoveTree
+Description: Removes an entry and everything below it.
+Parameters: path - normalised path (not the root)
+Return: None
+*/
+void SimulatedBackend::RemoveTree(const string& path)
+{
+    string prefix = path + "/";
+    m_nodes.erase(m_nodes.lower_bound(prefix),
+                  find_if(m_nodes.lower_bound(prefix), m_nodes.end(),
+                          [&prefix](const pair<const string, Node>& node)
+                          {
+                              return node.first.compare(0, prefix.size(), prefix) != 0;
+                          }));
+    m_nodes.erase(path);
+    Node* parent = Find(ParentOf(path));
+    if (parent != nullptr)
+    {
+        parent->children.erase(NameOf(path));
+    }
+}
+
+/*
+Function: CopyTree
+Description: Copies an entry and everything below it; copies get new
+             inodes.
+Parameters: from - existing normalised path
+            to   - free normalised path
+Return: false with errno set if the destination's parent is missing
+*/
+bool SimulatedBackend::CopyTree(const string& from, const string& to)
+{
+    const Node source = m_nodes[from];
+    if (!AddNode(to, source.isDirectory, source.size, source.modified))
+    {
+        return false;
+    }
+    m_nodes[to].data = source.data;
+    for (const string& name : source.children)
+    {
+        if (!CopyTree(Join(from, name), Join(to, name)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+Function: Describe
+Description: A node as a listing entry.
+Parameters: name - entry name
+            node - the node
+Return: The entry
+*/
+DirectoryListing::Entry SimulatedBackend::Describe(const string& name, const Node& node) const
+{
+    DirectoryListing::Entry entry;
+    entry.name        = name;
+    entry.isDirectory = node.isDirectory;
+    entry.size        = node.size;
+    entry.modified    = node.modified;
+    entry.device      = DEVICE;
+    entry.inode       = node.inode;
+    return entry;
+}
+
+/*
+Function: Normalise
+Description: Makes a path absolute, without repeated or trailing slashes.
+Parameters: path - path as given
+Return: The key it is stored under
+*/
+string SimulatedBackend::Normalise(const string& path)
+{
+    string normalised = "/";
+    for (char c : path)
+    {
+        if (c != '/' || normalised.back() != '/')
+        {
+            normalised += c;
+        }
+    }
+    if (normalised.size() > 1 && normalised.back() == '/')
+    {
+        normalised.pop_back();
+    }
+    return normalised;
+}
+
+/*
+Function: ParentOf
+Description: The folder a normalised path is in.
+Parameters: path - normalised path
+Return: Its parent ("/" for the root)
+*/
+string SimulatedBackend::ParentOf(const string& path)
+{
+    size_t slash = path.find_last_of('/');
+    return slash == 0 || slash == string::npos ? string("/") : path.substr(0, slash);
+}
+
+/*
+Function: NameOf
+Description: The last component of a normalised path.
+Parameters: path - normalised path
+Return: Its name
+*/
+string SimulatedBackend::NameOf(const string& path)
+{
+    return path.substr(path.find_last_of('/') + 1);
+}
+
+/*
+Function: Join
+Description: Appends a name to a normalised folder path.
+Parameters: folder - folder
+            name   - entry name
+Return: The entry's path
+*/
+string SimulatedBackend::Join(const string& folder, const string& name)
+{
+    return folder == "/" ? "/" + name : folder + "/" + name;
+}
@@ -0,0 +1,122 @@
+/*
+Author: Guo Jia
+Description: Declaration of SimulatedBackend – a FileSystemBackend holding
+             its tree in memory.  Every call first sleeps for a configurable
+             latency plus random jitter and may fail with EIO at a
+             configurable rate, separately for each kind of call, so a slow
+             or flaky network mount can be reproduced on any machine.
+             Enumerate() costs one enumerate call plus one stat call per
+             entry, as readdir plus stat does on a real mount.
+Date: 2026-10-18
+*/
+
+#ifndef SIMULATEDBACKEND_H
+#define SIMULATEDBACKEND_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include "FileSystemBackend.h"
+
+class SimulatedBackend : public FileSystemBackend
+{
+public:
+    enum Call
+    {
+        CALL_ENUMERATE = 0,
+        CALL_STAT,
+        CALL_OPEN,
+        CALL_READ,
+        CALL_WRITE,
+        CALL_COPY,
+        CALL_RENAME,
+        CALL_UNLINK,
+        CALL_MAKE_DIRECTORY,
+        CALL_COUNT
+    };
+
+    // How one kind of call behaves.
+    struct Profile
+    {
+        unsigned int latencyMillis;   // every call sleeps this long ...
+        unsigned int jitterMillis;    // ... plus up to this much more
+        double       failureRate;     // fraction of calls failing with EIO
+
+        Profile();
+    };
+
+    SimulatedBackend();
+    virtual ~SimulatedBackend();
+
+    // Set the profile of every kind of call, or of one.
+    void SetProfile(const Profile& profile);
+    void SetProfile(Call call, const Profile& profile);
+
+    // Add 'folders' folders of 'files' files each below 'root', and the
+    // same again inside each new folder down to 'depth' levels.  Names,
+    // sizes and times are the same on every run.  Costs no latency.
+    void Populate(const std::string& root, std::size_t folders, std::size_t files, unsigned int depth);
+
+    // How many calls of one kind were made (failed ones included).
+    std::uint64_t GetCallCount(Call call) const { return m_calls[call]; }
+
+    bool Enumerate(const std::string& folder, std::vector<DirectoryListing::Entry>& entries) override;
+    bool Stat(const std::string& path, DirectoryListing::Entry& entry) override;
+    bool LinkStat(const std::string& path, DirectoryListing::Entry& entry) override;
+    std::unique_ptr<File> Open(const std::string& path, bool write) override;
+    bool Copy(const std::string& from, const std::string& to, bool overwrite) override;
+    bool Rename(const std::string& from, const std::string& to) override;
+    bool Unlink(const std::string& path) override;
+    bool MakeDirectory(const std::string& path) override;
+    bool IsLocal() const override { return false; }
+    std::string HomePath() const override { return "/"; }
+
+private:
+    struct Node
+    {
+        bool                  isDirectory;
+        std::uint64_t         size;        // file size ...
+        std::string           data;        // ... of which the first bytes; the rest are zeros
+        std::int64_t          modified;
+        std::uint64_t         inode;
+        std::set<std::string> children;    // names, for folders
+
+        Node();
+    };
+
+    class SimulatedFile;
+
+    // Made-up st_dev of every entry.
+    static constexpr std::uint64_t DEVICE = 0x5e4d;
+
+    std::array<Profile, CALL_COUNT>                    m_profiles;
+    std::array<std::atomic<std::uint64_t>, CALL_COUNT> m_calls;
+    std::mt19937                                       m_random;
+    std::uint64_t                                      m_nextInode;
+    mutable std::mutex                                 m_mutex;     // guards everything above and below but m_calls
+    std::map<std::string, Node>                        m_nodes;     // by normalised full path
+
+    // Sleep as the call's profile says; false (errno = EIO) if it fails.
+    bool Delay(Call call);
+
+    // The following expect m_mutex to be held.
+    Node* Find(const std::string& path);
+    bool  AddNode(const std::string& path, bool isDirectory, std::uint64_t size, std::int64_t modified);
+    void  PopulateFolder(const std::string& folder, std::size_t folders, std::size_t files, unsigned int depth);
+    void  RemoveTree(const std::string& path);
+    bool  CopyTree(const std::string& from, const std::string& to);
+    DirectoryListing::Entry Describe(const std::string& name, const Node& node) const;
+
+    static std::string Normalise(const std::string& path);
+    static std::string ParentOf(const std::string& path);
+    static std::string NameOf(const std::string& path);
+    static std::string Join(const std::string& folder, const std::string& name);
+};
+
+#endif // SIMULATEDBACKEND_H
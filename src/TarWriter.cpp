@@ -0,0 +1,456 @@
+/*
+Author: Guo Jia
+Description: Implementation of TarWriter.  Long names are split across the
+             ustar prefix and name fields where possible; names and link
+             targets that still do not fit, and sizes of 8 GiB or more, get
+             a pax extended header, which every current tar understands.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "TarWriter.h"
+#include "JobProgress.h"
+
+using namespace std;
+
+namespace
+{
+    const size_t   NAME_FIELD   = 100;
+    const size_t   PREFIX_FIELD = 155;
+    const uint64_t OCTAL_11_MAX = 077777777777ULL;   // largest size in 11 octal digits
+    const size_t   LINK_BUFFER  = 4096;
+
+    // Right-aligned zero-padded octal, NUL-terminated, as ustar wants.
+    void PutOctal(char* field, size_t length, uint64_t value)
+    {
+        snprintf(field, length, "%0*llo", static_cast<int>(length - 1),
+                 static_cast<unsigned long long>(value));
+    }
+
+    // GNU base-256 for numbers too large for octal; readers that know pax
+    // take the size from the pax record instead.
+    void PutBase256(char* field, size_t length, uint64_t value)
+    {
+        for (size_t i = length; i-- > 1;)
+        {
+            field[i] = static_cast<char>(value & 0xFF);
+            value >>= 8;
+        }
+        field[0] = static_cast<char>(0x80);
+    }
+
+    void PutText(char* field, size_t length, const string& text)
+    {
+        memcpy(field, text.data(), min(length, text.size()));
+    }
+
+    // One "<length> <key>=<value>\n" record; the length counts its own
+    // digits, so it is found by iterating until it stops changing.
+    string PaxRecord(const string& key, const string& value)
+    {
+        size_t body   = key.size() + value.size() + 3;   // ' ', '=', '\n'
+        size_t length = body + 1;
+        while (to_string(length).size() + body != length)
+        {
+            length = to_string(length).size() + body;
+        }
+        return to_string(length) + " " + key + "=" + value + "\n";
+    }
+
+    // Split a name into ustar prefix and name at a '/', if it fits.
+    bool SplitName(const string& name, string& prefix, string& rest)
+    {
+        if (name.size() <= NAME_FIELD)
+        {
+            prefix.clear();
+            rest = name;
+            return true;
+        }
+        size_t slash = name.find('/', name.size() > NAME_FIELD + 1 ? name.size() - NAME_FIELD - 1 : 0);
+        if (slash == string::npos || slash == 0 || slash > PREFIX_FIELD || name.size() - slash - 1 == 0)
+        {
+            return false;
+        }
+        prefix = name.substr(0, slash);
+        rest   = name.substr(slash + 1);
+        return true;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: TarWriter
+Description: Creates a writer that emits nothing until Add() is called.
+Parameters: sink - receives the tar stream
+Return: None
+*/
+TarWriter::TarWriter(const Sink& sink)
+    : m_sink(sink),
+      m_error(),
+      m_buffer(),
+      m_hardLinks(),
+      m_idNames()
+{
+}
+
+/*
+Function: ~TarWriter
+Description: Destructor.  Does not finish the archive.
+Parameters: None
+Return: None
+*/
+TarWriter::~TarWriter()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Writing
+// ---------------------------------------------------------------------------
+
+/*
+Function: Add
+Description: Adds a file or folder tree.  Leading slashes are dropped from
+             the archive name so extracting never writes to absolute paths.
+Parameters: path     - file or folder on disk
+            name     - name it gets in the archive
+            progress - progress/cancel state of the job
+Return: true if everything was written
+*/
+bool TarWriter::Add(const string& path, const string& name, JobProgress& progress)
+{
+    size_t start = name.find_first_not_of('/');
+    if (start == string::npos)
+    {
+        return Fail("Invalid name in archive: " + name);
+    }
+    return AddEntry(path, name.substr(start), progress);
+}
+
+/*
+Function: Finish
+Description: Two zero blocks mark the end of a tar archive.
+Parameters: None
+Return: true if written
+*/
+bool TarWriter::Finish()
+{
+    vector<char> end(2 * BLOCK, '\0');
+    if (!m_sink(end.data(), end.size()))
+    {
+        return Fail("Could not write the archive");
+    }
+    return true;
+}
+
+/*
+Function: TotalSize
+Description: Walks the tree with lstat only, adding up regular file sizes.
+Parameters: path - file or folder
+Return: Bytes of file data
+*/
+uint64_t TarWriter::TotalSize(const string& path)
+{
+    struct stat info;
+    if (lstat(path.c_str(), &info) != 0)
+    {
+        return 0;
+    }
+    if (S_ISREG(info.st_mode))
+    {
+        return static_cast<uint64_t>(info.st_size);
+    }
+    if (!S_ISDIR(info.st_mode))
+    {
+        return 0;
+    }
+
+    uint64_t total = 0;
+    DIR* directory = opendir(path.c_str());
+    if (directory == nullptr)
+    {
+        return 0;
+    }
+    while (struct dirent* item = readdir(directory))
+    {
+        if (strcmp(item->d_name, ".") != 0 && strcmp(item->d_name, "..") != 0)
+        {
+            total += TotalSize(path + "/" + item->d_name);
+        }
+    }
+    closedir(directory);
+    return total;
+}
+
+/*
+Function: AddEntry
+Description: Writes one entry and, for a folder, its children in name
+             order, so the same tree always gives the same archive.  A
+             file with several links is stored once; its other names
+             become hard-link entries.  Sockets, FIFOs and device nodes
+             are skipped.
+Parameters: path     - entry on disk
+            name     - its name in the archive
+            progress - progress/cancel state of the job
+Return: true if written
+*/
+bool TarWriter::AddEntry(const string& path, const string& name, JobProgress& progress)
+{
+    if (progress.IsCancelled())
+    {
+        return Fail("Cancelled");
+    }
+
+    struct stat info;
+    if (lstat(path.c_str(), &info) != 0)
+    {
+        return Fail("Cannot read " + path + ": " + strerror(errno));
+    }
+
+    if (S_ISLNK(info.st_mode))
+    {
+        // st_size is the target's length, except on a few pseudo file systems.
+        vector<char> target(info.st_size > 0 ? static_cast<size_t>(info.st_size) + 1 : LINK_BUFFER);
+        ssize_t length = readlink(path.c_str(), target.data(), target.size() - 1);
+        if (length < 0)
+        {
+            return Fail("Cannot read link " + path + ": " + strerror(errno));
+        }
+        return WriteHeader(name, info, '2', string(target.data(), static_cast<size_t>(length)), 0);
+    }
+
+    if (S_ISREG(info.st_mode))
+    {
+        if (info.st_nlink > 1)
+        {
+            auto key      = make_pair(info.st_dev, info.st_ino);
+            auto existing = m_hardLinks.find(key);
+            if (existing != m_hardLinks.end())
+            {
+                return WriteHeader(name, info, '1', existing->second, 0);
+            }
+            m_hardLinks.emplace(key, name);
+        }
+        uint64_t size = static_cast<uint64_t>(info.st_size);
+        progress.SetMessage(name);
+        return WriteHeader(name, info, '0', string(), size) &&
+               WriteFileData(path, size, progress);
+    }
+
+    if (!S_ISDIR(info.st_mode))
+    {
+        return true;
+    }
+
+    if (!WriteHeader(name + "/", info, '5', string(), 0))
+    {
+        return false;
+    }
+    DIR* directory = opendir(path.c_str());
+    if (directory == nullptr)
+    {
+        return Fail("Cannot open folder " + path + ": " + strerror(errno));
+    }
+    vector<string> children;
+    while (struct dirent* item = readdir(directory))
+    {
+        if (strcmp(item->d_name, ".") != 0 && strcmp(item->d_name, "..") != 0)
+        {
+            children.push_back(item->d_name);
+        }
+    }
+    closedir(directory);
+    sort(children.begin(), children.end());
+
+    for (const string& child : children)
+    {
+        if (!AddEntry(path + "/" + child, name + "/" + child, progress))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+Function: WriteHeader
+Description: Fills a ustar header.  Owner and group names are looked up
+             once per id.  Anything that does not fit goes into a pax 'x'
+             header written just before it.
+Parameters: name - entry name ('/'-terminated for folders)
+            info - lstat of the entry
+            type - ustar type flag
+            link - link target for types '1' and '2'
+            size - bytes of data following the header
+Return: true if written
+*/
+bool TarWriter::WriteHeader(const string& name, const struct stat& info, char type,
+                            const string& link, uint64_t size)
+{
+    string pax;
+    string prefix;
+    string shortName;
+    if (!SplitName(name, prefix, shortName))
+    {
+        pax      += PaxRecord("path", name);
+        prefix.clear();
+        shortName = name.substr(0, NAME_FIELD);
+    }
+    if (link.size() > NAME_FIELD)
+    {
+        pax += PaxRecord("linkpath", link);
+    }
+    if (size > OCTAL_11_MAX)
+    {
+        pax += PaxRecord("size", to_string(size));
+    }
+
+    if (!pax.empty())
+    {
+        struct stat paxInfo = info;
+        paxInfo.st_mode = S_IFREG | 0644;
+        string paxName = "PaxHeaders/" + shortName.substr(0, NAME_FIELD - 11);
+        if (!WriteHeader(paxName, paxInfo, 'x', string(), pax.size()) ||
+            !m_sink(pax.data(), pax.size()) || !WritePadding(pax.size()))
+        {
+            return Fail("Could not write the archive");
+        }
+    }
+
+    char header[BLOCK];
+    memset(header, 0, sizeof(header));
+    PutText(header, NAME_FIELD, shortName);
+    PutOctal(header + 100, 8, static_cast<uint64_t>(info.st_mode & 07777));
+    PutOctal(header + 108, 8, static_cast<uint64_t>(info.st_uid) & 07777777);
+    PutOctal(header + 116, 8, static_cast<uint64_t>(info.st_gid) & 07777777);
+    if (size > OCTAL_11_MAX)
+    {
+        PutBase256(header + 124, 12, size);
+    }
+    else
+    {
+        PutOctal(header + 124, 12, size);
+    }
+    PutOctal(header + 136, 12, min(static_cast<uint64_t>(max<time_t>(info.st_mtime, 0)), OCTAL_11_MAX));
+    header[156] = type;
+    PutText(header + 157, NAME_FIELD, link);
+    memcpy(header + 257, "ustar\0" "00", 8);
+    PutText(header + 265, 32, m_idNames.UserName(static_cast<uint32_t>(info.st_uid)));
+    PutText(header + 297, 32, m_idNames.GroupName(static_cast<uint32_t>(info.st_gid)));
+    PutOctal(header + 329, 8, 0);
+    PutOctal(header + 337, 8, 0);
+    PutText(header + 345, PREFIX_FIELD, prefix);
+
+    // The checksum is computed with its own field as spaces.
+    memset(header + 148, ' ', 8);
+    unsigned int checksum = 0;
+    for (unsigned char c : header)
+    {
+        checksum += c;
+    }
+    snprintf(header + 148, 8, "%06o", checksum);
+    header[155] = ' ';
+
+    if (!m_sink(header, sizeof(header)))
+    {
+        return Fail("Could not write the archive");
+    }
+    return true;
+}
+
+/*
+Function: WriteFileData
+Description: Streams the file through a reusable buffer.  The header
+             already promised 'size' bytes: a file that shrank meanwhile
+             is padded with zeros and one that grew is cut off, as GNU tar
+             does, so the archive stays readable.
+Parameters: path     - file to read
+            size     - size recorded in its header
+            progress - advanced by bytes read
+Return: true if written
+*/
+bool TarWriter::WriteFileData(const string& path, uint64_t size, JobProgress& progress)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NOCTTY);
+    if (fd < 0)
+    {
+        return Fail("Cannot read " + path + ": " + strerror(errno));
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    if (m_buffer.empty())
+    {
+        m_buffer.resize(READ_BUFFER);
+    }
+
+    uint64_t remaining = size;
+    bool     ok        = true;
+    while (remaining > 0 && ok)
+    {
+        if (progress.IsCancelled())
+        {
+            ok = Fail("Cancelled");
+            break;
+        }
+        size_t  want = static_cast<size_t>(min<uint64_t>(remaining, m_buffer.size()));
+        ssize_t got  = read(fd, m_buffer.data(), want);
+        if (got < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (got < 0)
+        {
+            ok = Fail("Cannot read " + path + ": " + strerror(errno));
+            break;
+        }
+        if (got == 0)
+        {
+            fill(m_buffer.begin(), m_buffer.begin() + static_cast<long>(want), '\0');   // file shrank
+            got = static_cast<ssize_t>(want);
+        }
+        ok = m_sink(m_buffer.data(), static_cast<size_t>(got)) || Fail("Could not write the archive");
+        remaining -= static_cast<uint64_t>(got);
+        progress.Advance(static_cast<uint64_t>(got));
+    }
+    close(fd);
+    return ok && WritePadding(size);
+}
+
+/*
+Function: WritePadding
+Description: Data is padded with zeros to a whole block.
+Parameters: size - bytes of data just written
+Return: true if written
+*/
+bool TarWriter::WritePadding(uint64_t size)
+{
+    size_t padding = static_cast<size_t>((BLOCK - size % BLOCK) % BLOCK);
+    if (padding == 0)
+    {
+        return true;
+    }
+    char zeros[BLOCK] = {};
+    return m_sink(zeros, padding) || Fail("Could not write the archive");
+}
+
+/*
+Function: Fail
+Description: Records the first error; later ones are consequences of it.
+Parameters: message - what went wrong
+Return: false, so callers can return Fail(...)
+*/
+bool TarWriter::Fail(const string& message)
+{
+    if (m_error.empty())
+    {
+        m_error = message;
+    }
+    return false;
+}
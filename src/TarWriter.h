@@ -0,0 +1,74 @@
+/*
+Author: Guo Jia
+Description: Declaration of TarWriter – turns files and folder trees into
+             a POSIX (ustar + pax) tar stream handed to a sink in pieces, so
+             the stream can be compressed or written as it is produced and
+             never has to exist in full.
+Date: 2026-10-18
+*/
+
+#ifndef TARWRITER_H
+#define TARWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sys/stat.h>
+#include "IdNameCache.h"
+
+class JobProgress;
+
+class TarWriter
+{
+public:
+    // Receives the stream; returns false to abort the archive.
+    using Sink = std::function<bool(const char* data, std::size_t length)>;
+
+    explicit TarWriter(const Sink& sink);
+    virtual ~TarWriter();
+
+    TarWriter(const TarWriter&) = delete;
+    TarWriter& operator=(const TarWriter&) = delete;
+
+    // Store 'path' (a folder with everything under it) under the name
+    // 'name' in the archive.  Progress advances by file bytes read.
+    // Returns false on a read error, a sink failure or cancellation;
+    // GetError() then says why.
+    bool Add(const std::string& path, const std::string& name, JobProgress& progress);
+
+    // Write the end-of-archive marker.  Nothing may be added afterwards.
+    bool Finish();
+
+    const std::string& GetError() const { return m_error; }
+
+    // Bytes of file data under 'path' (symbolic links not followed), for
+    // setting up progress before Add().
+    static std::uint64_t TotalSize(const std::string& path);
+
+private:
+    static constexpr std::size_t BLOCK       = 512;
+    static constexpr std::size_t READ_BUFFER = 1024 * 1024;
+
+    Sink                                           m_sink;
+    std::string                                    m_error;
+    std::vector<char>                              m_buffer;
+    std::map<std::pair<dev_t, ino_t>, std::string> m_hardLinks;   // first name of each multiply-linked file
+    IdNameCache                                    m_idNames;
+
+    bool AddEntry(const std::string& path, const std::string& name, JobProgress& progress);
+
+    // Header for 'name', preceded by a pax record when the name, link
+    // target or size does not fit the ustar fields.
+    bool WriteHeader(const std::string& name, const struct stat& info, char type,
+                     const std::string& link, std::uint64_t size);
+    bool WriteFileData(const std::string& path, std::uint64_t size, JobProgress& progress);
+    bool WritePadding(std::uint64_t size);
+
+    bool Fail(const std::string& message);
+};
+
+#endif // TARWRITER_H
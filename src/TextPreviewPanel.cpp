@@ -0,0 +1,679 @@
+/*
+Author: Guo Jia
+Description: Implementation of TextPreviewPanel.  The view is described by
+             a single byte offset (the top row); everything else – rows,
+             scroll bar position, line number – is derived from the mapped
+             bytes around it, so opening and jumping cost the same for a
+             1 KB file and a 20 GB one.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <wx/sizer.h>
+#include <wx/dcbuffer.h>
+#include <wx/settings.h>
+#include "TextPreviewPanel.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: TextPreviewPanel
+Description: Builds the toolbar row (go-to box, follow checkbox, position
+             label) above the custom-drawn text area and its scroll bar.
+Parameters: parent - parent window (the main splitter)
+Return: None
+*/
+TextPreviewPanel::TextPreviewPanel(wxWindow* parent)
+    : wxPanel(parent),
+      m_gotoCtrl(nullptr),
+      m_followBox(nullptr),
+      m_infoLabel(nullptr),
+      m_canvas(nullptr),
+      m_scrollBar(nullptr),
+      m_pollTimer(this),
+      m_font(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL),
+      m_file(),
+      m_index(),
+      m_topOffset(0),
+      m_bottomOffset(0)
+{
+    // --- Toolbar row --------------------------------------------------------
+    m_gotoCtrl = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxSize(120, -1),
+                                wxTE_PROCESS_ENTER);
+    m_gotoCtrl->SetHint("line or %");
+    m_followBox = new wxCheckBox(this, wxID_ANY, "Follow");
+    m_infoLabel = new wxStaticText(this, wxID_ANY, "");
+
+    wxBoxSizer* toolbar = new wxBoxSizer(wxHORIZONTAL);
+    toolbar->Add(new wxStaticText(this, wxID_ANY, "Go to:"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 4);
+    toolbar->Add(m_gotoCtrl,  0, wxRIGHT, 8);
+    toolbar->Add(m_followBox, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 8);
+    toolbar->Add(m_infoLabel, 1, wxALIGN_CENTER_VERTICAL);
+
+    // --- Text area ----------------------------------------------------------
+    m_canvas = new wxWindow(this, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                            wxWANTS_CHARS | wxFULL_REPAINT_ON_RESIZE);
+    m_canvas->SetBackgroundStyle(wxBG_STYLE_PAINT);
+    m_canvas->SetFont(m_font);
+    m_scrollBar = new wxScrollBar(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxSB_VERTICAL);
+
+    wxBoxSizer* body = new wxBoxSizer(wxHORIZONTAL);
+    body->Add(m_canvas,    1, wxEXPAND);
+    body->Add(m_scrollBar, 0, wxEXPAND);
+
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(toolbar, 0, wxEXPAND | wxALL, 4);
+    sizer->Add(body,    1, wxEXPAND);
+    SetSizer(sizer);
+
+    // --- Bind events --------------------------------------------------------
+    m_canvas->Bind(wxEVT_PAINT,      &TextPreviewPanel::OnPaint,      this);
+    m_canvas->Bind(wxEVT_SIZE,       &TextPreviewPanel::OnSize,       this);
+    m_canvas->Bind(wxEVT_MOUSEWHEEL, &TextPreviewPanel::OnMouseWheel, this);
+    m_canvas->Bind(wxEVT_KEY_DOWN,   &TextPreviewPanel::OnKeyDown,    this);
+    m_canvas->Bind(wxEVT_LEFT_DOWN,  [this](wxMouseEvent& event) { m_canvas->SetFocus(); event.Skip(); });
+
+    m_scrollBar->Bind(wxEVT_SCROLL_LINEUP,       [this](wxScrollEvent&) { ScrollRows(-1); });
+    m_scrollBar->Bind(wxEVT_SCROLL_LINEDOWN,     [this](wxScrollEvent&) { ScrollRows(1); });
+    m_scrollBar->Bind(wxEVT_SCROLL_PAGEUP,       [this](wxScrollEvent&) { ScrollRows(-VisibleRows()); });
+    m_scrollBar->Bind(wxEVT_SCROLL_PAGEDOWN,     [this](wxScrollEvent&) { ScrollRows(VisibleRows()); });
+    m_scrollBar->Bind(wxEVT_SCROLL_THUMBTRACK,   &TextPreviewPanel::OnScrollThumb, this);
+    m_scrollBar->Bind(wxEVT_SCROLL_THUMBRELEASE, &TextPreviewPanel::OnScrollThumb, this);
+
+    m_gotoCtrl->Bind(wxEVT_TEXT_ENTER, &TextPreviewPanel::OnGoTo,   this);
+    m_followBox->Bind(wxEVT_CHECKBOX,  &TextPreviewPanel::OnFollow, this);
+    Bind(wxEVT_TIMER, &TextPreviewPanel::OnPollTimer, this, m_pollTimer.GetId());
+}
+
+/*
+Function: ~TextPreviewPanel
+Description: Stops the poll timer; the index thread is stopped by
+             ~LineIndex and the mapping released by ~MappedFile.
+Parameters: None
+Return: None
+*/
+TextPreviewPanel::~TextPreviewPanel()
+{
+    m_pollTimer.Stop();
+}
+
+// ---------------------------------------------------------------------------
+// File handling
+// ---------------------------------------------------------------------------
+
+/*
+Function: ShowFile
+Description: Opens a file and shows it from the top.  Opening is O(1): the
+             file is not read here, only mapped on first paint, and the
+             line index is built on its own thread.
+Parameters: path - file to show
+Return: true if the file was opened
+*/
+bool TextPreviewPanel::ShowFile(const wxString& path)
+{
+    CloseFile();
+    if (!m_file.Open(path.ToStdString()))
+    {
+        m_infoLabel->SetLabel("Cannot open \"" + path + "\"");
+        return false;
+    }
+
+    m_index.Build(m_file.GetPath());
+    m_pollTimer.Start(POLL_MS);
+    if (m_followBox->GetValue())
+    {
+        ScrollToEnd();
+    }
+    else
+    {
+        ScrollTo(0);
+    }
+    return true;
+}
+
+/*
+Function: CloseFile
+Description: Releases the file and clears the view.
+Parameters: None
+Return: None
+*/
+void TextPreviewPanel::CloseFile()
+{
+    m_pollTimer.Stop();
+    m_index.Stop();
+    m_file.Close();
+    m_topOffset    = 0;
+    m_bottomOffset = 0;
+    m_infoLabel->SetLabel("");
+    UpdateScrollBar();
+    m_canvas->Refresh();
+}
+
+// ---------------------------------------------------------------------------
+// Event handlers
+// ---------------------------------------------------------------------------
+
+/*
+Function: OnPaint
+Description: Draws the rows from m_topOffset down until the area is full.
+             Only these rows are read from the mapping and decoded.  The
+             size is re-checked first so a file truncated under us drops
+             its stale mapping instead of faulting.
+Parameters: event - paint event (unused)
+Return: None
+*/
+void TextPreviewPanel::OnPaint(wxPaintEvent& /*event*/)
+{
+    wxAutoBufferedPaintDC dc(m_canvas);
+    dc.SetBackground(wxBrush(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOW)));
+    dc.Clear();
+
+    if (!m_file.IsOpen())
+    {
+        return;
+    }
+    m_file.UpdateSize();
+
+    dc.SetFont(m_font);
+    dc.SetTextForeground(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOWTEXT));
+
+    int rowHeight = dc.GetCharHeight();
+    int height    = m_canvas->GetClientSize().GetHeight();
+    uint64_t offset = min(m_topOffset, m_file.GetSize());
+
+    for (int y = 0; y < height && offset < m_file.GetSize(); y += rowHeight)
+    {
+        uint64_t next   = NextRow(offset);
+        size_t   wanted = static_cast<size_t>(min<uint64_t>(next - offset, MAX_SHOWN_BYTES));
+        size_t   available = 0;
+        const char* data = m_file.Read(offset, wanted, available);
+        if (data == nullptr)
+        {
+            break;
+        }
+        dc.DrawText(DecodeRow(data, min(wanted, available)), TEXT_MARGIN, y);
+        offset = next;
+    }
+    m_bottomOffset = offset;
+}
+
+/*
+Function: OnSize
+Description: A resize changes how much of the file is visible, which the
+             scroll bar thumb reflects.
+Parameters: event - size event (skipped)
+Return: None
+*/
+void TextPreviewPanel::OnSize(wxSizeEvent& event)
+{
+    event.Skip();
+    m_canvas->Refresh();
+    UpdateScrollBar();
+}
+
+/*
+Function: OnMouseWheel
+Description: Scrolls by the platform's lines-per-notch.
+Parameters: event - mouse-wheel event
+Return: None
+*/
+void TextPreviewPanel::OnMouseWheel(wxMouseEvent& event)
+{
+    int notches = event.GetWheelRotation() / max(1, event.GetWheelDelta());
+    ScrollRows(-static_cast<long>(notches) * event.GetLinesPerAction());
+}
+
+/*
+Function: OnKeyDown
+Description: Arrow, page and Home/End keys move through the file.
+Parameters: event - key event (skipped for other keys)
+Return: None
+*/
+void TextPreviewPanel::OnKeyDown(wxKeyEvent& event)
+{
+    switch (event.GetKeyCode())
+    {
+    case WXK_UP:       ScrollRows(-1);             break;
+    case WXK_DOWN:     ScrollRows(1);              break;
+    case WXK_PAGEUP:   ScrollRows(-VisibleRows()); break;
+    case WXK_PAGEDOWN: ScrollRows(VisibleRows());  break;
+    case WXK_HOME:     m_followBox->SetValue(false); ScrollTo(0); break;
+    case WXK_END:      ScrollToEnd();              break;
+    default:           event.Skip();               break;
+    }
+}
+
+/*
+Function: OnScrollThumb
+Description: Maps the thumb position linearly onto the file's bytes and
+             snaps to the start of the row found there.
+Parameters: event - scroll event carrying the thumb position
+Return: None
+*/
+void TextPreviewPanel::OnScrollThumb(wxScrollEvent& event)
+{
+    if (!m_file.IsOpen())
+    {
+        return;
+    }
+    m_followBox->SetValue(false);
+    if (event.GetPosition() >= SCROLL_RANGE)
+    {
+        ScrollToEnd();
+        return;
+    }
+    double fraction = static_cast<double>(event.GetPosition()) / SCROLL_RANGE;
+    ScrollTo(RowStart(static_cast<uint64_t>(fraction * static_cast<double>(m_file.GetSize()))));
+}
+
+/*
+Function: OnGoTo
+Description: Parses the go-to box: "1234" jumps to that line, "37.5%" to
+             that fraction of the file.
+Parameters: event - text-enter event (unused)
+Return: None
+*/
+void TextPreviewPanel::OnGoTo(wxCommandEvent& /*event*/)
+{
+    if (!m_file.IsOpen())
+    {
+        return;
+    }
+    m_followBox->SetValue(false);
+
+    string text = m_gotoCtrl->GetValue().Trim().Trim(false).ToStdString();
+    if (!text.empty() && text.back() == '%')
+    {
+        double percent = max(0.0, min(100.0, atof(text.c_str())));
+        ScrollTo(RowStart(static_cast<uint64_t>(percent / 100.0 * static_cast<double>(m_file.GetSize()))));
+    }
+    else
+    {
+        unsigned long long line = strtoull(text.c_str(), nullptr, 10);
+        GoToLine(line > 0 ? line - 1 : 0);
+    }
+    m_canvas->SetFocus();
+}
+
+/*
+Function: OnFollow
+Description: Turning follow mode on jumps to the end right away.
+Parameters: event - checkbox event
+Return: None
+*/
+void TextPreviewPanel::OnFollow(wxCommandEvent& event)
+{
+    if (event.IsChecked() && m_file.IsOpen())
+    {
+        ScrollToEnd();
+    }
+}
+
+/*
+Function: OnPollTimer
+Description: Watches the open file.  Growth extends the line index (and,
+             in follow mode, moves the view to the new end); a file that
+             shrank was truncated or rotated, so it is re-indexed from
+             scratch.  Also refreshes the indexing progress shown.
+Parameters: event - timer event (unused)
+Return: None
+*/
+void TextPreviewPanel::OnPollTimer(wxTimerEvent& /*event*/)
+{
+    if (!m_file.IsOpen())
+    {
+        return;
+    }
+
+    bool changed = m_file.UpdateSize();
+    if (m_file.GetSize() < m_index.GetIndexedBytes())
+    {
+        m_index.Build(m_file.GetPath());
+        m_topOffset = RowStart(min(m_topOffset, m_file.GetSize()));
+    }
+    else if (m_index.IsComplete() && m_file.GetSize() > m_index.GetIndexedBytes())
+    {
+        m_index.Extend();
+    }
+
+    if (changed && m_followBox->GetValue())
+    {
+        ScrollToEnd();
+        return;
+    }
+    if (changed)
+    {
+        m_canvas->Refresh();
+        UpdateScrollBar();
+    }
+    UpdateInfo();
+}
+
+// ---------------------------------------------------------------------------
+// Navigation
+// ---------------------------------------------------------------------------
+
+/*
+Function: ScrollRows
+Description: Moves the view by a number of rows; scrolling up leaves
+             follow mode.
+Parameters: count - rows to move (negative = up)
+Return: None
+*/
+void TextPreviewPanel::ScrollRows(long count)
+{
+    if (!m_file.IsOpen())
+    {
+        return;
+    }
+
+    uint64_t offset = m_topOffset;
+    for (long i = 0; i < count; ++i)
+    {
+        uint64_t next = NextRow(offset);
+        if (next >= m_file.GetSize())
+        {
+            break;
+        }
+        offset = next;
+    }
+    for (long i = 0; i > count && offset > 0; --i)
+    {
+        offset = PreviousRow(offset);
+    }
+
+    if (count < 0)
+    {
+        m_followBox->SetValue(false);
+    }
+    ScrollTo(offset);
+}
+
+/*
+Function: ScrollTo
+Description: Makes the row starting at 'offset' the top row.
+Parameters: offset - start of a row
+Return: None
+*/
+void TextPreviewPanel::ScrollTo(uint64_t offset)
+{
+    m_topOffset = min(offset, m_file.GetSize());
+    m_canvas->Refresh();
+    UpdateScrollBar();
+    UpdateInfo();
+}
+
+/*
+Function: ScrollToEnd
+Description: Positions the view so the last row of the file is at the
+             bottom.  A final newline does not count as an extra row.
+Parameters: None
+Return: None
+*/
+void TextPreviewPanel::ScrollToEnd()
+{
+    uint64_t size = m_file.GetSize();
+    if (size == 0)
+    {
+        ScrollTo(0);
+        return;
+    }
+
+    size_t available = 0;
+    const char* last = m_file.Read(size - 1, 1, available);
+    uint64_t offset = (last != nullptr && *last == '\n') ? RowStart(size - 1) : RowStart(size);
+    for (int i = 1; i < VisibleRows() && offset > 0; ++i)
+    {
+        offset = PreviousRow(offset);
+    }
+    ScrollTo(offset);
+}
+
+/*
+Function: GoToLine
+Description: Jumps to a line through the sparse index: one lookup, then at
+             most LineIndex::STRIDE rows scanned forward.  Lines not yet
+             reached by the indexer are reported rather than scanned for.
+Parameters: line - 0-based line number
+Return: true if the view moved
+*/
+bool TextPreviewPanel::GoToLine(uint64_t line)
+{
+    uint64_t offset = 0;
+    uint64_t skip   = 0;
+    if (!m_index.FindLine(line, offset, skip))
+    {
+        if (m_index.IsComplete())
+        {
+            ScrollToEnd();
+            return true;
+        }
+        m_infoLabel->SetLabel(wxString::Format("Line %llu has not been indexed yet",
+                                               static_cast<unsigned long long>(line + 1)));
+        return false;
+    }
+
+    for (uint64_t i = 0; i < skip && offset < m_file.GetSize(); ++i)
+    {
+        offset = NextRow(offset);
+    }
+    ScrollTo(offset);
+    return true;
+}
+
+/*
+Function: VisibleRows
+Description: Number of whole rows that fit in the text area.
+Parameters: None
+Return: Row count (at least 1)
+*/
+int TextPreviewPanel::VisibleRows() const
+{
+    return max(1, m_canvas->GetClientSize().GetHeight() / max(1, m_canvas->GetCharHeight()));
+}
+
+// ---------------------------------------------------------------------------
+// Row boundaries
+// ---------------------------------------------------------------------------
+
+/*
+Function: NextRow
+Description: Start of the row after the one starting at 'offset': just past
+             the next newline, or MAX_LINE_BYTES on if there is none.
+Parameters: offset - start of a row
+Return: Start of the following row (at most the file size)
+*/
+uint64_t TextPreviewPanel::NextRow(uint64_t offset)
+{
+    size_t available = 0;
+    const char* data = m_file.Read(offset, MAX_LINE_BYTES, available);
+    if (data == nullptr)
+    {
+        return m_file.GetSize();
+    }
+    size_t length = min(available, MAX_LINE_BYTES);
+    const char* newline = static_cast<const char*>(memchr(data, '\n', length));
+    return offset + (newline != nullptr ? static_cast<uint64_t>(newline - data) + 1 : length);
+}
+
+/*
+Function: PreviousRow
+Description: Start of the row before the one starting at 'offset'.
+Parameters: offset - start of a row
+Return: Start of the preceding row
+*/
+uint64_t TextPreviewPanel::PreviousRow(uint64_t offset)
+{
+    if (offset == 0)
+    {
+        return 0;
+    }
+    return RowStart(offset - 1);
+}
+
+/*
+Function: RowStart
+Description: Start of the row containing 'offset': just past the previous
+             newline, searched backwards at most MAX_LINE_BYTES.
+Parameters: offset - any byte offset
+Return: Row start
+*/
+uint64_t TextPreviewPanel::RowStart(uint64_t offset)
+{
+    if (offset == 0)
+    {
+        return 0;
+    }
+    uint64_t start  = offset > MAX_LINE_BYTES ? offset - MAX_LINE_BYTES : 0;
+    size_t   length = static_cast<size_t>(offset - start);
+    size_t   available = 0;
+    const char* data = m_file.Read(start, length, available);
+    if (data == nullptr)
+    {
+        return offset;
+    }
+    const char* newline = static_cast<const char*>(memrchr(data, '\n', min(length, available)));
+    if (newline != nullptr)
+    {
+        return start + static_cast<uint64_t>(newline - data) + 1;
+    }
+    return start;
+}
+
+// ---------------------------------------------------------------------------
+// Display helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: UpdateScrollBar
+Description: The scroll bar maps bytes, not lines, so it works before the
+             line index exists.  The thumb covers the visible byte range.
+Parameters: None
+Return: None
+*/
+void TextPreviewPanel::UpdateScrollBar()
+{
+    uint64_t size = m_file.GetSize();
+    if (!m_file.IsOpen() || size == 0)
+    {
+        m_scrollBar->SetScrollbar(0, SCROLL_RANGE, SCROLL_RANGE, SCROLL_RANGE);
+        return;
+    }
+
+    double top     = static_cast<double>(m_topOffset) / static_cast<double>(size);
+    double visible = static_cast<double>(max(m_bottomOffset, m_topOffset) - m_topOffset) /
+                     static_cast<double>(size);
+    int thumb = max(1, static_cast<int>(visible * SCROLL_RANGE));
+    m_scrollBar->SetScrollbar(static_cast<int>(top * SCROLL_RANGE), thumb, SCROLL_RANGE + thumb, thumb);
+}
+
+/*
+Function: UpdateInfo
+Description: Shows the top row's line number, the line count (or how far
+             indexing has got) and the position as a percentage.  The line
+             number is the nearest checkpoint plus the newlines counted from
+             there, skipped if that would mean scanning too far.
+Parameters: None
+Return: None
+*/
+void TextPreviewPanel::UpdateInfo()
+{
+    uint64_t size = m_file.GetSize();
+    if (!m_file.IsOpen())
+    {
+        return;
+    }
+
+    wxString position = "Line ?";
+    uint64_t checkpointLine   = 0;
+    uint64_t checkpointOffset = 0;
+    if (m_index.FindOffset(m_topOffset, checkpointLine, checkpointOffset) &&
+        m_topOffset - checkpointOffset <= MAX_COUNT_BYTES)
+    {
+        uint64_t line   = checkpointLine;
+        uint64_t offset = checkpointOffset;
+        while (offset < m_topOffset)
+        {
+            size_t available = 0;
+            const char* data = m_file.Read(offset, static_cast<size_t>(m_topOffset - offset), available);
+            if (data == nullptr)
+            {
+                break;
+            }
+            size_t length = static_cast<size_t>(min<uint64_t>(available, m_topOffset - offset));
+            for (const char* p = data; (p = static_cast<const char*>(memchr(p, '\n', data + length - p))) != nullptr; ++p)
+            {
+                ++line;
+            }
+            offset += length;
+        }
+        position = wxString::Format("Line %llu", static_cast<unsigned long long>(line + 1));
+    }
+
+    wxString lines;
+    if (m_index.IsComplete())
+    {
+        lines = wxString::Format("%llu lines", static_cast<unsigned long long>(m_index.GetNewlineCount()));
+    }
+    else
+    {
+        double indexed = size > 0 ? 100.0 * static_cast<double>(m_index.GetIndexedBytes()) / static_cast<double>(size) : 100.0;
+        lines = wxString::Format("%llu+ lines (indexing %.0f%%)",
+                                 static_cast<unsigned long long>(m_index.GetNewlineCount()), indexed);
+    }
+
+    double percent = size > 0 ? 100.0 * static_cast<double>(m_topOffset) / static_cast<double>(size) : 0.0;
+    m_infoLabel->SetLabel(wxString::Format("%s of %s, %.1f%%", position, lines, percent));
+}
+
+/*
+Function: DecodeRow
+Description: Turns the raw bytes of one row into display text: the line
+             terminator is dropped, tabs are expanded and other control
+             bytes become '.'.  UTF-8 is assumed; bytes that are not valid
+             UTF-8 are shown as Latin-1 so binary junk still displays.
+Parameters: data   - row bytes
+            length - number of bytes
+Return: Display string
+*/
+wxString TextPreviewPanel::DecodeRow(const char* data, size_t length)
+{
+    while (length > 0 && (data[length - 1] == '\n' || data[length - 1] == '\r'))
+    {
+        --length;
+    }
+
+    string row;
+    row.reserve(length);
+    size_t column = 0;
+    for (size_t i = 0; i < length; ++i)
+    {
+        unsigned char byte = static_cast<unsigned char>(data[i]);
+        if (byte == '\t')
+        {
+            size_t spaces = TAB_WIDTH - column % TAB_WIDTH;
+            row.append(spaces, ' ');
+            column += spaces;
+            continue;
+        }
+        row += (byte < 0x20 || byte == 0x7F) ? '.' : static_cast<char>(byte);
+        if ((byte & 0xC0) != 0x80)
+        {
+            ++column;   // count characters, not UTF-8 continuation bytes
+        }
+    }
+
+    wxString text = wxString::FromUTF8(row.data(), row.size());
+    if (text.empty() && !row.empty())
+    {
+        text = wxString::From8BitData(row.data(), row.size());
+    }
+    return text;
+}
@@ -0,0 +1,94 @@
+/*
+Author: Guo Jia
+Description: Declaration of TextPreviewPanel – a read-only viewer for text
+             files of any size, shown next to the file list.  The file is
+             accessed through a MappedFile window and only the lines on
+             screen are decoded; a LineIndex built in the background makes
+             "go to line" and "go to percent" instant.  Follow mode keeps the
+             view at the end of a growing file, like tail -f.
+Date: 2026-10-18
+*/
+
+#ifndef TEXTPREVIEWPANEL_H
+#define TEXTPREVIEWPANEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <wx/panel.h>
+#include <wx/textctrl.h>
+#include <wx/checkbox.h>
+#include <wx/stattext.h>
+#include <wx/scrolbar.h>
+#include <wx/timer.h>
+#include <wx/font.h>
+#include "MappedFile.h"
+#include "LineIndex.h"
+
+class TextPreviewPanel : public wxPanel
+{
+public:
+    explicit TextPreviewPanel(wxWindow* parent);
+    virtual ~TextPreviewPanel();
+
+    // Show a file from its first line.  Returns false if it cannot be
+    // opened (the panel is then left empty).
+    bool ShowFile(const wxString& path);
+    void CloseFile();
+
+    wxString GetPath() const { return wxString(m_file.GetPath()); }
+
+private:
+    // Longest run of bytes treated as one line; longer lines wrap into
+    // several rows.  Keeps every scan bounded on files without newlines.
+    static constexpr std::size_t MAX_LINE_BYTES   = 64 * 1024;
+    // Only this much of a row is decoded and drawn.
+    static constexpr std::size_t MAX_SHOWN_BYTES  = 4096;
+    // Beyond this distance from a checkpoint the line number is not counted.
+    static constexpr std::size_t MAX_COUNT_BYTES  = 16 * 1024 * 1024;
+    static constexpr int         SCROLL_RANGE     = 1000000;
+    static constexpr int         POLL_MS          = 500;
+    static constexpr int         TAB_WIDTH        = 4;
+    static constexpr int         TEXT_MARGIN      = 4;
+
+    wxTextCtrl*   m_gotoCtrl;
+    wxCheckBox*   m_followBox;
+    wxStaticText* m_infoLabel;
+    wxWindow*     m_canvas;
+    wxScrollBar*  m_scrollBar;
+    wxTimer       m_pollTimer;
+    wxFont        m_font;
+
+    MappedFile    m_file;
+    LineIndex     m_index;
+    std::uint64_t m_topOffset;      // first byte of the top row
+    std::uint64_t m_bottomOffset;   // first byte after the last row drawn
+
+    // Event handlers
+    void OnPaint(wxPaintEvent& event);
+    void OnSize(wxSizeEvent& event);
+    void OnMouseWheel(wxMouseEvent& event);
+    void OnKeyDown(wxKeyEvent& event);
+    void OnScrollThumb(wxScrollEvent& event);
+    void OnGoTo(wxCommandEvent& event);
+    void OnFollow(wxCommandEvent& event);
+    void OnPollTimer(wxTimerEvent& event);
+
+    // Navigation
+    void ScrollRows(long count);
+    void ScrollTo(std::uint64_t offset);
+    void ScrollToEnd();
+    bool GoToLine(std::uint64_t line);
+    int  VisibleRows() const;
+
+    // Row boundaries, all bounded by MAX_LINE_BYTES
+    std::uint64_t NextRow(std::uint64_t offset);
+    std::uint64_t PreviousRow(std::uint64_t offset);
+    std::uint64_t RowStart(std::uint64_t offset);
+
+    void UpdateScrollBar();
+    void UpdateInfo();
+
+    static wxString DecodeRow(const char* data, std::size_t length);
+};
+
+#endif // TEXTPREVIEWPANEL_H
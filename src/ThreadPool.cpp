@@ -0,0 +1,126 @@
+/*
+Author: Guo Jia
+Description: Implementation of ThreadPool – worker threads pulling tasks
+             from a shared queue guarded by a mutex/condition variable.
+Date: 2026-10-18
+*/
+
+#include <memory>
+#include "ThreadPool.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: ThreadPool
+Description: Starts the worker threads.  A count of zero picks one worker
+             per hardware thread (at least one if the count is unknown).
+Parameters: threadCount - number of workers to start, or 0 for automatic
+Return: None
+*/
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : m_threads(),
+      m_queue(),
+      m_mutex(),
+      m_wakeup(),
+      m_stopping(false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = thread::hardware_concurrency();
+    }
+    if (threadCount == 0)
+    {
+        threadCount = 1;
+    }
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+/*
+Function: ~ThreadPool
+Description: Lets the workers drain the queue, then joins them.  Tasks that
+             are already queued still run so no future is left dangling.
+Parameters: None
+Return: None
+*/
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+
+    for (thread& worker : m_threads)
+    {
+        worker.join();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Task submission
+// ---------------------------------------------------------------------------
+
+/*
+Function: Submit
+Description: Wraps the task in a packaged_task so the caller can wait for it
+             (or collect its exception) and appends it to the queue.
+Parameters: task - callable to run on a worker thread
+Return: Future that becomes ready once the task has finished
+*/
+future<void> ThreadPool::Submit(function<void()> task)
+{
+    // packaged_task is move-only but std::function needs a copyable target,
+    // so hold it through a shared_ptr.
+    auto packaged = make_shared<packaged_task<void()>>(move(task));
+    future<void> result = packaged->get_future();
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_queue.emplace_back([packaged]() { (*packaged)(); });
+    }
+    m_wakeup.notify_one();
+
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+/*
+Function: WorkerLoop
+Description: Body of every worker thread.  Sleeps until a task is queued,
+             runs it outside the lock, and exits once the pool is stopping
+             and the queue is empty.
+Parameters: None
+Return: None
+*/
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_wakeup.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+
+            if (m_queue.empty())
+            {
+                return;   // stopping and nothing left to do
+            }
+
+            task = move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,48 @@
+/*
+Author: Guo Jia
+Description: Declaration of ThreadPool – a fixed set of worker threads that
+             run submitted tasks in FIFO order.  Used by the long-running
+             operations (sync, compare, ...) to spread file-system work
+             across all cores without blocking the GUI thread.
+Date: 2026-10-18
+*/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+    // Starts threadCount workers; 0 means one per hardware thread.
+    explicit ThreadPool(unsigned int threadCount = 0);
+    virtual ~ThreadPool();
+
+    // Threads cannot be duplicated, so neither can the pool.
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task.  The returned future becomes ready when the task has
+    // run, and rethrows anything the task threw.
+    std::future<void> Submit(std::function<void()> task);
+
+    unsigned int GetThreadCount() const { return static_cast<unsigned int>(m_threads.size()); }
+
+private:
+    std::vector<std::thread>               m_threads;
+    std::deque<std::function<void()>>      m_queue;
+    std::mutex                             m_mutex;
+    std::condition_variable                m_wakeup;
+    bool                                   m_stopping;
+
+    void WorkerLoop();
+};
+
+#endif // THREADPOOL_H
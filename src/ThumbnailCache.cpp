@@ -0,0 +1,493 @@
+/*
+Author: Guo Jia
+Description: Implementation of ThumbnailCache, following the freedesktop.org
+             Thumbnail Managing Standard: names are md5(uri).png, validity is
+             decided by the Thumb::URI and Thumb::MTime text chunks, files
+             are written to a temporary name with mode 0600 and renamed into
+             place so readers never see a partial thumbnail.
+Date: 2026-10-18
+*/
+
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wx/log.h>
+#include <wx/mstream.h>
+#include <wx/zstream.h>
+#include "ThumbnailCache.h"
+#include "Md5.h"
+
+using namespace std;
+
+namespace
+{
+    const char*  APPLICATION_NAME = "filemanager";
+    const char   PNG_SIGNATURE[8] = { '\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n' };
+    const size_t MAX_THUMBNAIL_BYTES = 4 * 1024 * 1024;   // larger files are not thumbnails
+
+    /*
+    Function: Crc32
+    Description: CRC-32 as used by PNG chunks (table built on first use).
+    Parameters: data   - bytes to checksum
+                length - number of bytes
+                crc    - running value (0 to start)
+    Return: Updated CRC
+    */
+    uint32_t Crc32(const unsigned char* data, size_t length, uint32_t crc)
+    {
+        static const vector<uint32_t> table = []()
+        {
+            vector<uint32_t> entries(256);
+            for (uint32_t n = 0; n < 256; ++n)
+            {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k)
+                {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                entries[n] = c;
+            }
+            return entries;
+        }();
+
+        crc = ~crc;
+        for (size_t i = 0; i < length; ++i)
+        {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    /*
+    Function: AppendBigEndian
+    Description: Appends a 32-bit value in network byte order.
+    Parameters: out   - buffer
+                value - value to append
+    Return: None
+    */
+    void AppendBigEndian(string& out, uint32_t value)
+    {
+        out += static_cast<char>(value >> 24);
+        out += static_cast<char>(value >> 16);
+        out += static_cast<char>(value >> 8);
+        out += static_cast<char>(value);
+    }
+
+    /*
+    Function: ReadBigEndian
+    Description: Reads a 32-bit value in network byte order.
+    Parameters: p - first byte
+    Return: The value
+    */
+    uint32_t ReadBigEndian(const char* p)
+    {
+        const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+        return (static_cast<uint32_t>(u[0]) << 24) | (static_cast<uint32_t>(u[1]) << 16) |
+               (static_cast<uint32_t>(u[2]) << 8)  |  static_cast<uint32_t>(u[3]);
+    }
+
+    /*
+    Function: AppendChunk
+    Description: Appends a PNG chunk: length, type, data and CRC of type+data.
+    Parameters: out  - buffer
+                type - four-letter chunk type
+                data - chunk payload
+    Return: None
+    */
+    void AppendChunk(string& out, const char* type, const string& data)
+    {
+        AppendBigEndian(out, static_cast<uint32_t>(data.size()));
+        size_t start = out.size();
+        out.append(type, 4);
+        out += data;
+        AppendBigEndian(out, Crc32(reinterpret_cast<const unsigned char*>(out.data() + start),
+                                   out.size() - start, 0));
+    }
+
+    /*
+    Function: ReadSmallFile
+    Description: Reads a whole file of at most MAX_THUMBNAIL_BYTES.
+    Parameters: path     - file to read
+                contents - receives the bytes
+    Return: false if missing, unreadable or too large
+    */
+    bool ReadSmallFile(const string& path, string& contents)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat info;
+        bool ok = fstat(fd, &info) == 0 && S_ISREG(info.st_mode) &&
+                  static_cast<size_t>(info.st_size) <= MAX_THUMBNAIL_BYTES;
+        if (ok)
+        {
+            contents.resize(static_cast<size_t>(info.st_size));
+            size_t done = 0;
+            while (done < contents.size())
+            {
+                ssize_t got = read(fd, &contents[done], contents.size() - done);
+                if (got <= 0)
+                {
+                    ok = (got == 0);
+                    break;
+                }
+                done += static_cast<size_t>(got);
+            }
+            contents.resize(done);
+        }
+        close(fd);
+        return ok;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: ThumbnailCache
+Description: Locates the cache root and makes sure the normal and failure
+             directories exist (mode 0700, as the standard requires).
+Parameters: None
+Return: None
+*/
+ThumbnailCache::ThumbnailCache()
+    : m_normalDir(""),
+      m_failDir(""),
+      m_usable(false)
+{
+    string root;
+    const char* cacheHome = getenv("XDG_CACHE_HOME");
+    const char* home      = getenv("HOME");
+    if (cacheHome != nullptr && cacheHome[0] == '/')
+    {
+        root = string(cacheHome) + "/thumbnails";
+    }
+    else if (home != nullptr && home[0] == '/')
+    {
+        root = string(home) + "/.cache/thumbnails";
+    }
+    else
+    {
+        return;
+    }
+
+    m_normalDir = root + "/normal";
+    m_failDir   = root + "/fail/" + APPLICATION_NAME;
+    m_usable    = MakeDirectories(m_normalDir) && MakeDirectories(m_failDir);
+}
+
+/*
+Function: ~ThumbnailCache
+Description: Destructor.  Nothing to release.
+Parameters: None
+Return: None
+*/
+ThumbnailCache::~ThumbnailCache()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Cache access
+// ---------------------------------------------------------------------------
+
+/*
+Function: Lookup
+Description: Looks for a valid thumbnail, then for a failure marker.  Only
+             the small cached PNG is decoded, never the source file.
+Parameters: path      - absolute path of the source file
+            modified  - its modification time (seconds)
+            thumbnail - receives the thumbnail on a hit
+Return: LOOKUP_HIT, LOOKUP_FAILED or LOOKUP_MISS
+*/
+ThumbnailCache::LookupResult ThumbnailCache::Lookup(const string& path, int64_t modified,
+                                                    wxImage& thumbnail) const
+{
+    if (!m_usable)
+    {
+        return LOOKUP_MISS;
+    }
+
+    string uri  = UriForPath(path);
+    string name = Md5::Hex(uri) + ".png";
+    string contents;
+
+    if (MatchesSource(m_normalDir + "/" + name, uri, modified, contents))
+    {
+        wxLogNull quiet;
+        wxMemoryInputStream stream(contents.data(), contents.size());
+        if (thumbnail.LoadFile(stream, wxBITMAP_TYPE_PNG))
+        {
+            return LOOKUP_HIT;
+        }
+    }
+    if (MatchesSource(m_failDir + "/" + name, uri, modified, contents))
+    {
+        return LOOKUP_FAILED;
+    }
+    return LOOKUP_MISS;
+}
+
+/*
+Function: Store
+Description: Writes a thumbnail (at most NORMAL_SIZE on its longer edge)
+             with the metadata that ties it to this version of the source.
+Parameters: path      - absolute path of the source file
+            modified  - its modification time (seconds)
+            thumbnail - the scaled image
+Return: true if written
+*/
+bool ThumbnailCache::Store(const string& path, int64_t modified, const wxImage& thumbnail) const
+{
+    if (!m_usable || !thumbnail.IsOk())
+    {
+        return false;
+    }
+    string uri = UriForPath(path);
+    TextChunks text = {
+        { "Thumb::URI",   uri },
+        { "Thumb::MTime", to_string(modified) },
+        { "Software",     APPLICATION_NAME }
+    };
+    return WritePng(m_normalDir + "/" + Md5::Hex(uri) + ".png", thumbnail, text);
+}
+
+/*
+Function: StoreFailure
+Description: Records that the source could not be thumbnailed, as a 1x1
+             PNG with the same metadata under fail/<application>/.
+Parameters: path     - absolute path of the source file
+            modified - its modification time (seconds)
+Return: true if written
+*/
+bool ThumbnailCache::StoreFailure(const string& path, int64_t modified) const
+{
+    if (!m_usable)
+    {
+        return false;
+    }
+    wxImage marker(1, 1);
+    marker.InitAlpha();
+    marker.SetAlpha(0, 0, 0);
+
+    string uri = UriForPath(path);
+    TextChunks text = {
+        { "Thumb::URI",   uri },
+        { "Thumb::MTime", to_string(modified) },
+        { "Software",     APPLICATION_NAME }
+    };
+    return WritePng(m_failDir + "/" + Md5::Hex(uri) + ".png", marker, text);
+}
+
+/*
+Function: UriForPath
+Description: Percent-escapes every byte except ASCII letters, digits and
+             the characters GLib leaves alone in paths.
+Parameters: path - absolute path
+Return: "file://" URI
+*/
+string ThumbnailCache::UriForPath(const string& path)
+{
+    static const char SAFE[]   = "!$&'()*+,-./:=@_~";
+    static const char DIGITS[] = "0123456789ABCDEF";
+
+    string uri = "file://";
+    uri.reserve(uri.size() + path.size());
+    for (char c : path)
+    {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (isalnum(byte) && byte < 0x80)
+        {
+            uri += c;
+        }
+        else if (byte != 0 && strchr(SAFE, c) != nullptr)
+        {
+            uri += c;
+        }
+        else
+        {
+            uri += '%';
+            uri += DIGITS[byte >> 4];
+            uri += DIGITS[byte & 0x0F];
+        }
+    }
+    return uri;
+}
+
+// ---------------------------------------------------------------------------
+// PNG helpers
+// ---------------------------------------------------------------------------
+
+/*
+Function: MatchesSource
+Description: Walks the PNG's chunks up to the image data and compares the
+             Thumb::URI and Thumb::MTime text chunks.  Thumbnails without
+             them are treated as stale, as the standard asks.
+Parameters: file     - thumbnail file
+            uri      - expected source URI
+            modified - expected source modification time
+            contents - receives the file's bytes
+Return: true if both chunks are present and match
+*/
+bool ThumbnailCache::MatchesSource(const string& file, const string& uri,
+                                   int64_t modified, string& contents)
+{
+    if (!ReadSmallFile(file, contents) || contents.size() < sizeof(PNG_SIGNATURE) ||
+        memcmp(contents.data(), PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) != 0)
+    {
+        return false;
+    }
+
+    string mtime = to_string(modified);
+    bool uriMatches   = false;
+    bool mtimeMatches = false;
+    size_t pos = sizeof(PNG_SIGNATURE);
+    while (pos + 12 <= contents.size())
+    {
+        uint32_t length = ReadBigEndian(contents.data() + pos);
+        string   type(contents.data() + pos + 4, 4);
+        if (length > contents.size() - pos - 12 || type == "IDAT" || type == "IEND")
+        {
+            break;
+        }
+        if (type == "tEXt")
+        {
+            string data(contents.data() + pos + 8, length);
+            size_t separator = data.find('\0');
+            if (separator != string::npos)
+            {
+                string key   = data.substr(0, separator);
+                string value = data.substr(separator + 1);
+                uriMatches   = uriMatches   || (key == "Thumb::URI"   && value == uri);
+                mtimeMatches = mtimeMatches || (key == "Thumb::MTime" && value == mtime);
+            }
+        }
+        pos += 12 + length;
+    }
+    return uriMatches && mtimeMatches;
+}
+
+/*
+Function: WritePng
+Description: Encodes the image as 8-bit RGB (or RGBA when it has alpha),
+             deflates the scanlines through wxZlibOutputStream and writes
+             IHDR, the text chunks, IDAT and IEND to a temporary file that
+             is then renamed over 'file'.
+Parameters: file  - destination path
+            image - image to encode
+            text  - tEXt key/value pairs
+Return: true if written
+*/
+bool ThumbnailCache::WritePng(const string& file, const wxImage& image, const TextChunks& text)
+{
+    int  width    = image.GetWidth();
+    int  height   = image.GetHeight();
+    bool hasAlpha = image.HasAlpha();
+    const unsigned char* rgb   = image.GetData();
+    const unsigned char* alpha = image.GetAlpha();
+    if (width <= 0 || height <= 0 || rgb == nullptr)
+    {
+        return false;
+    }
+
+    // Scanlines, each preceded by filter type 0 (none).
+    size_t channels = hasAlpha ? 4 : 3;
+    string raw;
+    raw.reserve(static_cast<size_t>(height) * (1 + static_cast<size_t>(width) * channels));
+    for (int y = 0; y < height; ++y)
+    {
+        raw += '\0';
+        for (int x = 0; x < width; ++x)
+        {
+            size_t pixel = static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x);
+            raw.append(reinterpret_cast<const char*>(rgb + pixel * 3), 3);
+            if (hasAlpha)
+            {
+                raw += static_cast<char>(alpha[pixel]);
+            }
+        }
+    }
+
+    wxMemoryOutputStream compressedStream;
+    {
+        wxZlibOutputStream zlib(compressedStream, -1, wxZLIB_ZLIB);
+        zlib.Write(raw.data(), raw.size());
+        if (!zlib.Close())
+        {
+            return false;
+        }
+    }
+    string compressed(compressedStream.GetLength(), '\0');
+    compressedStream.CopyTo(&compressed[0], compressed.size());
+
+    string header;
+    AppendBigEndian(header, static_cast<uint32_t>(width));
+    AppendBigEndian(header, static_cast<uint32_t>(height));
+    header += static_cast<char>(8);                    // bit depth
+    header += static_cast<char>(hasAlpha ? 6 : 2);     // colour type: RGBA / RGB
+    header.append(3, '\0');                            // compression, filter, interlace
+
+    string png(PNG_SIGNATURE, sizeof(PNG_SIGNATURE));
+    AppendChunk(png, "IHDR", header);
+    for (const auto& entry : text)
+    {
+        AppendChunk(png, "tEXt", entry.first + '\0' + entry.second);
+    }
+    AppendChunk(png, "IDAT", compressed);
+    AppendChunk(png, "IEND", "");
+
+    // mkstemp creates the file with mode 0600, which the standard requires.
+    string temporary = file + ".XXXXXX";
+    int fd = mkstemp(&temporary[0]);
+    if (fd < 0)
+    {
+        return false;
+    }
+    size_t done = 0;
+    while (done < png.size())
+    {
+        ssize_t wrote = write(fd, png.data() + done, png.size() - done);
+        if (wrote <= 0)
+        {
+            break;
+        }
+        done += static_cast<size_t>(wrote);
+    }
+    bool ok = close(fd) == 0 && done == png.size() && rename(temporary.c_str(), file.c_str()) == 0;
+    if (!ok)
+    {
+        unlink(temporary.c_str());
+    }
+    return ok;
+}
+
+/*
+Function: MakeDirectories
+Description: mkdir -p with mode 0700.
+Parameters: path - absolute directory path
+Return: true if the directory exists afterwards
+*/
+bool ThumbnailCache::MakeDirectories(const string& path)
+{
+    for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1))
+    {
+        string prefix = path.substr(0, slash);
+        if (mkdir(prefix.c_str(), 0700) != 0 && errno != EEXIST)
+        {
+            return false;
+        }
+        if (slash == string::npos)
+        {
+            break;
+        }
+    }
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
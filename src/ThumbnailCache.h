@@ -0,0 +1,69 @@
+/*
+Author: Guo Jia
+Description: Declaration of ThumbnailCache – the freedesktop.org shared
+             thumbnail cache (~/.cache/thumbnails).  A thumbnail is a PNG
+             named after the MD5 of the source file's URI and carries the
+             source's URI and modification time in tEXt chunks, so a
+             thumbnail is only reused while the file is unchanged, and
+             thumbnails made by other desktop applications are reused too.
+             Files that cannot be decoded get a marker under fail/ so they
+             are not tried again until they change.
+Date: 2026-10-18
+*/
+
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <wx/image.h>
+
+class ThumbnailCache
+{
+public:
+    // Edge length of the "normal" thumbnail size.
+    static constexpr int NORMAL_SIZE = 128;
+
+    enum LookupResult {
+        LOOKUP_HIT,      // thumbnail loaded
+        LOOKUP_FAILED,   // the source is known not to decode
+        LOOKUP_MISS
+    };
+
+    // Resolves (and creates) the cache directories under $XDG_CACHE_HOME,
+    // or ~/.cache when that is not set.
+    ThumbnailCache();
+    virtual ~ThumbnailCache();
+
+    // All members are safe to call from several threads at once: each call
+    // only touches its own files, which are replaced atomically.
+    LookupResult Lookup(const std::string& path, std::int64_t modified, wxImage& thumbnail) const;
+    bool         Store(const std::string& path, std::int64_t modified, const wxImage& thumbnail) const;
+    bool         StoreFailure(const std::string& path, std::int64_t modified) const;
+
+    // "file://" URI of an absolute path, escaped the way GLib does so the
+    // MD5 names match those written by other applications.
+    static std::string UriForPath(const std::string& path);
+
+private:
+    typedef std::vector<std::pair<std::string, std::string>> TextChunks;
+
+    std::string m_normalDir;   // .../thumbnails/normal
+    std::string m_failDir;     // .../thumbnails/fail/<application>
+    bool        m_usable;      // false if the directories could not be created
+
+    // True if 'file' is a PNG whose Thumb::URI and Thumb::MTime match.
+    // Reads the file into 'contents' so the caller can decode it.
+    static bool MatchesSource(const std::string& file, const std::string& uri,
+                              std::int64_t modified, std::string& contents);
+
+    // Minimal PNG encoder (8-bit RGB or RGBA, no filtering) that can
+    // attach tEXt chunks, which wxImage's PNG handler cannot write.
+    static bool WritePng(const std::string& file, const wxImage& image, const TextChunks& text);
+
+    static bool MakeDirectories(const std::string& path);
+};
+
+#endif // THUMBNAILCACHE_H
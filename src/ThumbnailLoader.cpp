@@ -0,0 +1,299 @@
+/*
+Author: Guo Jia
+Description: Implementation of ThumbnailLoader.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <wx/log.h>
+#include "ThumbnailLoader.h"
+#include "ThumbnailCache.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: ThumbnailLoader
+Description: Starts up to MAX_THREADS workers (half the hardware threads,
+             at least one), leaving the rest of the machine to the GUI and
+             foreground jobs.  They are shared by every client.
+Parameters: cache - disk cache consulted and filled by the workers
+Return: None
+*/
+ThumbnailLoader::ThumbnailLoader(ThumbnailCache& cache)
+    : m_cache(cache),
+      m_clients(),
+      m_nextClient(0),
+      m_current(0),
+      m_stopping(false),
+      m_mutex(),
+      m_deliverMutex(),
+      m_wakeup(),
+      m_threads(),
+      m_decoded(0),
+      m_cacheHits(0)
+{
+    unsigned int count = max(1u, min(MAX_THREADS, thread::hardware_concurrency() / 2));
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        m_threads.emplace_back(&ThumbnailLoader::WorkerLoop, this);
+    }
+}
+
+/*
+Function: ~ThumbnailLoader
+Description: Abandons the queues and waits for thumbnails in progress.
+Parameters: None
+Return: None
+*/
+ThumbnailLoader::~ThumbnailLoader()
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stopping = true;
+        m_clients.clear();
+    }
+    m_wakeup.notify_all();
+    for (thread& worker : m_threads)
+    {
+        worker.join();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Clients
+// ---------------------------------------------------------------------------
+
+/*
+Function: AddClient
+Description: Registers an owner with an empty queue.
+Parameters: handler - receives the owner's thumbnails
+Return: The owner's id
+*/
+ThumbnailLoader::ClientId ThumbnailLoader::AddClient(const ResultHandler& handler)
+{
+    lock_guard<mutex> lock(m_mutex);
+    ClientId client = ++m_nextClient;
+    Client& added = m_clients[client];
+    added.handler    = handler;
+    added.generation = 0;
+    return client;
+}
+
+/*
+Function: RemoveClient
+Description: Drops the owner and its queue, then waits out a delivery to
+             it that may already be running.  Thumbnails of its rows still
+             being produced are discarded when they finish.
+Parameters: client - owner to remove
+Return: None
+*/
+void ThumbnailLoader::RemoveClient(ClientId client)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_clients.erase(client);
+    }
+    lock_guard<mutex> delivering(m_deliverMutex);
+}
+
+// ---------------------------------------------------------------------------
+// Requests
+// ---------------------------------------------------------------------------
+
+/*
+Function: SetRequests
+Description: Swaps in a new queue for the client.  Whatever it had queued
+             before and is not in the new list is thereby cancelled.
+Parameters: client     - owner of the rows
+            generation - listing the rows belong to
+            requests   - rows wanted, most urgent first
+Return: None
+*/
+void ThumbnailLoader::SetRequests(ClientId client, unsigned long generation, const vector<Request>& requests)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        auto found = m_clients.find(client);
+        if (found == m_clients.end())
+        {
+            return;
+        }
+        Client& owner = found->second;
+        if (generation != owner.generation)
+        {
+            owner.generation = generation;
+            owner.inFlight.clear();
+        }
+        owner.queue.clear();
+        for (const Request& request : requests)
+        {
+            if (owner.inFlight.count(request.row) == 0)
+            {
+                owner.queue.push_back(request);
+            }
+        }
+    }
+    m_wakeup.notify_all();
+}
+
+/*
+Function: Clear
+Description: Drops the client's queued requests.
+Parameters: client - owner of the requests
+Return: None
+*/
+void ThumbnailLoader::Clear(ClientId client)
+{
+    lock_guard<mutex> lock(m_mutex);
+    auto found = m_clients.find(client);
+    if (found != m_clients.end())
+    {
+        found->second.queue.clear();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+/*
+Function: NextClient
+Description: Round robin: the first client after the one served last that
+             has something queued, so a panel with a long queue cannot
+             starve the others.
+Parameters: None
+Return: Client with work, or m_clients.end()
+*/
+map<ThumbnailLoader::ClientId, ThumbnailLoader::Client>::iterator ThumbnailLoader::NextClient()
+{
+    for (auto it = m_clients.upper_bound(m_current); it != m_clients.end(); ++it)
+    {
+        if (!it->second.queue.empty())
+        {
+            return it;
+        }
+    }
+    for (auto it = m_clients.begin(); it != m_clients.end() && it->first <= m_current; ++it)
+    {
+        if (!it->second.queue.empty())
+        {
+            return it;
+        }
+    }
+    return m_clients.end();
+}
+
+/*
+Function: WorkerLoop
+Description: Takes the front request of the next client, produces its
+             thumbnail outside the lock and hands it to the client's
+             handler, unless the client has gone or its rows have been
+             replaced by another listing in the meantime.  Deliveries hold
+             m_deliverMutex, which RemoveClient() waits for.
+Parameters: None
+Return: None
+*/
+void ThumbnailLoader::WorkerLoop()
+{
+    for (;;)
+    {
+        Request       request;
+        ClientId      client     = 0;
+        unsigned long generation = 0;
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_wakeup.wait(lock, [this]() { return m_stopping || NextClient() != m_clients.end(); });
+            if (m_stopping)
+            {
+                return;
+            }
+            auto next = NextClient();
+            Client& owner = next->second;
+            request = owner.queue.front();
+            owner.queue.pop_front();
+            client     = next->first;
+            generation = owner.generation;
+            owner.inFlight.insert(request.row);
+            m_current = client;
+        }
+
+        shared_ptr<const wxImage> image = Produce(request);
+
+        lock_guard<mutex> delivering(m_deliverMutex);
+        ResultHandler handler;
+        {
+            lock_guard<mutex> lock(m_mutex);
+            auto found = m_clients.find(client);
+            if (found == m_clients.end() || generation != found->second.generation || m_stopping)
+            {
+                continue;
+            }
+            found->second.inFlight.erase(request.row);
+            handler = found->second.handler;
+        }
+        handler(generation, request.row, image);
+    }
+}
+
+/*
+Function: Produce
+Description: Cache hit: the stored thumbnail.  Known failure: nothing.
+             Miss: decode the source, shrink it to the standard's normal
+             size, store it (or a failure marker) and return it.
+Parameters: request - row to produce
+Return: The thumbnail, or null if there is none
+*/
+shared_ptr<const wxImage> ThumbnailLoader::Produce(const Request& request)
+{
+    shared_ptr<wxImage> thumbnail = make_shared<wxImage>();
+    switch (m_cache.Lookup(request.path, request.modified, *thumbnail))
+    {
+    case ThumbnailCache::LOOKUP_HIT:
+        ++m_cacheHits;
+        return thumbnail;
+    case ThumbnailCache::LOOKUP_FAILED:
+        return nullptr;
+    case ThumbnailCache::LOOKUP_MISS:
+        break;
+    }
+
+    wxImage source;
+    {
+        wxLogNull quiet;   // undecodable files are expected, not errors
+        if (!source.LoadFile(request.path, wxBITMAP_TYPE_ANY) || !source.IsOk())
+        {
+            m_cache.StoreFailure(request.path, request.modified);
+            return nullptr;
+        }
+    }
+    ++m_decoded;
+
+    *thumbnail = ScaleToFit(source, ThumbnailCache::NORMAL_SIZE);
+    m_cache.Store(request.path, request.modified, *thumbnail);
+    return thumbnail;
+}
+
+/*
+Function: ScaleToFit
+Description: Box-filtered downscale keeping the aspect ratio.
+Parameters: image - source image
+            size  - edge of the bounding box
+Return: Scaled image
+*/
+wxImage ThumbnailLoader::ScaleToFit(const wxImage& image, int size)
+{
+    int width  = image.GetWidth();
+    int height = image.GetHeight();
+    if (width <= size && height <= size)
+    {
+        return image;
+    }
+    double factor = static_cast<double>(size) / max(width, height);
+    return image.Scale(max(1, static_cast<int>(width * factor)),
+                       max(1, static_cast<int>(height * factor)),
+                       wxIMAGE_QUALITY_HIGH);
+}
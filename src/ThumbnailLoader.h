@@ -0,0 +1,116 @@
+/*
+Author: Guo Jia
+Description: Declaration of ThumbnailLoader – produces thumbnails for list
+             rows on a small, fixed set of background threads.  The owner
+             replaces the whole queue whenever the visible rows change, so
+             rows scrolled out of view are dropped before any work is done
+             for them.  Each request is answered from the ThumbnailCache
+             when possible; only a miss decodes the source image, and the
+             result is written back so it is never decoded again.  One
+             loader serves every file panel: each registers as a client
+             with its own queue, and the workers take from them in turn.
+Date: 2026-10-18
+*/
+
+#ifndef THUMBNAILLOADER_H
+#define THUMBNAILLOADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <wx/image.h>
+
+class ThumbnailCache;
+
+class ThumbnailLoader
+{
+public:
+    struct Request
+    {
+        long          row;
+        std::string   path;
+        std::int64_t  modified;
+    };
+
+    // Receives finished thumbnails.  Runs on a worker thread, so it should
+    // only hand the result over (e.g. with CallAfter).  'image' is null
+    // when the file cannot be thumbnailed.  The image is not shared with
+    // anything else, so it may be used from the thread it is handed to.
+    typedef std::function<void(unsigned long generation, long row,
+                               std::shared_ptr<const wxImage> image)> ResultHandler;
+
+    // Identifies one owner of rows (a file panel).
+    typedef unsigned long ClientId;
+
+    explicit ThumbnailLoader(ThumbnailCache& cache);
+    virtual ~ThumbnailLoader();
+
+    ThumbnailLoader(const ThumbnailLoader&) = delete;
+    ThumbnailLoader& operator=(const ThumbnailLoader&) = delete;
+
+    // Register an owner whose thumbnails go to 'handler'.  After
+    // RemoveClient() returns the handler is never called again, so the
+    // owner may be destroyed.
+    ClientId AddClient(const ResultHandler& handler);
+    void     RemoveClient(ClientId client);
+
+    // Replace the client's queue with 'requests', served front first –
+    // put the visible rows first.  Rows already being worked on are not
+    // queued again.  A new generation means the rows now refer to a
+    // different listing.
+    void SetRequests(ClientId client, unsigned long generation, const std::vector<Request>& requests);
+
+    // Drop everything the client has queued.
+    void Clear(ClientId client);
+
+    // Images decoded from source files / served from the disk cache.
+    std::size_t GetDecodedCount() const { return m_decoded; }
+    std::size_t GetCacheHitCount() const { return m_cacheHits; }
+
+private:
+    // Decoding is CPU- and memory-heavy (a 24-megapixel JPEG is ~70 MB
+    // decoded), so the number of concurrent decodes is kept small.
+    static constexpr unsigned int MAX_THREADS = 4;
+
+    struct Client
+    {
+        ResultHandler       handler;
+        std::deque<Request> queue;
+        std::set<long>      inFlight;     // rows of 'generation' being processed
+        unsigned long       generation;
+    };
+
+    ThumbnailCache&             m_cache;
+    std::map<ClientId, Client>  m_clients;
+    ClientId                    m_nextClient;
+    ClientId                    m_current;        // served last; the next client goes first
+    bool                        m_stopping;
+    std::mutex                  m_mutex;
+    std::mutex                  m_deliverMutex;   // held while a handler runs
+    std::condition_variable     m_wakeup;
+    std::vector<std::thread>    m_threads;
+    std::atomic<std::size_t>    m_decoded;
+    std::atomic<std::size_t>    m_cacheHits;
+
+    void WorkerLoop();
+
+    // Client to take the next request from, or end().  Needs m_mutex.
+    std::map<ClientId, Client>::iterator NextClient();
+
+    std::shared_ptr<const wxImage> Produce(const Request& request);
+
+    // Shrink to fit a size x size box, keeping the aspect ratio.  Smaller
+    // images are returned unchanged.
+    static wxImage ScaleToFit(const wxImage& image, int size);
+};
+
+#endif // THUMBNAILLOADER_H
@@ -0,0 +1,219 @@
+/*
+Author: Guo Jia
+Description: Implementation of TreeHashCache.  The on-disk format is a small
+             header followed by fixed-size (signature, hash) pairs, written to
+             a temporary file and renamed so a crash never leaves a torn
+             cache behind.
+Date: 2026-10-18
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "TreeHashCache.h"
+#include "ContentHash.h"
+
+using namespace std;
+
+namespace
+{
+    const char     CACHE_MAGIC[8] = { 'F', 'M', 'T', 'H', 'C', 'v', '0', '1' };
+    const uint64_t SIGNATURE_SEED = 0x5452454548415348ULL;   // "TREEHASH"
+}
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+/*
+Function: TreeHashCache
+Description: Creates an empty cache bound to a storage file.  Nothing is
+             read until Load() is called.
+Parameters: storagePath - cache file location
+Return: None
+*/
+TreeHashCache::TreeHashCache(const string& storagePath)
+    : m_storagePath(storagePath),
+      m_mutex(),
+      m_entries(),
+      m_loaded(false)
+{
+}
+
+/*
+Function: ~TreeHashCache
+Description: Destructor.  Saving is left to the owner so shutdown never
+             blocks on a large write unexpectedly.
+Parameters: None
+Return: None
+*/
+TreeHashCache::~TreeHashCache()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Lookup / store
+// ---------------------------------------------------------------------------
+
+/*
+Function: Lookup
+Description: Finds the hash stored for a signature and marks it as used so
+             Save() keeps it.
+Parameters: signature - stat-derived signature
+            hash      - receives the stored hash on a hit
+Return: true on a cache hit
+*/
+bool TreeHashCache::Lookup(uint64_t signature, uint64_t& hash)
+{
+    lock_guard<mutex> lock(m_mutex);
+    auto found = m_entries.find(signature);
+    if (found == m_entries.end())
+    {
+        return false;
+    }
+    found->second.used = true;
+    hash = found->second.hash;
+    return true;
+}
+
+/*
+Function: Store
+Description: Records (or replaces) the hash for a signature.
+Parameters: signature - stat-derived signature
+            hash      - content hash to remember
+Return: None
+*/
+void TreeHashCache::Store(uint64_t signature, uint64_t hash)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_entries[signature] = Entry{ hash, true };
+}
+
+// ---------------------------------------------------------------------------
+// Persistence
+// ---------------------------------------------------------------------------
+
+/*
+Function: Load
+Description: Reads the cache file once per session.  A missing file is not
+             an error (first run); a file with a foreign header is ignored.
+Parameters: None
+Return: false only if an existing cache file could not be read
+*/
+bool TreeHashCache::Load()
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_loaded)
+    {
+        return true;
+    }
+    m_loaded = true;
+
+    ifstream in(m_storagePath, ios::binary);
+    if (!in)
+    {
+        return true;
+    }
+
+    char magic[sizeof(CACHE_MAGIC)];
+    uint64_t count = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!in || memcmp(magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || count > MAX_ENTRIES)
+    {
+        return true;
+    }
+
+    vector<uint64_t> pairs(static_cast<size_t>(count) * 2);
+    in.read(reinterpret_cast<char*>(pairs.data()), static_cast<streamsize>(pairs.size() * sizeof(uint64_t)));
+    if (!in)
+    {
+        return false;
+    }
+
+    m_entries.reserve(static_cast<size_t>(count));
+    for (size_t i = 0; i < pairs.size(); i += 2)
+    {
+        // Entries computed this session before Load() win over stale ones.
+        m_entries.emplace(pairs[i], Entry{ pairs[i + 1], false });
+    }
+    return true;
+}
+
+/*
+Function: Save
+Description: Writes the cache atomically.  When over MAX_ENTRIES, entries
+             not touched this session are dropped first, which keeps the
+             trees the user actually compares.
+Parameters: None
+Return: true if the file was written
+*/
+bool TreeHashCache::Save()
+{
+    lock_guard<mutex> lock(m_mutex);
+
+    vector<uint64_t> pairs;
+    pairs.reserve(min(m_entries.size(), MAX_ENTRIES) * 2);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        bool wantUsed = (pass == 0);
+        for (const auto& entry : m_entries)
+        {
+            if (entry.second.used == wantUsed && pairs.size() / 2 < MAX_ENTRIES)
+            {
+                pairs.push_back(entry.first);
+                pairs.push_back(entry.second.hash);
+            }
+        }
+    }
+
+    string tempPath = m_storagePath + ".tmp";
+    {
+        ofstream out(tempPath, ios::binary | ios::trunc);
+        uint64_t count = pairs.size() / 2;
+        out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char*>(pairs.data()), static_cast<streamsize>(pairs.size() * sizeof(uint64_t)));
+        if (!out)
+        {
+            return false;
+        }
+    }
+    return rename(tempPath.c_str(), m_storagePath.c_str()) == 0;
+}
+
+/*
+Function: GetEntryCount
+Description: Number of signatures currently cached.
+Parameters: None
+Return: Entry count
+*/
+size_t TreeHashCache::GetEntryCount()
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+// ---------------------------------------------------------------------------
+// Signatures
+// ---------------------------------------------------------------------------
+
+/*
+Function: FileSignature
+Description: Hashes a file's stat tuple.  Any change to contents bumps the
+             mtime or size, and a replaced file gets a new inode, so an equal
+             signature means the cached content hash is still valid.
+Parameters: device           - st_dev
+            inode            - st_ino
+            mtimeNanoseconds - modification time in ns since the epoch
+            size             - st_size
+Return: 64-bit signature
+*/
+uint64_t TreeHashCache::FileSignature(uint64_t device, uint64_t inode,
+                                      int64_t mtimeNanoseconds, uint64_t size)
+{
+    uint64_t tuple[4] = { device, inode, static_cast<uint64_t>(mtimeNanoseconds), size };
+    return ContentHash::Hash(tuple, sizeof(tuple), SIGNATURE_SEED);
+}
@@ -0,0 +1,62 @@
+/*
+Author: Guo Jia
+Description: Declaration of TreeHashCache – a persistent map from a stat
+             "signature" to a content hash.  A file's signature is derived
+             from (dev, inode, mtime, size); a directory's from its own stat
+             tuple plus the signatures of all its children, so an unchanged
+             subtree maps to its previously computed aggregate hash without
+             reading a single file.
+Date: 2026-10-18
+*/
+
+#ifndef TREEHASHCACHE_H
+#define TREEHASHCACHE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class TreeHashCache
+{
+public:
+    // storagePath is where Load()/Save() keep the cache between sessions.
+    explicit TreeHashCache(const std::string& storagePath);
+    virtual ~TreeHashCache();
+
+    // Holds a mutex; shared by reference only.
+    TreeHashCache(const TreeHashCache&) = delete;
+    TreeHashCache& operator=(const TreeHashCache&) = delete;
+
+    // Look up / store the content hash for a signature.  Thread-safe.
+    bool Lookup(std::uint64_t signature, std::uint64_t& hash);
+    void Store(std::uint64_t signature, std::uint64_t hash);
+
+    // Read the on-disk cache (once; later calls are no-ops) and write it
+    // back.  Save() keeps every entry used this session and, space
+    // permitting, older ones.  Both return false on I/O errors.
+    bool Load();
+    bool Save();
+
+    std::size_t GetEntryCount();
+
+    // Signature of a file from its stat tuple.
+    static std::uint64_t FileSignature(std::uint64_t device, std::uint64_t inode,
+                                       std::int64_t mtimeNanoseconds, std::uint64_t size);
+
+private:
+    struct Entry
+    {
+        std::uint64_t hash;
+        bool          used;   // looked up or stored during this session
+    };
+
+    static constexpr std::size_t MAX_ENTRIES = 4 * 1024 * 1024;
+
+    std::string                              m_storagePath;
+    std::mutex                               m_mutex;
+    std::unordered_map<std::uint64_t, Entry> m_entries;
+    bool                                     m_loaded;
+};
+
+#endif // TREEHASHCACHE_H